@@ -22,13 +22,14 @@ vector<string> AlignCommand::setParameters(){
 	try {
 		CommandParameter ptemplate("reference", "InputTypes", "", "", "none", "none", "none","",false,true,true); parameters.push_back(ptemplate);
 		CommandParameter pcandidate("fasta", "InputTypes", "", "", "none", "none", "none","fasta-alignreport-accnos",false,true,true); parameters.push_back(pcandidate);
-		CommandParameter psearch("search", "Multiple", "kmer-blast-suffix", "kmer", "", "", "","",false,false,true); parameters.push_back(psearch);
+		CommandParameter psearch("search", "Multiple", "kmer-blast-suffix-minimizer", "kmer", "", "", "","",false,false,true); parameters.push_back(psearch);
 		CommandParameter pksize("ksize", "Number", "", "8", "", "", "","",false,false); parameters.push_back(pksize);
 		CommandParameter pmatch("match", "Number", "", "1.0", "", "", "","",false,false); parameters.push_back(pmatch);
-		CommandParameter palign("align", "Multiple", "needleman-gotoh-blast-noalign", "needleman", "", "", "","",false,false,true); parameters.push_back(palign);
+		CommandParameter palign("align", "Multiple", "needleman-gotoh-fastneedleman-fastgotoh-blast-noalign", "needleman", "", "", "","",false,false,true); parameters.push_back(palign);
 		CommandParameter pmismatch("mismatch", "Number", "", "-1.0", "", "", "","",false,false); parameters.push_back(pmismatch);
 		CommandParameter pgapopen("gapopen", "Number", "", "-5.0", "", "", "","",false,false); parameters.push_back(pgapopen);
 		CommandParameter pgapextend("gapextend", "Number", "", "-2.0", "", "", "","",false,false); parameters.push_back(pgapextend);
+		CommandParameter pband("band", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pband);
 		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pflip("flip", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pflip);
 		CommandParameter psave("save", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(psave);
@@ -50,18 +51,20 @@ string AlignCommand::getHelpString(){
 	try {
 		string helpString = "";
 		helpString += "The align.seqs command reads a file containing sequences and creates an alignment file and a report file.";
-		helpString += "The align.seqs command parameters are reference, fasta, search, ksize, align, match, mismatch, gapopen, gapextend and processors.";
+		helpString += "The align.seqs command parameters are reference, fasta, search, ksize, align, match, mismatch, gapopen, gapextend, band and processors.";
 		helpString += "The reference and fasta parameters are required. You may leave fasta blank if you have a valid fasta file. You may enter multiple fasta files by separating their names with dashes. ie. fasta=abrecovery.fasta-amzon.fasta.";
-		helpString += "The search parameter allows you to specify the method to find most similar template.  Your options are: suffix, kmer and blast. The default is kmer.";
-		helpString += "The align parameter allows you to specify the alignment method to use.  Your options are: gotoh, needleman, blast and noalign. The default is needleman.";
+		helpString += "The search parameter allows you to specify the method to find most similar template.  Your options are: suffix, kmer, minimizer and blast. The default is kmer. The minimizer search indexes only the minimizers of spaced seeds of ksize bases, so its index is smaller and it is less affected by sequencing errors.";
+		helpString += "The align parameter allows you to specify the alignment method to use.  Your options are: gotoh, needleman, fastgotoh, fastneedleman, blast and noalign. The default is needleman.";
+		helpString += "The fastgotoh and fastneedleman methods give the same alignments as gotoh and needleman, but are faster. They require the match, mismatch, gapopen and gapextend scores to be whole numbers.";
+		helpString += "The band parameter allows you to limit the fastgotoh and fastneedleman alignments to the cells within band positions of the diagonal shared by the most 8mers of the candidate and template. This is faster, but may change the alignment. The default is 0, meaning the whole matrix is used.";
 		helpString += "The ksize parameter allows you to specify the kmer size for finding most similar template to candidate.  The default is 8.";
 		helpString += "The match parameter allows you to specify the bonus for having the same base. The default is 1.0.";
 		helpString += "The mistmatch parameter allows you to specify the penalty for having different bases.  The default is -1.0.";
 		helpString += "The gapopen parameter allows you to specify the penalty for opening a gap in an alignment. The default is -5.0.";
 		helpString += "The gapextend parameter allows you to specify the penalty for extending a gap in an alignment.  The default is -2.0.";
-		helpString += "The flip parameter is used to specify whether or not you want mothur to try the reverse complement if a sequence falls below the threshold.  The default is false.";
-		helpString += "The threshold is used to specify a cutoff at which an alignment is deemed 'bad' and the reverse complement may be tried. The default threshold is 0.50, meaning 50% of the bases are removed in the alignment.";
-		helpString += "If the flip parameter is set to true the reverse complement of the sequence is aligned and the better alignment is reported.";
+		helpString += "The flip parameter is used to specify whether or not you want mothur to try the reverse complement of your sequences.  The default is false.";
+		helpString += "The threshold is used to specify a cutoff at which an alignment is deemed 'bad' and added to the accnos file. The default threshold is 0.50, meaning 50% of the bases are removed in the alignment.";
+		helpString += "If the flip parameter is set to true the template search scores the sequence and its reverse complement together, the orientation that shares more kmers with the templates is aligned and the reversed sequences are listed in the flip.accnos file.";
 		helpString += "If the save parameter is set to true the reference sequences will be saved in memory, to clear them later you can use the clear.memory command. Default=f.";
 		helpString += "The default for the threshold parameter is 0.50, meaning at least 50% of the bases must remain or the sequence is reported as potentially reversed.";
 		helpString += "The align.seqs command should be in the following format:";
@@ -255,6 +258,9 @@ AlignCommand::AlignCommand(string option)  {
 			temp = validParameter.validFile(parameters, "gapextend", false);	if (temp == "not found"){	temp = "-2.0";			}
 			m->mothurConvert(temp, gapExtend); 
 			
+			temp = validParameter.validFile(parameters, "band", false);			if (temp == "not found"){	temp = "0";				}
+			m->mothurConvert(temp, band); 
+			
 			temp = validParameter.validFile(parameters, "processors", false);	if (temp == "not found"){	temp = m->getProcessors();	}
 			m->setProcessors(temp);
 			m->mothurConvert(temp, processors); 
@@ -287,10 +293,18 @@ AlignCommand::AlignCommand(string option)  {
 			m->mothurConvert(temp, threshold); 
 			
 			search = validParameter.validFile(parameters, "search", false);		if (search == "not found"){	search = "kmer";		}
-			if ((search != "suffix") && (search != "kmer") && (search != "blast")) { m->mothurOut("invalid search option: choices are kmer, suffix or blast."); m->mothurOutEndLine(); abort=true; }
+			if ((search != "suffix") && (search != "kmer") && (search != "blast") && (search != "minimizer")) { m->mothurOut("invalid search option: choices are kmer, suffix, minimizer or blast."); m->mothurOutEndLine(); abort=true; }
 			
 			align = validParameter.validFile(parameters, "align", false);		if (align == "not found"){	align = "needleman";	}
-			if ((align != "needleman") && (align != "gotoh") && (align != "blast") && (align != "noalign")) { m->mothurOut("invalid align option: choices are needleman, gotoh, blast or noalign."); m->mothurOutEndLine(); abort=true; }
+			if ((align != "needleman") && (align != "gotoh") && (align != "fastneedleman") && (align != "fastgotoh") && (align != "blast") && (align != "noalign")) { m->mothurOut("invalid align option: choices are needleman, gotoh, fastneedleman, fastgotoh, blast or noalign."); m->mothurOutEndLine(); abort=true; }
+			
+			//the fast aligners score with integers
+			if ((align == "fastneedleman") || (align == "fastgotoh")) {
+				if (!FastAlignment::isWholeNumber(match) || !FastAlignment::isWholeNumber(misMatch) || !FastAlignment::isWholeNumber(gapOpen) || !FastAlignment::isWholeNumber(gapExtend)) {
+					m->mothurOut("[WARNING]: The " + align + " method requires whole number scores, using " + align.substr(4) + " instead."); m->mothurOutEndLine();
+					align = align.substr(4);
+				}
+			}
 
 		}
 		
@@ -535,7 +549,7 @@ int AlignCommand::driver(linePair* filePos, string alignFName, string reportFNam
 		ifstream inFASTA;
 		m->openInputFile(filename, inFASTA);
 
-		inFASTA.seekg(filePos->start);
+		if (filePos->start != 0) { inFASTA.seekg(filePos->start); }
 
 		bool done = false;
 		int count = 0;
@@ -544,10 +558,13 @@ int AlignCommand::driver(linePair* filePos, string alignFName, string reportFNam
 		Alignment* alignment;
 		int longestBase = templateDB->getLongestBase();
         if (m->debug) { m->mothurOut("[DEBUG]: template longest base = "  + toString(templateDB->getLongestBase()) + " \n"); }
-		if(align == "gotoh")			{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);			}
-		else if(align == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);				}
-		else if(align == "blast")		{	alignment = new BlastAlignment(gapOpen, gapExtend, match, misMatch);		}
-		else if(align == "noalign")		{	alignment = new NoAlign();													}
+		string method = FastAlignment::getMethod(align, longestBase, match, misMatch, gapOpen, gapExtend);
+		if(method == "gotoh")			{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);			}
+		else if(method == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);				}
+		else if(method == "fastgotoh")		{	alignment = new FastGotoh(gapOpen, gapExtend, match, misMatch, longestBase, band);			}
+		else if(method == "fastneedleman")	{	alignment = new FastNeedleman(gapOpen, match, misMatch, longestBase, band);				}
+		else if(method == "blast")		{	alignment = new BlastAlignment(gapOpen, gapExtend, match, misMatch);		}
+		else if(method == "noalign")		{	alignment = new NoAlign();													}
 		else {
 			m->mothurOut(align + " is not a valid alignment option. I will run the command using needleman.");
 			m->mothurOutEndLine();
@@ -562,7 +579,6 @@ int AlignCommand::driver(linePair* filePos, string alignFName, string reportFNam
 			report.setCandidate(candidateSeq);
 
 			int origNumBases = candidateSeq->getNumBases();
-			string originalUnaligned = candidateSeq->getUnaligned();
 			int numBasesNeeded = origNumBases * threshold;
 	
 			if (candidateSeq->getName() != "") { //incase there is a commented sequence at the end of a file
@@ -570,63 +586,25 @@ int AlignCommand::driver(linePair* filePos, string alignFName, string reportFNam
                     if (m->debug) { m->mothurOut("[DEBUG]: " + candidateSeq->getName() + " " + toString(candidateSeq->getUnaligned().length()) + " " + toString(alignment->getnRows()) + " \n"); }
 					alignment->resize(candidateSeq->getUnaligned().length()+2);
 				}
-				Sequence temp = templateDB->findClosestSequence(candidateSeq);
-				Sequence* templateSeq = new Sequence(temp.getName(), temp.getAligned());
+				//with flip the search picks the orientation, so each read is only aligned once
+				bool reversed = false;
+				Sequence temp;
+				if (flip)	{	temp = templateDB->findClosestOrientation(candidateSeq, reversed);	}
+				else		{	temp = templateDB->findClosestSequence(candidateSeq);				}
+				Sequence* templateSeq = &temp;	//temp is already a copy of the template, so nast can set its pairwise alignment
 				
 				float searchScore = templateDB->getSearchScore();
+				
+				if (m->debug && reversed) { m->mothurOut("[DEBUG]: flipping "  + candidateSeq->getName() + " \n"); }
 								
 				Nast* nast = new Nast(alignment, candidateSeq, templateSeq);
-		
-				Sequence* copy;
 				
-				Nast* nast2;
-				bool needToDeleteCopy = false;  //this is needed in case you have you enter the ifs below
-												//since nast does not make a copy of hte sequence passed, and it is used by the reporter below
-												//you can't delete the copy sequence til after you report, but you may choose not to create it in the first place
-												//so this bool tells you if you need to delete it
-												
-				//if there is a possibility that this sequence should be reversed
-				if (candidateSeq->getNumBases() < numBasesNeeded) {
+				//if the sequence was reversed or too many bases were lost
+				if (reversed || (candidateSeq->getNumBases() < numBasesNeeded)) {
 					
 					string wasBetter =  "";
-					//if the user wants you to try the reverse
-					if (flip) {
-				
-						//get reverse compliment
-						copy = new Sequence(candidateSeq->getName(), originalUnaligned);
-						copy->reverseComplement();
-                        
-                        if (m->debug) { m->mothurOut("[DEBUG]: flipping "  + candidateSeq->getName() + " \n"); }
-						
-						//rerun alignment
-						Sequence temp2 = templateDB->findClosestSequence(copy);
-						Sequence* templateSeq2 = new Sequence(temp2.getName(), temp2.getAligned());
-                        
-                        if (m->debug) { m->mothurOut("[DEBUG]: closest template "  + temp2.getName() + " \n"); }
-						
-						searchScore = templateDB->getSearchScore();
-						
-						nast2 = new Nast(alignment, copy, templateSeq2);
-                        
-                        if (m->debug) { m->mothurOut("[DEBUG]: completed Nast2 "  + candidateSeq->getName() + " flipped numBases = " + toString(copy->getNumBases()) + " old numbases = " + toString(candidateSeq->getNumBases()) +" \n"); }
-			
-						//check if any better
-						if (copy->getNumBases() > candidateSeq->getNumBases()) {
-							candidateSeq->setAligned(copy->getAligned());  //use reverse compliments alignment since its better
-                            delete templateSeq;
-							templateSeq = templateSeq2;
-							delete nast;
-							nast = nast2;
-							needToDeleteCopy = true;
-							wasBetter = "\treverse complement produced a better alignment, so mothur used the reverse complement.";
-						}else{  
-							wasBetter = "\treverse complement did NOT produce a better alignment so it was not used, please check sequence.";
-							delete nast2;
-                            delete templateSeq2;
-							delete copy;	
-						}
-                        if (m->debug) { m->mothurOut("[DEBUG]: done.\n"); }
-					}
+					if (reversed)	{	wasBetter = "\treverse complement matched the template better, so mothur used the reverse complement.";	}
+					else if (flip)	{	wasBetter = "\treverse complement did NOT match the template better so it was not used, please check sequence.";	}
 					
 					//create accnos file with names
 					accnosFile << candidateSeq->getName() << wasBetter << endl;
@@ -641,16 +619,13 @@ int AlignCommand::driver(linePair* filePos, string alignFName, string reportFNam
 				
 				report.print();
 				delete nast;
-                delete templateSeq;
-				if (needToDeleteCopy) {   delete copy;   }
 				
 				count++;
 			}
 			delete candidateSeq;
 			
 			#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				unsigned long long pos = inFASTA.tellg();
-				if ((pos == -1) || (pos >= filePos->end)) { break; }
+				if (m->endOfPart(inFASTA, filePos->end)) { break; }
 			#else
 				if (inFASTA.eof()) { break; }
 			#endif
@@ -702,10 +677,13 @@ int AlignCommand::driverMPI(int start, int num, MPI_File& inMPI, MPI_File& align
 		
 		Alignment* alignment;
 		int longestBase = templateDB->getLongestBase();
-		if(align == "gotoh")			{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);			}
-		else if(align == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);				}
-		else if(align == "blast")		{	alignment = new BlastAlignment(gapOpen, gapExtend, match, misMatch);		}
-		else if(align == "noalign")		{	alignment = new NoAlign();													}
+		string method = FastAlignment::getMethod(align, longestBase, match, misMatch, gapOpen, gapExtend);
+		if(method == "gotoh")			{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);			}
+		else if(method == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);				}
+		else if(method == "fastgotoh")		{	alignment = new FastGotoh(gapOpen, gapExtend, match, misMatch, longestBase, band);			}
+		else if(method == "fastneedleman")	{	alignment = new FastNeedleman(gapOpen, match, misMatch, longestBase, band);				}
+		else if(method == "blast")		{	alignment = new BlastAlignment(gapOpen, gapExtend, match, misMatch);		}
+		else if(method == "noalign")		{	alignment = new NoAlign();													}
 		else {
 			m->mothurOut(align + " is not a valid alignment option. I will run the command using needleman.");
 			m->mothurOutEndLine();
@@ -737,7 +715,6 @@ int AlignCommand::driverMPI(int start, int num, MPI_File& inMPI, MPI_File& align
 			report.setCandidate(candidateSeq);
 
 			int origNumBases = candidateSeq->getNumBases();
-			string originalUnaligned = candidateSeq->getUnaligned();
 			int numBasesNeeded = origNumBases * threshold;
 	
 			if (candidateSeq->getName() != "") { //incase there is a commented sequence at the end of a file
@@ -745,54 +722,23 @@ int AlignCommand::driverMPI(int start, int num, MPI_File& inMPI, MPI_File& align
 					alignment->resize(candidateSeq->getUnaligned().length()+1);
 				}
 								
-				Sequence temp = templateDB->findClosestSequence(candidateSeq);
-				Sequence* templateSeq = new Sequence(temp.getName(), temp.getAligned());
+				//with flip the search picks the orientation, so each read is only aligned once
+				bool reversed = false;
+				Sequence temp;
+				if (flip)	{	temp = templateDB->findClosestOrientation(candidateSeq, reversed);	}
+				else		{	temp = templateDB->findClosestSequence(candidateSeq);				}
+				Sequence* templateSeq = &temp;	//temp is already a copy of the template, so nast can set its pairwise alignment
 				
 				float searchScore = templateDB->getSearchScore();
 								
 				Nast* nast = new Nast(alignment, candidateSeq, templateSeq);
-				Sequence* copy;
-				
-				Nast* nast2;
-				bool needToDeleteCopy = false;  //this is needed in case you have you enter the ifs below
-												//since nast does not make a copy of hte sequence passed, and it is used by the reporter below
-												//you can't delete the copy sequence til after you report, but you may choose not to create it in the first place
-												//so this bool tells you if you need to delete it
 												
-				//if there is a possibility that this sequence should be reversed
-				if (candidateSeq->getNumBases() < numBasesNeeded) {
+				//if the sequence was reversed or too many bases were lost
+				if (reversed || (candidateSeq->getNumBases() < numBasesNeeded)) {
 					
 					string wasBetter = "";
-					//if the user wants you to try the reverse
-					if (flip) {
-						//get reverse compliment
-						copy = new Sequence(candidateSeq->getName(), originalUnaligned);
-						copy->reverseComplement();
-						
-						//rerun alignment
-						Sequence temp2 = templateDB->findClosestSequence(copy);
-						Sequence* templateSeq2 = new Sequence(temp2.getName(), temp2.getAligned());
-						
-						searchScore = templateDB->getSearchScore();
-						
-						nast2 = new Nast(alignment, copy, templateSeq2);
-			
-						//check if any better
-						if (copy->getNumBases() > candidateSeq->getNumBases()) {
-							candidateSeq->setAligned(copy->getAligned());  //use reverse compliments alignment since its better
-							delete templateSeq;
-							templateSeq = templateSeq2;
-							delete nast;
-							nast = nast2;
-							needToDeleteCopy = true;
-							wasBetter = "\treverse complement produced a better alignment, so mothur used the reverse complement.";
-						}else{  
-							wasBetter = "\treverse complement did NOT produce a better alignment, please check sequence.";
-							delete nast2;
-                            delete templateSeq2;
-							delete copy;	
-						}
-					}
+					if (reversed)	{	wasBetter = "\treverse complement matched the template better, so mothur used the reverse complement.";	}
+					else if (flip)	{	wasBetter = "\treverse complement did NOT match the template better, please check sequence.";	}
 					
 					//create accnos file with names
 					outputString = candidateSeq->getName() + wasBetter + "\n";
@@ -835,8 +781,6 @@ int AlignCommand::driverMPI(int start, int num, MPI_File& inMPI, MPI_File& align
 				
 				delete buf3;
 				delete nast;
-                delete templateSeq;
-				if (needToDeleteCopy) {   delete copy;   }
 			}
 			delete candidateSeq;
 			
@@ -990,7 +934,7 @@ int AlignCommand::createProcesses(string alignFileName, string reportFileName, s
 			string extension = "";
 			if (i != 0) { extension = toString(i) + ".temp"; }
 			
-			alignData* tempalign = new alignData(templateFileName, (alignFileName + extension), (reportFileName + extension), (accnosFName + extension), filename, align, search, kmerSize, m, lines[i]->start, lines[i]->end, flip, match, misMatch, gapOpen, gapExtend, threshold, i);
+			alignData* tempalign = new alignData(templateFileName, (alignFileName + extension), (reportFileName + extension), (accnosFName + extension), filename, align, search, kmerSize, m, lines[i]->start, lines[i]->end, flip, match, misMatch, gapOpen, gapExtend, threshold, i, band);
 			pDataArray.push_back(tempalign);
 			processIDS.push_back(i);
 				
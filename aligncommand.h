@@ -17,6 +17,8 @@
 
 #include "gotohoverlap.hpp"
 #include "needlemanoverlap.hpp"
+#include "fastgotoh.hpp"
+#include "fastneedleman.hpp"
 #include "blastalign.hpp"
 #include "noalign.hpp"
 
@@ -65,7 +67,7 @@ private:
 	
 	string candidateFileName, templateFileName, distanceFileName, search, align, outputDir;
 	float match, misMatch, gapOpen, gapExtend, threshold;
-	int processors, kmerSize;
+	int processors, kmerSize, band;
 	vector<string> candidateFileNames;
 	vector<string> outputNames;
 	
@@ -91,10 +93,10 @@ struct alignData {
 	MothurOut* m;
 	//AlignmentDB* templateDB;
 	float match, misMatch, gapOpen, gapExtend, threshold;
-	int count, kmerSize, threadID;
+	int count, kmerSize, threadID, band;
 	
 	alignData(){}
-	alignData(string te, string a, string r, string ac, string f, string al, string se, int ks, MothurOut* mout, unsigned long long st, unsigned long long en, bool fl, float ma, float misMa, float gapO, float gapE, float thr, int tid) {
+	alignData(string te, string a, string r, string ac, string f, string al, string se, int ks, MothurOut* mout, unsigned long long st, unsigned long long en, bool fl, float ma, float misMa, float gapO, float gapE, float thr, int tid, int ba) {
 		templateFileName = te;
 		alignFName = a;
 		reportFName = r;
@@ -115,6 +117,7 @@ struct alignData {
 		count = 0;
 		kmerSize = ks;
 		threadID = tid;
+		band = ba;
 	}
 };
 
@@ -149,10 +152,13 @@ static DWORD WINAPI MyAlignThreadFunction(LPVOID lpParam){
 		//moved this into driver to avoid deep copies in windows paralellized version
 		Alignment* alignment;
 		int longestBase = templateDB->getLongestBase();
-		if(pDataArray->align == "gotoh")			{	alignment = new GotohOverlap(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch, longestBase);			}
-		else if(pDataArray->align == "needleman")	{	alignment = new NeedlemanOverlap(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, longestBase);				}
-		else if(pDataArray->align == "blast")		{	alignment = new BlastAlignment(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch);		}
-		else if(pDataArray->align == "noalign")		{	alignment = new NoAlign();													}
+		string method = FastAlignment::getMethod(pDataArray->align, longestBase, pDataArray->match, pDataArray->misMatch, pDataArray->gapOpen, pDataArray->gapExtend);
+		if(method == "gotoh")			{	alignment = new GotohOverlap(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch, longestBase);			}
+		else if(method == "needleman")	{	alignment = new NeedlemanOverlap(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, longestBase);				}
+		else if(method == "fastgotoh")		{	alignment = new FastGotoh(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch, longestBase, pDataArray->band);			}
+		else if(method == "fastneedleman")	{	alignment = new FastNeedleman(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, longestBase, pDataArray->band);				}
+		else if(method == "blast")		{	alignment = new BlastAlignment(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch);		}
+		else if(method == "noalign")		{	alignment = new NoAlign();													}
 		else {
 			pDataArray->m->mothurOut(pDataArray->align + " is not a valid alignment option. I will run the command using needleman.");
 			pDataArray->m->mothurOutEndLine();
@@ -168,7 +174,6 @@ static DWORD WINAPI MyAlignThreadFunction(LPVOID lpParam){
 			report.setCandidate(candidateSeq);
 			
 			int origNumBases = candidateSeq->getNumBases();
-			string originalUnaligned = candidateSeq->getUnaligned();
 			int numBasesNeeded = origNumBases * pDataArray->threshold;
 			
 			if (candidateSeq->getName() != "") { //incase there is a commented sequence at the end of a file
@@ -176,56 +181,23 @@ static DWORD WINAPI MyAlignThreadFunction(LPVOID lpParam){
 					alignment->resize(candidateSeq->getUnaligned().length()+1);
 				}
 				
-				Sequence temp = templateDB->findClosestSequence(candidateSeq);
-				Sequence* templateSeq = new Sequence(temp.getName(), temp.getAligned());
+				//with flip the search picks the orientation, so each read is only aligned once
+				bool reversed = false;
+				Sequence temp;
+				if (pDataArray->flip)	{	temp = templateDB->findClosestOrientation(candidateSeq, reversed);	}
+				else					{	temp = templateDB->findClosestSequence(candidateSeq);				}
+				Sequence* templateSeq = &temp;	//temp is already a copy of the template, so nast can set its pairwise alignment
 				
 				float searchScore = templateDB->getSearchScore();
 				
 				Nast* nast = new Nast(alignment, candidateSeq, templateSeq);
 				
-				Sequence* copy;
-				
-				Nast* nast2;
-				bool needToDeleteCopy = false;  //this is needed in case you have you enter the ifs below
-				//since nast does not make a copy of hte sequence passed, and it is used by the reporter below
-				//you can't delete the copy sequence til after you report, but you may choose not to create it in the first place
-				//so this bool tells you if you need to delete it
-				
-				//if there is a possibility that this sequence should be reversed
-				if (candidateSeq->getNumBases() < numBasesNeeded) {
+				//if the sequence was reversed or too many bases were lost
+				if (reversed || (candidateSeq->getNumBases() < numBasesNeeded)) {
 					
 					string wasBetter =  "";
-					//if the user wants you to try the reverse
-					if (pDataArray->flip) {
-						
-						//get reverse compliment
-						copy = new Sequence(candidateSeq->getName(), originalUnaligned);
-						copy->reverseComplement();
-						
-						//rerun alignment
-						Sequence temp2 = templateDB->findClosestSequence(copy);
-						Sequence* templateSeq2 = new Sequence(temp2.getName(), temp2.getAligned());
-						
-						searchScore = templateDB->getSearchScore();
-						
-						nast2 = new Nast(alignment, copy, templateSeq2);
-						
-						//check if any better
-						if (copy->getNumBases() > candidateSeq->getNumBases()) {
-							candidateSeq->setAligned(copy->getAligned());  //use reverse compliments alignment since its better
-							delete templateSeq;
-							templateSeq = templateSeq2;
-							delete nast;
-							nast = nast2;
-							needToDeleteCopy = true;
-							wasBetter = "\treverse complement produced a better alignment, so mothur used the reverse complement.";
-						}else{  
-							wasBetter = "\treverse complement did NOT produce a better alignment so it was not used, please check sequence.";
-							delete nast2;
-                            delete templateSeq2;
-							delete copy;	
-						}
-					}
+					if (reversed)				{	wasBetter = "\treverse complement matched the template better, so mothur used the reverse complement.";	}
+					else if (pDataArray->flip)	{	wasBetter = "\treverse complement did NOT match the template better so it was not used, please check sequence.";	}
 					
 					//create accnos file with names
 					accnosFile << candidateSeq->getName() << wasBetter << endl;
@@ -240,8 +212,6 @@ static DWORD WINAPI MyAlignThreadFunction(LPVOID lpParam){
 				
 				report.print();
 				delete nast;
-                delete templateSeq;
-				if (needToDeleteCopy) {   delete copy;   }
 				
 				pDataArray->count++;
 			}
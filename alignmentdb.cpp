@@ -11,6 +11,7 @@
 #include "kmerdb.hpp"
 #include "suffixdb.hpp"
 #include "blastdb.hpp"
+#include "minimizerdb.hpp"
 #include "referencedb.h"
 
 /**************************************************************************************************/
@@ -23,6 +24,7 @@ AlignmentDB::AlignmentDB(string fastaFileName, string s, int kmerSize, float gap
 		ReferenceDB* rdb = ReferenceDB::getInstance();
 		bool silent = false;
 		threadID = tid;
+		cache = NULL;
 		
 		if (fastaFileName == "saved-silent") {
 			fastaFileName = "saved"; silent = true;
@@ -115,36 +117,49 @@ AlignmentDB::AlignmentDB(string fastaFileName, string s, int kmerSize, float gap
 				MPI_File_close(&inMPI);
 			
 		#else
-			ifstream fastaFile;
-			m->openInputFile(fastaFileName, fastaFile);
+			//the templates are mapped from the cache file if a run has already read this fasta file
+			cache = new TemplateCache(fastaFileName);
+			if (cache->read()) {
+				if (cache->getNumSeqs() != 0) { longest = cache->getLongestBase()+1; }
+				if ((cache->getNumSeqs() != 0) && (cache->getAlignedLength() == 0)) { m->mothurOut("[ERROR]: template is not aligned, aborting.\n"); m->control_pressed=true; }
+				if (rdb->save) { for (int i = 0; i < cache->getNumSeqs(); i++) { rdb->referenceSeqs.push_back(cache->getSequence(i)); } }
+			}else {
+				delete cache; cache = NULL;
+			
+				ifstream fastaFile;
+				m->openInputFile(fastaFileName, fastaFile);
 
-			while (!fastaFile.eof()) {
-				Sequence temp(fastaFile);  m->gobble(fastaFile);
+				while (!fastaFile.eof()) {
+					Sequence temp(fastaFile);  m->gobble(fastaFile);
 				
-				if (m->control_pressed) {  templateSequences.clear(); break;  }
+					if (m->control_pressed) {  templateSequences.clear(); break;  }
 				
-				if (temp.getName() != "") {
-					templateSequences.push_back(temp);
+					if (temp.getName() != "") {
+						templateSequences.push_back(temp);
 					
-					if (rdb->save) { rdb->referenceSeqs.push_back(temp); }
+						if (rdb->save) { rdb->referenceSeqs.push_back(temp); }
 					
-					//save longest base
-					if (temp.getUnaligned().length() >= longest)  { longest = (temp.getUnaligned().length()+1); }
+						//save longest base
+						if (temp.getUnaligned().length() >= longest)  { longest = (temp.getUnaligned().length()+1); }
                     
-                    if (tempLength != 0) {
-                        if (tempLength != temp.getAligned().length()) { m->mothurOut("[ERROR]: template is not aligned, aborting.\n"); m->control_pressed=true; }
-                    }else { tempLength = temp.getAligned().length(); }
+                        if (tempLength != 0) {
+                            if (tempLength != temp.getAligned().length()) { m->mothurOut("[ERROR]: template is not aligned, aborting.\n"); m->control_pressed=true; }
+                        }else { tempLength = temp.getAligned().length(); }
+					}
 				}
+				fastaFile.close();
+			
+				if (!m->control_pressed && (templateSequences.size() != 0)) { TemplateCache newCache(fastaFileName); newCache.write(templateSequences); }
 			}
-			fastaFile.close();
 		#endif
 		
 			numSeqs = templateSequences.size();
+			if (cache != NULL) { numSeqs = cache->getNumSeqs(); }
 			//all of this is elsewhere already!
 			
 			m->mothurOut("DONE.");
 			m->mothurOutEndLine();	cout.flush();
-			m->mothurOut("It took " + toString(time(NULL) - start) + " to read  " + toString(templateSequences.size()) + " sequences."); m->mothurOutEndLine();  
+			m->mothurOut("It took " + toString(time(NULL) - start) + " to read  " + toString(numSeqs) + " sequences."); m->mothurOutEndLine();  
 
 		}
 		
@@ -173,6 +188,7 @@ AlignmentDB::AlignmentDB(string fastaFileName, string s, int kmerSize, float gap
 		}
 		else if(method == "suffix")		{	search = new SuffixDB(numSeqs);								}
 		else if(method == "blast")		{	search = new BlastDB(fastaFileName.substr(0,fastaFileName.find_last_of(".")+1), gapOpen, gapExtend, match, misMatch, "", threadID);	}
+		else if(method == "minimizer")	{	search = new MinimizerDB(kmerSize);							}
 		else {
 			method = "kmer";
 			m->mothurOut(method + " is not a valid search option. I will run the command using kmer, ksize=8.");
@@ -183,8 +199,9 @@ AlignmentDB::AlignmentDB(string fastaFileName, string s, int kmerSize, float gap
 		if (!(m->control_pressed)) {
 			if (needToGenerate) {
 				//add sequences to search 
-				for (int i = 0; i < templateSequences.size(); i++) {
-					search->addSequence(templateSequences[i]);
+				for (int i = 0; i < numSeqs; i++) {
+					Sequence temp = getTemplate(i);
+					search->addSequence(temp);
 					
 					if (m->control_pressed) {  templateSequences.clear(); break;  }
 				}
@@ -212,6 +229,7 @@ AlignmentDB::AlignmentDB(string s){
 	try {											
 		m = MothurOut::getInstance();
 		method = s;
+		cache = NULL;
 		
 		if(method == "suffix")		{	search = new SuffixDB();	}
 		else if(method == "blast")	{	search = new BlastDB("", 0);		}
@@ -231,14 +249,25 @@ AlignmentDB::AlignmentDB(string s){
 	}
 }
 /**************************************************************************************************/
-AlignmentDB::~AlignmentDB() {  delete search;	}
+AlignmentDB::~AlignmentDB() {  delete search; delete cache;	}
+/**************************************************************************************************/
+Sequence AlignmentDB::getTemplate(int i) {
+	try{
+		if (cache != NULL)	{	return cache->getSequence(i);	}
+		else				{	return templateSequences[i];	}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "AlignmentDB", "getTemplate");
+		exit(1);
+	}
+}
 /**************************************************************************************************/
 Sequence AlignmentDB::findClosestSequence(Sequence* seq) {
 	try{
 	
 		vector<int> spot = search->findClosestSequences(seq, 1);
 	
-		if (spot.size() != 0)	{		return templateSequences[spot[0]];	}
+		if (spot.size() != 0)	{		return getTemplate(spot[0]);	}
 		else					{		return emptySequence;				}
 		
 	}
@@ -248,6 +277,21 @@ Sequence AlignmentDB::findClosestSequence(Sequence* seq) {
 	}
 }
 /**************************************************************************************************/
+//searches both strands in one pass and reverse complements seq if its reverse complement is closer
+Sequence AlignmentDB::findClosestOrientation(Sequence* seq, bool& reversed) {
+	try{
+		vector<int> spot = search->findClosestBothStrands(seq, 1, reversed);
+		if (reversed) { seq->reverseComplement(); }
+		
+		if (spot.size() != 0)	{		return getTemplate(spot[0]);	}
+		else					{		return emptySequence;				}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "AlignmentDB", "findClosestOrientation");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
 
 
 
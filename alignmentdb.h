@@ -13,6 +13,7 @@
 #include "mothur.h"
 #include "sequence.hpp"
 #include "database.hpp"
+#include "templatecache.h"
 
 /**************************************************************************************************/
 
@@ -25,6 +26,7 @@ public:
 	~AlignmentDB();
 	
 	Sequence findClosestSequence(Sequence*);
+	Sequence findClosestOrientation(Sequence*, bool&);	//reverse complements the sequence if that is closer to the templates
 	float getSearchScore()  {  return search->getSearchScore();  }
 	int getLongestBase()	{  return longest;  }
 	
@@ -34,6 +36,9 @@ private:
 	
 	Database* search;
 	vector<Sequence> templateSequences;
+	TemplateCache* cache;			//used instead of templateSequences when the templates were read from a cache file
+	
+	Sequence getTemplate(int);
 	Sequence emptySequence;
 	MothurOut* m;
 };
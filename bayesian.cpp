@@ -5,12 +5,38 @@
  *  Created by westcott on 11/3/09.
  *  Copyright 2009 Schloss Lab. All rights reserved.
  *
+ *  If mothur is compiled with AVX2 enabled (-mavx2 or -march=native) the genus scores are summed 8 genera at a time,
+ *  otherwise the compiler is left to vectorize the plain loop.
+ *
  */
 
+#ifdef __AVX2__
+	#include <immintrin.h>
+#endif
+
 #include "bayesian.h"
 #include "kmer.hpp"
 #include "phylosummary.h"
 #include "referencedb.h"
+#include "templatecache.h"
+
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+	#include <sys/mman.h>
+	#include <fcntl.h>
+#endif
+
+static const char bayesianModelMagic[8] = { 'M', 'T', 'H', 'R', 'W', 'A', 'N', 'G' };
+static const unsigned int bayesianModelVersion = 2;
+
+/**************************************************************************************************/
+//splitmix64, small enough to keep one per thread and each seed gives an unrelated stream
+static inline unsigned long long nextRandom(unsigned long long& state) {
+	unsigned long long z = (state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
 /**************************************************************************************************/
 Bayesian::Bayesian(string tfile, string tempFile, string method, int ksize, int cutoff, int i, int tid, bool f, bool sh) : 
 Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
@@ -34,10 +60,13 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 		string phyloTreeSumName = tfileroot + "tree.sum";
 		string probFileName = tfileroot + tempfileroot + char('0'+ kmerSize) + "mer.prob";
 		string probFileName2 = tfileroot + tempfileroot + char('0'+ kmerSize) + "mer.numNonZero";
+		string modelFileName = tfileroot + tempfileroot + char('0'+ kmerSize) + "mer.model";
 		
-		ofstream out;
-		ofstream out2;
+		probTable = NULL;
+		mappedModel = NULL;
+		mappedModelSize = 0;
 		
+		ifstream modelFileTest(modelFileName.c_str());
 		ifstream phyloTreeTest(phyloTreeName.c_str());
 		ifstream probFileTest2(probFileName2.c_str());
 		ifstream probFileTest(probFileName.c_str());
@@ -45,45 +74,68 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 		
 		int start = time(NULL);
 		
+		//if there is a model file make sure it was trained from these files, otherwise it is remade
+		bool modelGood = false;
+		if (modelFileTest && probFileTest3) {
+			modelFileTest.close();
+			modelGood = readModelFile(modelFileName, baseName, baseTName);
+		}
+		
 		//if they are there make sure they were created after this release date
 		bool FilesGood = false;
-		if(probFileTest && probFileTest2 && phyloTreeTest && probFileTest3){
+		if(!modelFileTest && probFileTest && probFileTest2 && phyloTreeTest && probFileTest3){
 			FilesGood = checkReleaseDate(probFileTest, probFileTest2, phyloTreeTest, probFileTest3);
 		}
 		
 		//if you want to save, but you dont need to calculate then just read
-		if (rdb->save && probFileTest && probFileTest2 && phyloTreeTest && probFileTest3 && FilesGood && (tempFile != "saved")) {  
-			ifstream saveIn;
-			m->openInputFile(tempFile, saveIn);
-			
-			while (!saveIn.eof()) {
-				Sequence temp(saveIn);
-				m->gobble(saveIn);
+		if (rdb->save && (modelGood || FilesGood) && (tempFile != "saved")) {  
+			TemplateCache cache(tempFile);
+			if (cache.read()) {
+				for (int i = 0; i < cache.getNumSeqs(); i++) { rdb->referenceSeqs.push_back(cache.getSequence(i)); }
+			}else {
+				ifstream saveIn;
+				m->openInputFile(tempFile, saveIn);
 				
-				rdb->referenceSeqs.push_back(temp); 
+				while (!saveIn.eof()) {
+					Sequence temp(saveIn);
+					m->gobble(saveIn);
+					
+					rdb->referenceSeqs.push_back(temp); 
+				}
+				saveIn.close();
 			}
-			saveIn.close();			
 		}
 
-		if(probFileTest && probFileTest2 && phyloTreeTest && probFileTest3 && FilesGood){	
+		if(modelGood || FilesGood){	
 			if (tempFile == "saved") { m->mothurOutEndLine();  m->mothurOut("Using sequences from " + rdb->getSavedReference() + " that are saved in memory.");	m->mothurOutEndLine(); }
 			
 			m->mothurOut("Reading template taxonomy...     "); cout.flush();
 			
-			phyloTree = new PhyloTree(phyloTreeTest, phyloTreeName);
+			if (!modelGood) { phyloTree = new PhyloTree(phyloTreeTest, phyloTreeName); } //the model file holds the tree
 			
 			m->mothurOut("DONE."); m->mothurOutEndLine();
 			
 			genusNodes = phyloTree->getGenusNodes(); 
 			genusTotals = phyloTree->getGenusTotals();
+			setGenusStride();
 			
 			if (tfile == "saved") { 
 				m->mothurOutEndLine();  m->mothurOut("Using probabilties from " + rdb->getSavedTaxonomy() + " that are saved in memory...    ");	cout.flush();; 
 				wordGenusProb = rdb->wordGenusProb;
 				WordPairDiffArr = rdb->WordPairDiffArr;
+				probTable = &wordGenusProb[0];
+			}else if (modelGood) {
+				m->mothurOut("Reading template probabilities...     "); cout.flush();
+				
+				//the mapped probabilities are shared, unless they need to be kept after this command
+				if (rdb->save) { 
+					wordGenusProb.assign(probTable, probTable + (unsigned long long)numKmers * genusStride);
+					probTable = &wordGenusProb[0];
+				}
 			}else {
 				m->mothurOut("Reading template probabilities...     "); cout.flush();
 				readProbFile(probFileTest, probFileTest2, probFileName, probFileName2);
+				probTable = &wordGenusProb[0];
 			}	
 			
 			//save probabilities
@@ -94,14 +146,16 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 			generateDatabaseAndNames(tfile, tempFile, method, ksize, 0.0, 0.0, 0.0, 0.0);
 			
 			//prevents errors caused by creating shortcut files if you had an error in the sanity check.
-			if (m->control_pressed) {  m->mothurRemove(phyloTreeName);  m->mothurRemove(probFileName); m->mothurRemove(probFileName2); }
+			if (m->control_pressed) {  m->mothurRemove(modelFileName); }
 			else{ 
 				genusNodes = phyloTree->getGenusNodes(); 
 				genusTotals = phyloTree->getGenusTotals();
+				setGenusStride();
 				
 				m->mothurOut("Calculating template taxonomy tree...     "); cout.flush();
 				
-				phyloTree->printTreeNodes(phyloTreeName);
+				vector<TaxNode> treeNodes;
+				phyloTree->getTreeNodes(treeNodes);
 							
 				m->mothurOut("DONE."); m->mothurOutEndLine();
 				
@@ -110,57 +164,16 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 				numKmers = database->getMaxKmer() + 1;
 			
 				//initialze probabilities
-				wordGenusProb.resize(numKmers);
+				wordGenusProb.resize((unsigned long long)numKmers * genusStride, 0.0);
 				WordPairDiffArr.resize(numKmers);
-			
-				for (int j = 0; j < wordGenusProb.size(); j++) {	wordGenusProb[j].resize(genusNodes.size());		}
-                ofstream out;
-				ofstream out2;
+				probTable = &wordGenusProb[0];
 				
-				#ifdef USE_MPI
-					int pid;
-					MPI_Comm_rank(MPI_COMM_WORLD, &pid); //find out who we are
-
-					if (pid == 0) {  
-				#endif
-
-				
-                if (shortcuts) { 
-                    m->openOutputFile(probFileName, out); 
-				
-                    //output mothur version
-                    out << "#" << m->getVersion() << endl;
-				
-                    out << numKmers << endl;
-				
-                    m->openOutputFile(probFileName2, out2);
-				
-                    //output mothur version
-                    out2 << "#" << m->getVersion() << endl;
-                }
-				
-				#ifdef USE_MPI
-					}
-				#endif
-
 				//for each word
 				for (int i = 0; i < numKmers; i++) {
                     //m->mothurOut("[DEBUG]: kmer = " + toString(i) + "\n");
                     
 					if (m->control_pressed) {  break; }
 					
-					#ifdef USE_MPI
-						MPI_Comm_rank(MPI_COMM_WORLD, &pid); //find out who we are
-
-						if (pid == 0) {  
-					#endif
-
-                    if (shortcuts) {  out << i << '\t'; }
-					
-					#ifdef USE_MPI
-						}
-					#endif
-					
 					vector<int> seqsWithWordi = database->getSequencesWithKmer(i);
 					
 					//for each sequence with that word
@@ -175,66 +188,28 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 					diffPair tempProb(log(probabilityInTemplate), 0.0);
 					WordPairDiffArr[i] = tempProb;
 						
-					int numNotZero = 0;
 					for (int k = 0; k < genusNodes.size(); k++) {
 						//probabilityInThisTaxonomy = (# of seqs with that word in this taxonomy + probabilityInTemplate) / (total number of seqs in this taxonomy + 1);
-						
-						
-						wordGenusProb[i][k] = log((count[k] + probabilityInTemplate) / (float) (genusTotals[k] + 1));  
-									
-						if (count[k] != 0) { 
-							#ifdef USE_MPI
-								int pid;
-								MPI_Comm_rank(MPI_COMM_WORLD, &pid); //find out who we are
-						
-								if (pid == 0) {  
-							#endif
-
-                            if (shortcuts) { out << k << '\t' << wordGenusProb[i][k] << '\t' ; }
-							
-							#ifdef USE_MPI
-								}
-							#endif
-
-							numNotZero++;  
-						}
+						getGenusProbs(i)[k] = log((count[k] + probabilityInTemplate) / (float) (genusTotals[k] + 1));  
 					}
-					
-					#ifdef USE_MPI
-						MPI_Comm_rank(MPI_COMM_WORLD, &pid); //find out who we are
-				
-						if (pid == 0) {  
-					#endif
-					
-                            if (shortcuts) { 
-                                out << endl;
-                                out2 << probabilityInTemplate << '\t' << numNotZero << '\t' << log(probabilityInTemplate) << endl;
-                            }
-					
-					#ifdef USE_MPI
-						}
-					#endif
 				}
 				
+				//make the training tree with less info. - its faster
+				delete phyloTree;
+				phyloTree = new PhyloTree(treeNodes, genusNodes, genusTotals);
+				
 				#ifdef USE_MPI
+					int pid;
 					MPI_Comm_rank(MPI_COMM_WORLD, &pid); //find out who we are
-				
+
 					if (pid == 0) {  
 				#endif
 				
-                        if (shortcuts) { 
-                            out.close();
-                            out2.close();
-                        }
+				if (shortcuts && !m->control_pressed) { writeModelFile(modelFileName, treeNodes, baseName, baseTName); }
+				
 				#ifdef USE_MPI
 					}
 				#endif
-				
-				//read in new phylotree with less info. - its faster
-				ifstream phyloTreeTest(phyloTreeName.c_str());
-				delete phyloTree;
-				
-				phyloTree = new PhyloTree(phyloTreeTest, phyloTreeName);
                 
 				//save probabilities
 				if (rdb->save) { rdb->wordGenusProb = wordGenusProb; rdb->WordPairDiffArr = WordPairDiffArr; }
@@ -261,6 +236,9 @@ Bayesian::~Bayesian() {
 	try {
         if (phyloTree != NULL) { delete phyloTree; }
         if (database != NULL) {  delete database; }
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+		if (mappedModel != NULL) { munmap(mappedModel, mappedModelSize); }
+#endif
 	}
 	catch(exception& e) {
 		m->errorOut(e, "Bayesian", "~Bayesian");
@@ -270,10 +248,28 @@ Bayesian::~Bayesian() {
 
 /**************************************************************************************************/
 string Bayesian::getTaxonomy(Sequence* seq) {
+	try {
+		string tax = getTaxonomy(seq, scratch, rand());
+		
+		simpleTax = scratch.simpleTax;
+		flipped = scratch.flipped;
+		if (scratch.messages != "") { m->mothurOut(scratch.messages); }
+		
+		return tax;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "getTaxonomy");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//only reads the classifier, so threads can classify at the same time as long as each has its own scratch
+string Bayesian::getTaxonomy(Sequence* seq, bayesianScratch& work, unsigned int seed) {
 	try {
 		string tax = "";
 		Kmer kmer(kmerSize);
-		flipped = false;
+		work.flipped = false;
+		work.messages = "";
 		
 		//get words contained in query
 		//getKmerString returns a string where the index in the string is hte kmer number 
@@ -290,7 +286,7 @@ string Bayesian::getTaxonomy(Sequence* seq) {
 		//if user wants to test reverse compliment and its reversed use that instead
 		if (flip) {	
 			if (isReversed(queryKmers)) { 
-				flipped = true;
+				work.flipped = true;
 				seq->reverseComplement(); 
 				queryKmerString = kmer.getKmerString(seq->getUnaligned()); 
 				queryKmers.clear();
@@ -302,21 +298,22 @@ string Bayesian::getTaxonomy(Sequence* seq) {
 			}  
 		}
 		
-		if (queryKmers.size() == 0) {  m->mothurOut(seq->getName() + " is bad. It has no kmers of length " + toString(kmerSize) + "."); m->mothurOutEndLine(); simpleTax = "unknown;";  return "unknown;"; }
+		if (queryKmers.size() == 0) {  work.messages = seq->getName() + " is bad. It has no kmers of length " + toString(kmerSize) + ".\n"; work.simpleTax = "unknown;";  return "unknown;"; }
 		
 		
-		int index = getMostProbableTaxonomy(queryKmers);
+		int index = getMostProbableTaxonomy(queryKmers, work);
 		
 		if (m->control_pressed) { return tax; }
 					
 		//bootstrap - to set confidenceScore
 		int numToSelect = queryKmers.size() / 8;
 	
-        if (m->debug) {  m->mothurOut(seq->getName() + "\t"); }
+        if (m->debug) {  work.messages += seq->getName() + "\t"; }
         
-		tax = bootstrapResults(queryKmers, index, numToSelect);
+		work.random = seed;
+		tax = bootstrapResults(queryKmers, index, numToSelect, work);
         
-        if (m->debug) {  m->mothurOut("\n"); }
+        if (m->debug) {  work.messages += "\n"; }
 		
 		return tax;	
 	}
@@ -326,7 +323,7 @@ string Bayesian::getTaxonomy(Sequence* seq) {
 	}
 }
 /**************************************************************************************************/
-string Bayesian::bootstrapResults(vector<int> kmers, int tax, int numToSelect) {
+string Bayesian::bootstrapResults(vector<int>& kmers, int tax, int numToSelect, bayesianScratch& work) {
 	try {
 				
 		map<int, int> confidenceScores; 
@@ -345,20 +342,21 @@ string Bayesian::bootstrapResults(vector<int> kmers, int tax, int numToSelect) {
 		map<int, int>::iterator itBoot;
 		map<int, int>::iterator itBoot2;
 		map<int, int>::iterator itConvert;
+		
+		//pick the words for every bootstrap up front, so they can be scored back to back
+		vector<int>& bootstrapKmers = work.bootstrapKmers;
+		bootstrapKmers.resize(iters * numToSelect);
+		for (int i = 0; i < bootstrapKmers.size(); i++) {
+			int index = int(nextRandom(work.random) % kmers.size());
+			bootstrapKmers[i] = kmers[index];
+		}
 			
 		for (int i = 0; i < iters; i++) {
 			if (m->control_pressed) { return "control"; }
 			
-			vector<int> temp;
-			for (int j = 0; j < numToSelect; j++) {
-				int index = int(rand() % kmers.size());
-				
-				//add word to temp
-				temp.push_back(kmers[index]);
-			}
-			
 			//get taxonomy
-			int newTax = getMostProbableTaxonomy(temp);
+			scoreGenera(bootstrapKmers, i * numToSelect, numToSelect, work.genusScores);
+			int newTax = findMostProbableGenus(work.genusScores);
 			//int newTax = 1;
 			TaxNode taxonomyTemp = phyloTree->get(newTax);
 			
@@ -377,6 +375,7 @@ string Bayesian::bootstrapResults(vector<int> kmers, int tax, int numToSelect) {
 		}
 		
 		string confidenceTax = "";
+		string& simpleTax = work.simpleTax;
 		simpleTax = "";
 		
 		int seqTaxIndex = tax;
@@ -392,7 +391,7 @@ string Bayesian::bootstrapResults(vector<int> kmers, int tax, int numToSelect) {
 					confidence = itBoot2->second;
 				}
 				
-                if (m->debug) { m->mothurOut(seqTax.name + "(" + toString(((confidence/(float)iters) * 100)) + ");"); }
+                if (m->debug) { work.messages += seqTax.name + "(" + toString(((confidence/(float)iters) * 100)) + ");"; }
             
 				if (((confidence/(float)iters) * 100) >= confidenceThreshold) {
 					confidenceTax = seqTax.name + "(" + toString(((confidence/(float)iters) * 100)) + ");" + confidenceTax;
@@ -414,39 +413,75 @@ string Bayesian::bootstrapResults(vector<int> kmers, int tax, int numToSelect) {
 	}
 }
 /**************************************************************************************************/
-int Bayesian::getMostProbableTaxonomy(vector<int> queryKmer) {
+int Bayesian::getMostProbableTaxonomy(vector<int>& queryKmer, bayesianScratch& work) {
+	try {
+		scoreGenera(queryKmer, 0, queryKmer.size(), work.genusScores);
+		return findMostProbableGenus(work.genusScores);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "getMostProbableTaxonomy");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//sums the probabilities of kmers[start] to kmers[start+num-1] for every genus into genusScores.
+//each kmer's row is added across all the genera at once, the kmers are added in order so the totals match a genus by genus sum.
+void Bayesian::scoreGenera(const vector<int>& kmers, int start, int num, vector<double>& genusScores) {
+	try {
+		genusScores.resize(genusStride);
+		double* scores = &genusScores[0];
+		for (int k = 0; k < genusStride; k++) { scores[k] = 0.0; }
+		
+		for (int i = start; i < start + num; i++) {
+			const float* probs = probTable + (unsigned long long)kmers[i] * genusStride;
+#ifdef __AVX2__
+			for (int k = 0; k < genusStride; k += 8) {
+				__m256 p = _mm256_loadu_ps(probs + k);
+				__m256d low = _mm256_add_pd(_mm256_loadu_pd(scores + k), _mm256_cvtps_pd(_mm256_castps256_ps128(p)));
+				__m256d high = _mm256_add_pd(_mm256_loadu_pd(scores + k + 4), _mm256_cvtps_pd(_mm256_extractf128_ps(p, 1)));
+				_mm256_storeu_pd(scores + k, low);
+				_mm256_storeu_pd(scores + k + 4, high);
+			}
+#else
+			for (int k = 0; k < genusStride; k++) { scores[k] += probs[k]; }
+#endif
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "scoreGenera");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//find taxonomy with highest probability in genusScores, the first genus wins ties
+int Bayesian::findMostProbableGenus(vector<double>& genusScores) {
 	try {
 		int indexofGenus = 0;
-		
 		double maxProbability = -1000000.0;
-		//find taxonomy with highest probability that this sequence is from it
-		
-		
-//		cout << genusNodes.size() << endl;
-		
 		
 		for (int k = 0; k < genusNodes.size(); k++) {
-			//for each taxonomy calc its probability
-			
-			double prob = 0.0000;
-			for (int i = 0; i < queryKmer.size(); i++) {
-				prob += wordGenusProb[queryKmer[i]][k];
-			}
-			
-//			cout << phyloTree->get(genusNodes[k]).name << '\t' << prob << endl;
-
 			//is this the taxonomy with the greatest probability?
-			if (prob > maxProbability) { 
+			if (genusScores[k] > maxProbability) { 
 				indexofGenus = genusNodes[k];
-				maxProbability = prob;
+				maxProbability = genusScores[k];
 			}
 		}
 		
-			
 		return indexofGenus;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "Bayesian", "getMostProbableTaxonomy");
+		m->errorOut(e, "Bayesian", "findMostProbableGenus");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//pads the rows of wordGenusProb out to a multiple of 8 genera, the padding is never read as a genus
+void Bayesian::setGenusStride() {
+	try {
+		genusStride = ((genusNodes.size() + 7) / 8) * 8;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "setGenusStride");
 		exit(1);
 	}
 }
@@ -586,9 +621,7 @@ void Bayesian::readProbFile(ifstream& in, ifstream& inNum, string inName, string
 			iss >> numKmers;  
 			
 			//initialze probabilities
-			wordGenusProb.resize(numKmers);
-			
-			for (int j = 0; j < wordGenusProb.size(); j++) {	wordGenusProb[j].resize(genusNodes.size());		}
+			wordGenusProb.assign((unsigned long long)numKmers * genusStride, 0.0);
 			
 			int kmer, name;  
 			vector<int> numbers; numbers.resize(numKmers);
@@ -641,13 +674,13 @@ void Bayesian::readProbFile(ifstream& in, ifstream& inNum, string inName, string
 				
 				//set them all to zero value
 				for (int i = 0; i < genusNodes.size(); i++) {
-					wordGenusProb[kmer][i] = log(zeroCountProb[kmer] / (float) (genusTotals[i]+1));
+					getGenusProbs(kmer)[i] = log(zeroCountProb[kmer] / (float) (genusTotals[i]+1));
 				}
 				
 				//get probs for nonzero values
 				for (int i = 0; i < numbers[kmer]; i++) {
 					iss >> name >> prob;
-					wordGenusProb[kmer][name] = prob;
+					getGenusProbs(kmer)[name] = prob;
 				}
 				
 			}
@@ -660,9 +693,7 @@ void Bayesian::readProbFile(ifstream& in, ifstream& inNum, string inName, string
 			in >> numKmers; m->gobble(in);
 			//cout << threadID << '\t' << line << '\t' << numKmers << &in << '\t' << &inNum << '\t' << genusNodes.size() << endl;
 			//initialze probabilities
-			wordGenusProb.resize(numKmers);
-			
-			for (int j = 0; j < wordGenusProb.size(); j++) {	wordGenusProb[j].resize(genusNodes.size());		}
+			wordGenusProb.assign((unsigned long long)numKmers * genusStride, 0.0);
 			
 			int kmer, name, count;  count = 0;
 			vector<int> num; num.resize(numKmers);
@@ -690,13 +721,13 @@ void Bayesian::readProbFile(ifstream& in, ifstream& inNum, string inName, string
 			//cout << threadID << '\t' << kmer << endl;
 				//set them all to zero value
 				for (int i = 0; i < genusNodes.size(); i++) {
-					wordGenusProb[kmer][i] = log(zeroCountProb[kmer] / (float) (genusTotals[i]+1));
+					getGenusProbs(kmer)[i] = log(zeroCountProb[kmer] / (float) (genusTotals[i]+1));
 				}
 			//cout << threadID << '\t' << num[kmer] << "here" << endl;	
 				//get probs for nonzero values
 				for (int i = 0; i < num[kmer]; i++) {
 					in >> name >> prob;
-					wordGenusProb[kmer][name] = prob;
+					getGenusProbs(kmer)[name] = prob;
 				}
 				
 				m->gobble(in);
@@ -711,6 +742,191 @@ void Bayesian::readProbFile(ifstream& in, ifstream& inNum, string inName, string
 	}
 }
 /**************************************************************************************************/
+//64 bit FNV-1a hash of the template and taxonomy files, ties a model file to the files it was trained from
+unsigned long long Bayesian::getTrainingChecksum(string templateFile, string taxonomyFile) {
+	try {
+		unsigned long long hash = 14695981039346656037ULL;
+		
+		vector<string> files; files.push_back(templateFile); files.push_back(taxonomyFile);
+		vector<char> block(1048576);
+		
+		for (int i = 0; i < files.size(); i++) {
+			ifstream in(files[i].c_str(), ios::binary);
+			while (in) {
+				in.read(&block[0], block.size());
+				int numRead = in.gcount();
+				for (int j = 0; j < numRead; j++) { hash = (hash ^ (unsigned char)block[j]) * 1099511628211ULL; }
+			}
+			hash = (hash ^ 0xff) * 1099511628211ULL; //so moving bytes between the files changes the hash
+		}
+		
+		return hash;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "getTrainingChecksum");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//fills in the sizes and modification times of the template and taxonomy files, zero if a file can't be found
+void Bayesian::getTrainingFileInfo(string templateFile, string taxonomyFile, bayesianModelHeader& header) {
+	try {
+		struct stat info;
+		header.templateSize = 0; header.templateTime = 0; header.taxonomySize = 0; header.taxonomyTime = 0;
+		if (stat(templateFile.c_str(), &info) != -1) { header.templateSize = info.st_size; header.templateTime = info.st_mtime; }
+		if (stat(taxonomyFile.c_str(), &info) != -1) { header.taxonomySize = info.st_size; header.taxonomyTime = info.st_mtime; }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "getTrainingFileInfo");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void Bayesian::writeModelFile(string modelFileName, vector<TaxNode>& treeNodes, string templateFile, string taxonomyFile) {
+	try {
+		ofstream out;
+		m->openOutputFileBinary(modelFileName, out);
+		
+		//output mothur version
+		out << "#" << m->getVersion() << endl;
+		
+		unsigned long long headerOffset = out.tellp();
+		while ((headerOffset % 8) != 0) { out.put(0); headerOffset++; }
+		
+		//tree nodes vary in length so they are packed into a buffer first
+		vector<char> tree;
+		for (int i = 0; i < treeNodes.size(); i++) {
+			int values[3] = { treeNodes[i].level, treeNodes[i].parent, (int)treeNodes[i].name.length() };
+			tree.insert(tree.end(), (char*)values, (char*)values + sizeof(values));
+			tree.insert(tree.end(), treeNodes[i].name.begin(), treeNodes[i].name.end());
+		}
+		while ((tree.size() % 8) != 0) { tree.push_back(0); }
+		
+		vector<float> wordPairs(numKmers);
+		for (int i = 0; i < numKmers; i++) { wordPairs[i] = WordPairDiffArr[i].prob; }
+		
+		bayesianModelHeader header;
+		memcpy(header.magic, bayesianModelMagic, 8);
+		header.version = bayesianModelVersion;
+		header.kmerSize = kmerSize;
+		header.checksum = getTrainingChecksum(templateFile, taxonomyFile);
+		getTrainingFileInfo(templateFile, taxonomyFile, header);
+		header.numKmers = numKmers;
+		header.numNodes = treeNodes.size();
+		header.numGenus = genusNodes.size();
+		header.genusStride = genusStride;
+		header.treeOffset = headerOffset + sizeof(bayesianModelHeader);
+		header.genusOffset = header.treeOffset + tree.size();
+		header.wordPairOffset = header.genusOffset + 2 * genusNodes.size() * sizeof(int);
+		header.probOffset = header.wordPairOffset + wordPairs.size() * sizeof(float);
+		
+		//start the probabilities on a cache line
+		unsigned long long padding = 0;
+		while (((header.probOffset + padding) % 64) != 0) { padding++; }
+		header.probOffset += padding;
+		
+		out.write((char*)&header, sizeof(bayesianModelHeader));
+		if (tree.size() != 0)			{ out.write(&tree[0], tree.size()); }
+		if (genusNodes.size() != 0)		{ out.write((char*)&genusNodes[0], genusNodes.size() * sizeof(int)); out.write((char*)&genusTotals[0], genusTotals.size() * sizeof(int)); }
+		if (wordPairs.size() != 0)		{ out.write((char*)&wordPairs[0], wordPairs.size() * sizeof(float)); }
+		for (int i = 0; i < padding; i++) { out.put(0); }
+		if (wordGenusProb.size() != 0)	{ out.write((char*)&wordGenusProb[0], wordGenusProb.size() * sizeof(float)); }
+		out.close();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "writeModelFile");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//returns false if the file is not a model for this kmer size trained from these files
+bool Bayesian::readModelFile(string modelFileName, string templateFile, string taxonomyFile) {
+	try {
+		ifstream in;
+		m->openInputFileBinary(modelFileName, in);
+		string line = m->getline(in); 
+		
+		unsigned long long headerOffset = line.length() + 1;
+		while ((headerOffset % 8) != 0) { headerOffset++; }
+		
+		bayesianModelHeader header;
+		in.seekg(headerOffset);
+		in.read((char*)&header, sizeof(bayesianModelHeader));
+		bool good = (in.gcount() == sizeof(bayesianModelHeader));
+		in.close();
+		
+		if (!good) { return false; }
+		if (memcmp(header.magic, bayesianModelMagic, 8) != 0) { return false; }
+		if ((header.version != bayesianModelVersion) || (header.kmerSize != kmerSize)) { return false; }
+		
+		//the files are only read for the checksum when they have been changed or touched since the model was written
+		bayesianModelHeader files;
+		getTrainingFileInfo(templateFile, taxonomyFile, files);
+		bool sameFiles = (header.templateSize == files.templateSize) && (header.templateTime == files.templateTime) && (header.taxonomySize == files.taxonomySize) && (header.taxonomyTime == files.taxonomyTime);
+		if (!sameFiles && (header.checksum != getTrainingChecksum(templateFile, taxonomyFile))) { return false; }
+		if (header.genusStride != ((header.numGenus + 7) / 8) * 8) { return false; }
+		
+		unsigned long long fileSize = header.probOffset + header.numKmers * header.genusStride * sizeof(float);
+		char* data = NULL;
+		
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+		int fd = open(modelFileName.c_str(), O_RDONLY);
+		if (fd == -1) { return false; }
+		struct stat info;
+		if (fstat(fd, &info) == -1) { ::close(fd); return false; }
+		if (info.st_size < fileSize) { ::close(fd); return false; }
+		void* mapped = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (mapped == MAP_FAILED) { return false; }
+		mappedModel = (char*)mapped;
+		mappedModelSize = info.st_size;
+		data = mappedModel;
+#else
+		m->openInputFileBinary(modelFileName, in);
+		in.seekg(0, ios::end);
+		unsigned long long size = in.tellg();
+		in.seekg(0, ios::beg);
+		if (size < fileSize) { in.close(); return false; }
+		modelBuffer.resize(size);
+		in.read(&modelBuffer[0], size);
+		in.close();
+		data = &modelBuffer[0];
+#endif
+		
+		vector<TaxNode> treeNodes(header.numNodes);
+		const char* p = data + header.treeOffset;
+		for (int i = 0; i < treeNodes.size(); i++) {
+			int values[3];
+			memcpy(values, p, sizeof(values)); p += sizeof(values);
+			treeNodes[i].level = values[0];
+			treeNodes[i].parent = values[1];
+			treeNodes[i].name.assign(p, values[2]); p += values[2];
+		}
+		
+		vector<int> genus(header.numGenus), totals(header.numGenus);
+		if (header.numGenus != 0) {
+			memcpy(&genus[0], data + header.genusOffset, header.numGenus * sizeof(int));
+			memcpy(&totals[0], data + header.genusOffset + header.numGenus * sizeof(int), header.numGenus * sizeof(int));
+		}
+		
+		phyloTree = new PhyloTree(treeNodes, genus, totals);
+		
+		numKmers = header.numKmers;
+		WordPairDiffArr.resize(numKmers);
+		const float* wordPairs = (const float*)(data + header.wordPairOffset);
+		for (int i = 0; i < numKmers; i++) { WordPairDiffArr[i].prob = wordPairs[i]; }
+		
+		//the probabilities are read from the file from now on
+		probTable = (const float*)(data + header.probOffset);
+		
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "readModelFile");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
 bool Bayesian::checkReleaseDate(ifstream& file1, ifstream& file2, ifstream& file3, ifstream& file4) {
 	try {
 		
@@ -8,6 +8,20 @@
  *  Created by westcott on 11/3/09.
  *  Copyright 2009 Schloss Lab. All rights reserved.
  *
+ *  The trained classifier is saved to a model file (.8mer.model for kmer size 8) that starts with the mothur version line
+ *  followed by binary sections that are memory mapped, so concurrent classify.seqs runs with the same template share one copy
+ *  of the probabilities in the page cache:
+ *
+ *		bayesianModelHeader	- padded to 8 bytes from the start of the file. the sizes and modification times of the template
+ *							  and taxonomy files the model was trained from, and a checksum of their contents that is only
+ *							  taken when a size or time has changed, so touched files are not retrained but edited ones are
+ *		tree				- for each node of the training tree its level, parent, name length and name
+ *		genus				- numGenus genus node indexes followed by numGenus genus totals, all 32 bit ints
+ *		wordPairs			- numKmers floats, the log probability of each kmer being in the template
+ *		probabilities		- numKmers rows of genusStride floats, the wordGenusProb matrix
+ *
+ *  The text .prob, .numNonZero and .tree.train files written by older versions are still read if there is no model file.
+ *
  */
 
 #include "mothur.h"
@@ -15,6 +29,40 @@
 
 /**************************************************************************************************/
 
+struct bayesianModelHeader {
+	char magic[8];
+	unsigned int version;
+	unsigned int kmerSize;
+	unsigned long long checksum;
+	unsigned long long templateSize;
+	long long templateTime;
+	unsigned long long taxonomySize;
+	long long taxonomyTime;
+	unsigned long long numKmers;
+	unsigned long long numNodes;
+	unsigned long long numGenus;
+	unsigned long long genusStride;
+	unsigned long long treeOffset;
+	unsigned long long genusOffset;
+	unsigned long long wordPairOffset;
+	unsigned long long probOffset;
+};
+
+/**************************************************************************************************/
+//everything that changes while a sequence is classified, so threads with their own scratch can share one Bayesian
+struct bayesianScratch {
+	vector<double> genusScores;		//per genus running total for the kmers being scored, genusStride long
+	vector<int> bootstrapKmers;		//the kmers chosen for every bootstrap, iters * numToSelect long
+	unsigned long long random;		//state of the generator that picks the bootstrap kmers, reseeded for each sequence
+	string simpleTax;
+	string messages;				//warnings and debug output, printed by whoever owns the scratch
+	bool flipped;
+	
+	bayesianScratch() : random(0), flipped(false) {}
+};
+
+/**************************************************************************************************/
+
 class Bayesian : public Classify {
 	
 public:
@@ -22,10 +70,11 @@ public:
 	~Bayesian();
 	
 	string getTaxonomy(Sequence*);
+	string getTaxonomy(Sequence*, bayesianScratch&, unsigned int);	//thread safe, seed for the bootstraps
 	
 private:
-	vector< vector<float> > wordGenusProb;	//vector of maps from genus to probability
-										//wordGenusProb[0][392] = probability that a sequence within genus that's index in the tree is 392 would contain kmer 0;
+	vector<float> wordGenusProb;	//kmer major matrix of genus probabilities, each kmer's row is genusStride long
+									//wordGenusProb[0 * genusStride + 392] = probability that a sequence within genus that's index in the tree is 392 would contain kmer 0;
 	
 	vector<int> genusTotals;
 	vector<int> genusNodes;  //indexes in phyloTree where genus' are located
@@ -33,10 +82,24 @@ private:
 	vector<diffPair> WordPairDiffArr; 
 	
 	int kmerSize, numKmers, confidenceThreshold, iters;
+	int genusStride;				//genusNodes.size() rounded up to a multiple of 8 so rows can be added a whole vector at a time
+	bayesianScratch scratch;		//used by getTaxonomy(Sequence*)
+	const float* probTable;			//wordGenusProb or the probabilities in the mapped model file
+	char* mappedModel;
+	unsigned long long mappedModelSize;
+	vector<char> modelBuffer;		//holds the model file on systems without mmap
 	
-	string bootstrapResults(vector<int>, int, int);
-	int getMostProbableTaxonomy(vector<int>);
+	float* getGenusProbs(int kmer) { return &wordGenusProb[(unsigned long long)kmer * genusStride]; }
+	void setGenusStride();
+	string bootstrapResults(vector<int>&, int, int, bayesianScratch&);
+	int getMostProbableTaxonomy(vector<int>&, bayesianScratch&);
+	void scoreGenera(const vector<int>&, int, int, vector<double>&);
+	int findMostProbableGenus(vector<double>&);
 	void readProbFile(ifstream&, ifstream&, string, string);
+	bool readModelFile(string, string, string);
+	void writeModelFile(string, vector<TaxNode>&, string, string);
+	unsigned long long getTrainingChecksum(string, string);
+	void getTrainingFileInfo(string, string, bayesianModelHeader&);
 	bool checkReleaseDate(ifstream&, ifstream&, ifstream&, ifstream&);
 	bool isReversed(vector<int>&);
 	vector<int> createWordIndexArr(Sequence*);
@@ -0,0 +1,383 @@
+//
+//  binarydist.cpp
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+#include "binarydist.h"
+
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+	#include <sys/mman.h>
+	#include <fcntl.h>
+#endif
+
+static const char binaryDistMagic[8] = { 'M', 'T', 'H', 'R', 'D', 'I', 'S', 'T' };
+static const unsigned int binaryDistVersion = 1;
+
+/**************************************************************************************************/
+//ieee half precision, rounds to nearest even.  distances are never negative, but the sign is kept anyway
+static unsigned short floatToHalf(float f) {
+	unsigned int bits; memcpy(&bits, &f, sizeof(float));
+	unsigned short sign = (bits >> 16) & 0x8000;
+	int exponent = ((bits >> 23) & 0xff) - 127 + 15;
+	unsigned int mantissa = bits & 0x7fffff;
+
+	if (((bits >> 23) & 0xff) == 0xff) { return sign | 0x7c00 | (mantissa ? 0x200 : 0); } //inf or nan
+	if (exponent >= 31) { return sign | 0x7c00; }                                        //too big, inf
+	if (exponent <= 0) {                                                                 //subnormal or zero
+		if (exponent < -10) { return sign; }
+		mantissa |= 0x800000;
+		int shift = 14 - exponent;
+		unsigned int half = mantissa >> shift;
+		unsigned int rest = mantissa & ((1u << shift) - 1);
+		unsigned int halfway = 1u << (shift - 1);
+		if ((rest > halfway) || ((rest == halfway) && (half & 1))) { half++; }
+		return sign | half;
+	}
+
+	unsigned int half = (exponent << 10) | (mantissa >> 13);
+	unsigned int rest = mantissa & 0x1fff;
+	if ((rest > 0x1000) || ((rest == 0x1000) && (half & 1))) { half++; }  //a carry into the exponent is still correct
+	return sign | half;
+}
+/**************************************************************************************************/
+static float halfToFloat(unsigned short h) {
+	unsigned int sign = (h & 0x8000) << 16;
+	unsigned int exponent = (h >> 10) & 0x1f;
+	unsigned int mantissa = h & 0x3ff;
+	unsigned int bits;
+
+	if (exponent == 0) {
+		if (mantissa == 0) { bits = sign; }
+		else {                                          //subnormal, normalize it
+			exponent = 127 - 15 + 1;
+			while ((mantissa & 0x400) == 0) { mantissa <<= 1; exponent--; }
+			bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+		}
+	}else if (exponent == 31) { bits = sign | 0x7f800000 | (mantissa << 13); }
+	else { bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13); }
+
+	float f; memcpy(&f, &bits, sizeof(float));
+	return f;
+}
+/**************************************************************************************************/
+BinaryDistWriter::BinaryDistWriter(string f, vector<string>& n, float cutoff, bool half) : filename(f), names(n) {
+	try {
+		m = MothurOut::getInstance();
+		open(cutoff, half);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "BinaryDistWriter", "BinaryDistWriter");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+BinaryDistWriter::BinaryDistWriter(string f, int numSeqs, float cutoff, bool half) : filename(f) {
+	try {
+		m = MothurOut::getInstance();
+		names.resize(numSeqs);
+		open(cutoff, half);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "BinaryDistWriter", "BinaryDistWriter");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void BinaryDistWriter::open(float cutoff, bool half) {
+	try {
+		closed = false;
+		currentRow = 0;
+		rows.resize(names.size()+1, 0);
+
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, binaryDistMagic, sizeof(header.magic));
+		header.version = binaryDistVersion;
+		header.distBytes = half ? 2 : 4;
+		header.numSeqs = names.size();
+		header.cutoff = cutoff;
+
+		//the header is written again with the offsets filled in by close()
+		m->openOutputFileBinary(filename, out);
+		out.write((char*)&header, sizeof(header));
+		header.colsOffset = out.tellp();
+
+		//dists are collected separately and appended after the cols in close()
+		distsFileName = filename + ".dists.temp";
+		m->openOutputFileBinary(distsFileName, distsOut);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "BinaryDistWriter", "open");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+BinaryDistWriter::~BinaryDistWriter() { close(); }
+/**************************************************************************************************/
+void BinaryDistWriter::setName(int i, string name) { names[i] = name; }
+/**************************************************************************************************/
+float BinaryDistWriter::roundDist(double dist) {
+	//same value a column file written with setprecision(4) gives when it is read back in
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%.4g", dist);
+	return strtof(buffer, NULL);
+}
+/**************************************************************************************************/
+void BinaryDistWriter::pad(ofstream& file) {
+	try {
+		char zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+		long long extra = ((long long)file.tellp()) % 8;
+		if (extra != 0) { file.write(zeros, 8 - extra); }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "BinaryDistWriter", "pad");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//every row up to and including row starts where the distances written so far end
+void BinaryDistWriter::finishRows(unsigned long long row) {
+	while (currentRow <= row) { rows[currentRow] = header.numDists; currentRow++; }
+}
+/**************************************************************************************************/
+void BinaryDistWriter::addDist(unsigned long long row, unsigned long long col, float dist) {
+	try {
+		if (row >= header.numSeqs) { m->mothurOut("[ERROR]: row " + toString(row) + " is not in the distance matrix.\n"); m->control_pressed = true; return; }
+		if (col >= row) { m->mothurOut("[ERROR]: binary distance files only hold the lower triangle, column " + toString(col) + " is not below row " + toString(row) + ".\n"); m->control_pressed = true; return; }
+		if (currentRow <= row) { finishRows(row); }
+		else if (row != (currentRow-1)) { m->mothurOut("[ERROR]: rows must be added to a binary distance file in order.\n"); m->control_pressed = true; return; }
+
+		unsigned int c = col;
+		out.write((char*)&c, sizeof(unsigned int));
+
+		if (header.distBytes == 2) { unsigned short h = floatToHalf(dist); distsOut.write((char*)&h, sizeof(unsigned short)); }
+		else { distsOut.write((char*)&dist, sizeof(float)); }
+
+		header.numDists++;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "BinaryDistWriter", "addDist");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void BinaryDistWriter::addRow(unsigned long long row, vector<PDistCell>& cells) {
+	try {
+		if (currentRow <= row) { finishRows(row); }
+		for (int i = 0; i < cells.size(); i++) { addDist(row, cells[i].index, cells[i].dist); }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "BinaryDistWriter", "addRow");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void BinaryDistWriter::writePart(ofstream& out, unsigned long long row, unsigned long long col, double dist) {
+	unsigned int cell[2] = { (unsigned int)row, (unsigned int)col };
+	float d = roundDist(dist);
+	out.write((char*)cell, sizeof(cell));
+	out.write((char*)&d, sizeof(float));
+}
+/**************************************************************************************************/
+int BinaryDistWriter::addPart(string partFile) {
+	try {
+		ifstream in;
+		if (m->openInputFileBinary(partFile, in, "no error") != 0) { return 0; }
+
+		int count = 0;
+		unsigned int cell[2]; float dist;
+		while (in.read((char*)cell, sizeof(cell)) && in.read((char*)&dist, sizeof(float))) {
+			if (m->control_pressed) { break; }
+			addDist(cell[0], cell[1], dist);
+			count++;
+		}
+		in.close();
+
+		return count;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "BinaryDistWriter", "addPart");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void BinaryDistWriter::close() {
+	try {
+		if (closed) { return; }
+		closed = true;
+
+		if (currentRow <= header.numSeqs) { finishRows(header.numSeqs); }
+
+		pad(out);
+		header.distsOffset = out.tellp();
+
+		distsOut.close();
+		ifstream in;
+		m->openInputFileBinary(distsFileName, in, "no error");
+		char buffer[65536];
+		while (in) {
+			in.read(buffer, sizeof(buffer));
+			if (in.gcount() > 0) { out.write(buffer, in.gcount()); }
+		}
+		in.close();
+		m->mothurRemove(distsFileName);
+
+		pad(out);
+		header.rowsOffset = out.tellp();
+		out.write((char*)&rows[0], rows.size() * sizeof(unsigned long long));
+
+		header.namesOffset = out.tellp();
+		for (int i = 0; i < names.size(); i++) { out.write(names[i].c_str(), names[i].length()+1); }
+
+		out.seekp(0);
+		out.write((char*)&header, sizeof(header));
+		out.close();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "BinaryDistWriter", "close");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+bool BinaryDistReader::isBinary(string filename) {
+	try {
+		ifstream in(filename.c_str(), ios::binary);
+		char magic[8];
+		in.read(magic, sizeof(magic));
+		return (in.gcount() == sizeof(magic)) && (memcmp(magic, binaryDistMagic, sizeof(magic)) == 0);
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "BinaryDistReader", "isBinary");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+BinaryDistReader::BinaryDistReader(string filename) {
+	try {
+		m = MothurOut::getInstance();
+		opened = false;
+		data = NULL;
+		dataSize = 0;
+		cols = NULL; dists = NULL; halfDists = NULL; rows = NULL;
+
+		if (!isBinary(filename)) { m->mothurOut("[ERROR]: " + filename + " is not a binary distance file.\n"); return; }
+
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+		int fd = open(filename.c_str(), O_RDONLY);
+		if (fd == -1) { m->mothurOut("[ERROR]: Could not open " + filename + "\n"); return; }
+		struct stat info;
+		if (fstat(fd, &info) == -1) { ::close(fd); m->mothurOut("[ERROR]: Could not open " + filename + "\n"); return; }
+		dataSize = info.st_size;
+		void* mapped = mmap(NULL, dataSize, PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (mapped == MAP_FAILED) { m->mothurOut("[ERROR]: Could not map " + filename + "\n"); dataSize = 0; return; }
+		madvise(mapped, dataSize, MADV_SEQUENTIAL);
+		data = (char*)mapped;
+#else
+		ifstream in(filename.c_str(), ios::binary);
+		in.seekg(0, ios::end);
+		dataSize = in.tellg();
+		in.seekg(0, ios::beg);
+		buffer.resize(dataSize);
+		in.read(&buffer[0], dataSize);
+		in.close();
+		data = &buffer[0];
+#endif
+
+		if (dataSize < sizeof(header)) { m->mothurOut("[ERROR]: " + filename + " is truncated.\n"); return; }
+		memcpy(&header, data, sizeof(header));
+
+		unsigned long long distsEnd = header.distsOffset + header.numDists * header.distBytes;
+		unsigned long long colsEnd = header.colsOffset + header.numDists * sizeof(unsigned int);
+		unsigned long long rowsEnd = header.rowsOffset + (header.numSeqs+1) * sizeof(unsigned long long);
+		if ((header.version != binaryDistVersion) || ((header.distBytes != 2) && (header.distBytes != 4)) || (distsEnd > dataSize) || (colsEnd > dataSize) || (rowsEnd > dataSize) || (header.namesOffset > dataSize)) {
+			m->mothurOut("[ERROR]: " + filename + " is damaged or was written by a newer version of mothur.\n"); return;
+		}
+
+		cols = (const unsigned int*)(data + header.colsOffset);
+		rows = (const unsigned long long*)(data + header.rowsOffset);
+
+		//every row must lie inside cols and dists and every column must name a sequence, or fillMatrix would read past them
+		bool damaged = (rows[0] != 0) || (rows[header.numSeqs] != header.numDists);
+		for (unsigned long long i = 0; (i < header.numSeqs) && !damaged; i++) { if (rows[i] > rows[i+1]) { damaged = true; } }
+		for (unsigned long long k = 0; (k < header.numDists) && !damaged; k++) { if (cols[k] >= header.numSeqs) { damaged = true; } }
+		if (damaged) { m->mothurOut("[ERROR]: " + filename + " is damaged.\n"); cols = NULL; rows = NULL; return; }
+
+		if (header.distBytes == 2) { halfDists = (const unsigned short*)(data + header.distsOffset); }
+		else { dists = (const float*)(data + header.distsOffset); }
+
+		opened = true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "BinaryDistReader", "BinaryDistReader");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+BinaryDistReader::~BinaryDistReader() {
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+	if (data != NULL) { munmap(data, dataSize); }
+#endif
+}
+/**************************************************************************************************/
+float BinaryDistReader::getDist(unsigned long long i) {
+	if (halfDists != NULL) { return halfToFloat(halfDists[i]); }
+	return dists[i];
+}
+/**************************************************************************************************/
+vector<string> BinaryDistReader::getNames() {
+	try {
+		vector<string> names; names.reserve(header.numSeqs);
+		const char* name = data + header.namesOffset;
+		for (unsigned long long i = 0; i < header.numSeqs; i++) {
+			names.push_back(name);
+			name += names.back().length() + 1;
+		}
+		return names;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "BinaryDistReader", "getNames");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+int BinaryDistReader::fillMatrix(SparseDistanceMatrix* DMatrix, vector<int>& indexes, float cutoff, bool sim) {
+	try {
+		//size every row first, so the matrix rows are allocated once
+		vector<ull> sizes(DMatrix->getNumRows(), 0);
+		for (unsigned long long i = 0; i < header.numSeqs; i++) {
+			if (m->control_pressed) { return 0; }
+			for (unsigned long long k = rows[i]; k < rows[i+1]; k++) {
+				int a = indexes[i]; int b = indexes[cols[k]];
+				if (a != b) { sizes[a]++; sizes[b]++; }
+			}
+		}
+		for (int i = 0; i < sizes.size(); i++) { DMatrix->reserve(i, sizes[i]); }
+
+		for (unsigned long long i = 0; i < header.numSeqs; i++) {
+			if (m->control_pressed) { return 0; }
+
+			int a = indexes[i];
+			for (unsigned long long k = rows[i]; k < rows[i+1]; k++) {
+				int b = indexes[cols[k]];
+				float distance = getDist(k);
+
+				if (distance == -1) { distance = 1000000; }
+				else if (sim) { distance = 1.0 - distance;  }  //user has entered a sim matrix that we need to convert.
+
+				if ((distance < cutoff) && (a != b)) {
+					if (a < b) { DMatrix->addCell(a, PDistCell(b, distance)); }
+					else { DMatrix->addCell(b, PDistCell(a, distance)); }
+				}
+			}
+		}
+
+		return 1;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "BinaryDistReader", "fillMatrix");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
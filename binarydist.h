@@ -0,0 +1,116 @@
+#ifndef Mothur_binarydist_h
+#define Mothur_binarydist_h
+
+//
+//  binarydist.h
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+/* The .dist.bin format stores a sparse, lower triangle distance matrix so it can be memory mapped and read without parsing.
+
+ header		- binaryDistHeader below
+ cols		- numDists unsigned 32 bit column indexes, grouped by row, padded to 8 bytes
+ dists		- numDists distances, 32 bit floats or 16 bit half floats (distBytes), padded to 8 bytes
+ rows		- numSeqs+1 unsigned 64 bit offsets into cols and dists, row i is [rows[i], rows[i+1])
+ names		- numSeqs null terminated sequence names
+
+ Each pair of sequences is stored once, in the row of the sequence with the larger index.  dist.seqs rounds
+ the distances to the 4 significant digits a column file would have, so clustering a .dist.bin file gives the
+ same results as clustering the column file. */
+
+#include "mothur.h"
+#include "mothurout.h"
+#include "sparsedistancematrix.h"
+
+/**************************************************************************************************/
+
+struct binaryDistHeader {
+	char magic[8];
+	unsigned int version;
+	unsigned int distBytes;
+	unsigned long long numSeqs;
+	unsigned long long numDists;
+	unsigned long long namesOffset;
+	unsigned long long colsOffset;
+	unsigned long long distsOffset;
+	unsigned long long rowsOffset;
+	float cutoff;
+	unsigned int reserved;
+};
+
+/**************************************************************************************************/
+//rows must be added in ascending order, rows that are never added have no distances
+class BinaryDistWriter {
+
+public:
+	BinaryDistWriter(string, vector<string>&, float, bool);    //filename, names, cutoff, half precision distances
+	BinaryDistWriter(string, int, float, bool);                //filename, number of sequences, cutoff, half precision - names are set as they are found
+	~BinaryDistWriter();
+
+	void setName(int, string);
+	void addRow(unsigned long long, vector<PDistCell>&);
+	void addDist(unsigned long long, unsigned long long, float);    //row, col < row, dist
+	int addPart(string);                                            //adds the distances saved with writePart, returns the number added
+	void close();
+
+	static float roundDist(double);
+	static void writePart(ofstream&, unsigned long long, unsigned long long, double);   //saves row, col, dist for a process that can't share the writer
+
+private:
+	MothurOut* m;
+	string filename, distsFileName;
+	ofstream out, distsOut;
+	binaryDistHeader header;
+	vector<string> names;
+	vector<unsigned long long> rows;
+	unsigned long long currentRow;
+	bool closed;
+
+	void open(float, bool);
+	void pad(ofstream&);
+	void finishRows(unsigned long long);
+};
+
+/**************************************************************************************************/
+//maps the file read only, on windows the file is read into memory instead
+class BinaryDistReader {
+
+public:
+	BinaryDistReader(string);
+	~BinaryDistReader();
+
+	static bool isBinary(string);        //checks the magic number at the start of the file
+
+	bool good() { return opened; }
+	unsigned long long getNumSeqs() { return header.numSeqs; }
+	unsigned long long getNumDists() { return header.numDists; }
+	float getCutoff() { return header.cutoff; }
+	vector<string> getNames();
+
+	unsigned long long getRowStart(unsigned long long row) { return rows[row]; }
+	unsigned long long getRowEnd(unsigned long long row) { return rows[row+1]; }
+	unsigned int getCol(unsigned long long i) { return cols[i]; }
+	float getDist(unsigned long long i);
+
+	//adds the distances below the cutoff to the matrix, indexes gives the matrix index of each sequence in the file
+	int fillMatrix(SparseDistanceMatrix*, vector<int>&, float, bool);
+
+private:
+	MothurOut* m;
+	binaryDistHeader header;
+	bool opened;
+	char* data;
+	unsigned long long dataSize;
+	vector<char> buffer;
+
+	const unsigned int* cols;
+	const float* dists;
+	const unsigned short* halfDists;
+	const unsigned long long* rows;
+};
+
+/**************************************************************************************************/
+
+#endif
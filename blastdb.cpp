@@ -327,7 +327,7 @@ vector<int> BlastDB::findClosestMegaBlast(Sequence* seq, int n, int minPerID) {
 	}
 }
 /**************************************************************************************************/
-void BlastDB::addSequence(Sequence seq) {
+void BlastDB::addSequence(const Sequence& seq) {
 	try {
 	
 		ofstream unalignedFastaFile;
@@ -21,7 +21,7 @@ public:
 	~BlastDB();
 	
 	void generateDB();
-	void addSequence(Sequence);
+	void addSequence(const Sequence&);
 	vector<int> findClosestSequences(Sequence*, int);
 	vector<int> findClosestMegaBlast(Sequence*, int, int);
 	
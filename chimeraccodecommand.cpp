@@ -512,7 +512,7 @@ int ChimeraCcodeCommand::driver(linePair* filePos, string outputFName, string fi
 		ifstream inFASTA;
 		m->openInputFile(filename, inFASTA);
 
-		inFASTA.seekg(filePos->start);
+		if (filePos->start != 0) { inFASTA.seekg(filePos->start); }
 
 		bool done = false;
 		int count = 0;
@@ -541,8 +541,7 @@ int ChimeraCcodeCommand::driver(linePair* filePos, string outputFName, string fi
 			delete candidateSeq;
 			
 			#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				unsigned long long pos = inFASTA.tellg();
-				if ((pos == -1) || (pos >= filePos->end)) { break; }
+				if (m->endOfPart(inFASTA, filePos->end)) { break; }
 			#else
 				if (inFASTA.eof()) { break; }
 			#endif
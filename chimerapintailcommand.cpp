@@ -600,7 +600,7 @@ int ChimeraPintailCommand::driver(linePair* filePos, string outputFName, string
 		ifstream inFASTA;
 		m->openInputFile(filename, inFASTA);
 
-		inFASTA.seekg(filePos->start);
+		if (filePos->start != 0) { inFASTA.seekg(filePos->start); }
 
 		bool done = false;
 		int count = 0;
@@ -629,8 +629,7 @@ int ChimeraPintailCommand::driver(linePair* filePos, string outputFName, string
 			delete candidateSeq;
 			
 			#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				unsigned long long pos = inFASTA.tellg();
-				if ((pos == -1) || (pos >= filePos->end)) { break; }
+				if (m->endOfPart(inFASTA, filePos->end)) { break; }
 			#else
 				if (inFASTA.eof()) { break; }
 			#endif
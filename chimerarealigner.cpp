@@ -149,13 +149,14 @@ void ChimeraReAligner::buildTemplateProfile(vector<string> parents) {
 void ChimeraReAligner::createAlignMatrix(int queryUnalignedLength, int alignmentLength){
 	
 	try{
-		alignMatrix.resize(alignmentLength+1);
-		for(int i=0;i<=alignmentLength;i++){
-			alignMatrix[i].resize(queryUnalignedLength+1);
-		}
+		numRows = alignmentLength;
+		numCols = queryUnalignedLength;
+		rowWords = (numCols / 64) + 1;
 
-		for(int i=1;i<=alignmentLength;i++)		{	alignMatrix[i][0].direction = 'l';	}
-		for(int j=1;j<=queryUnalignedLength;j++){	alignMatrix[0][j].direction = 'u';	}
+		//the first row points up and the first column points left, see getDirection
+		gapDirections.assign((numRows+1) * rowWords, 0);
+		lastRowScores.assign(numCols+1, 0);
+		lastColumnScores.assign(numRows+1, 0);
 	}
 	catch(exception& e) {
 		m->errorOut(e, "ChimeraReAligner", "createAlignMatrix");
@@ -169,34 +170,41 @@ void ChimeraReAligner::fillAlignMatrix(string query){
 	try{
 		int GAP = -4;
 		
-		int nrows = alignMatrix.size()-1;
-		int ncols = alignMatrix[0].size()-1;
+		int nrows = numRows;
+		int ncols = numCols;
+
+		vector<int> previous(ncols+1, 0);		//	the first row and column score 0
+		vector<int> current(ncols+1, 0);
 				
 		for(int i=1;i<=nrows;i++){
 			
 			bases p = profile[i-1];
 			int numChars = p.Chars;
+			unsigned long long* directions = &gapDirections[i * rowWords];
 			
 			for(int j=1;j<=ncols;j++){
 			
 				char q = query[j-1];
 				
 				//	score it for if there was a match
-				int maxScore = calcMatchScore(p, q) + alignMatrix[i-1][j-1].score;
-				int maxDirection = 'd';
+				int maxScore = calcMatchScore(p, q) + previous[j-1];
 				
 				//	score it for if there was a gap in the query
-				int score = alignMatrix[i-1][j].score + (numChars * GAP);
+				int score = previous[j] + (numChars * GAP);
 				if (score > maxScore) {
 					maxScore = score;
-					maxDirection = 'l';
+					directions[j / 64] |= (1ULL << (j % 64));
 				}
 				
-				alignMatrix[i][j].score = maxScore;
-				alignMatrix[i][j].direction = maxDirection;
-				
+				current[j] = maxScore;
 			}
+			
+			lastColumnScores[i] = current[ncols];
+			previous.swap(current);
 		}
+		
+		if (nrows > 0) { lastRowScores = previous; }
+		lastRowScores[0] = 0;
 	}
 	catch(exception& e) {
 		m->errorOut(e, "ChimeraReAligner", "fillAlignMatrix");
@@ -206,6 +214,16 @@ void ChimeraReAligner::fillAlignMatrix(string query){
 
 /***************************************************************************************************************/
 
+char ChimeraReAligner::getDirection(int row, int column){
+	if (row == 0)		{	return (column == 0) ? 'x' : 'u';	}
+	if (column == 0)	{	return 'l';							}
+	
+	if ((gapDirections[row * rowWords + (column / 64)] >> (column % 64)) & 1ULL) {	return 'l';	}
+	return 'd';
+}
+
+/***************************************************************************************************************/
+
 int ChimeraReAligner::calcMatchScore(bases p, char q){
 	try{
 		
@@ -238,14 +256,14 @@ string ChimeraReAligner::getNewAlignment(string query){
 		
 		int maxScore = -99999999;
 		
-		int nrows = alignMatrix.size()-1;
-		int ncols = alignMatrix[0].size()-1;
+		int nrows = numRows;
+		int ncols = numCols;
 
 		int bestCol = -1;
 		int bestRow = -1;
 		
 		for(int i=1;i<=nrows;i++){
-			int score = alignMatrix[i][ncols].score;
+			int score = lastColumnScores[i];
 			if (score > maxScore) {
 				maxScore = score;
 				bestRow = i;
@@ -254,7 +272,7 @@ string ChimeraReAligner::getNewAlignment(string query){
 		}
 		
 		for(int j=1;j<=ncols;j++){
-			int score = alignMatrix[nrows][j].score;
+			int score = lastRowScores[j];
 			if (score > maxScore) {
 				maxScore = score;
 				bestRow = nrows;
@@ -272,22 +290,22 @@ string ChimeraReAligner::getNewAlignment(string query){
 			}
 		}
 		
-		AlignCell c = alignMatrix[currentRow][currentCol];
-		while(c.direction != 'x'){
+		char direction = getDirection(currentRow, currentCol);
+		while(direction != 'x'){
 			
 			char q;
 
-			if(c.direction == 'd'){
+			if(direction == 'd'){
 				q = query[currentCol-1];
 				currentCol--;
 				currentRow--;
 			}
 			
 			
-			else if (c.direction == 'u') {
+			else if (direction == 'u') {
 				break;
 			}					
-			else if(c.direction == 'l'){
+			else if(direction == 'l'){
 				char gapChar;
 				if(currentCol == 0)	{	gapChar = '.';	}
 				else				{	gapChar = '-';	}
@@ -301,7 +319,7 @@ string ChimeraReAligner::getNewAlignment(string query){
 
 			queryAlignment[alignmentPosition] = q;
 			alignmentPosition++;
-			c = alignMatrix[currentRow][currentCol];
+			direction = getDirection(currentRow, currentCol);
 		}
 
 //		need to reverse the string
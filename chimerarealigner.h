@@ -15,14 +15,6 @@
 
 /***********************************************************/
 
-struct AlignCell {
-	int score;
-	char direction;
-	AlignCell() : score(0), direction('x') {};
-};
-
-/***********************************************************/
-
 struct  bases {
 	int A, T, G, C, Gap, Chars;
 	bases() : A(0), T(0), G(0), C(0), Gap(0), Chars(0){};
@@ -45,10 +37,16 @@ private:
 	void fillAlignMatrix(string);
 	int calcMatchScore(bases, char);
 	string getNewAlignment(string);
+	char getDirection(int, int);
 
 	int alignmentLength;
 	vector<bases> profile;
-	vector<vector<AlignCell> > alignMatrix;
+
+	//the rows of the matrix are the alignment columns, so only the scores of the last row and column are kept and the
+	//traceback is one bit per cell, set if the cell adds a gap to the query and clear if it points diagonally
+	int numRows, numCols, rowWords;
+	vector<int> lastRowScores, lastColumnScores;
+	vector<unsigned long long> gapDirections;
 
 	MothurOut* m;
 };
@@ -10,6 +10,7 @@
 #include "chimeraslayer.h"
 #include "chimerarealigner.h"
 #include "kmerdb.hpp"
+#include "minimizerdb.hpp"
 #include "blastdb.hpp"
 
 //***************************************************************************************************************
@@ -268,6 +269,28 @@ int ChimeraSlayer::doPrep() {
 			
 			databaseRight->setNumSeqs(templateSeqs.size());
 		#endif	
+		}else if (searchMethod == "minimizer") {
+			//the minimizer index is built in memory, so there is no left and right file to read
+			databaseLeft = new MinimizerDB(kmerSize);
+			databaseRight = new MinimizerDB(kmerSize);
+			
+			for (int i = 0; i < templateSeqs.size(); i++) {
+				if (m->control_pressed) { return 0; } 
+				
+				string leftFrag = templateSeqs[i]->getUnaligned();
+				leftFrag = leftFrag.substr(0, int(leftFrag.length() * 0.33));
+				Sequence leftTemp(templateSeqs[i]->getName(), leftFrag);
+				databaseLeft->addSequence(leftTemp);
+				
+				string rightFrag = templateSeqs[i]->getUnaligned();
+				rightFrag = rightFrag.substr(int(rightFrag.length() * 0.66));
+				Sequence rightTemp(templateSeqs[i]->getName(), rightFrag);
+				databaseRight->addSequence(rightTemp);
+			}
+			databaseLeft->generateDB();
+			databaseLeft->setNumSeqs(templateSeqs.size());
+			databaseRight->generateDB();
+			databaseRight->setNumSeqs(templateSeqs.size());
 		}else if (searchMethod == "blast") {
 		
 			//generate blastdb
@@ -382,6 +405,28 @@ vector<Sequence*> ChimeraSlayer::getTemplate(Sequence q, vector<Sequence*>& user
 			databaseRight->generateDB();
 			databaseRight->setNumSeqs(userTemplate.size());
 #endif	
+		}else if (searchMethod == "minimizer") {
+			//the minimizer index is built in memory, so there is no left and right file to read
+			databaseLeft = new MinimizerDB(kmerSize);
+			databaseRight = new MinimizerDB(kmerSize);
+			
+			for (int i = 0; i < userTemplate.size(); i++) {
+				if (m->control_pressed) { return userTemplate; } 
+				
+				string leftFrag = userTemplate[i]->getUnaligned();
+				leftFrag = leftFrag.substr(0, int(leftFrag.length() * 0.33));
+				Sequence leftTemp(userTemplate[i]->getName(), leftFrag);
+				databaseLeft->addSequence(leftTemp);
+				
+				string rightFrag = userTemplate[i]->getUnaligned();
+				rightFrag = rightFrag.substr(int(rightFrag.length() * 0.66));
+				Sequence rightTemp(userTemplate[i]->getName(), rightFrag);
+				databaseRight->addSequence(rightTemp);
+			}
+			databaseLeft->generateDB();
+			databaseLeft->setNumSeqs(userTemplate.size());
+			databaseRight->generateDB();
+			databaseRight->setNumSeqs(userTemplate.size());
 		}else if (searchMethod == "blast") {
 			
 			//generate blastdb
@@ -406,7 +451,7 @@ vector<Sequence*> ChimeraSlayer::getTemplate(Sequence q, vector<Sequence*>& user
 //***************************************************************************************************************
 ChimeraSlayer::~ChimeraSlayer() { 	
 	if (templateFileName != "self") {
-		if (searchMethod == "kmer") {  delete databaseRight;  delete databaseLeft;  }	
+		if ((searchMethod == "kmer") || (searchMethod == "minimizer")) {  delete databaseRight;  delete databaseLeft;  }	
 		else if (searchMethod == "blast") {  delete databaseLeft; }
 	}
 }
@@ -821,7 +866,7 @@ int ChimeraSlayer::getChimeras(Sequence* query) {
 		Slayer slayer(window, increment, minSim, divR, iters, minSNP, minBS);
 		
 		if (templateFileName == "self") {
-			if (searchMethod == "kmer") {  delete databaseRight;  delete databaseLeft;  }	
+			if ((searchMethod == "kmer") || (searchMethod == "minimizer")) {  delete databaseRight;  delete databaseLeft;  }	
 			else if (searchMethod == "blast") {  delete databaseLeft; }
 		}
 	
@@ -1091,7 +1136,7 @@ vector<Sequence> ChimeraSlayer::getRefSeqs(Sequence q, vector<Sequence*>& thisTe
 			delete newSeq;
 		}else if (searchMethod == "blast")  {
 			refSeqs = getBlastSeqs(q, thisTemplate, numWanted); //fills indexes
-		}else if (searchMethod == "kmer") {
+		}else if ((searchMethod == "kmer") || (searchMethod == "minimizer")) {
 			refSeqs = getKmerSeqs(q, thisTemplate, numWanted); //fills indexes
 		}else { m->mothurOut("not valid search."); exit(1);  } //should never get here
 		
@@ -29,7 +29,7 @@ vector<string> ChimeraSlayerCommand::setParameters(){
 		CommandParameter pmincov("mincov", "Number", "", "70", "", "", "","",false,false); parameters.push_back(pmincov);
 		CommandParameter pminsnp("minsnp", "Number", "", "10", "", "", "","",false,false); parameters.push_back(pminsnp);
 		CommandParameter pminbs("minbs", "Number", "", "90", "", "", "","",false,false); parameters.push_back(pminbs);
-		CommandParameter psearch("search", "Multiple", "kmer-blast", "blast", "", "", "","",false,false); parameters.push_back(psearch);
+		CommandParameter psearch("search", "Multiple", "kmer-blast-minimizer", "blast", "", "", "","",false,false); parameters.push_back(psearch);
 		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
         
 		CommandParameter prealign("realign", "Boolean", "", "T", "", "", "","",false,false); parameters.push_back(prealign);
@@ -78,7 +78,7 @@ string ChimeraSlayerCommand::getHelpString(){
 		helpString += "The window parameter allows you to specify the window size for searching for chimeras, default=50. \n";
 		helpString += "The increment parameter allows you to specify how far you move each window while finding chimeric sequences, default=5.\n";
 		helpString += "The numwanted parameter allows you to specify how many sequences you would each query sequence compared with, default=15.\n";
-		helpString += "The ksize parameter allows you to input kmersize, default is 7, used if search is kmer. \n";
+		helpString += "The ksize parameter allows you to input kmersize, default is 7, used if search is kmer or minimizer. \n";
 		helpString += "The match parameter allows you to reward matched bases in blast search, default is 5. \n";
 		helpString += "The parents parameter allows you to select the number of potential parents to investigate from the numwanted best matches after rating them, default is 3. \n";
 		helpString += "The mismatch parameter allows you to penalize mismatched bases in blast search, default is -4. \n";
@@ -88,7 +88,7 @@ string ChimeraSlayerCommand::getHelpString(){
 		helpString += "The mincov parameter allows you to specify minimum coverage by closest matches found in template. Default is 70, meaning 70%. \n";
 		helpString += "The minbs parameter allows you to specify minimum bootstrap support for calling a sequence chimeric. Default is 90, meaning 90%. \n";
 		helpString += "The minsnp parameter allows you to specify percent of SNPs to sample on each side of breakpoint for computing bootstrap support (default: 10) \n";
-		helpString += "The search parameter allows you to specify search method for finding the closest parent. Choices are blast, and kmer, default blast. \n";
+		helpString += "The search parameter allows you to specify search method for finding the closest parent. Choices are blast, kmer and minimizer, default blast. \n";
 		helpString += "The realign parameter allows you to realign the query to the potential parents. Choices are true or false, default true.  \n";
 		helpString += "The blastlocation parameter allows you to specify the location of your blast executable. By default mothur will look in ./blast/bin relative to mothur's executable.  \n";
 		helpString += "If the save parameter is set to true the reference sequences will be saved in memory, to clear them later you can use the clear.memory command. Default=f.";
@@ -643,7 +643,7 @@ ChimeraSlayerCommand::ChimeraSlayerCommand(string option)  {
 				if(ableToOpen == 1) {	m->mothurOut("[ERROR]: " + blastCommand + " file does not exist. mothur requires blastall.exe to run chimera.slayer."); m->mothurOutEndLine(); abort = true; }
 			}
 
-			if ((search != "blast") && (search != "kmer")) { m->mothurOut(search + " is not a valid search."); m->mothurOutEndLine(); abort = true;  }
+			if ((search != "blast") && (search != "kmer") && (search != "minimizer")) { m->mothurOut(search + " is not a valid search."); m->mothurOutEndLine(); abort = true;  }
 			
 			if ((hasName || hasCount) && (templatefile != "self")) { m->mothurOut("You have provided a namefile or countfile and the reference parameter is not set to self. I am not sure what reference you are trying to use, aborting."); m->mothurOutEndLine(); abort=true; }
 			if (hasGroup && (templatefile != "self")) { m->mothurOut("You have provided a group file and the reference parameter is not set to self. I am not sure what reference you are trying to use, aborting."); m->mothurOutEndLine(); abort=true; }
@@ -1740,7 +1740,7 @@ int ChimeraSlayerCommand::driver(linePair filePos, string outputFName, string fi
 		ifstream inFASTA;
 		m->openInputFile(filename, inFASTA);
 
-		inFASTA.seekg(filePos.start);
+		if (filePos.start != 0) { inFASTA.seekg(filePos.start); }
 		
 		if (filePos.start == 0) { chimera->printHeader(out); }
 
@@ -1817,8 +1817,7 @@ int ChimeraSlayerCommand::driver(linePair filePos, string outputFName, string fi
 			}
 			
 			#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				unsigned long long pos = inFASTA.tellg();
-				if ((pos == -1) || (pos >= filePos.end)) { break; }
+				if (m->endOfPart(inFASTA, filePos.end)) { break; }
 			#else
 				if (inFASTA.eof()) { break; }
 			#endif
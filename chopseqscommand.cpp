@@ -508,7 +508,7 @@ bool ChopSeqsCommand::driver(linePair filePos, string filename, string outFasta,
 		ifstream in;
 		m->openInputFile(filename, in);
         
-		in.seekg(filePos.start);
+		if (filePos.start != 0) { in.seekg(filePos.start); }
         
 		bool done = false;
         bool wroteAccnos = false;
@@ -536,8 +536,7 @@ bool ChopSeqsCommand::driver(linePair filePos, string filename, string outFasta,
 			}
 			
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-            unsigned long long pos = in.tellg();
-            if ((pos == -1) || (pos >= filePos.end)) { break; }
+            if (m->endOfPart(in, filePos.end)) { break; }
 #else
             if (in.eof()) { break; }
 #endif
@@ -13,7 +13,9 @@
 #include "suffixdb.hpp"
 #include "blastdb.hpp"
 #include "distancedb.hpp"
+#include "minimizerdb.hpp"
 #include "referencedb.h"
+#include "templatecache.h"
 
 /**************************************************************************************************/
 void Classify::generateDatabaseAndNames(string tfile, string tempFile, string method, int kmerSize, float gapOpen, float gapExtend, float match, float misMatch)  {		
@@ -47,6 +49,7 @@ void Classify::generateDatabaseAndNames(string tfile, string tempFile, string me
 				}
 			}
 			else if(method == "suffix")		{	database = new SuffixDB(numSeqs);								}
+			else if(method == "minimizer")	{	database = new MinimizerDB(kmerSize);							}
 			else if(method == "blast")		{	database = new BlastDB(tempFile.substr(0,tempFile.find_last_of(".")+1), gapOpen, gapExtend, match, misMatch, "", threadID);	}
 			else if(method == "distance")	{	database = new DistanceDB();	}
 			else {
@@ -119,6 +122,7 @@ void Classify::generateDatabaseAndNames(string tfile, string tempFile, string me
 				//create database
 				if(method == "kmer")			{	database = new KmerDB(tempFile, kmerSize);			}
 				else if(method == "suffix")		{	database = new SuffixDB(numSeqs);								}
+				else if(method == "minimizer")	{	database = new MinimizerDB(kmerSize);							}
 				else if(method == "blast")		{	database = new BlastDB(tempFile.substr(0,tempFile.find_last_of(".")+1), gapOpen, gapExtend, match, misMatch, "", pid);	}
 				else if(method == "distance")	{	database = new DistanceDB();	}
 				else {
@@ -172,6 +176,7 @@ void Classify::generateDatabaseAndNames(string tfile, string tempFile, string me
 				}
 			}
 			else if(method == "suffix")		{	database = new SuffixDB(numSeqs);								}
+			else if(method == "minimizer")	{	database = new MinimizerDB(kmerSize);							}
 			else if(method == "blast")		{	database = new BlastDB(tempFile.substr(0,tempFile.find_last_of(".")+1), gapOpen, gapExtend, match, misMatch, "", threadID);	}
 			else if(method == "distance")	{	database = new DistanceDB();	}
 			else {
@@ -203,17 +208,31 @@ void Classify::generateDatabaseAndNames(string tfile, string tempFile, string me
 				ifstream kmerFileTest(kmerDBName.c_str());
 				database->readKmerDB(kmerFileTest);	
 			
-				ifstream fastaFile;
-				m->openInputFile(tempFile, fastaFile);
-				
-				while (!fastaFile.eof()) {
-					Sequence temp(fastaFile);
-					m->gobble(fastaFile);
+				//the names are mapped from the template cache if a run has already read this fasta file
+				TemplateCache cache(tempFile);
+				if (cache.read()) {
+					for (int i = 0; i < cache.getNumSeqs(); i++) {
+						if (rdb->save) { rdb->referenceSeqs.push_back(cache.getSequence(i)); }
+						names.push_back(cache.getName(i));
+					}
+				}else {
+					vector<Sequence> templates;
 					
-					if (rdb->save) { rdb->referenceSeqs.push_back(temp); }
-					names.push_back(temp.getName());
+					ifstream fastaFile;
+					m->openInputFile(tempFile, fastaFile);
+					
+					while (!fastaFile.eof()) {
+						Sequence temp(fastaFile);
+						m->gobble(fastaFile);
+						
+						if (rdb->save) { rdb->referenceSeqs.push_back(temp); }
+						names.push_back(temp.getName());
+						if (temp.getName() != "") { templates.push_back(temp); }
+					}
+					fastaFile.close();
+					
+					if (!m->control_pressed && (templates.size() == names.size())) { cache.write(templates); }
 				}
-				fastaFile.close();
 			}
 	#endif	
             	
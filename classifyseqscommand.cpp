@@ -21,7 +21,7 @@ vector<string> ClassifySeqsCommand::setParameters(){
         CommandParameter pcount("count", "InputTypes", "", "", "NameCount-CountGroup", "none", "none","",false,false,true); parameters.push_back(pcount);
 		CommandParameter pgroup("group", "InputTypes", "", "", "CountGroup", "none", "none","",false,false,true); parameters.push_back(pgroup);
 
-		CommandParameter psearch("search", "Multiple", "kmer-blast-suffix-distance-align", "kmer", "", "", "","",false,false); parameters.push_back(psearch);
+		CommandParameter psearch("search", "Multiple", "kmer-blast-suffix-distance-align-minimizer", "kmer", "", "", "","",false,false); parameters.push_back(psearch);
 		CommandParameter pksize("ksize", "Number", "", "8", "", "", "","",false,false); parameters.push_back(pksize);
 		CommandParameter pmethod("method", "Multiple", "wang-knn-zap", "wang", "", "", "","",false,false); parameters.push_back(pmethod);
 		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
@@ -55,7 +55,7 @@ string ClassifySeqsCommand::getHelpString(){
 		helpString += "The classify.seqs command reads a fasta file containing sequences and creates a .taxonomy file and a .tax.summary file.\n";
 		helpString += "The classify.seqs command parameters are reference, fasta, name, group, count, search, ksize, method, taxonomy, processors, match, mismatch, gapopen, gapextend, numwanted, relabund and probs.\n";
 		helpString += "The reference, fasta and taxonomy parameters are required. You may enter multiple fasta files by separating their names with dashes. ie. fasta=abrecovery.fasta-amzon.fasta \n";
-		helpString += "The search parameter allows you to specify the method to find most similar template.  Your options are: suffix, kmer, blast, align and distance. The default is kmer.\n";
+		helpString += "The search parameter allows you to specify the method to find most similar template.  Your options are: suffix, kmer, minimizer, blast, align and distance. The default is kmer. The minimizer search may be used with the knn method.\n";
 		helpString += "The name parameter allows you add a names file with your fasta file, if you enter multiple fasta files, you must enter matching names files for them.\n";
 		helpString += "The group parameter allows you add a group file so you can have the summary totals broken up by group.\n";
         helpString += "The count parameter allows you add a count file so you can have the summary totals broken up by group.\n";
@@ -759,30 +759,36 @@ int ClassifySeqsCommand::execute(){
 				
 #else
 		
-			vector<unsigned long long> positions; 
+			//wang only reads its classifier while classifying, so one copy is shared by threads instead of being copied into processes
+			Bayesian* bayesian = dynamic_cast<Bayesian*>(classify);
+			if (bayesian != NULL) {
+				numFastaSeqs = createThreads(bayesian, newTaxonomyFile, tempTaxonomyFile, newaccnosFile, fastaFileNames[s]);
+			}else {
+				vector<unsigned long long> positions; 
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-			positions = m->divideFile(fastaFileNames[s], processors);
-			for (int i = 0; i < (positions.size()-1); i++) {	lines.push_back(new linePair(positions[i], positions[(i+1)]));	}
+				positions = m->divideFile(fastaFileNames[s], processors);
+				for (int i = 0; i < (positions.size()-1); i++) {	lines.push_back(new linePair(positions[i], positions[(i+1)]));	}
 #else
-			if (processors == 1) {
-				lines.push_back(new linePair(0, 1000));
-			}else {
-				positions = m->setFilePosFasta(fastaFileNames[s], numFastaSeqs); 
-                if (positions.size() < processors) { processors = positions.size(); }
+				if (processors == 1) {
+					lines.push_back(new linePair(0, 1000));
+				}else {
+					positions = m->setFilePosFasta(fastaFileNames[s], numFastaSeqs); 
+	                if (positions.size() < processors) { processors = positions.size(); }
 				
-				//figure out how many sequences you have to process
-				int numSeqsPerProcessor = numFastaSeqs / processors;
-				for (int i = 0; i < processors; i++) {
-					int startIndex =  i * numSeqsPerProcessor;
-					if(i == (processors - 1)){	numSeqsPerProcessor = numFastaSeqs - i * numSeqsPerProcessor; 	}
-					lines.push_back(new linePair(positions[startIndex], numSeqsPerProcessor));
+					//figure out how many sequences you have to process
+					int numSeqsPerProcessor = numFastaSeqs / processors;
+					for (int i = 0; i < processors; i++) {
+						int startIndex =  i * numSeqsPerProcessor;
+						if(i == (processors - 1)){	numSeqsPerProcessor = numFastaSeqs - i * numSeqsPerProcessor; 	}
+						lines.push_back(new linePair(positions[startIndex], numSeqsPerProcessor));
+					}
 				}
-			}
 #endif
-			if(processors == 1){
-				numFastaSeqs = driver(lines[0], newTaxonomyFile, tempTaxonomyFile, newaccnosFile, fastaFileNames[s]);
-			}else{
-				numFastaSeqs = createProcesses(newTaxonomyFile, tempTaxonomyFile, newaccnosFile, fastaFileNames[s]); 
+				if(processors == 1){
+					numFastaSeqs = driver(lines[0], newTaxonomyFile, tempTaxonomyFile, newaccnosFile, fastaFileNames[s]);
+				}else{
+					numFastaSeqs = createProcesses(newTaxonomyFile, tempTaxonomyFile, newaccnosFile, fastaFileNames[s]); 
+				}
 			}
 #endif
 			
@@ -1094,6 +1100,150 @@ int ClassifySeqsCommand::createProcesses(string taxFileName, string tempTaxFile,
 	}
 }
 //**********************************************************************************************************************
+//this thread reads the fasta file in batches and writes the results in file order, the workers classify the batches with the shared classifier
+int ClassifySeqsCommand::createThreads(Bayesian* bayesian, string taxFName, string tempTFName, string accnos, string filename) {
+	try {
+		ofstream outTax;
+		m->openOutputFile(taxFName, outTax);
+
+		ofstream outTaxSimple;
+		m->openOutputFile(tempTFName, outTaxSimple);
+
+		ofstream outAcc;
+		m->openOutputFile(accnos, outAcc);
+
+		ifstream inFASTA;
+		m->openInputFile(filename, inFASTA);
+
+		//each sequence's bootstraps are seeded from its number in the file, so the results do not depend on the number of processors
+		bootstrapSeed = rand();
+
+		//only a few batches are read ahead of the one being written, so the memory used stays the same for any size file
+		int batchSize = 100;
+		int window = 4 * processors;
+		batches.clear();
+		batches.resize(window);
+
+		WorkQueue queue(processors);
+		vector<thread*> workers;
+		for (int i = 0; i < processors; i++) { workers.push_back(new thread(&ClassifySeqsCommand::classifyWorker, this, i, bayesian, &queue)); }
+
+		unsigned long long numRead = 0;
+		long long numBatches = 0;
+		long long numWritten = 0;
+		bool moreSeqs = true;
+		int count = 0;
+
+		while (moreSeqs || (numWritten < numBatches)) {
+			if (m->control_pressed) { moreSeqs = false; }
+
+			if (moreSeqs && ((numBatches - numWritten) < window)) {
+				classifyBatch& batch = batches[numBatches % window];
+				batch.seqs.clear();
+				batch.firstSeq = numRead;
+				batch.classified = false;
+
+				while ((batch.seqs.size() < batchSize) && !inFASTA.eof()) {
+					Sequence candidateSeq(inFASTA); m->gobble(inFASTA);
+					if (candidateSeq.getName() != "") { batch.seqs.push_back(candidateSeq); numRead++; }
+				}
+				if (inFASTA.eof()) { moreSeqs = false; }
+
+				if (batch.seqs.size() != 0) { queue.push(numBatches % processors, numBatches); numBatches++; }
+				continue;
+			}
+
+			//write the oldest batch once it is classified
+			classifyBatch& batch = batches[numWritten % window];
+			{
+				unique_lock<mutex> guard(batchLock);
+				while (!batch.classified) { batchDone.wait(guard); }
+			}
+			numWritten++;
+
+			if (m->control_pressed) { continue; }
+
+			for (int i = 0; i < batch.seqs.size(); i++) {
+				string name = batch.seqs[i].getName();
+
+				if (batch.messages[i] != "") { m->mothurOut(batch.messages[i]); }
+
+				if (batch.taxonomy[i] == "unknown;") { m->mothurOut("[WARNING]: " + name + " could not be classified. You can use the remove.lineage command with taxon=unknown; to remove such sequences."); m->mothurOutEndLine(); }
+
+				//output confidence scores or not
+				if (probs) {
+					outTax << name << '\t' << batch.taxonomy[i] << endl;
+				}else{
+					outTax << name << '\t' << batch.simpleTax[i] << endl;
+				}
+
+				if (batch.flipped[i]) { outAcc << name << endl; }
+
+				outTaxSimple << name << '\t' << batch.simpleTax[i] << endl;
+
+				count++;
+
+				//report progress
+				if((count) % 100 == 0){	m->mothurOutJustToScreen("Processing sequence: " + toString(count) +"\n"); 		}
+			}
+		}
+
+		queue.close();
+		for (int i = 0; i < workers.size(); i++) { workers[i]->join(); delete workers[i]; }
+		batches.clear();
+
+		//report progress
+		if((count) % 100 != 0){	m->mothurOutJustToScreen("Processing sequence: " + toString(count)+"\n"); 		}
+
+		inFASTA.close();
+		outTax.close();
+		outTaxSimple.close();
+		outAcc.close();
+
+		if (m->control_pressed) { return 0; }
+
+		return count;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ClassifySeqsCommand", "createThreads");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+void ClassifySeqsCommand::classifyWorker(int worker, Bayesian* bayesian, WorkQueue* queue) {
+	try {
+		bayesianScratch work;
+
+		long long task;
+		while (queue->pop(worker, task)) {
+			classifyBatch& batch = batches[task % batches.size()];
+
+			int numSeqs = batch.seqs.size();
+			batch.taxonomy.assign(numSeqs, "");
+			batch.simpleTax.assign(numSeqs, "");
+			batch.messages.assign(numSeqs, "");
+			batch.flipped.assign(numSeqs, false);
+
+			for (int i = 0; i < numSeqs; i++) {
+				if (m->control_pressed) { break; }
+
+				batch.taxonomy[i] = bayesian->getTaxonomy(&batch.seqs[i], work, bootstrapSeed + batch.firstSeq + i);
+				batch.simpleTax[i] = work.simpleTax;
+				batch.messages[i] = work.messages;
+				batch.flipped[i] = work.flipped;
+			}
+
+			lock_guard<mutex> guard(batchLock);
+			batch.classified = true;
+			batchDone.notify_all();
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ClassifySeqsCommand", "classifyWorker");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
 
 int ClassifySeqsCommand::driver(linePair* filePos, string taxFName, string tempTFName, string accnos, string filename){
 	try {
@@ -1111,7 +1261,7 @@ int ClassifySeqsCommand::driver(linePair* filePos, string taxFName, string tempT
 		
 		string taxonomy;
 
-		inFASTA.seekg(filePos->start);
+		if (filePos->start != 0) { inFASTA.seekg(filePos->start); }
 
 		bool done = false;
 		int count = 0;
@@ -1149,8 +1299,7 @@ int ClassifySeqsCommand::driver(linePair* filePos, string taxFName, string tempT
 			delete candidateSeq;
 			
 			#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				unsigned long long pos = inFASTA.tellg();
-				if ((pos == -1) || (pos >= filePos->end)) { break; }
+				if (m->endOfPart(inFASTA, filePos->end)) { break; }
 			#else
 				if (inFASTA.eof()) { break; }
 			#endif
@@ -21,6 +21,7 @@
 #include "knn.h"
 #include "kmertree.h"
 #include "aligntree.h"
+#include "workqueue.h"
 
 
 //KNN and Wang methods modeled from algorithms in
@@ -60,6 +61,16 @@ private:
 		unsigned long long end;
 		linePair(unsigned long long i, unsigned long long j) : start(i), end(j) {}
 	};
+	
+	//a run of sequences read from the fasta file, classified by one of the worker threads and written out in file order
+	struct classifyBatch {
+		vector<Sequence> seqs;
+		vector<string> taxonomy, simpleTax, messages;
+		vector<bool> flipped;
+		unsigned long long firstSeq;    //number of seqs[0] in the fasta file, the bootstraps are seeded from it
+		bool classified;
+		classifyBatch() : firstSeq(0), classified(false) {}
+	};
 
 	vector<int> processIDS;   //processid
 	vector<linePair*> lines;
@@ -74,6 +85,11 @@ private:
 	Classify* classify;
 	ReferenceDB* rdb;
 	
+	vector<classifyBatch> batches;
+	mutex batchLock;
+	condition_variable batchDone;
+	unsigned int bootstrapSeed;
+	
 	string fastaFileName, templateFileName, countfile, distanceFileName, namefile, search, method, taxonomyFileName, outputDir, groupfile;
 	int processors, kmerSize, numWanted, cutoff, iters;
 	float match, misMatch, gapOpen, gapExtend;
@@ -81,6 +97,8 @@ private:
 	
 	int driver(linePair*, string, string, string, string);
 	int createProcesses(string, string, string, string); 
+	int createThreads(Bayesian*, string, string, string, string);
+	void classifyWorker(int, Bayesian*, WorkQueue*);
 	string addUnclassifieds(string, int);
 	
 	int MPIReadNamesFile(string);
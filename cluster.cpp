@@ -60,8 +60,8 @@ void Cluster::clusterNames(){
 void Cluster::update(double& cutOFF){
 	try {
         smallCol = dMatrix->getSmallestCell(smallRow);
-        nColCells = dMatrix->seqVec[smallCol].size();
-        nRowCells = dMatrix->seqVec[smallRow].size();
+        nColCells = dMatrix->getNumCells(smallCol);
+        nRowCells = dMatrix->getNumCells(smallRow);
         
 		vector<int> foundCol(nColCells, 0);
         //cout << dMatrix->getNNodes() << " small cell: " << smallRow << '\t' << smallCol << endl;
@@ -72,26 +72,24 @@ void Cluster::update(double& cutOFF){
             if (m->control_pressed) { break; }
              
 			//if you are not the smallCell
-			if (dMatrix->seqVec[smallRow][i].index != smallCol) { 
-                search = dMatrix->seqVec[smallRow][i].index;
+			if (dMatrix->getIndex(smallRow, i) != smallCol) { 
+                search = dMatrix->getIndex(smallRow, i);
                 
 				bool merged = false;
 				for (int j=0;j<nColCells;j++) {
                     
-					if (dMatrix->seqVec[smallCol][j].index != smallRow) {  //if you are not the smallest distance
-						if (dMatrix->seqVec[smallCol][j].index == search) {
+					if (dMatrix->getIndex(smallCol, j) != smallRow) {  //if you are not the smallest distance
+						if (dMatrix->getIndex(smallCol, j) == search) {
 							foundCol[j] = 1;
 							merged = true;
-							changed = updateDistance(dMatrix->seqVec[smallCol][j], dMatrix->seqVec[smallRow][i]);
-                            dMatrix->updateCellCompliment(smallCol, j);
+							changed = updateCell(j, i);
 							break;
-						}else if (dMatrix->seqVec[smallCol][j].index < search) { //we don't have a distance for this cell
+						}else if (dMatrix->getIndex(smallCol, j) < search) { //we don't have a distance for this cell
                             if (adjust != -1.0) { //adjust
                                 merged = true;
                                 PDistCell value(search, adjust); //create a distance for the missing value
                                 int location = dMatrix->addCellSorted(smallCol, value);
-                                changed = updateDistance(dMatrix->seqVec[smallCol][location], dMatrix->seqVec[smallRow][i]);
-                                dMatrix->updateCellCompliment(smallCol, location);
+                                changed = updateCell(location, i);
                                 nColCells++;
                                 foundCol.push_back(0); //add a new found column
                                 //adjust value
@@ -104,8 +102,8 @@ void Cluster::update(double& cutOFF){
 				}
 				//if not merged it you need it for warning 
 				if ((!merged) && (method == "average" || method == "weighted")) {  
-					if (cutOFF > dMatrix->seqVec[smallRow][i].dist) {  
-						cutOFF = dMatrix->seqVec[smallRow][i].dist;
+					if (cutOFF > dMatrix->getDist(smallRow, i)) {  
+						cutOFF = dMatrix->getDist(smallRow, i);
                         //cout << "changing cutoff to " << cutOFF << endl;
 					}
                     
@@ -122,13 +120,15 @@ void Cluster::update(double& cutOFF){
 			if (foundCol[i] == 0) {
                 if (adjust != -1.0) { //adjust
                     PDistCell value(smallCol, adjust); //create a distance for the missing value
-                    changed = updateDistance(dMatrix->seqVec[smallCol][i], value);
+                    PDistCell colCell = dMatrix->getCell(smallCol, i);
+                    changed = updateDistance(colCell, value);
+                    dMatrix->setDist(smallCol, i, colCell.dist);
                     dMatrix->updateCellCompliment(smallCol, i);
                 }else {
                     if (method == "average" || method == "weighted") {
-                        if (dMatrix->seqVec[smallCol][i].index != smallRow) { //if you are not hte smallest distance 
-                            if (cutOFF > dMatrix->seqVec[smallCol][i].dist) {  
-                                cutOFF = dMatrix->seqVec[smallCol][i].dist;  
+                        if (dMatrix->getIndex(smallCol, i) != smallRow) { //if you are not hte smallest distance 
+                            if (cutOFF > dMatrix->getDist(smallCol, i)) {  
+                                cutOFF = dMatrix->getDist(smallCol, i);  
                             }
                         }
                     }
@@ -144,6 +144,25 @@ void Cluster::update(double& cutOFF){
 	}
 }
 /***********************************************************************/
+//merges the row cell into the col cell, the matrix stores the distances apart so the cells are copied out and the new distance written back
+bool Cluster::updateCell(ull colCellIndex, ull rowCellIndex){
+	try {
+        PDistCell colCell = dMatrix->getCell(smallCol, colCellIndex);
+        PDistCell rowCell = dMatrix->getCell(smallRow, rowCellIndex);
+        
+        bool changed = updateDistance(colCell, rowCell);
+        
+        dMatrix->setDist(smallCol, colCellIndex, colCell.dist);
+        dMatrix->updateCellCompliment(smallCol, colCellIndex);
+        
+        return changed;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Cluster", "updateCell");
+		exit(1);
+	}
+}
+/***********************************************************************/
 void Cluster::setMapWanted(bool f)  {  
 	try {
 		mapWanted = f;
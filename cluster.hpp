@@ -22,6 +22,7 @@ public:
     
 protected:	    
 	virtual bool updateDistance(PDistCell& colCell, PDistCell& rowCell) = 0;
+    bool updateCell(ull, ull);
     
 	virtual void clusterBins();
 	virtual void clusterNames();
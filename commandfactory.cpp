@@ -151,6 +151,7 @@
 #include "sracommand.h"
 #include "mergesfffilecommand.h"
 #include "getmimarkspackagecommand.h"
+#include "convertdistcommand.h"
 
 /*******************************************************/
 
@@ -325,6 +326,7 @@ CommandFactory::CommandFactory(){
     commands["sra"]                 = "sra";
     commands["merge.sfffiles"]      = "merge.sfffiles";
     commands["get.mimarkspackage"]  = "get.mimarkspackage";
+    commands["convert.dist"]        = "convert.dist";
     
 
 }
@@ -555,6 +557,7 @@ Command* CommandFactory::getCommand(string commandName, string optionString){
         else if(commandName == "sra")                   {	command = new SRACommand(optionString);                     }
         else if(commandName == "merge.sfffiles")        {	command = new MergeSfffilesCommand(optionString);           }
         else if(commandName == "get.mimarkspackage")    {	command = new GetMIMarksPackageCommand(optionString);       }
+        else if(commandName == "convert.dist")          {	command = new ConvertDistCommand(optionString);             }
 		else											{	command = new NoCommand(optionString);						}
 
 		return command;
@@ -726,6 +729,7 @@ Command* CommandFactory::getCommand(string commandName, string optionString, str
         else if(commandName == "sra")                   {	pipecommand = new SRACommand(optionString);                     }
         else if(commandName == "merge.sfffiles")        {	pipecommand = new MergeSfffilesCommand(optionString);           }
         else if(commandName == "get.mimarkspackage")    {	pipecommand = new GetMIMarksPackageCommand(optionString);       }
+        else if(commandName == "convert.dist")          {	pipecommand = new ConvertDistCommand(optionString);             }
 		else											{	pipecommand = new NoCommand(optionString);						}
 
 		return pipecommand;
@@ -883,6 +887,7 @@ Command* CommandFactory::getCommand(string commandName){
         else if(commandName == "sra")                   {	shellcommand = new SRACommand();                    }
         else if(commandName == "merge.sfffiles")        {	shellcommand = new MergeSfffilesCommand();          }
         else if(commandName == "get.mimarkspackage")    {	shellcommand = new GetMIMarksPackageCommand();      }
+        else if(commandName == "convert.dist")          {	shellcommand = new ConvertDistCommand();            }
 		else											{	shellcommand = new NoCommand();						}
 
 		return shellcommand;
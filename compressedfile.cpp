@@ -0,0 +1,443 @@
+//
+//  compressedfile.cpp
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+#include "compressedfile.h"
+#include "mothurout.h"
+
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+#ifdef USE_COMPRESSION
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <zlib.h>
+#ifdef USE_ZSTD
+	#include <zstd.h>
+#endif
+
+mutex CompressedFile::threadsLock;
+vector<compressionThread> CompressedFile::writers;
+vector<compressionThread> CompressedFile::readers;
+set<thread::id> CompressedFile::ended;
+atomic<bool> CompressedFile::stopping(false);
+bool CompressedFile::finishAtExit = false;
+
+static const int compressionBufferSize = 131072;
+
+/**************************************************************************************************/
+string CompressedFile::getFormat(string fileName) {
+	try {
+		unsigned char magic[4] = { 0, 0, 0, 0 };
+		ifstream in(fileName.c_str(), ios::binary);
+		if (!in) { return ""; }
+		in.read((char*)magic, 4);
+		in.close();
+
+		if ((magic[0] == 0x1f) && (magic[1] == 0x8b))											{	return "gzip";	}
+		if ((magic[0] == 0x28) && (magic[1] == 0xb5) && (magic[2] == 0x2f) && (magic[3] == 0xfd))	{	return "zstd";	}
+		if ((magic[0] == 'B') && (magic[1] == 'Z') && (magic[2] == 'h'))						{	return "bzip2";	}
+
+		return "";
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "CompressedFile", "getFormat");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+string CompressedFile::getOutputFormat(string fileName) {
+	try {
+		string extension = "";
+		if (fileName.find_last_of('.') != string::npos) { extension = fileName.substr(fileName.find_last_of('.')); }
+
+		if (extension == ".gz")			{	return "gzip";	}
+		else if (extension == ".zst")	{	return "zstd";	}
+		else if (extension == ".bz2")	{	return "bzip2";	}
+
+		return "";
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "CompressedFile", "getOutputFormat");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//the pipe is made inside a new directory only this user can open, so no other process can take its name first
+string CompressedFile::makePipe() {
+	try {
+		MothurOut* m = MothurOut::getInstance();
+
+		string tempDir = "/tmp";
+		if ((getenv("TMPDIR") != NULL) && (string(getenv("TMPDIR")) != "")) { tempDir = getenv("TMPDIR"); }
+
+		string pattern = tempDir + "/mothur.XXXXXX";
+		vector<char> dirName(pattern.begin(), pattern.end()); dirName.push_back('\0');
+		if (mkdtemp(&dirName[0]) == NULL) {
+			m->mothurOut("[ERROR]: Could not make a directory in " + tempDir + " for a pipe: " + strerror(errno) + ".\n"); return "";
+		}
+
+		string pipeName = string(&dirName[0]) + "/pipe";
+		if (mkfifo(pipeName.c_str(), 0600) == -1) {
+			m->mothurOut("[ERROR]: Could not make the pipe " + pipeName + ": " + strerror(errno) + ".\n");
+			rmdir(&dirName[0]);
+			return "";
+		}
+
+		return pipeName;
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "CompressedFile", "makePipe");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//once both ends are open the pipe and its directory are no longer needed
+void CompressedFile::removePipe(string pipeName) {
+	try {
+		unlink(pipeName.c_str());
+		rmdir(pipeName.substr(0, pipeName.find_last_of('/')).c_str());
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "CompressedFile", "removePipe");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+string CompressedFile::startReading(string fileName) {
+	try {
+		joinEnded();
+
+		string pipeName = makePipe();
+		if (pipeName == "") { return ""; }
+
+		startThread(readers, &CompressedFile::decompress, fileName, pipeName, getFormat(fileName));
+
+		return pipeName;
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "CompressedFile", "startReading");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+string CompressedFile::startWriting(string fileName) {
+	try {
+		waitFor(fileName);
+		joinEnded();
+
+		string pipeName = makePipe();
+		if (pipeName == "") { return ""; }
+
+		startThread(writers, &CompressedFile::compress, fileName, pipeName, getOutputFormat(fileName));
+
+		return pipeName;
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "CompressedFile", "startWriting");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void CompressedFile::startThread(vector<compressionThread>& threads, void (*task)(string, string, string), string fileName, string pipeName, string format) {
+	try {
+		lock_guard<mutex> guard(threadsLock);
+
+		//forked children inherit the handler, so a child that calls exit joins the threads it started too
+		if (!finishAtExit) { atexit(&CompressedFile::finish); finishAtExit = true; }
+
+		compressionThread started;
+		started.fileName = fileName;
+		started.owner = getpid();
+		started.worker = new thread(&CompressedFile::run, task, fileName, pipeName, format);
+		threads.push_back(started);
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "CompressedFile", "startThread");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//runs compress or decompress on its own thread, then marks the thread ended so the next file opened joins it
+void CompressedFile::run(void (*task)(string, string, string), string fileName, string pipeName, string format) {
+	try {
+		//the other end of the pipe can be closed early, so writing to it returns an error instead of raising a signal
+		sigset_t blocked;
+		sigemptyset(&blocked);
+		sigaddset(&blocked, SIGPIPE);
+		pthread_sigmask(SIG_BLOCK, &blocked, NULL);
+
+		task(fileName, pipeName, format);
+
+		lock_guard<mutex> guard(threadsLock);
+		ended.insert(this_thread::get_id());
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "CompressedFile", "run");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//a forked child has copies of its parent's entries but not their threads, so it leaves them alone
+void CompressedFile::joinThreads(vector<compressionThread>& done) {
+	try {
+		for (int i = 0; i < done.size(); i++) {
+			if (done[i].owner != getpid()) { continue; }
+			if (done[i].worker->get_id() == this_thread::get_id()) { continue; } //exit was called on this thread
+
+			thread::id id = done[i].worker->get_id();
+			done[i].worker->join();
+			delete done[i].worker;
+
+			lock_guard<mutex> guard(threadsLock);
+			ended.erase(id);
+		}
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "CompressedFile", "joinThreads");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//joins the threads that have already returned, a reader's returns once its stream is closed or the file is read
+void CompressedFile::joinEnded() {
+	try {
+		vector<compressionThread> done;
+		{
+			lock_guard<mutex> guard(threadsLock);
+			for (int i = 0; i < readers.size(); i++) {
+				if (ended.count(readers[i].worker->get_id()) != 0) { done.push_back(readers[i]); readers.erase(readers.begin()+i); i--; }
+			}
+			for (int i = 0; i < writers.size(); i++) {
+				if (ended.count(writers[i].worker->get_id()) != 0) { done.push_back(writers[i]); writers.erase(writers.begin()+i); i--; }
+			}
+		}
+
+		joinThreads(done);
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "CompressedFile", "joinEnded");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//the ofstream writing the file must be closed first
+void CompressedFile::waitFor(string fileName) {
+	try {
+		vector<compressionThread> done;
+		{
+			lock_guard<mutex> guard(threadsLock);
+			for (int i = 0; i < writers.size(); i++) {
+				if (writers[i].fileName == fileName) { done.push_back(writers[i]); writers.erase(writers.begin()+i); i--; }
+			}
+		}
+
+		joinThreads(done);
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "CompressedFile", "waitFor");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//a closed stream is always read or written to its end, stopping only matters for one still open when mothur exits
+void CompressedFile::finish() {
+	try {
+		vector<compressionThread> done;
+		{
+			lock_guard<mutex> guard(threadsLock);
+			done.swap(writers);
+			done.insert(done.end(), readers.begin(), readers.end());
+			readers.clear();
+		}
+
+		stopping = true;
+		joinThreads(done);
+		stopping = false;
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "CompressedFile", "finish");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//false once the stream reading the pipe has been closed
+bool CompressedFile::writeAll(int fd, const char* data, unsigned long long length) {
+	while (length != 0) {
+		ssize_t written = write(fd, data, length);
+		if (written < 0) {
+			if (errno == EINTR) { continue; }
+			if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) { return false; }
+			if (stopping) { return false; }
+
+			struct pollfd waiting = { fd, POLLOUT, 0 };
+			poll(&waiting, 1, 100);
+			continue;
+		}
+		data += written; length -= written;
+	}
+	return true;
+}
+/**************************************************************************************************/
+//waits for data, returns 0 at the end of the pipe
+long long CompressedFile::readSome(int fd, char* data, unsigned long long length) {
+	while (true) {
+		ssize_t numRead = read(fd, data, length);
+		if (numRead >= 0) { return numRead; }
+		if (errno == EINTR) { continue; }
+		if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) { return -1; }
+		if (stopping) { return 0; }
+
+		struct pollfd waiting = { fd, POLLIN, 0 };
+		poll(&waiting, 1, 100);
+	}
+}
+/**************************************************************************************************/
+//runs on its own thread and writes the decompressed file into the pipe
+void CompressedFile::decompress(string fileName, string pipeName, string format) {
+	try {
+		MothurOut* m = MothurOut::getInstance();
+
+		//waits for the stream to open the pipe, then stops blocking so finish can give up on a stream left open
+		int fd = open(pipeName.c_str(), O_WRONLY);
+		removePipe(pipeName);
+		if (fd == -1) { return; }
+		fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+		vector<char> buffer(compressionBufferSize);
+
+		if (format == "gzip") {
+			gzFile in = gzopen(fileName.c_str(), "rb");
+			if (in == NULL) { m->mothurOut("[ERROR]: Could not decompress " + fileName + ".\n"); close(fd); return; }
+			gzbuffer(in, compressionBufferSize);
+
+			while (true) {
+				int numRead = gzread(in, &buffer[0], compressionBufferSize);
+				if (numRead < 0) { m->mothurOut("[ERROR]: " + fileName + " is not a complete gzip file.\n"); break; }
+				if (numRead == 0) { break; }
+				if (!writeAll(fd, &buffer[0], numRead)) { break; }
+			}
+			gzclose(in);
+		}
+#ifdef USE_ZSTD
+		else if (format == "zstd") {
+			FILE* in = fopen(fileName.c_str(), "rb");
+			if (in == NULL) { m->mothurOut("[ERROR]: Could not decompress " + fileName + ".\n"); close(fd); return; }
+
+			ZSTD_DStream* stream = ZSTD_createDStream();
+			ZSTD_initDStream(stream);
+			vector<char> decompressed(ZSTD_DStreamOutSize());
+
+			bool good = true;
+			size_t numRead;
+			while (good && ((numRead = fread(&buffer[0], 1, compressionBufferSize, in)) > 0)) {
+				ZSTD_inBuffer input = { &buffer[0], numRead, 0 };
+				while (input.pos < input.size) {
+					ZSTD_outBuffer output = { &decompressed[0], decompressed.size(), 0 };
+					size_t result = ZSTD_decompressStream(stream, &output, &input);
+					if (ZSTD_isError(result)) { m->mothurOut("[ERROR]: " + fileName + " is not a complete zstd file.\n"); good = false; break; }
+					if (!writeAll(fd, &decompressed[0], output.pos)) { good = false; break; }
+				}
+			}
+			ZSTD_freeDStream(stream);
+			fclose(in);
+		}
+#endif
+		else {
+			string command = "bzcat '" + fileName + "'";
+			if (format == "zstd") { command = "zstd -dcq '" + fileName + "'"; }
+
+			FILE* in = popen(command.c_str(), "r");
+			if (in == NULL) { m->mothurOut("[ERROR]: Could not decompress " + fileName + ".\n"); close(fd); return; }
+
+			size_t numRead;
+			while ((numRead = fread(&buffer[0], 1, compressionBufferSize, in)) > 0) {
+				if (!writeAll(fd, &buffer[0], numRead)) { break; }
+			}
+			pclose(in);
+		}
+		close(fd);
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "CompressedFile", "decompress");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//runs on its own thread and compresses what is written to the pipe into the file
+void CompressedFile::compress(string fileName, string pipeName, string format) {
+	try {
+		MothurOut* m = MothurOut::getInstance();
+
+		//waits for the stream to open the pipe, then stops blocking so finish can give up on a stream left open
+		int fd = open(pipeName.c_str(), O_RDONLY);
+		removePipe(pipeName);
+		if (fd == -1) { return; }
+		fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+		vector<char> buffer(compressionBufferSize);
+		long long numRead;
+
+		if (format == "gzip") {
+			gzFile out = gzopen(fileName.c_str(), "wb6");
+			if (out == NULL) { m->mothurOut("[ERROR]: Could not open " + fileName + ".\n"); close(fd); return; }
+			gzbuffer(out, compressionBufferSize);
+
+			while ((numRead = readSome(fd, &buffer[0], compressionBufferSize)) > 0) { gzwrite(out, &buffer[0], numRead); }
+			gzclose(out);
+		}
+#ifdef USE_ZSTD
+		else if (format == "zstd") {
+			FILE* out = fopen(fileName.c_str(), "wb");
+			if (out == NULL) { m->mothurOut("[ERROR]: Could not open " + fileName + ".\n"); close(fd); return; }
+			setvbuf(out, NULL, _IONBF, 0); //a child forked while this is buffered would write it again when it exits
+
+			ZSTD_CStream* stream = ZSTD_createCStream();
+			ZSTD_initCStream(stream, 3);
+			vector<char> compressed(ZSTD_CStreamOutSize());
+
+			while ((numRead = readSome(fd, &buffer[0], compressionBufferSize)) > 0) {
+				ZSTD_inBuffer input = { &buffer[0], (size_t)numRead, 0 };
+				while (input.pos < input.size) {
+					ZSTD_outBuffer output = { &compressed[0], compressed.size(), 0 };
+					ZSTD_compressStream(stream, &output, &input);
+					fwrite(&compressed[0], 1, output.pos, out);
+				}
+			}
+
+			size_t remaining;
+			do {
+				ZSTD_outBuffer output = { &compressed[0], compressed.size(), 0 };
+				remaining = ZSTD_endStream(stream, &output);
+				fwrite(&compressed[0], 1, output.pos, out);
+			} while ((remaining != 0) && !ZSTD_isError(remaining));
+
+			ZSTD_freeCStream(stream);
+			fclose(out);
+		}
+#endif
+		else {
+			string command = "bzip2 -c > '" + fileName + "'";
+			if (format == "zstd") { command = "zstd -qc > '" + fileName + "'"; }
+
+			FILE* out = popen(command.c_str(), "w");
+			if (out == NULL) { m->mothurOut("[ERROR]: Could not open " + fileName + ".\n"); close(fd); return; }
+			setvbuf(out, NULL, _IONBF, 0);
+
+			while ((numRead = readSome(fd, &buffer[0], compressionBufferSize)) > 0) { fwrite(&buffer[0], 1, numRead, out); }
+			pclose(out);
+		}
+		close(fd);
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "CompressedFile", "compress");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+#endif
+#endif
@@ -0,0 +1,70 @@
+#ifndef Mothur_compressedfile_h
+#define Mothur_compressedfile_h
+
+//
+//  compressedfile.h
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+/* CompressedFile lets the ifstreams and ofstreams MothurOut opens read and write compressed files.  A compressed input
+ file is found by its first bytes, gzip or zstd, so the name doesn't matter.  A thread decompresses it into a named
+ pipe and the stream opens the pipe instead of the file, so every command reads the decompressed text without it ever
+ being written to disk.  An output file named .gz or .zst is written the other way round, a thread reads what the
+ stream writes to the pipe and compresses it into the file.  The threads are joined by finish, which main calls at the
+ end of the run and atexit calls when a forked child exits.
+
+ gzip is read and written with zlib.  zstd uses libzstd when mothur is made with USEZSTD=yes, and otherwise runs the
+ zstd program like .bz2 files run bzcat and bzip2.  Only unix-like systems have named pipes, so this is compiled with
+ USE_COMPRESSION on them. */
+
+#include "mothur.h"
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+/**************************************************************************************************/
+
+struct compressionThread {
+	string fileName;		//the compressed file
+	thread* worker;
+	pid_t owner;			//the process that started the thread, a forked child copies the entry but not the thread
+};
+
+/**************************************************************************************************/
+
+class CompressedFile {
+
+public:
+	static string getFormat(string);		//"gzip", "zstd", "bzip2" or "" if the file isn't compressed
+	static string getOutputFormat(string);	//the format the extension of an output file asks for, "" for none
+
+	static string startReading(string);		//the pipe to open instead of the compressed file
+	static string startWriting(string);		//the pipe to open instead of the file to compress into
+	static void waitFor(string);			//waits until the compressed file has been completely written
+	static void finish();					//waits for all the threads this process started, also run at exit
+
+private:
+	static mutex threadsLock;
+	static vector<compressionThread> writers;	//the files being compressed and their threads
+	static vector<compressionThread> readers;	//the files being decompressed and their threads
+	static set<thread::id> ended;				//threads that have returned but have not been joined
+	static atomic<bool> stopping;				//set by finish, so a thread whose stream was never closed gives up
+	static bool finishAtExit;
+
+	static string makePipe();
+	static void removePipe(string);
+	static void startThread(vector<compressionThread>&, void (*)(string, string, string), string, string, string);
+	static void run(void (*)(string, string, string), string, string, string);
+	static void joinThreads(vector<compressionThread>&);
+	static void joinEnded();
+	static void decompress(string, string, string);
+	static void compress(string, string, string);
+	static bool writeAll(int, const char*, unsigned long long);
+	static long long readSome(int, char*, unsigned long long);
+};
+
+/**************************************************************************************************/
+
+#endif
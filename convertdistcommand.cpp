@@ -0,0 +1,527 @@
+//
+//  convertdistcommand.cpp
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+#include "convertdistcommand.h"
+#include "binarydist.h"
+
+//**********************************************************************************************************************
+vector<string> ConvertDistCommand::setParameters(){
+	try {
+		CommandParameter pphylip("phylip", "InputTypes", "", "", "PhylipColumnBinary", "PhylipColumnBinary", "none","binary",false,false,true); parameters.push_back(pphylip);
+        CommandParameter pcolumn("column", "InputTypes", "", "", "PhylipColumnBinary", "PhylipColumnBinary", "none","binary",false,false,true); parameters.push_back(pcolumn);
+        CommandParameter pbinary("binary", "InputTypes", "", "", "PhylipColumnBinary", "PhylipColumnBinary", "none","phylip-column",false,false,true); parameters.push_back(pbinary);
+		CommandParameter poutput("output", "Multiple", "column-lt-square-phylip-binary", "binary", "", "", "","phylip-column-binary",false,false,true); parameters.push_back(poutput);
+		CommandParameter pcutoff("cutoff", "Number", "", "-1", "", "", "","",false,false); parameters.push_back(pcutoff);
+		CommandParameter phalfprecision("halfprecision", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(phalfprecision);
+		CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
+		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
+
+		vector<string> myArray;
+		for (int i = 0; i < parameters.size(); i++) {	myArray.push_back(parameters[i].name);		}
+		return myArray;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ConvertDistCommand", "setParameters");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+string ConvertDistCommand::getHelpString(){
+	try {
+		string helpString = "";
+		helpString += "The convert.dist command converts a distance matrix between the column, phylip and binary (.dist.bin) formats.\n";
+		helpString += "The convert.dist command parameters are phylip, column, binary, output, cutoff and halfprecision. You must provide one of the phylip, column or binary parameters.\n";
+		helpString += "The output parameter allows you to specify the format of the new distance matrix. Options are column, lt, square and binary. The default is binary.\n";
+		helpString += "The cutoff parameter allows you to leave out distances above the cutoff. By default all distances are kept.\n";
+		helpString += "The halfprecision parameter allows you to store the binary distances as 16 bit floats, which halves their size but keeps about 3 significant digits.  The default is false.\n";
+		helpString += "A binary matrix only holds the distances it was given, so when it is converted to lt or square the missing distances are written as 1.0.\n";
+		helpString += "The convert.dist command should be in the following format: convert.dist(column=yourColumnFile, output=binary).\n";
+		helpString += "Example convert.dist(column=final.dist, output=binary).\n";
+		helpString += "Note: No spaces between parameter labels (i.e. column), '=' and parameters (i.e.final.dist).\n";
+		return helpString;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ConvertDistCommand", "getHelpString");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+string ConvertDistCommand::getOutputPattern(string type) {
+    try {
+        string pattern = "";
+
+        if (type == "phylip")           {   pattern = "[filename],[outputtag],dist";    }
+        else if (type == "column")      {   pattern = "[filename],dist";                }
+        else if (type == "binary")      {   pattern = "[filename],dist,bin";            }
+        else { m->mothurOut("[ERROR]: No definition for type " + type + " output pattern.\n"); m->control_pressed = true;  }
+
+        return pattern;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "ConvertDistCommand", "getOutputPattern");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+ConvertDistCommand::ConvertDistCommand(){
+	try {
+		abort = true; calledHelp = true;
+		setParameters();
+		vector<string> tempOutNames;
+		outputTypes["phylip"] = tempOutNames;
+		outputTypes["column"] = tempOutNames;
+		outputTypes["binary"] = tempOutNames;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ConvertDistCommand", "ConvertDistCommand");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+ConvertDistCommand::ConvertDistCommand(string option)  {
+	try {
+		abort = false; calledHelp = false;
+
+		//allow user to run help
+		if(option == "help") { help(); abort = true; calledHelp = true; }
+		else if(option == "citation") { citation(); abort = true; calledHelp = true;}
+
+		else {
+			vector<string> myArray = setParameters();
+
+			OptionParser parser(option);
+			map<string,string> parameters = parser.getParameters();
+
+			ValidParameters validParameter;
+			map<string,string>::iterator it;
+
+			//check to make sure all parameters are valid for command
+			for (it = parameters.begin(); it != parameters.end(); it++) {
+				if (validParameter.isValidParameter(it->first, myArray, it->second) != true) {  abort = true;  }
+			}
+
+			//initialize outputTypes
+			vector<string> tempOutNames;
+			outputTypes["phylip"] = tempOutNames;
+			outputTypes["column"] = tempOutNames;
+			outputTypes["binary"] = tempOutNames;
+
+			//if the user changes the output directory command factory will send this info to us in the output parameter
+			outputDir = validParameter.validFile(parameters, "outputdir", false);		if (outputDir == "not found"){	outputDir = "";		}
+
+			//if the user changes the input directory command factory will send this info to us in the output parameter
+			string inputDir = validParameter.validFile(parameters, "inputdir", false);
+			if (inputDir == "not found"){	inputDir = "";		}
+			else {
+				string path;
+				it = parameters.find("phylip");
+				//user has given a template file
+				if(it != parameters.end()){
+					path = m->hasPath(it->second);
+					//if the user has not given a path then, add inputdir. else leave path alone.
+					if (path == "") {	parameters["phylip"] = inputDir + it->second;		}
+				}
+
+				it = parameters.find("column");
+				//user has given a template file
+				if(it != parameters.end()){
+					path = m->hasPath(it->second);
+					//if the user has not given a path then, add inputdir. else leave path alone.
+					if (path == "") {	parameters["column"] = inputDir + it->second;		}
+				}
+
+                it = parameters.find("binary");
+				//user has given a template file
+				if(it != parameters.end()){
+					path = m->hasPath(it->second);
+					//if the user has not given a path then, add inputdir. else leave path alone.
+					if (path == "") {	parameters["binary"] = inputDir + it->second;		}
+				}
+            }
+
+			phylipfile = validParameter.validFile(parameters, "phylip", true);
+			if (phylipfile == "not open") { phylipfile = ""; abort = true; }
+			else if (phylipfile == "not found") { phylipfile = ""; }
+			else { 	m->setPhylipFile(phylipfile); }
+
+			columnfile = validParameter.validFile(parameters, "column", true);
+			if (columnfile == "not open") { columnfile = ""; abort = true; }
+			else if (columnfile == "not found") { columnfile = ""; }
+			else {  m->setColumnFile(columnfile);	}
+
+			binaryfile = validParameter.validFile(parameters, "binary", true);
+			if (binaryfile == "not open") { binaryfile = ""; abort = true; }
+			else if (binaryfile == "not found") { binaryfile = ""; }
+
+			int numInputs = 0;
+			if (phylipfile != "") { numInputs++; }
+			if (columnfile != "") { numInputs++; }
+			if (binaryfile != "") { numInputs++; }
+
+			if (numInputs > 1) { m->mothurOut("You may only provide one of the phylip, column or binary parameters."); m->mothurOutEndLine(); abort = true; }
+			else if (numInputs == 0) {
+				//is there are current file available for either of these?
+				//give priority to column, then phylip
+				columnfile = m->getColumnFile();
+				if (columnfile != "") {  m->mothurOut("Using " + columnfile + " as input file for the column parameter."); m->mothurOutEndLine(); }
+				else {
+					phylipfile = m->getPhylipFile();
+					if (phylipfile != "") {  m->mothurOut("Using " + phylipfile + " as input file for the phylip parameter."); m->mothurOutEndLine(); }
+					else {
+						m->mothurOut("No valid current files. You must provide a phylip, column or binary file."); m->mothurOutEndLine();
+						abort = true;
+					}
+				}
+			}
+
+			if ((binaryfile != "") && !BinaryDistReader::isBinary(binaryfile)) { m->mothurOut(binaryfile + " is not a binary distance file."); m->mothurOutEndLine(); abort = true; }
+
+			output = validParameter.validFile(parameters, "output", false);		if(output == "not found"){	output = "binary"; }
+            if (output == "phylip") { output = "lt";  }
+			if ((output != "column") && (output != "lt") && (output != "square") && (output != "binary")) { m->mothurOut(output + " is not a valid output form. Options are column, lt, square and binary."); m->mothurOutEndLine(); abort = true; }
+
+			string temp = validParameter.validFile(parameters, "cutoff", false);		if(temp == "not found"){	temp = "-1"; }
+			m->mothurConvert(temp, cutoff);
+
+			temp = validParameter.validFile(parameters, "halfprecision", false);		if(temp == "not found"){  temp = "F"; }
+			halfPrecision = m->isTrue(temp);
+		}
+
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ConvertDistCommand", "ConvertDistCommand");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+
+int ConvertDistCommand::execute(){
+	try {
+
+		if (abort == true) { if (calledHelp) { return 0; }  return 2;	}
+
+		string inputFile = binaryfile;
+		if (phylipfile != "") { inputFile = phylipfile; }
+		else if (columnfile != "") { inputFile = columnfile; }
+
+		string thisOutputDir = outputDir;
+		if (outputDir == "") {  thisOutputDir += m->hasPath(inputFile);  }
+
+		//x.dist.bin becomes x.dist, so the root is x. like the column file it was made from
+		string simpleName = m->getSimpleName(inputFile);
+		if (binaryfile != "") { if (m->getExtension(simpleName) == ".bin") { simpleName = simpleName.substr(0, simpleName.length()-4); } }
+
+        map<string, string> variables;
+        variables["[filename]"] = thisOutputDir + m->getRootName(simpleName);
+
+		string outputFile = "";
+		if (output == "binary")			{ outputFile = getOutputFileName("binary", variables);	}
+		else if (output == "column")	{ outputFile = getOutputFileName("column", variables);	}
+		else {
+			if (output == "lt") { variables["[outputtag]"] = "phylip"; }
+			else { variables["[outputtag]"] = "square"; }
+			outputFile = getOutputFileName("phylip", variables);
+		}
+
+		if (outputFile == inputFile) { m->mothurOut("[ERROR]: " + inputFile + " is already in the " + output + " format."); m->mothurOutEndLine(); return 0; }
+
+		//text inputs are converted to binary first
+		string binaryFile = binaryfile;
+		if (binaryfile == "") {
+			if (output == "binary") { binaryFile = outputFile; }
+			else { binaryFile = outputFile + ".bin.temp"; }
+
+			if (phylipfile != "")	{ phylipToBinary(phylipfile, binaryFile);	}
+			else					{ columnToBinary(columnfile, binaryFile);	}
+		}
+
+		if (!m->control_pressed) {
+			if (output == "column")									{ binaryToColumn(binaryFile, outputFile);	}
+			else if ((output == "lt") || (output == "square"))		{ binaryToPhylip(binaryFile, outputFile);	}
+		}
+
+		if (binaryFile != binaryfile) { if (binaryFile != outputFile) { m->mothurRemove(binaryFile); } }
+
+		if (m->control_pressed) { m->mothurRemove(outputFile); return 0; }
+
+		if (output == "binary")			{ outputTypes["binary"].push_back(outputFile);	}
+		else if (output == "column")	{ outputTypes["column"].push_back(outputFile);	}
+		else							{ outputTypes["phylip"].push_back(outputFile);	}
+		outputNames.push_back(outputFile);
+
+		m->mothurOutEndLine();
+		m->mothurOut("Output File names: "); m->mothurOutEndLine();
+		for (int i = 0; i < outputNames.size(); i++) {	m->mothurOut(outputNames[i]); m->mothurOutEndLine();	}
+		m->mothurOutEndLine();
+
+		//set phylip file as new current phylipfile
+		string current = "";
+		itTypes = outputTypes.find("phylip");
+		if (itTypes != outputTypes.end()) {
+			if ((itTypes->second).size() != 0) { current = (itTypes->second)[0]; m->setPhylipFile(current); }
+		}
+
+		itTypes = outputTypes.find("column");
+		if (itTypes != outputTypes.end()) {
+			if ((itTypes->second).size() != 0) { current = (itTypes->second)[0]; m->setColumnFile(current); }
+		}
+
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ConvertDistCommand", "execute");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+//each pair is kept once, in the row of the sequence found later in the file.  If the column file is square,
+//each pair is in it twice and only the one whose first sequence was found later is kept.
+int ConvertDistCommand::columnToBinary(string inputFile, string binaryFile){
+	try {
+		map<string, unsigned int> indexes;
+		map<string, unsigned int>::iterator itA, itB;
+		vector<string> names;
+		vector<unsigned long long> allCounts, lowerCounts;
+
+		bool square = false;
+		unsigned int refRow = 0, refCol = 0; bool foundRef = false;	//like ReadColumnMatrix, a square file has the transpose of its first distance
+
+		string firstName, secondName;
+		float distance;
+
+		ifstream in;
+		m->openInputFile(inputFile, in);
+
+		while (!in.eof()) {
+			if (m->control_pressed) { in.close(); return 0; }
+
+			in >> firstName >> secondName >> distance; m->gobble(in);
+
+			itA = indexes.find(firstName);
+			if (itA == indexes.end()) { itA = indexes.insert(make_pair(firstName, (unsigned int)names.size())).first; names.push_back(firstName); allCounts.push_back(0); lowerCounts.push_back(0); }
+			itB = indexes.find(secondName);
+			if (itB == indexes.end()) { itB = indexes.insert(make_pair(secondName, (unsigned int)names.size())).first; names.push_back(secondName); allCounts.push_back(0); lowerCounts.push_back(0); }
+
+			unsigned int a = itA->second; unsigned int b = itB->second;
+			if (a == b) { continue; }
+			if ((cutoff >= 0) && (distance > cutoff)) { continue; }
+
+			if (!foundRef) { refRow = a; refCol = b; foundRef = true; }
+			else if ((a == refCol) && (b == refRow)) { square = true; }
+
+			allCounts[max(a, b)]++;
+			if (a > b) { lowerCounts[a]++; }
+		}
+		in.close();
+
+		//place the distances by row
+		vector<unsigned long long>& counts = square ? lowerCounts : allCounts;
+		vector<unsigned long long> rowStart(names.size()+1, 0);
+		for (int i = 0; i < names.size(); i++) { rowStart[i+1] = rowStart[i] + counts[i]; }
+		vector<unsigned int> cols(rowStart[names.size()]);
+		vector<float> dists(rowStart[names.size()]);
+		vector<unsigned long long> next(rowStart.begin(), rowStart.end()-1);
+
+		m->openInputFile(inputFile, in);
+		while (!in.eof()) {
+			if (m->control_pressed) { in.close(); return 0; }
+
+			in >> firstName >> secondName >> distance; m->gobble(in);
+
+			unsigned int a = indexes[firstName]; unsigned int b = indexes[secondName];
+			if (a == b) { continue; }
+			if ((cutoff >= 0) && (distance > cutoff)) { continue; }
+			if (square && (a < b)) { continue; }
+
+			unsigned int row = max(a, b);
+			cols[next[row]] = min(a, b);
+			dists[next[row]] = distance;
+			next[row]++;
+		}
+		in.close();
+
+		float fileCutoff = cutoff;
+		if (cutoff < 0) { fileCutoff = 1.0; }
+		BinaryDistWriter out(binaryFile, names, fileCutoff, halfPrecision);
+		for (int i = 0; i < names.size(); i++) {
+			if (m->control_pressed) { break; }
+			for (unsigned long long k = rowStart[i]; k < rowStart[i+1]; k++) { out.addDist(i, cols[k], dists[k]); }
+		}
+		out.close();
+
+		m->mothurOut("Converted " + toString(rowStart[names.size()]) + " distances between " + toString(names.size()) + " sequences."); m->mothurOutEndLine();
+
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ConvertDistCommand", "columnToBinary");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+int ConvertDistCommand::phylipToBinary(string inputFile, string binaryFile){
+	try {
+		ifstream in;
+		m->openInputFile(inputFile, in);
+
+		string numTest, name;
+		int nseqs;
+		in >> numTest >> name;
+
+		if (!m->isContainingOnlyDigits(numTest)) { m->mothurOut("[ERROR]: expected a number and got " + numTest + ", quitting."); m->mothurOutEndLine(); m->control_pressed = true; in.close(); return 0; }
+		else { convert(numTest, nseqs); }
+
+		//is the matrix square?
+		bool square = false;
+		char d;
+		while((d=in.get()) != EOF){
+			if(isalnum(d)){ square = true; break; }
+			if(d == '\n'){ square = false; break; }
+		}
+		in.close();
+
+		float fileCutoff = cutoff;
+		if (cutoff < 0) { fileCutoff = 1.0; }
+		BinaryDistWriter out(binaryFile, nseqs, fileCutoff, halfPrecision);
+
+		m->openInputFile(inputFile, in);
+		in >> numTest;
+
+		float distance;
+		unsigned long long count = 0;
+		for (int i = 0; i < nseqs; i++) {
+			in >> name;
+			out.setName(i, name);
+
+			int numDists = i;
+			if (square) { numDists = nseqs; }
+
+			for (int j = 0; j < numDists; j++) {
+				if (m->control_pressed) { in.close(); out.close(); return 0; }
+
+				in >> distance;
+				if (j >= i) { continue; }
+				if ((cutoff >= 0) && (distance > cutoff)) { continue; }
+
+				out.addDist(i, j, distance);
+				count++;
+			}
+		}
+		in.close();
+		out.close();
+
+		m->mothurOut("Converted " + toString(count) + " distances between " + toString(nseqs) + " sequences."); m->mothurOutEndLine();
+
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ConvertDistCommand", "phylipToBinary");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+int ConvertDistCommand::binaryToColumn(string binaryFile, string outputFile){
+	try {
+		BinaryDistReader reader(binaryFile);
+		if (!reader.good()) { m->control_pressed = true; return 0; }
+
+		vector<string> names = reader.getNames();
+
+		ofstream out;
+		m->openOutputFile(outputFile, out);
+		out.setf(ios::fixed, ios::showpoint);
+		out << setprecision(4);
+
+		for (unsigned long long i = 0; i < reader.getNumSeqs(); i++) {
+			if (m->control_pressed) { break; }
+
+			for (unsigned long long k = reader.getRowStart(i); k < reader.getRowEnd(i); k++) {
+				float distance = reader.getDist(k);
+				if ((cutoff >= 0) && (distance > cutoff)) { continue; }
+				out << names[i] << ' ' << names[reader.getCol(k)] << ' ' << distance << endl;
+			}
+		}
+		out.close();
+
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ConvertDistCommand", "binaryToColumn");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+int ConvertDistCommand::binaryToPhylip(string binaryFile, string outputFile){
+	try {
+		BinaryDistReader reader(binaryFile);
+		if (!reader.good()) { m->control_pressed = true; return 0; }
+
+		vector<string> names = reader.getNames();
+		unsigned long long nseqs = reader.getNumSeqs();
+
+		unsigned long long numPairs = nseqs * (nseqs - 1) / 2;
+		if ((nseqs != 0) && (reader.getNumDists() < numPairs)) {
+			m->mothurOut("[WARNING]: " + binaryFile + " only has " + toString(reader.getNumDists()) + " of the " + toString(numPairs) + " distances, the missing distances will be 1.0."); m->mothurOutEndLine();
+		}
+
+		//the upper triangle of the square matrix needs the distances by column, every row only has the columns below it
+		vector<unsigned long long> colStart;
+		vector<unsigned int> colRows;
+		vector<float> colDists;
+		if (output == "square") {
+			colStart.resize(nseqs+1, 0);
+			for (unsigned long long k = 0; k < reader.getNumDists(); k++) { colStart[reader.getCol(k)+1]++; }
+			for (unsigned long long i = 0; i < nseqs; i++) { colStart[i+1] += colStart[i]; }
+
+			colRows.resize(reader.getNumDists()); colDists.resize(reader.getNumDists());
+			vector<unsigned long long> next(colStart.begin(), colStart.end()-1);
+			for (unsigned long long i = 0; i < nseqs; i++) {
+				for (unsigned long long k = reader.getRowStart(i); k < reader.getRowEnd(i); k++) {
+					unsigned int col = reader.getCol(k);
+					colRows[next[col]] = i; colDists[next[col]] = reader.getDist(k); next[col]++;
+				}
+			}
+		}
+
+		ofstream out;
+		m->openOutputFile(outputFile, out);
+		out.setf(ios::fixed, ios::showpoint);
+		out << setprecision(4);
+
+		out << nseqs << endl;
+
+		vector<float> row;
+		for (unsigned long long i = 0; i < nseqs; i++) {
+			if (m->control_pressed) { break; }
+
+			int numDists = i;
+			if (output == "square") { numDists = nseqs; }
+
+			row.assign(numDists, 1.0);
+			if (output == "square") { row[i] = 0.0; }
+
+			for (unsigned long long k = reader.getRowStart(i); k < reader.getRowEnd(i); k++) { row[reader.getCol(k)] = reader.getDist(k); }
+			if (output == "square") { for (unsigned long long k = colStart[i]; k < colStart[i+1]; k++) { row[colRows[k]] = colDists[k]; } }
+
+			string name = names[i];
+			//pad with spaces to make compatible
+			if (name.length() < 10) { while (name.length() < 10) {  name += " ";  } }
+			out << name << '\t';
+
+			for (int j = 0; j < numDists; j++) { out << row[j] << '\t'; }
+			out << endl;
+		}
+		out.close();
+
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ConvertDistCommand", "binaryToPhylip");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
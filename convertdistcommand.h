@@ -0,0 +1,51 @@
+//
+//  convertdistcommand.h
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+#ifndef Mothur_convertdistcommand_h
+#define Mothur_convertdistcommand_h
+
+#include "command.hpp"
+
+/* converts distance matrices between the column, phylip and binary (.dist.bin) formats.
+ text files are converted to binary first, so every conversion goes through the same writers. */
+
+class ConvertDistCommand : public Command {
+
+public:
+
+	ConvertDistCommand(string);
+	ConvertDistCommand();
+	~ConvertDistCommand(){}
+
+	vector<string> setParameters();
+	string getCommandName()			{ return "convert.dist";			}
+	string getCommandCategory()		{ return "General";                 }
+
+	string getHelpString();
+    string getOutputPattern(string);
+	string getCitation() { return "http://www.mothur.org/wiki/Convert.dist"; }
+	string getDescription()		{ return "converts a distance matrix between the column, phylip and binary formats"; }
+
+
+	int execute();
+	void help() { m->mothurOut(getHelpString()); }
+
+
+private:
+	string phylipfile, columnfile, binaryfile, output, outputDir;
+	float cutoff;
+	bool abort, halfPrecision;
+	vector<string> outputNames;
+
+	int columnToBinary(string, string);
+	int phylipToBinary(string, string);
+	int binaryToColumn(string, string);
+	int binaryToPhylip(string, string);
+};
+
+
+#endif
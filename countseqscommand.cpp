@@ -540,7 +540,7 @@ int CountSeqsCommand::driver(unsigned long long start, unsigned long long end, s
         
         ifstream in;
 		m->openInputFile(namefile, in);
-		in.seekg(start);
+		if (start != 0) { in.seekg(start); }
         
 		bool done = false;
         int total = 0;
@@ -593,8 +593,7 @@ int CountSeqsCommand::driver(unsigned long long start, unsigned long long end, s
 			total += names.size();
             
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-            unsigned long long pos = in.tellg();
-            if ((pos == -1) || (pos >= end)) { break; }
+            if (m->endOfPart(in, end)) { break; }
 #else
             if (in.eof()) { break; }
 #endif
@@ -32,3 +32,33 @@ float Database::getSearchScore()	{	return searchScore;		}	//	we're assuming that
 int Database::getLongestBase()	{	return longest+1;		}	
 
 /**************************************************************************************************/
+//searches for the query and then its reverse complement, the child classes can do both in one search
+
+vector<int> Database::findClosestBothStrands(Sequence* candidateSeq, int num, bool& reversed){
+	try {
+		reversed = false;
+		
+		vector<int> forwardMatches = findClosestSequences(candidateSeq, num);
+		float forwardScore = searchScore;
+		vector<float> forwardScores = Scores;
+		
+		Sequence copy(candidateSeq->getName(), candidateSeq->getUnaligned());
+		copy.reverseComplement();
+		vector<int> reverseMatches = findClosestSequences(&copy, num);
+		
+		if ((reverseMatches.size() != 0) && ((forwardMatches.size() == 0) || (searchScore > forwardScore))) {
+			reversed = true;
+			return reverseMatches;
+		}
+		
+		searchScore = forwardScore;
+		Scores = forwardScores;
+		return forwardMatches;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Database", "findClosestBothStrands");
+		exit(1);
+	}	
+}
+
+/**************************************************************************************************/
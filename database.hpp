@@ -32,6 +32,11 @@ inline bool compareSeqMatches (seqMatch member, seqMatch member2){ //sorts large
 	}
 }
 /**************************************************************************************************/
+inline bool compareSeqMatchRank (const seqMatch& member, const seqMatch& member2){ //sorts largest to smallest, ties go to the lower index
+	if (member.match != member2.match) { return (member.match > member2.match); }
+	return (member.seq < member2.seq);
+}
+/**************************************************************************************************/
 inline bool compareSeqMatchesReverse (seqMatch member, seqMatch member2){ //sorts largest to smallest
 	if(member.match < member2.match){
 		return true;   }   
@@ -47,9 +52,10 @@ public:
 	Database();
 	virtual ~Database();
 	virtual void generateDB() = 0; 
-	virtual void addSequence(Sequence) = 0;  //add sequence to search engine
+	virtual void addSequence(const Sequence&) = 0;  //add sequence to search engine
 	virtual string getName(int) { return ""; }  
 	virtual vector<int> findClosestSequences(Sequence*, int) = 0;  // returns indexes of n closest sequences to query
+	virtual vector<int> findClosestBothStrands(Sequence*, int, bool&);  // returns indexes of n closest sequences to query or its reverse complement, sets the bool if the reverse complement was closer
 	virtual vector<int> findClosestMegaBlast(Sequence*, int, int){return results;}
 	virtual float getSearchScore();
 	virtual vector<float> getSearchScores() { return Scores; } //assumes you already called findClosestMegaBlast
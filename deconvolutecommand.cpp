@@ -220,8 +220,8 @@ int DeconvoluteCommand::execute() {
 		
 		if (m->control_pressed) { return 0; }
 		
-		ifstream in; 
-		m->openInputFile(inFastaName, in);
+		SeqReader reader(inFastaName, "fasta");
+		seqRecord record;
 		
 		ofstream outFasta;
 		m->openOutputFile(outFastaFile, outFasta);
@@ -232,11 +232,11 @@ int DeconvoluteCommand::execute() {
 		set<string>::iterator itname;
 		vector<string> nameFileOrder;
 		int count = 0;
-		while (!in.eof()) {
+		while (reader.getNext(record)) {
 			
-			if (m->control_pressed) { in.close(); outFasta.close(); m->mothurRemove(outFastaFile); return 0; }
+			if (m->control_pressed) { outFasta.close(); m->mothurRemove(outFastaFile); return 0; }
 			
-			Sequence seq(in);
+			Sequence& seq = record.seq;
 			
 			if (seq.getName() != "") {
 				
@@ -284,14 +284,11 @@ int DeconvoluteCommand::execute() {
 				count++;
 			}
 			
-			m->gobble(in);
-			
 			if(count % 1000 == 0)	{ m->mothurOutJustToScreen(toString(count) + "\t" + toString(sequenceStrings.size()) + "\n");	}
 		}
 		
 		if(count % 1000 != 0)	{ m->mothurOut(toString(count) + "\t" + toString(sequenceStrings.size())); m->mothurOutEndLine();	}
 		
-		in.close();
 		outFasta.close();
 		
 		if (m->control_pressed) { m->mothurRemove(outFastaFile); return 0; }
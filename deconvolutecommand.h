@@ -12,6 +12,7 @@
 #include "command.hpp"
 #include "fastamap.h"
 #include "counttable.h"
+#include "seqreader.h"
 
 /* The unique.seqs command reads a fasta file, finds the duplicate sequences and outputs a names file
 	containing 2 columns.  The first being the groupname and the second the list of identical sequence names. */ 
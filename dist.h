@@ -20,7 +20,9 @@ public:
 	Dist(){ dist = 0; m = MothurOut::getInstance(); }
 	Dist(const Dist& d) : dist(d.dist) { m = MothurOut::getInstance(); }
 	virtual ~Dist() {}
-	virtual void calcDist(Sequence, Sequence) = 0;
+	//the calculators declare using Dist::calcDist, so their calcDist(const char*, ...) does not hide this one
+	void calcDist(const Sequence& A, const Sequence& B) { calcDist(A.getAligned().c_str(), B.getAligned().c_str(), A.getAligned().length()); }
+	virtual void calcDist(const char*, const char*, int) = 0;	//the aligned bases of the two sequences and the alignment length
 	double getDist()	{	return dist;	}
 
 protected:
@@ -8,17 +8,19 @@
  */
 
 #include "distancecommand.h"
+#include "binarydist.h"
 
 //**********************************************************************************************************************
 vector<string> DistanceCommand::setParameters(){	
 	try {
 		CommandParameter pcolumn("column", "InputTypes", "", "", "none", "none", "OldFastaColumn","column",false,false); parameters.push_back(pcolumn);
 		CommandParameter poldfasta("oldfasta", "InputTypes", "", "", "none", "none", "OldFastaColumn","",false,false); parameters.push_back(poldfasta);
-		CommandParameter pfasta("fasta", "InputTypes", "", "", "none", "none", "none","phylip-column",false,true, true); parameters.push_back(pfasta);
-		CommandParameter poutput("output", "Multiple", "column-lt-square-phylip", "column", "", "", "","phylip-column",false,false, true); parameters.push_back(poutput);
+		CommandParameter pfasta("fasta", "InputTypes", "", "", "none", "none", "none","phylip-column-binary",false,true, true); parameters.push_back(pfasta);
+		CommandParameter poutput("output", "Multiple", "column-lt-square-phylip-binary", "column", "", "", "","phylip-column-binary",false,false, true); parameters.push_back(poutput);
 		CommandParameter pcalc("calc", "Multiple", "nogaps-eachgap-onegap", "onegap", "", "", "","",false,false); parameters.push_back(pcalc);
 		CommandParameter pcountends("countends", "Boolean", "", "T", "", "", "","",false,false); parameters.push_back(pcountends);
 		CommandParameter pcompress("compress", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pcompress);
+		CommandParameter phalfprecision("halfprecision", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(phalfprecision);
 		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false, true); parameters.push_back(pprocessors);
 		CommandParameter pcutoff("cutoff", "Number", "", "1.0", "", "", "","",false,false, true); parameters.push_back(pcutoff);
 		CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
@@ -38,13 +40,15 @@ string DistanceCommand::getHelpString(){
 	try {
 		string helpString = "";
 		helpString += "The dist.seqs command reads a file containing sequences and creates a distance file.\n";
-		helpString += "The dist.seqs command parameters are fasta, oldfasta, column, calc, countends, output, compress, cutoff and processors.  \n";
+		helpString += "The dist.seqs command parameters are fasta, oldfasta, column, calc, countends, output, compress, halfprecision, cutoff and processors.  \n";
 		helpString += "The fasta parameter is required, unless you have a valid current fasta file.\n";
 		helpString += "The oldfasta and column parameters allow you to append the distances calculated to the column file.\n";
 		helpString += "The calc parameter allows you to specify the method of calculating the distances.  Your options are: nogaps, onegap or eachgap. The default is onegap.\n";
 		helpString += "The countends parameter allows you to specify whether to include terminal gaps in distance.  Your options are: T or F. The default is T.\n";
 		helpString += "The cutoff parameter allows you to specify maximum distance to keep. The default is 1.0.\n";
-		helpString += "The output parameter allows you to specify format of your distance matrix. Options are column, lt, and square. The default is column.\n";
+		helpString += "The output parameter allows you to specify format of your distance matrix. Options are column, lt, square and binary. The default is column.\n";
+		helpString += "The binary output is a .dist.bin file holding the same distances as the column file. It is much smaller and faster to read, and can be given to the cluster and cluster.split commands as a column file.\n";
+		helpString += "The halfprecision parameter allows you to store the binary distances as 16 bit floats, which halves their size but keeps about 3 significant digits.  The default is false.\n";
 		helpString += "The processors parameter allows you to specify number of processors to use.  The default is 1.\n";
 		helpString += "The compress parameter allows you to indicate that you want the resulting distance file compressed.  The default is false.\n";
 		helpString += "The dist.seqs command should be in the following format: \n";
@@ -65,6 +69,7 @@ string DistanceCommand::getOutputPattern(string type) {
         
         if (type == "phylip") {  pattern = "[filename],[outputtag],dist"; } 
         else if (type == "column") { pattern = "[filename],dist"; }
+        else if (type == "binary") { pattern = "[filename],dist,bin"; }
         else { m->mothurOut("[ERROR]: No definition for type " + type + " output pattern.\n"); m->control_pressed = true;  }
         
         return pattern;
@@ -77,11 +82,12 @@ string DistanceCommand::getOutputPattern(string type) {
 //**********************************************************************************************************************
 DistanceCommand::DistanceCommand(){	
 	try {
-		abort = true; calledHelp = true; 
+		abort = true; calledHelp = true; packedDist = NULL;
 		setParameters();
 		vector<string> tempOutNames;
 		outputTypes["phylip"] = tempOutNames;
 		outputTypes["column"] = tempOutNames;
+		outputTypes["binary"] = tempOutNames;
 	}
 	catch(exception& e) {
 		m->errorOut(e, "DistanceCommand", "DistanceCommand");
@@ -91,7 +97,7 @@ DistanceCommand::DistanceCommand(){
 //**********************************************************************************************************************
 DistanceCommand::DistanceCommand(string option) {
 	try {
-		abort = false; calledHelp = false;   
+		abort = false; calledHelp = false; packedDist = NULL;
 		Estimators.clear();
 				
 		//allow user to run help
@@ -116,6 +122,7 @@ DistanceCommand::DistanceCommand(string option) {
 			vector<string> tempOutNames;
 			outputTypes["phylip"] = tempOutNames;
 			outputTypes["column"] = tempOutNames;
+			outputTypes["binary"] = tempOutNames;
 		
 			//if the user changes the input directory command factory will send this info to us in the output parameter 
 			string inputDir = validParameter.validFile(parameters, "inputdir", false);		
@@ -203,6 +210,9 @@ DistanceCommand::DistanceCommand(string option) {
 			
 			temp = validParameter.validFile(parameters, "compress", false);		if(temp == "not found"){  temp = "F"; }
 			convert(temp, compress);
+			
+			temp = validParameter.validFile(parameters, "halfprecision", false);		if(temp == "not found"){  temp = "F"; }
+			halfPrecision = m->isTrue(temp);
 
 			output = validParameter.validFile(parameters, "output", false);		if(output == "not found"){	output = "column"; }
             if (output == "phylip") { output = "lt";  }
@@ -211,7 +221,11 @@ DistanceCommand::DistanceCommand(string option) {
 			
 			if ((column != "") && (oldfastafile != "") && (output != "column")) { m->mothurOut("You have provided column and oldfasta, indicating you want to append distances to your column file. Your output must be in column format to do so."); m->mothurOutEndLine(); abort=true; }
 			
-			if ((output != "column") && (output != "lt") && (output != "square")) { m->mothurOut(output + " is not a valid output form. Options are column, lt and square. I will use column."); m->mothurOutEndLine(); output = "column"; }
+			if ((output != "column") && (output != "lt") && (output != "square") && (output != "binary")) { m->mothurOut(output + " is not a valid output form. Options are column, lt, square and binary. I will use column."); m->mothurOutEndLine(); output = "column"; }
+			
+			#ifdef USE_MPI
+			if (output == "binary") { m->mothurOut("The binary output is not available with MPI. I will use column."); m->mothurOutEndLine(); output = "column"; }
+			#endif
 
 		}
 				
@@ -243,6 +257,14 @@ int DistanceCommand::execute(){
 		
 		if (!alignDB.sameLength()) {  m->mothurOut("[ERROR]: your sequences are not the same length, aborting."); m->mothurOutEndLine(); return 0; }
 		
+		//encode the alignment once so the drivers can compare the packed columns instead of the strings
+		string distCalc = "onegap";
+		ValidCalculators validCalculator;
+		for (int i=0; i<Estimators.size(); i++) {
+			if (validCalculator.isValidCalculator("distance", Estimators[i]) == true) { distCalc = Estimators[i]; }
+		}
+		packedDist = new PackedDist(alignDB, distCalc, m->isTrue(countends));
+		
 		string outputFile;
         
         map<string, string> variables; 
@@ -264,6 +286,10 @@ int DistanceCommand::execute(){
 			}
 			
 			m->mothurRemove(outputFile);
+		}else if (output == "binary") { //user wants the column distances in a .dist.bin file
+			outputFile = getOutputFileName("binary", variables);
+			m->mothurRemove(outputFile);
+			outputTypes["binary"].push_back(outputFile);
 		}else { //assume square
 			variables["[outputtag]"] = "square";
 			outputFile = getOutputFileName("phylip", variables);
@@ -399,52 +425,11 @@ int DistanceCommand::execute(){
 			}
 		}
 		MPI_Barrier(MPI_COMM_WORLD); //make everyone wait - just in case
-#else		
-				
-	//#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-		//if you don't need to fork anything
-		if(processors == 1){
-			if (output != "square") {  driver(0, numSeqs, outputFile, cutoff); }
-			else { driver(0, numSeqs, outputFile, "square");  }
-		}else{ //you have multiple processors
-			
-			unsigned long long numDists = 0;
-			
-			if (output == "square") {
-				 numDists = numSeqs * numSeqs;
-			}else {
-				for(int i=0;i<numSeqs;i++){
-					for(int j=0;j<i;j++){
-						numDists++;
-						if (numDists > processors) { break; }
-					}
-				}
-			}
-			
-			if (numDists < processors) { processors = numDists; }
-			
-			for (int i = 0; i < processors; i++) {
-				distlinePair tempLine;
-				lines.push_back(tempLine);
-				if (output != "square") {
-					lines[i].start = int (sqrt(float(i)/float(processors)) * numSeqs);
-					lines[i].end = int (sqrt(float(i+1)/float(processors)) * numSeqs);
-				}else{
-					lines[i].start = int ((float(i)/float(processors)) * numSeqs);
-					lines[i].end = int ((float(i+1)/float(processors)) * numSeqs);
-				}
-				
-			}
-			
-			createProcesses(outputFile); 
-		}
-	//#else
-		//ifstream inFASTA;
-		//if (output != "square") {  driver(0, numSeqs, outputFile, cutoff); }
-		//else { driver(0, numSeqs, outputFile, "square");  }
-	//#endif
-	
+#else
+		createThreads(outputFile);
 #endif
+		delete packedDist; packedDist = NULL;
+		
 		if (m->control_pressed) { outputTypes.clear();  m->mothurRemove(outputFile); return 0; }
 		
 		#ifdef USE_MPI
@@ -526,238 +511,302 @@ int DistanceCommand::execute(){
 	}
 }
 /**************************************************************************************************/
-void DistanceCommand::createProcesses(string filename) {
+//splits the lower triangle (or square) into tiles of tileSize x tileSize sequences and calculates them on 
+//processors threads that share alignDB.  Tiles are handed out a band of rows at a time through a work stealing
+//queue and the bands are written to the output file in order as soon as all of their tiles are done.
+int DistanceCommand::createThreads(string filename) {
 	try {
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-		int process = 1;
-		processIDS.clear();
+		int numSeqs = alignDB.getNumSeqs();
+		int startTime = time(NULL);
 		
-		//loop through and create all the processes you want
-		while (process != processors) {
-			pid_t pid = fork();
-			
-			if (pid > 0) {
-				processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-				process++;
-			}else if (pid == 0){
-				if (output != "square") {  driver(lines[process].start, lines[process].end, filename + m->mothurGetpid(process) + ".temp", cutoff); }
-				else { driver(lines[process].start, lines[process].end, filename + m->mothurGetpid(process) + ".temp", "square"); }
-				exit(0);
-			}else { 
-				m->mothurOut("[ERROR]: unable to spawn the necessary processes. Error code: " + toString(pid)); m->mothurOutEndLine(); 
-				perror(" : ");
-				for (int i=0;i<processIDS.size();i++) {  int temp = processIDS[i]; kill (temp, SIGINT); }
-				exit(0);
-			}
-		}
+		names.resize(numSeqs);
+		for (int i = 0; i < numSeqs; i++) { names[i] = alignDB.getName(i); }
+		
+		//size the tiles so the sequences of a row block and a column block fit in L2 cache together, 
+		//but keep enough bands to spread over the processors
+		int bytesPerSeq = 1;
+		if (packedDist->isPacked())	{ bytesPerSeq = packedDist->getBytesPerSeq();				}
+		else if (numSeqs != 0)		{ bytesPerSeq = alignDB.getAlignedLength(0) + 1;	}
 		
-		//parent does its part
-		if (output != "square") {  driver(lines[0].start, lines[0].end, filename, cutoff); }
-		else { driver(lines[0].start, lines[0].end, filename, "square"); }
+		tileSize = (256 * 1024) / (2 * bytesPerSeq);
+		tileSize = min(tileSize, numSeqs / (4 * processors));
+		if (tileSize > 256) { tileSize = 256; }
+		if (tileSize < 8)	{ tileSize = 8;	  }
 		
+		numBlocks = (numSeqs + tileSize - 1) / tileSize;
 		
-		//force parent to wait until all the processes are done
-		for (int i=0;i<processIDS.size();i++) { 
-			int temp = processIDS[i];
-			wait(&temp);
+		ofstream outFile;
+		BinaryDistWriter* binaryFile = NULL;
+		if (output == "binary") { binaryFile = new BinaryDistWriter(filename, names, cutoff, halfPrecision); }
+		else { 
+			outFile.open(filename.c_str(), ios::trunc);
+			if (output != "column") { outFile << numSeqs << endl; }
 		}
-#else
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		//Windows version shared memory, so be careful when passing variables through the distanceData struct. 
-		//Above fork() will clone, so memory is separate, but that's not the case with windows, 
-		//that's why the distance calculator was moved inside of the driver to make separate copies.
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		
-		vector<distanceData*> pDataArray; //[processors-1];
-		DWORD   dwThreadIdArray[processors-1];
-		HANDLE  hThreadArray[processors-1]; 
-		
-		//Create processor-1 worker threads.
-		for( int i=0; i<processors-1; i++ ){
+		
+		bands.clear();
+		bands.resize(numBlocks);
+		
+		//until a tile is done guess the bytes of each distance from the output format
+		totalCells = 1;
+		if (output == "binary")			{ totalBytes = sizeof(PDistCell); }
+		else if (output == "column")	{ 
+			totalBytes = 10;
+			for (int i = 0; i < numSeqs; i++) { totalBytes += 2 * names[i].length() / (double) numSeqs; }
+		}else							{ totalBytes = 7; }
+		
+		WorkQueue queue(processors);
+		
+		//only the bands whose output fits in DIST_BUFFER are calculated ahead of the one being written, at most a few per processor
+		int window = 2 * processors;
+		int released = 1;
+		releaseBand(0, queue);
+		while ((released < numBlocks) && (released < window) && (bufferedBytes(0, released) < DIST_BUFFER)) { releaseBand(released, queue); released++; }
+		
+		vector<thread*> workers;
+		for (int i = 0; i < processors; i++) { workers.push_back(new thread(&DistanceCommand::tileWorker, this, i, &queue)); }
+		
+		for (int b = 0; b < numBlocks; b++) {
+			{
+				unique_lock<mutex> guard(bandLock);
+				while (bands[b].remaining != 0) { bandDone.wait(guard); }
+			}
 			
-			// Allocate memory for thread data.
-			distanceData* tempDist = new distanceData(lines[i+1].start, lines[i+1].end, (filename + toString(i) + ".temp"), cutoff, alignDB, Estimators, m, output, numNewFasta, countends);
-			pDataArray.push_back(tempDist);
-			processIDS.push_back(i);
+			int rowStart = b * tileSize;
+			int rowEnd = min(numSeqs, rowStart + tileSize);
 			
-			//MyDistThreadFunction is in header. It must be global or static to work with the threads.
-			//default security attributes, thread function name, argument to thread function, use default creation flags, returns the thread identifier
-			hThreadArray[i] = CreateThread(NULL, 0, MyDistThreadFunction, pDataArray[i], 0, &dwThreadIdArray[i]);   
+			if (!m->control_pressed) {
+				for (int i = rowStart; i < rowEnd; i++) {
+					if (binaryFile != NULL) { 
+						for (int t = 0; t < bands[b].cells.size(); t++) { binaryFile->addRow(i, bands[b].cells[t][i-rowStart]); }
+					}else {
+						for (int t = 0; t < bands[b].tiles.size(); t++) { outFile << bands[b].tiles[t][i-rowStart]; }
+						if (output != "column") { outFile << '\n'; }
+					}
+					
+					if(i % 100 == 0){
+						m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(NULL) - startTime)+"\n"); 
+					}
+				}
+			}
+			
+			vector< vector<string> >().swap(bands[b].tiles);
+			vector< vector< vector<PDistCell> > >().swap(bands[b].cells);
+			
+			//the next band is always released, so a band bigger than DIST_BUFFER is still calculated
+			if ((released == (b+1)) && (released < numBlocks)) { releaseBand(released, queue); released++; }
+			while ((released < numBlocks) && ((released - b) <= window) && (bufferedBytes(b+1, released) < DIST_BUFFER)) { releaseBand(released, queue); released++; }
 		}
 		
-		//do your part
-		if (output != "square") {  driver(lines[0].start, lines[0].end, filename, cutoff); }
-		else { driver(lines[0].start, lines[0].end, filename, "square"); }
+		queue.close();
+		for (int i = 0; i < workers.size(); i++) { workers[i]->join(); delete workers[i]; }
 		
-		//Wait until all threads have terminated.
-		WaitForMultipleObjects(processors-1, hThreadArray, TRUE, INFINITE);
+		if (binaryFile != NULL) { binaryFile->close(); delete binaryFile; }
+		else { outFile.close(); }
+		bands.clear();
+		names.clear();
 		
-		//Close all thread handles and free memory allocations.
-		for(int i=0; i < pDataArray.size(); i++){
-            if (pDataArray[i]->count != (pDataArray[i]->endLine-pDataArray[i]->startLine)) {
-                m->mothurOut("[ERROR]: process " + toString(i) + " only processed " + toString(pDataArray[i]->count) + " of " + toString(pDataArray[i]->endLine-pDataArray[i]->startLine) + " sequences assigned to it, quitting. \n"); m->control_pressed = true; 
-            }
-			CloseHandle(hThreadArray[i]);
-			delete pDataArray[i];
-		}
-#endif
+		m->mothurOutJustToScreen(toString(numSeqs-1) + "\t" + toString(time(NULL) - startTime)+"\n");
+		
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "DistanceCommand", "createThreads");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//the output held for the bands from first up to last, finished tiles count their bytes and the rest their share of the
+//estimate.  Includes the estimate for the band last, which is not released yet.
+double DistanceCommand::bufferedBytes(int first, int last) {
+	try {
+		lock_guard<mutex> guard(bandLock);
+		
+		double bytes = 0;
+		for (int b = first; b < last; b++) { bytes += bands[b].bytes + (bands[b].estimate * bands[b].remaining / (double) bands[b].numTiles); }
 		
-		//append and remove temp files
-		for (int i=0;i<processIDS.size();i++) { 
-			m->appendFiles((filename + toString(processIDS[i]) + ".temp"), filename);
-			m->mothurRemove((filename + toString(processIDS[i]) + ".temp"));
+		int numSeqs = alignDB.getNumSeqs();
+		int rowEnd = min(numSeqs, (last + 1) * tileSize);
+		double cells = (rowEnd - (last * tileSize)) * (double) rowEnd;
+		if (output == "square") { cells = (rowEnd - (last * tileSize)) * (double) numSeqs; }
+		bytes += cells * totalBytes / totalCells;
+		
+		return bytes;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "DistanceCommand", "bufferedBytes");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//queues the tiles of a band, spread over the workers deques
+void DistanceCommand::releaseBand(int band, WorkQueue& queue) {
+	try {
+		int numTiles = band + 1;
+		if (output == "square") { numTiles = numBlocks; }
+		
+		int numSeqs = alignDB.getNumSeqs();
+		int rowEnd = min(numSeqs, (band + 1) * tileSize);
+		double cells = (rowEnd - (band * tileSize)) * (double) rowEnd;
+		if (output == "square") { cells = (rowEnd - (band * tileSize)) * (double) numSeqs; }
+		
+		{
+			lock_guard<mutex> guard(bandLock);
+			if (output == "binary")	{ bands[band].cells.resize(numTiles); }
+			else					{ bands[band].tiles.resize(numTiles); }
+			bands[band].remaining = numTiles;
+			bands[band].numTiles = numTiles;
+			bands[band].estimate = cells * totalBytes / totalCells;
 		}
 		
+		for (int t = 0; t < numTiles; t++) { queue.push(t, ((long long)band * numBlocks) + t); }
 	}
 	catch(exception& e) {
-		m->errorOut(e, "DistanceCommand", "createProcesses");
+		m->errorOut(e, "DistanceCommand", "releaseBand");
 		exit(1);
 	}
 }
 /**************************************************************************************************/
-/////// need to fix to work with calcs and sequencedb
-int DistanceCommand::driver(int startLine, int endLine, string dFileName, float cutoff){
+void DistanceCommand::tileWorker(int worker, WorkQueue* queue) {
 	try {
-		ValidCalculators validCalculator;
-		Dist* distCalculator;
-		if (m->isTrue(countends) == true) {
-			for (int i=0; i<Estimators.size(); i++) {
-				if (validCalculator.isValidCalculator("distance", Estimators[i]) == true) { 
-					if (Estimators[i] == "nogaps")			{	distCalculator = new ignoreGaps();	}
-					else if (Estimators[i] == "eachgap")	{	distCalculator = new eachGapDist();	}
-					else if (Estimators[i] == "onegap")		{	distCalculator = new oneGapDist();	}
-				}
-			}
-		}else {
-			for (int i=0; i<Estimators.size(); i++) {
-				if (validCalculator.isValidCalculator("distance", Estimators[i]) == true) { 
-					if (Estimators[i] == "nogaps")		{	distCalculator = new ignoreGaps();					}
-					else if (Estimators[i] == "eachgap"){	distCalculator = new eachGapIgnoreTermGapDist();	}
-					else if (Estimators[i] == "onegap")	{	distCalculator = new oneGapIgnoreTermGapDist();		}
-				}
-			}
+		Dist* distCalculator = getDistCalculator();
+		
+		long long task;
+		while (queue->pop(worker, task)) {
+			int band = task / numBlocks;
+			int block = task % numBlocks;
+			
+			vector<string> rows;
+			vector< vector<PDistCell> > cells;
+			long long numCells = 0;
+			if (!m->control_pressed) { numCells = calcTile(band, block, distCalculator, rows, cells); }
+			else { rows.resize(tileSize); cells.resize(tileSize); }
+			
+			double bytes = 0;
+			for (int i = 0; i < rows.size(); i++) { bytes += rows[i].length(); }
+			for (int i = 0; i < cells.size(); i++) { bytes += cells[i].size() * sizeof(PDistCell); }
+			
+			lock_guard<mutex> guard(bandLock);
+			if (output == "binary")	{ bands[band].cells[block].swap(cells); }
+			else					{ bands[band].tiles[block].swap(rows); }
+			bands[band].bytes += bytes;
+			totalBytes += bytes;
+			totalCells += numCells;
+			bands[band].remaining--;
+			if (bands[band].remaining == 0) { bandDone.notify_all(); }
 		}
 		
-		int startTime = time(NULL);
+		delete distCalculator;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "DistanceCommand", "tileWorker");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//formats the part of each row in the band that falls in the block of columns, binary output keeps the cells instead.
+//Returns the number of distances calculated.
+long long DistanceCommand::calcTile(int band, int block, Dist* distCalculator, vector<string>& rows, vector< vector<PDistCell> >& cells) {
+	try {
+		int numSeqs = alignDB.getNumSeqs();
+		int rowStart = band * tileSize;
+		int rowEnd = min(numSeqs, rowStart + tileSize);
+		int colStart = block * tileSize;
+		int colEnd = min(numSeqs, colStart + tileSize);
 		
-		//column file
-		ofstream outFile(dFileName.c_str(), ios::trunc);
-		outFile.setf(ios::fixed, ios::showpoint);
-		outFile << setprecision(4);
+		if (output == "binary")	{ cells.resize(rowEnd - rowStart); }
+		else					{ rows.resize(rowEnd - rowStart); }
 		
-		if((output == "lt") && startLine == 0){	outFile << alignDB.getNumSeqs() << endl;	}
+		long long numCells = 0;
 		
-		for(int i=startLine;i<endLine;i++){
-			if(output == "lt")	{	
-				string name = alignDB.get(i).getName();
-				if (name.length() < 10) { //pad with spaces to make compatible
-					while (name.length() < 10) {  name += " ";  }
-				}
-				outFile << name << '\t';	
+		ostringstream out;
+		out.setf(ios::fixed, ios::showpoint);
+		out << setprecision(4);
+		
+		for (int i = rowStart; i < rowEnd; i++) {
+			if (m->control_pressed) { break; }
+			
+			out.str("");
+			
+			if ((block == 0) && ((output == "lt") || (output == "square"))) {
+				string name = names[i];
+				//pad with spaces to make compatible
+				if (name.length() < 10) { while (name.length() < 10) {  name += " ";  } }
+				out << name << '\t';
 			}
-			for(int j=0;j<i;j++){
-				
-				if (m->control_pressed) { delete distCalculator; outFile.close(); return 0;  }
-				
+			
+			int end = colEnd;
+			if (output != "square") { 
+				end = min(end, i); 
 				//if there was a column file given and we are appending, we don't want to calculate the distances that are already in the column file
-				//the alignDB contains the new sequences and then the old, so if i an oldsequence and j is an old sequence then break out of this loop
-				if ((i >= numNewFasta) && (j >= numNewFasta)) { break; }
-				
-				distCalculator->calcDist(alignDB.get(i), alignDB.get(j));
-				double dist = distCalculator->getDist();
-				
-				if(dist <= cutoff){
-					if (output == "column") { outFile << alignDB.get(i).getName() << ' ' << alignDB.get(j).getName() << ' ' << dist << endl; }
-				}
-				if (output == "lt") {  outFile << dist << '\t'; }
+				//the alignDB contains the new sequences and then the old, so if i an oldsequence and j is an old sequence then skip it
+				if (i >= numNewFasta) { end = min(end, numNewFasta); }
 			}
 			
-			if (output == "lt") { outFile << endl; }
+			if (end > colStart) { numCells += end - colStart; }
 			
-			if(i % 100 == 0){
-				m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(NULL) - startTime)+"\n"); 
+			for (int j = colStart; j < end; j++) {
+				double dist = calcDist(distCalculator, i, j);
+				
+				if (output == "column") { 
+					if (dist <= cutoff) { out << names[i] << ' ' << names[j] << ' ' << dist << endl; }
+				}else if (output == "binary") {
+					if (dist <= cutoff) { cells[i - rowStart].push_back(PDistCell(j, BinaryDistWriter::roundDist(dist))); }
+				}else { out << dist << '\t'; }
 			}
 			
+			if (output != "binary") { rows[i - rowStart] = out.str(); }
 		}
-		m->mothurOutJustToScreen(toString(endLine-1) + "\t" + toString(time(NULL) - startTime)+"\n");
 		
-		outFile.close();
-		delete distCalculator;
-		
-		return 1;
+		return numCells;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "DistanceCommand", "driver");
+		m->errorOut(e, "DistanceCommand", "calcTile");
 		exit(1);
 	}
 }
 /**************************************************************************************************/
-/////// need to fix to work with calcs and sequencedb
-int DistanceCommand::driver(int startLine, int endLine, string dFileName, string square){
+Dist* DistanceCommand::getDistCalculator(){
 	try {
 		ValidCalculators validCalculator;
-		Dist* distCalculator;
+		Dist* distCalculator = NULL;
 		if (m->isTrue(countends) == true) {
 			for (int i=0; i<Estimators.size(); i++) {
 				if (validCalculator.isValidCalculator("distance", Estimators[i]) == true) { 
-					if (Estimators[i] == "nogaps")			{	distCalculator = new ignoreGaps();	}
-					else if (Estimators[i] == "eachgap")	{	distCalculator = new eachGapDist();	}
-					else if (Estimators[i] == "onegap")		{	distCalculator = new oneGapDist();	}
+					if (Estimators[i] == "nogaps")			{	delete distCalculator; distCalculator = new ignoreGaps();	}
+					else if (Estimators[i] == "eachgap")	{	delete distCalculator; distCalculator = new eachGapDist();	}
+					else if (Estimators[i] == "onegap")		{	delete distCalculator; distCalculator = new oneGapDist();	}
 				}
 			}
 		}else {
 			for (int i=0; i<Estimators.size(); i++) {
 				if (validCalculator.isValidCalculator("distance", Estimators[i]) == true) { 
-					if (Estimators[i] == "nogaps")		{	distCalculator = new ignoreGaps();					}
-					else if (Estimators[i] == "eachgap"){	distCalculator = new eachGapIgnoreTermGapDist();	}
-					else if (Estimators[i] == "onegap")	{	distCalculator = new oneGapIgnoreTermGapDist();		}
+					if (Estimators[i] == "nogaps")		{	delete distCalculator; distCalculator = new ignoreGaps();					}
+					else if (Estimators[i] == "eachgap"){	delete distCalculator; distCalculator = new eachGapIgnoreTermGapDist();	}
+					else if (Estimators[i] == "onegap")	{	delete distCalculator; distCalculator = new oneGapIgnoreTermGapDist();		}
 				}
 			}
 		}
 		
-		int startTime = time(NULL);
-		
-		//column file
-		ofstream outFile(dFileName.c_str(), ios::trunc);
-		outFile.setf(ios::fixed, ios::showpoint);
-		outFile << setprecision(4);
-		
-		if(startLine == 0){	outFile << alignDB.getNumSeqs() << endl;	}
-		
-		for(int i=startLine;i<endLine;i++){
-				
-			string name = alignDB.get(i).getName();
-			//pad with spaces to make compatible
-			if (name.length() < 10) { while (name.length() < 10) {  name += " ";  } }
-				
-			outFile << name << '\t';	
-			
-			for(int j=0;j<alignDB.getNumSeqs();j++){
-				
-				if (m->control_pressed) { delete distCalculator; outFile.close(); return 0;  }
-				
-				distCalculator->calcDist(alignDB.get(i), alignDB.get(j));
-				double dist = distCalculator->getDist();
-				
-				outFile << dist << '\t'; 
-			}
-			
-			outFile << endl; 
-			
-			if(i % 100 == 0){
-				m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(NULL) - startTime)+"\n");
-			}
-			
+		return distCalculator;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "DistanceCommand", "getDistCalculator");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//uses the packed alignment when the sequences could be encoded, otherwise the distance calculator
+double DistanceCommand::calcDist(Dist* distCalculator, int i, int j){
+	try {
+		if (packedDist != NULL) { 
+			if (packedDist->isPacked()) { return packedDist->calcDist(i, j); }
 		}
-		m->mothurOutJustToScreen(toString(endLine-1) + "\t" + toString(time(NULL) - startTime)+"\n");
-		
-		outFile.close();
-		delete distCalculator;
 		
-		return 1;
+		distCalculator->calcDist(alignDB.getAligned(i), alignDB.getAligned(j), alignDB.getAlignedLength(i));
+		return distCalculator->getDist();
 	}
 	catch(exception& e) {
-		m->errorOut(e, "DistanceCommand", "driver");
+		m->errorOut(e, "DistanceCommand", "calcDist");
 		exit(1);
 	}
 }
@@ -803,11 +852,10 @@ int DistanceCommand::driverMPI(int startLine, int endLine, MPI_File& outMPI, flo
 				//the alignDB contains the new sequences and then the old, so if i an oldsequence and j is an old sequence then break out of this loop
 				if ((i >= numNewFasta) && (j >= numNewFasta)) { break; }
 				
-				distCalculator->calcDist(alignDB.get(i), alignDB.get(j));
-				double dist = distCalculator->getDist();
+				double dist = calcDist(distCalculator, i, j);
 				
 				if(dist <= cutoff){
-					 outputString += (alignDB.get(i).getName() + ' ' + alignDB.get(j).getName() + ' ' + toString(dist) + '\n'); 
+					 outputString += (alignDB.getName(i) + ' ' + alignDB.getName(j) + ' ' + toString(dist) + '\n'); 
 				}
 			}
 			
@@ -885,7 +933,7 @@ int DistanceCommand::driverMPI(int startLine, int endLine, string file, unsigned
 		
 		for(int i=startLine;i<endLine;i++){
 				
-			string name = alignDB.get(i).getName();
+			string name = alignDB.getName(i);
 			if (name.length() < 10) { //pad with spaces to make compatible
 				while (name.length() < 10) {  name += " ";  }
 			}
@@ -895,8 +943,7 @@ int DistanceCommand::driverMPI(int startLine, int endLine, string file, unsigned
 				
 				if (m->control_pressed) { delete distCalculator; return 0;  }
 				
-				distCalculator->calcDist(alignDB.get(i), alignDB.get(j));
-				double dist = distCalculator->getDist();
+				double dist = calcDist(distCalculator, i, j);
 				
 				outputString += toString(dist) + "\t"; 
 			}
@@ -978,7 +1025,7 @@ int DistanceCommand::driverMPI(int startLine, int endLine, string file, unsigned
 		
 		for(int i=startLine;i<endLine;i++){
 				
-			string name = alignDB.get(i).getName();
+			string name = alignDB.getName(i);
 			if (name.length() < 10) { //pad with spaces to make compatible
 				while (name.length() < 10) {  name += " ";  }
 			}
@@ -988,8 +1035,7 @@ int DistanceCommand::driverMPI(int startLine, int endLine, string file, unsigned
 				
 				if (m->control_pressed) { delete distCalculator; return 0;  }
 				
-				distCalculator->calcDist(alignDB.get(i), alignDB.get(j));
-				double dist = distCalculator->getDist();
+				double dist = calcDist(distCalculator, i, j);
 				
 				outputString += toString(dist) + "\t"; 
 			}
@@ -27,7 +27,7 @@ DistanceDB::DistanceDB() : Database() {
 	}	
 }
 /**************************************************************************************************/
-void DistanceDB::addSequence(Sequence seq) {
+void DistanceDB::addSequence(const Sequence& seq) {
 	try {
 		//are the template sequences aligned
 		if (!isAligned(seq.getAligned())) {
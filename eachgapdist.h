@@ -20,16 +20,13 @@ public:
 	
 	eachGapDist() {}
 	
-	void calcDist(Sequence A, Sequence B){		
+	using Dist::calcDist;
+	
+	void calcDist(const char* seqA, const char* seqB, int alignLength){		
 		int diff = 0;
 		int length = 0;
 		int start = 0;
 		
-		string seqA = A.getAligned();
-		string seqB = B.getAligned();
-
-		int alignLength = seqA.length();
-		
 		for(int i=0; i<alignLength; i++){
 			if(seqA[i] != '.' || seqB[i] != '.'){
 				start = i;
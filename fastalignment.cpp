@@ -0,0 +1,382 @@
+//
+//  fastalignment.cpp
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+#include "fastalignment.hpp"
+
+/**************************************************************************************************/
+
+const int FastAlignment::NEG_SCORE;
+const int FastAlignment::MAX_TRACE_BYTES;
+const int FastAlignment::LONG_SEQUENCE_LENGTH;
+
+/**************************************************************************************************/
+
+static inline int floorHalf(int x) { return (x >= 0) ? (x / 2) : -((1 - x) / 2); }
+static inline int ceilHalf(int x) { return -floorHalf(-x); }
+
+static inline int baseCode(char base) {
+	switch (base) {
+		case 'A': case 'a': return 0;
+		case 'C': case 'c': return 1;
+		case 'G': case 'g': return 2;
+		case 'T': case 't': case 'U': case 'u': return 3;
+		default: return -1;
+	}
+}
+/**************************************************************************************************/
+
+FastAlignment::FastAlignment(int r, int b) : Alignment(), band(b), numBuffers(0), bufferSize(0), checkpointed(false), blockLength(1), loadedBlock(0) {
+	try {
+		nRows = r;			//	there is no full matrix to allocate, the buffers are sized for each pair of sequences
+		nCols = r;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FastAlignment", "FastAlignment");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+void FastAlignment::resize(int A) {
+	try {
+		nRows = A;
+		nCols = A;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FastAlignment", "resize");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//the integer kernels can only reproduce the float scores if they are whole numbers
+bool FastAlignment::isWholeNumber(float score) {
+	return (score == (float)((int)score));
+}
+/**************************************************************************************************/
+//a full matrix of AlignmentCells for long sequences takes hundreds of MB per process, so needleman and gotoh switch to
+//the fast aligners, which give the same alignment, when the longest sequence is longer than LONG_SEQUENCE_LENGTH
+string FastAlignment::getMethod(string align, int longestBase, float match, float misMatch, float gapOpen, float gapExtend) {
+	if (longestBase <= LONG_SEQUENCE_LENGTH) { return align; }
+	if ((align != "needleman") && (align != "gotoh")) { return align; }
+	if (!isWholeNumber(match) || !isWholeNumber(misMatch) || !isWholeNumber(gapOpen) || !isWholeNumber(gapExtend)) { return align; }
+
+	return "fast" + align;
+}
+/**************************************************************************************************/
+//finds the diagonal (row - column) shared by the most 8mers of seqA and seqB
+bool FastAlignment::findDiagonal(int& center) {
+	try {
+		const int kmerSize = 8;
+		const int numKmers = 65536;
+		const int maxHits = 16;		//	repeated kmers say little about the diagonal
+
+		if (kmerFirst.size() != numKmers) { kmerFirst.assign(numKmers, -1); }
+		kmerNext.assign(lB, -1);
+		votes.assign(lA + lB, 0);
+
+		vector<int> rowKmers;
+		int code = 0; int valid = 0;
+		for (int i = 1; i < lB; i++) {
+			int base = baseCode(seqB[i]);
+			if (base == -1) { valid = 0; continue; }
+			code = ((code << 2) | base) & (numKmers - 1);
+			if (++valid >= kmerSize) {
+				int start = i - kmerSize + 1;
+				kmerNext[start] = kmerFirst[code];
+				kmerFirst[code] = start;
+				rowKmers.push_back(code);
+			}
+		}
+
+		code = 0; valid = 0;
+		for (int j = 1; j < lA; j++) {
+			int base = baseCode(seqA[j]);
+			if (base == -1) { valid = 0; continue; }
+			code = ((code << 2) | base) & (numKmers - 1);
+			if (++valid >= kmerSize) {
+				int start = j - kmerSize + 1;
+				int hits = 0;
+				for (int pos = kmerFirst[code]; (pos != -1) && (hits < maxHits); pos = kmerNext[pos], hits++) {
+					votes[pos - start + lA]++;
+				}
+			}
+		}
+
+		for (int i = 0; i < rowKmers.size(); i++) { kmerFirst[rowKmers[i]] = -1; }
+
+		int best = 0;
+		for (int i = 1; i < votes.size(); i++) { if (votes[i] > votes[best]) { best = i; } }
+		if (votes[best] == 0) { return false; }
+
+		center = best - lA;
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FastAlignment", "findDiagonal");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//anti-diagonal k holds the cells (i, k-i), diagonalStart and diagonalEnd are the first and last rows scored
+void FastAlignment::setDiagonals() {
+	try {
+		int numDiagonals = lA + lB - 1;
+		diagonalStart.assign(numDiagonals, 1);
+		diagonalEnd.assign(numDiagonals, 0);
+		traceOffset.assign(numDiagonals, 0);
+
+		int center = 0;
+		bool banded = false;
+		if (band > 0) { banded = findDiagonal(center); }
+
+		int size = 0;
+		for (int k = 2; k < numDiagonals; k++) {
+			int start = max(1, k - (lA - 1));
+			int end = min(lB - 1, k - 1);
+			if (banded) {
+				start = max(start, ceilHalf(k + center - band));
+				end = min(end, floorHalf(k + center + band));
+			}
+			diagonalStart[k] = start;
+			diagonalEnd[k] = end;
+			traceOffset[k] = size;
+			if (end >= start) { size += 2 * ((end - start + 8) / 8); }
+		}
+
+		bufferSize = lB + 16;
+		if (scoreBuffers.size() < (numBuffers * bufferSize)) { scoreBuffers.resize(numBuffers * bufferSize); }
+
+		//if the traceback is too big, only keep the traceback of one block of anti-diagonals at a time
+		checkpointed = (size > MAX_TRACE_BYTES);
+		if (checkpointed) {
+			blockLength = max(64, (int)sqrt(16.0 * numDiagonals * numBuffers));
+			int numBlocks = getBlock(numDiagonals - 1) + 1;
+			checkpoints.resize(numBlocks);
+
+			int totalSize = size;
+			size = 0;
+			for (int b = 0; b < numBlocks; b++) {
+				int first = 2 + b * blockLength;
+				int last = first + blockLength;
+				int blockEnd = (last < numDiagonals) ? traceOffset[last] : totalSize;
+				size = max(size, blockEnd - traceOffset[first]);
+			}
+		}else {
+			blockLength = numDiagonals;
+			checkpoints.clear();
+		}
+		if (traceMatrix.size() < size) { traceMatrix.resize(size); }
+
+		lastRow.assign(lA, NEG_SCORE);
+		lastColumn.assign(lB, NEG_SCORE);
+		lastRow[0] = 0;
+		lastColumn[0] = 0;
+		if (lA == 1) { lastColumn.assign(lB, 0); }
+		if (lB == 1) { lastRow.assign(lA, 0); }
+
+		rowBases = seqB + string(8, ' ');
+		revColumnBases.assign(seqA.rbegin(), seqA.rend());
+		revColumnBases += string(8, ' ');
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FastAlignment", "setDiagonals");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//scores the anti-diagonals in order, saving the score buffers at the start of each block if the traceback is checkpointed
+void FastAlignment::fillMatrix() {
+	try {
+		int numDiagonals = lA + lB - 1;
+		int blockOffset = 0;
+
+		for (int k = 2; k < numDiagonals; k++) {
+			if (checkpointed && (((k - 2) % blockLength) == 0)) {
+				checkpoints[getBlock(k)] = scoreBuffers;
+				blockOffset = traceOffset[k];
+			}
+
+			if (diagonalEnd[k] >= diagonalStart[k]) {
+				scoreDiagonal(k, &traceMatrix[traceOffset[k] - blockOffset]);
+				saveEdgeScores(k, getBuffer(k % 3));
+			}
+		}
+
+		loadedBlock = getBlock(max(2, numDiagonals - 1));
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FastAlignment", "fillMatrix");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//recomputes the traceback of a block from the score buffers saved at its start
+void FastAlignment::loadBlock(int block) {
+	try {
+		int numDiagonals = lA + lB - 1;
+		int first = 2 + block * blockLength;
+		int last = min(numDiagonals, first + blockLength);
+
+		scoreBuffers = checkpoints[block];
+		for (int k = first; k < last; k++) {
+			if (diagonalEnd[k] >= diagonalStart[k]) { scoreDiagonal(k, &traceMatrix[traceOffset[k] - traceOffset[first]]); }
+		}
+
+		loadedBlock = block;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FastAlignment", "loadBlock");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//sets the rows from-to of a buffer holding anti-diagonal k that were not scored.  the first row and column of the
+//matrix score 0 and the cells outside the band can not be used
+void FastAlignment::setEdges(int* scores, int k, int from, int to) {
+	int start = diagonalStart[k];
+	int end = diagonalEnd[k];
+
+	for (int i = from; (i <= to) && (i < start); i++)		{ scores[i] = ((i == 0) || (i == k)) ? 0 : NEG_SCORE; }
+	for (int i = max(from, end + 1); i <= to; i++)		{ scores[i] = ((i == 0) || (i == k)) ? 0 : NEG_SCORE; }
+}
+/**************************************************************************************************/
+
+void FastAlignment::saveEdgeScores(int k, int* scores) {
+	int start = diagonalStart[k];
+	int end = diagonalEnd[k];
+
+	int row = k - (lA - 1);
+	if ((row >= start) && (row <= end))			{ lastColumn[row] = scores[row]; }
+	if ((end == lB - 1) && (end >= start))		{ lastRow[k - end] = scores[end];	}
+}
+/**************************************************************************************************/
+//same as Overlap::setOverlap, gaps are added to the 3' end of whichever sequence gives the highest score
+void FastAlignment::setOverlap() {
+	try {
+		int max = -100;
+		int rowIndex = lA - 1;
+		for (int i = 0; i < lB; i++) {
+			if (lastColumn[i] >= max) { rowIndex = i; max = lastColumn[i]; }
+		}
+
+		max = -100;
+		int colIndex = lB - 1;
+		for (int i = 0; i < lA; i++) {
+			if (lastRow[i] >= max) { colIndex = i; max = lastRow[i]; }
+		}
+
+		overlapRow = lB;
+		overlapColumn = lA;
+
+		if ((colIndex == lA - 1) && (rowIndex == lB - 1)) {}
+		else if (lastRow[colIndex] < lastColumn[rowIndex])	{ overlapRow = rowIndex + 1;		}
+		else												{ overlapColumn = colIndex + 1;	}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FastAlignment", "setOverlap");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+char FastAlignment::getPrevCell(int row, int column) {
+	if ((column == lA - 1) && (row >= overlapRow))		{ return 'u'; }
+	if ((row == lB - 1) && (column >= overlapColumn))	{ return 'l'; }
+
+	if (row == 0) { return (column == 0) ? 'x' : 'l'; }
+	if (column == 0) { return 'u'; }
+
+	int k = row + column;
+	int index = row - diagonalStart[k];
+	if ((index < 0) || (row > diagonalEnd[k])) { return 'd'; }	//	outside the band
+
+	int group = traceOffset[k] + 2 * (index / 8);
+	if (checkpointed) {
+		if (getBlock(k) != loadedBlock) { loadBlock(getBlock(k)); }
+		group -= traceOffset[2 + loadedBlock * blockLength];
+	}
+
+	int bit = index % 8;
+	if ((traceMatrix[group + 1] >> bit) & 1)	{ return 'l'; }
+	if ((traceMatrix[group] >> bit) & 1)		{ return 'u'; }
+	return 'd';
+}
+/**************************************************************************************************/
+//same as Alignment::traceBack, but the alignment is built back to front and reversed once
+void FastAlignment::traceBackPacked() {
+	try {
+		BBaseMap.clear();
+		ABaseMap.clear();
+		seqAaln = "";
+		seqBaln = "";
+		int row = lB-1;
+		int column = lA-1;
+
+		vector<int> aColumns, aCounts, bRows, bCounts;
+
+		char prevCell = getPrevCell(row, column);
+		if (prevCell == 'x') {	seqAaln = seqBaln = "NOALIGNMENT";	}
+		else {
+			int count = 0;
+			while (prevCell != 'x') {
+				if (prevCell == 'u') {
+					seqAaln += '-';
+					seqBaln += seqB[row];
+					bRows.push_back(row); bCounts.push_back(count);
+					row--;
+				}
+				else if (prevCell == 'l') {
+					seqBaln += '-';
+					seqAaln += seqA[column];
+					aColumns.push_back(column); aCounts.push_back(count);
+					column--;
+				}
+				else {
+					seqAaln += seqA[column];
+					seqBaln += seqB[row];
+					bRows.push_back(row); bCounts.push_back(count);
+					aColumns.push_back(column); aCounts.push_back(count);
+					row--; column--;
+				}
+				count++;
+				prevCell = getPrevCell(row, column);
+			}
+			reverse(seqAaln.begin(), seqAaln.end());
+			reverse(seqBaln.begin(), seqBaln.end());
+		}
+
+		pairwiseLength = seqAaln.length();
+		seqAstart = 1;	seqAend = 0;
+		seqBstart = 1;	seqBend = 0;
+
+		for (int i = 0; i < aColumns.size(); i++) { ABaseMap[pairwiseLength-aCounts[i]-1] = aColumns[i]-1; }
+		for (int i = 0; i < bRows.size(); i++) { BBaseMap[pairwiseLength-bCounts[i]-1] = bRows[i]-1; }
+
+		for(int i=0;i<seqAaln.length();i++){
+			if(seqAaln[i] != '-' && seqBaln[i] == '-')		{	seqAstart++;	}
+			else if(seqAaln[i] == '-' && seqBaln[i] != '-')	{	seqBstart++;	}
+			else											{	break;			}
+		}
+
+		pairwiseLength -= (seqAstart + seqBstart - 2);
+
+		for(int i=seqAaln.length()-1; i>=0;i--){
+			if(seqAaln[i] != '-' && seqBaln[i] == '-')		{	seqAend++;		}
+			else if(seqAaln[i] == '-' && seqBaln[i] != '-')	{	seqBend++;		}
+			else											{	break;			}
+		}
+		pairwiseLength -= (seqAend + seqBend);
+
+		seqAend = seqA.length() - seqAend - 1;
+		seqBend = seqB.length() - seqBend - 1;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FastAlignment", "traceBackPacked");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
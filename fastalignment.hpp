@@ -0,0 +1,82 @@
+//
+//  fastalignment.hpp
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+#ifndef Mothur_fastalignment_hpp
+#define Mothur_fastalignment_hpp
+
+#include "mothur.h"
+#include "alignment.hpp"
+
+/**************************************************************************************************/
+
+/* FastAlignment is the parent of the fastneedleman and fastgotoh aligners.  They give the same alignments as the
+ NeedlemanOverlap and GotohOverlap classes when the scores are whole numbers, but fill the dynamic programming matrix one
+ anti-diagonal at a time with integer scores, so the cells of an anti-diagonal can be scored 8 at a time with AVX2.
+
+ Only three anti-diagonals of scores are kept.  The traceback is stored separately with 2 bits per cell: each
+ anti-diagonal is split into groups of 8 cells and each group is stored in two bytes, the first has a bit set for the
+ cells that point up and the second for the cells that point left.  Cells that point diagonally have neither bit set.
+
+ If band is greater than 0, the diagonal shared by the most 8mers of the two sequences is found and only the cells within
+ band positions of that diagonal are scored.  This is faster again, but the alignment may differ from the full matrix
+ if the best path leaves the band.
+
+ If the traceback of a pair of sequences would need more than MAX_TRACE_BYTES, the anti-diagonals are split into blocks
+ and only the score buffers at the start of each block are saved.  The traceback of a block is recomputed from its saved
+ scores when the traceback reaches it, so the memory used grows with the square root of the number of cells and the
+ alignment is the same. */
+
+class FastAlignment : public Alignment {
+
+public:
+	FastAlignment(int, int);
+	virtual ~FastAlignment() {}
+
+	void resize(int);
+	static bool isWholeNumber(float);
+	static string getMethod(string, int, float, float, float, float);
+
+	static const int LONG_SEQUENCE_LENGTH = 2000;	//	longer sequences use the fast aligners instead of a full matrix
+
+protected:
+	static const int NEG_SCORE = -(1 << 28);	//	the score of cells outside the band
+	static const int MAX_TRACE_BYTES = (1 << 24);
+
+	int band;
+	int numBuffers, bufferSize;				//	the score buffers used by the child class for each anti-diagonal
+	vector<int> scoreBuffers;
+	vector<int> diagonalStart, diagonalEnd, traceOffset;
+	vector<unsigned char> traceMatrix;
+	vector<int> lastRow, lastColumn;		//	scores of the bottom row and right column, used to fix the 3' end
+	int overlapRow, overlapColumn;			//	gaps added at the 3' end, see Overlap
+	string rowBases, revColumnBases;		//	seqB and seqA reversed, padded so 8 bases can be read past the end
+
+	int* getBuffer(int b) { return &scoreBuffers[b * bufferSize]; }
+	virtual void scoreDiagonal(int, unsigned char*) = 0;
+
+	void setDiagonals();
+	void fillMatrix();
+	void setEdges(int*, int, int, int);
+	void saveEdgeScores(int, int*);
+	void setOverlap();
+	char getPrevCell(int, int);
+	void traceBackPacked();
+
+private:
+	vector<int> kmerFirst, kmerNext, votes;
+	bool checkpointed;
+	int blockLength, loadedBlock;
+	vector< vector<int> > checkpoints;		//	the score buffers before the first anti-diagonal of each block
+
+	bool findDiagonal(int&);
+	int getBlock(int k) { return (k - 2) / blockLength; }
+	void loadBlock(int);
+};
+
+/**************************************************************************************************/
+
+#endif
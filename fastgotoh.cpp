@@ -0,0 +1,119 @@
+//
+//  fastgotoh.cpp
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+//  If mothur is compiled with AVX2 enabled (-mavx2 or -march=native) 8 cells of an anti-diagonal are scored at a time,
+//  otherwise one cell at a time.
+//
+
+#ifdef __AVX2__
+	#include <immintrin.h>
+#endif
+
+#include "fastgotoh.hpp"
+
+/**************************************************************************************************/
+
+FastGotoh::FastGotoh(float gO, float gE, float f, float mm, int r, int b) :
+gapOpen((int)gO), gapExtend((int)gE), match((int)f), mismatch((int)mm), FastAlignment(r, b) {
+	numBuffers = 7;		//	the scores of the last three anti-diagonals, then the gap scores of the last two
+}
+/**************************************************************************************************/
+
+void FastGotoh::align(string A, string B){
+	try {
+		seqA = ' ' + A;	lA = seqA.length();		//	the algorithm requires that the first character be a dummy value
+		seqB = ' ' + B;	lB = seqB.length();		//	the algorithm requires that the first character be a dummy value
+
+		setDiagonals();
+		fillMatrix();
+		setOverlap();				//	Fix the gaps at the ends of the sequences
+		traceBackPacked();			//	Construct the alignment and set seqAaln and seqBaln
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FastGotoh", "align");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+void FastGotoh::scoreDiagonal(int k, unsigned char* cells){
+	try {
+		int start = diagonalStart[k];
+		int end = diagonalEnd[k];
+
+		int* current = getBuffer(k % 3);
+		int* previous = getBuffer((k - 1) % 3);
+		int* previous2 = getBuffer((k - 2) % 3);
+		int* insertCurrent = getBuffer(3 + k % 2);				//	best score ending with a gap in seqB, from the left
+		int* insertPrevious = getBuffer(3 + (k - 1) % 2);
+		int* deletionCurrent = getBuffer(5 + k % 2);			//	best score ending with a gap in seqA, from above
+		int* deletionPrevious = getBuffer(5 + (k - 1) % 2);
+		setEdges(previous, k - 1, start - 1, end);
+		setEdges(previous2, k - 2, start - 1, end - 1);
+		setEdges(insertPrevious, k - 1, start - 1, end);
+		setEdges(deletionPrevious, k - 1, start - 1, end);
+
+		const char* rows = rowBases.c_str();
+		const char* columns = revColumnBases.c_str();
+		int shift = lA - 1 - k;				//	columns[shift + i] is seqA[k - i]
+		int i = start;
+
+#ifdef __AVX2__
+		__m256i gapOpenV = _mm256_set1_epi32(gapOpen);
+		__m256i gapExtendV = _mm256_set1_epi32(gapExtend);
+		__m256i matchV = _mm256_set1_epi32(match);
+		__m256i mismatchV = _mm256_set1_epi32(mismatch);
+
+		for (int group = 0; i <= end; i += 8, group++) {
+			__m256i rowBase = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(rows + i)));
+			__m256i columnBase = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(columns + shift + i)));
+			__m256i score = _mm256_blendv_epi8(mismatchV, matchV, _mm256_cmpeq_epi32(rowBase, columnBase));
+
+			__m256i diagonal = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(previous2 + i - 1)), score);
+
+			__m256i left = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(previous + i)), gapOpenV);
+			left = _mm256_add_epi32(_mm256_max_epi32(_mm256_loadu_si256((const __m256i*)(insertPrevious + i)), left), gapExtendV);
+			__m256i up = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(previous + i - 1)), gapOpenV);
+			up = _mm256_add_epi32(_mm256_max_epi32(_mm256_loadu_si256((const __m256i*)(deletionPrevious + i - 1)), up), gapExtendV);
+			_mm256_storeu_si256((__m256i*)(insertCurrent + i), left);
+			_mm256_storeu_si256((__m256i*)(deletionCurrent + i), up);
+
+			__m256i leftFirst = _mm256_cmpgt_epi32(left, up);
+			__m256i isLeft = _mm256_and_si256(leftFirst, _mm256_cmpgt_epi32(left, diagonal));
+			__m256i isUp = _mm256_andnot_si256(leftFirst, _mm256_cmpgt_epi32(up, diagonal));
+			_mm256_storeu_si256((__m256i*)(current + i), _mm256_max_epi32(diagonal, _mm256_max_epi32(left, up)));
+
+			cells[2 * group] = (unsigned char)_mm256_movemask_ps(_mm256_castsi256_ps(isUp));
+			cells[2 * group + 1] = (unsigned char)_mm256_movemask_ps(_mm256_castsi256_ps(isLeft));
+		}
+#else
+		for (int group = 0; i <= end; group++) {
+			unsigned char upBits = 0;
+			unsigned char leftBits = 0;
+			for (int bit = 0; (bit < 8) && (i <= end); bit++, i++) {
+				int diagonal = previous2[i - 1] + ((rows[i] == columns[shift + i]) ? match : mismatch);
+				int left = max(insertPrevious[i], previous[i] + gapOpen) + gapExtend;
+				int up = max(deletionPrevious[i - 1], previous[i - 1] + gapOpen) + gapExtend;
+				insertCurrent[i] = left;
+				deletionCurrent[i] = up;
+
+				current[i] = diagonal;		//	same order of comparisons as GotohOverlap
+				if (left > up) {
+					if (left > diagonal)	{ current[i] = left;	leftBits |= (1 << bit);	}
+				}
+				else if (up > diagonal)		{ current[i] = up;		upBits |= (1 << bit);	}
+			}
+			cells[2 * group] = upBits;
+			cells[2 * group + 1] = leftBits;
+		}
+#endif
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FastGotoh", "scoreDiagonal");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
@@ -0,0 +1,37 @@
+//
+//  fastgotoh.hpp
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+#ifndef Mothur_fastgotoh_hpp
+#define Mothur_fastgotoh_hpp
+
+#include "mothur.h"
+#include "fastalignment.hpp"
+
+/**************************************************************************************************/
+
+/* Gotoh alignment with affine gap penalties, giving the same alignments as GotohOverlap.  The scores must be whole
+ numbers, see FastAlignment. */
+
+class FastGotoh : public FastAlignment {
+
+public:
+	FastGotoh(float, float, float, float, int, int);
+	~FastGotoh() {}
+	void align(string, string);
+
+private:
+	int gapOpen;
+	int gapExtend;
+	int match;
+	int mismatch;
+
+	void scoreDiagonal(int, unsigned char*);
+};
+
+/**************************************************************************************************/
+
+#endif
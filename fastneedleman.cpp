@@ -0,0 +1,104 @@
+//
+//  fastneedleman.cpp
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+//  If mothur is compiled with AVX2 enabled (-mavx2 or -march=native) 8 cells of an anti-diagonal are scored at a time,
+//  otherwise one cell at a time.
+//
+
+#ifdef __AVX2__
+	#include <immintrin.h>
+#endif
+
+#include "fastneedleman.hpp"
+
+/**************************************************************************************************/
+
+FastNeedleman::FastNeedleman(float gO, float f, float mm, int r, int b) :
+gap((int)gO), match((int)f), mismatch((int)mm), FastAlignment(r, b) {
+	numBuffers = 3;		//	the scores of the last three anti-diagonals
+}
+/**************************************************************************************************/
+
+void FastNeedleman::align(string A, string B){
+	try {
+		seqA = ' ' + A;	lA = seqA.length();		//	algorithm requires a dummy space at the beginning of each string
+		seqB = ' ' + B;	lB = seqB.length();		//	algorithm requires a dummy space at the beginning of each string
+
+		setDiagonals();
+		fillMatrix();
+		setOverlap();				//	Fix gaps at the beginning and end of the sequences
+		traceBackPacked();			//	Traceback the alignment to populate seqAaln and seqBaln
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FastNeedleman", "align");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+void FastNeedleman::scoreDiagonal(int k, unsigned char* cells){
+	try {
+		int start = diagonalStart[k];
+		int end = diagonalEnd[k];
+
+		int* current = getBuffer(k % 3);
+		int* previous = getBuffer((k - 1) % 3);
+		int* previous2 = getBuffer((k - 2) % 3);
+		setEdges(previous, k - 1, start - 1, end);
+		setEdges(previous2, k - 2, start - 1, end - 1);
+
+		const char* rows = rowBases.c_str();
+		const char* columns = revColumnBases.c_str();
+		int shift = lA - 1 - k;				//	columns[shift + i] is seqA[k - i]
+		int i = start;
+
+#ifdef __AVX2__
+		__m256i gapV = _mm256_set1_epi32(gap);
+		__m256i matchV = _mm256_set1_epi32(match);
+		__m256i mismatchV = _mm256_set1_epi32(mismatch);
+
+		for (int group = 0; i <= end; i += 8, group++) {
+			__m256i rowBase = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(rows + i)));
+			__m256i columnBase = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(columns + shift + i)));
+			__m256i score = _mm256_blendv_epi8(mismatchV, matchV, _mm256_cmpeq_epi32(rowBase, columnBase));
+
+			__m256i diagonal = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(previous2 + i - 1)), score);
+			__m256i up = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(previous + i - 1)), gapV);
+			__m256i left = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(previous + i)), gapV);
+
+			__m256i isUp = _mm256_cmpgt_epi32(up, diagonal);
+			__m256i best = _mm256_max_epi32(diagonal, up);
+			__m256i isLeft = _mm256_cmpgt_epi32(left, best);
+			_mm256_storeu_si256((__m256i*)(current + i), _mm256_max_epi32(best, left));
+
+			cells[2 * group] = (unsigned char)_mm256_movemask_ps(_mm256_castsi256_ps(isUp));
+			cells[2 * group + 1] = (unsigned char)_mm256_movemask_ps(_mm256_castsi256_ps(isLeft));
+		}
+#else
+		for (int group = 0; i <= end; group++) {
+			unsigned char upBits = 0;
+			unsigned char leftBits = 0;
+			for (int bit = 0; (bit < 8) && (i <= end); bit++, i++) {
+				int diagonal = previous2[i - 1] + ((rows[i] == columns[shift + i]) ? match : mismatch);
+				int up = previous[i - 1] + gap;
+				int left = previous[i] + gap;
+
+				int best = diagonal;			//	ties go to the diagonal, then up, as in NeedlemanOverlap
+				if (up > best)		{ best = up;	upBits |= (1 << bit);	}
+				if (left > best)	{ best = left;	leftBits |= (1 << bit);	}
+				current[i] = best;
+			}
+			cells[2 * group] = upBits;
+			cells[2 * group + 1] = leftBits;
+		}
+#endif
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FastNeedleman", "scoreDiagonal");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
@@ -0,0 +1,36 @@
+//
+//  fastneedleman.hpp
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+#ifndef Mothur_fastneedleman_hpp
+#define Mothur_fastneedleman_hpp
+
+#include "mothur.h"
+#include "fastalignment.hpp"
+
+/**************************************************************************************************/
+
+/* Needleman-Wunsch alignment with the same gap penalty for every gapped position, giving the same alignments as
+ NeedlemanOverlap.  The scores must be whole numbers, see FastAlignment. */
+
+class FastNeedleman : public FastAlignment {
+
+public:
+	FastNeedleman(float, float, float, int, int);
+	~FastNeedleman() {}
+	void align(string, string);
+
+private:
+	int gap;
+	int match;
+	int mismatch;
+
+	void scoreDiagonal(int, unsigned char*);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -63,10 +63,10 @@ public:
 	
 	}
 	
-	void doTrump(Sequence seq) {
+	void doTrump(Sequence& seq) { doTrump(seq.getAligned().c_str()); }
+	
+	void doTrump(const char* curAligned) {
 	
-		string curAligned = seq.getAligned();
-
 		for(int j = 0; j < alignmentLength; j++) {
 			if(curAligned[j] == trump){
 				filter[j] = '0';
@@ -86,16 +86,30 @@ public:
         if (filter.length() != alignmentLength) {  m->mothurOut("[ERROR]: Sequences are not all the same length as the filter, please correct.\n");  m->control_pressed = true; }
 	}
 
-	void getFreqs(Sequence seq) {
+	void getFreqs(Sequence& seq) { getFreqs(seq.getAligned().c_str()); }
 	
-		string curAligned = seq.getAligned();
+	//one pass over the columns for each base, so the compiler can count many columns at once
+	void getFreqs(const char* curAligned) {
+		
+		addMatches(curAligned, a, 'A', 'a');
+		addMatches(curAligned, t, 'T', 't');
+		addMatches(curAligned, t, 'U', 'u');
+		addMatches(curAligned, g, 'G', 'g');
+		addMatches(curAligned, c, 'C', 'c');
+		addMatches(curAligned, gap, '-', '.');
+	}
 	
-		for(int j=0;j<alignmentLength;j++){
-			if(toupper(curAligned[j]) == 'A')										{	a[j]++;		}
-			else if(toupper(curAligned[j]) == 'T' || toupper(curAligned[j]) == 'U')	{	t[j]++;		}
-			else if(toupper(curAligned[j]) == 'G')									{	g[j]++;		}
-			else if(toupper(curAligned[j]) == 'C')									{	c[j]++;		}
-			else if(curAligned[j] == '-' || curAligned[j] == '.')					{	gap[j]++;	}
+	//adds the filter and counts of a Filters that looked at other sequences
+	void merge(Filters& other) {
+		for(int i=0;i<alignmentLength;i++){
+			if(other.filter[i] == '0'){ filter[i] = '0'; }
+		}
+		if (a.size() != 0) {
+			for (int k = 0; k < alignmentLength; k++) {	 a[k] += other.a[k];       }
+			for (int k = 0; k < alignmentLength; k++) {	 t[k] += other.t[k];       }
+			for (int k = 0; k < alignmentLength; k++) {	 g[k] += other.g[k];       }
+			for (int k = 0; k < alignmentLength; k++) {	 c[k] += other.c[k];       }
+			for (int k = 0; k < alignmentLength; k++) {	 gap[k] += other.gap[k];   }
 		}
 	}
 		
@@ -105,6 +119,12 @@ protected:
 	float soft;
 	char trump;
 	MothurOut* m;
+	
+	void addMatches(const char* curAligned, vector<int>& counts, char upper, char lower) {
+		int* columns = &counts[0];
+		int length = alignmentLength;
+		for(int j=0;j<length;j++){ columns[j] += ((curAligned[j] == upper) | (curAligned[j] == lower)); }
+	}
 
 };
 
@@ -20,6 +20,7 @@ vector<string> FilterSeqsCommand::setParameters(){
 		CommandParameter psoft("soft", "Number", "", "0", "", "", "","",false,false); parameters.push_back(psoft);
 		CommandParameter pvertical("vertical", "Boolean", "", "T", "", "", "","",false,false, true); parameters.push_back(pvertical);
 		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false, true); parameters.push_back(pprocessors);
+		CommandParameter pcache("cache", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pcache);
 		CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
 		
@@ -37,7 +38,7 @@ string FilterSeqsCommand::getHelpString(){
 	try {
 		string helpString = "";
 		helpString += "The filter.seqs command reads a file containing sequences and creates a .filter and .filter.fasta file.\n";
-		helpString += "The filter.seqs command parameters are fasta, trump, soft, hard, processors and vertical. \n";
+		helpString += "The filter.seqs command parameters are fasta, trump, soft, hard, processors, cache and vertical. \n";
 		helpString += "The fasta parameter is required, unless you have a valid current fasta file. You may enter several fasta files to build the filter from and filter, by separating their names with -'s.\n";
 		helpString += "For example: fasta=abrecovery.fasta-amazon.fasta \n";
 		helpString += "The trump option will remove a column if the trump character is found at that position in any sequence of the alignment. Default=*, meaning no trump. \n";
@@ -45,6 +46,7 @@ string FilterSeqsCommand::getHelpString(){
 		helpString += "The hard parameter allows you to enter a file containing the filter you want to use.\n";
 		helpString += "The vertical parameter removes columns where all sequences contain a gap character. The default is T.\n";
 		helpString += "The processors parameter allows you to specify the number of processors to use. The default is 1.\n";
+		helpString += "The cache parameter keeps the alignment in memory while the filter is made, so each fasta file is read once instead of twice. It needs enough memory for the aligned sequences. The default is F.\n";
 		helpString += "The filter.seqs command should be in the following format: \n";
 		helpString += "filter.seqs(fasta=yourFastaFile, trump=yourTrump) \n";
 		helpString += "Example filter.seqs(fasta=abrecovery.fasta, trump=.).\n";
@@ -75,7 +77,7 @@ string FilterSeqsCommand::getOutputPattern(string type) {
 //**********************************************************************************************************************
 FilterSeqsCommand::FilterSeqsCommand(){	
 	try {
-		abort = true; calledHelp = true; 
+		abort = true; calledHelp = true; cache = false;
 		setParameters();
 		vector<string> tempOutNames;
 		outputTypes["fasta"] = tempOutNames;
@@ -89,7 +91,7 @@ FilterSeqsCommand::FilterSeqsCommand(){
 /**************************************************************************************/
 FilterSeqsCommand::FilterSeqsCommand(string option)  {
 	try {
-		abort = false; calledHelp = false;   
+		abort = false; calledHelp = false; cache = false;
 		filterFileName = "";
 		
 		//allow user to run help
@@ -245,6 +247,9 @@ FilterSeqsCommand::FilterSeqsCommand(string option)  {
 			m->setProcessors(temp);
 			m->mothurConvert(temp, processors); 
 			
+			temp = validParameter.validFile(parameters, "cache", false);		if (temp == "not found") { temp = "F"; }
+			cache = m->isTrue(temp);
+			
 			vertical = validParameter.validFile(parameters, "vertical", false);		
 			if (vertical == "not found") { 
 				if ((hard == "") && (trump == '*') && (soft == 0)) { vertical = "T"; } //you have not given a hard file or set the trump char.
@@ -445,6 +450,16 @@ int FilterSeqsCommand::filterSequences() {
 				
 #else
             
+            if (cache) {
+                numSeqs += runFilterCached(filteredFasta, getCachedSeqs(s));
+                delete cachedSeqs[s]; cachedSeqs[s] = NULL;
+                
+                if (m->control_pressed) {  return 1; }
+                
+                outputNames.push_back(filteredFasta); outputTypes["fasta"].push_back(filteredFasta);
+                continue;
+            }
+            
             vector<unsigned long long> positions;
             if (savedPositions.size() != 0) { positions = savedPositions[s]; }
             else {
@@ -591,7 +606,9 @@ int FilterSeqsCommand::driverRunFilter(string F, string outputFilename, string i
 		ifstream in;
 		m->openInputFile(inputFilename, in);
 				
-		in.seekg(filePos->start);
+		if (filePos->start != 0) { in.seekg(filePos->start); }
+		
+		vector<int> columns = getFilterColumns();
 
 		bool done = false;
 		int count = 0;
@@ -602,22 +619,17 @@ int FilterSeqsCommand::driverRunFilter(string F, string outputFilename, string i
 				
 				Sequence seq(in); m->gobble(in);
 				if (seq.getName() != "") {
-					string align = seq.getAligned();
-					string filterSeq = "";
+					const string& align = seq.getAligned();
+					string filterSeq(columns.size(), ' ');
 					
-					for(int j=0;j<alignmentLength;j++){
-						if(filter[j] == '1'){
-							filterSeq += align[j];
-						}
-					}
+					for(int j=0;j<columns.size();j++){ filterSeq[j] = align[columns[j]]; }
 					
 					out << '>' << seq.getName() << endl << filterSeq << endl;
 				count++;
 			}
 			
 			#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				unsigned long long pos = in.tellg();
-				if ((pos == -1) || (pos >= filePos->end)) { break; }
+				if (m->endOfPart(in, filePos->end)) { break; }
 			#else
 				if (in.eof()) { break; }
 			#endif
@@ -838,6 +850,12 @@ string FilterSeqsCommand::createFilter() {
 				
 #else
 				
+                if (cache) {
+                    numSeqs += createFilterCached(F, getCachedSeqs(s));
+                    if (m->control_pressed) {  return filterString; }
+                    continue;
+                }
+                
                 vector<unsigned long long> positions;
 		#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
 				positions = m->divideFile(fastafileNames[s], processors);
@@ -979,7 +997,7 @@ int FilterSeqsCommand::driverCreateFilter(Filters& F, string filename, linePair*
 		ifstream in;
 		m->openInputFile(filename, in);
 				
-		in.seekg(filePos->start);
+		if (filePos->start != 0) { in.seekg(filePos->start); }
 
 		bool done = false;
 		int count = 0;
@@ -1000,8 +1018,7 @@ int FilterSeqsCommand::driverCreateFilter(Filters& F, string filename, linePair*
 			}
 			
 			#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				unsigned long long pos = in.tellg();
-				if ((pos == -1) || (pos >= filePos->end)) { break; }
+				if (m->endOfPart(in, filePos->end)) { break; }
 			#else
 				if (in.eof()) { break; }
 			#endif
@@ -1020,6 +1037,169 @@ int FilterSeqsCommand::driverCreateFilter(Filters& F, string filename, linePair*
 		exit(1);
 	}
 }
+/**************************************************************************************/
+//the columns of the alignment the filter keeps, in order
+vector<int> FilterSeqsCommand::getFilterColumns() {	
+	try {
+		vector<int> columns;
+		for(int j=0;j<alignmentLength;j++){
+			if(filter[j] == '1'){ columns.push_back(j); }
+		}
+		return columns;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FilterSeqsCommand", "getFilterColumns");
+		exit(1);
+	}
+}
+/**************************************************************************************/
+//reads fasta file s into memory the first time it is needed, so createFilter and filterSequences read it once
+SequenceDB* FilterSeqsCommand::getCachedSeqs(int s) {	
+	try {
+		if (cachedSeqs.size() != fastafileNames.size()) { cachedSeqs.resize(fastafileNames.size(), NULL); }
+		
+		if (cachedSeqs[s] == NULL) {
+			ifstream in;
+			m->openInputFile(fastafileNames[s], in);
+			cachedSeqs[s] = new SequenceDB(in);
+			
+			for (int i = 0; i < cachedSeqs[s]->getNumSeqs(); i++) {
+				if (cachedSeqs[s]->getAlignedLength(i) != alignmentLength) { m->mothurOut("[ERROR]: Sequences are not all the same length, please correct."); m->mothurOutEndLine(); m->control_pressed = true; break; }
+			}
+		}
+		
+		return cachedSeqs[s];
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FilterSeqsCommand", "getCachedSeqs");
+		exit(1);
+	}
+}
+/**************************************************************************************/
+//each thread counts its share of the sequences into its own Filters, which are added to F when they finish
+int FilterSeqsCommand::createFilterCached(Filters& F, SequenceDB* seqs) {	
+	try {
+		int numFastaSeqs = seqs->getNumSeqs();
+		if (m->control_pressed) { return 0; }
+		
+		int numThreads = max(1, min(processors, numFastaSeqs));
+		
+		vector<Filters*> threadFilters;
+		vector<thread*> workers;
+		for (int i = 0; i < numThreads; i++) {
+			Filters* threadFilter = new Filters();
+			if (trump != '*')		{  threadFilter->setTrump(trump);	}
+			threadFilter->setLength(alignmentLength);
+			threadFilter->initialize();
+			threadFilter->setFilter(string(alignmentLength, '1'));
+			threadFilters.push_back(threadFilter);
+			
+			int start = (long long)i * numFastaSeqs / numThreads;
+			int end = (long long)(i+1) * numFastaSeqs / numThreads;
+			workers.push_back(new thread(&FilterSeqsCommand::countWorker, this, threadFilter, seqs, start, end));
+		}
+		
+		for (int i = 0; i < workers.size(); i++) { 
+			workers[i]->join(); delete workers[i]; 
+			F.merge(*threadFilters[i]); delete threadFilters[i];
+		}
+		
+		m->mothurOutJustToScreen(toString(numFastaSeqs)+"\n");
+		
+		return numFastaSeqs;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FilterSeqsCommand", "createFilterCached");
+		exit(1);
+	}
+}
+/**************************************************************************************/
+void FilterSeqsCommand::countWorker(Filters* F, SequenceDB* seqs, int start, int end) {	
+	try {
+		bool countBases = (m->isTrue(vertical) || (soft != 0));
+		
+		for (int i = start; i < end; i++) {
+			if (m->control_pressed) { break; }
+			
+			const char* aligned = seqs->getAligned(i);
+			if(trump != '*')	{	F->doTrump(aligned);		}
+			if(countBases)		{	F->getFreqs(aligned);	}
+			
+			//report progress
+			if((start == 0) && ((i+1) % 100 == 0)){	m->mothurOutJustToScreen(toString(i+1)+"\n"); 		}
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FilterSeqsCommand", "countWorker");
+		exit(1);
+	}
+}
+/**************************************************************************************/
+//each thread filters its share of the sequences into its own file, which are appended in order
+int FilterSeqsCommand::runFilterCached(string filteredFasta, SequenceDB* seqs) {	
+	try {
+		int numFastaSeqs = seqs->getNumSeqs();
+		if (m->control_pressed) { return 0; }
+		
+		vector<int> columns = getFilterColumns();
+		int numThreads = max(1, min(processors, numFastaSeqs));
+		
+		vector<string> outputFileNames;
+		vector<thread*> workers;
+		for (int i = 0; i < numThreads; i++) {
+			string outputFileName = filteredFasta;
+			if (i != 0) { outputFileName = filteredFasta + toString(i) + ".temp"; }
+			outputFileNames.push_back(outputFileName);
+			
+			int start = (long long)i * numFastaSeqs / numThreads;
+			int end = (long long)(i+1) * numFastaSeqs / numThreads;
+			workers.push_back(new thread(&FilterSeqsCommand::filterWorker, this, seqs, start, end, outputFileName, &columns));
+		}
+		
+		for (int i = 0; i < workers.size(); i++) { workers[i]->join(); delete workers[i]; }
+		
+		for (int i = 1; i < outputFileNames.size(); i++) {
+			m->appendFiles(outputFileNames[i], filteredFasta);
+			m->mothurRemove(outputFileNames[i]);
+		}
+		
+		m->mothurOutJustToScreen(toString(numFastaSeqs)+"\n");
+		
+		return numFastaSeqs;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FilterSeqsCommand", "runFilterCached");
+		exit(1);
+	}
+}
+/**************************************************************************************/
+void FilterSeqsCommand::filterWorker(SequenceDB* seqs, int start, int end, string outputFileName, vector<int>* columns) {	
+	try {
+		ofstream out;
+		m->openOutputFile(outputFileName, out);
+		
+		int numColumns = columns->size();
+		string filterSeq(numColumns, ' ');
+		
+		for (int i = start; i < end; i++) {
+			if (m->control_pressed) { break; }
+			
+			const char* aligned = seqs->getAligned(i);
+			for (int j = 0; j < numColumns; j++) { filterSeq[j] = aligned[(*columns)[j]]; }
+			
+			out << '>' << seqs->getName(i) << '\n' << filterSeq << '\n';
+			
+			//report progress
+			if((start == 0) && ((i+1) % 100 == 0)){	m->mothurOutJustToScreen(toString(i+1)+"\n"); 		}
+		}
+		
+		out.close();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "FilterSeqsCommand", "filterWorker");
+		exit(1);
+	}
+}
 #ifdef USE_MPI
 /**************************************************************************************/
 int FilterSeqsCommand::MPICreateFilter(int start, int num, Filters& F, MPI_File& inMPI, vector<unsigned long long>& MPIPos) {	
@@ -12,6 +12,8 @@
 
 #include "command.hpp"
 #include "filters.h"
+#include "sequencedb.h"
+#include <thread>
 
 class Sequence;
 class FilterSeqsCommand : public Command {
@@ -19,7 +21,7 @@ class FilterSeqsCommand : public Command {
 public:
 	FilterSeqsCommand(string);
 	FilterSeqsCommand();
-	~FilterSeqsCommand() {};
+	~FilterSeqsCommand() { for (int i = 0; i < cachedSeqs.size(); i++) { if (cachedSeqs[i] != NULL) { delete cachedSeqs[i]; } } }
 	
 	vector<string> setParameters();
 	string getCommandName()			{ return "filter.seqs";			}
@@ -49,9 +51,10 @@ private:
 	int alignmentLength, processors;
 	vector<int> bufferSizes;
 	vector<string> outputNames;
+	vector<SequenceDB*> cachedSeqs;		//the fasta files kept in memory by createFilter when cache=t, NULL until read
 
 	char trump;
-	bool abort;
+	bool abort, cache;
 	float soft;
 	int numSeqs;
 	
@@ -61,6 +64,12 @@ private:
 	int createProcessesRunFilter(string, string, string);
 	int driverRunFilter(string, string, string, linePair*);
 	int driverCreateFilter(Filters& F, string filename, linePair* line);
+	vector<int> getFilterColumns();
+	SequenceDB* getCachedSeqs(int);
+	int createFilterCached(Filters&, SequenceDB*);
+	int runFilterCached(string, SequenceDB*);
+	void countWorker(Filters*, SequenceDB*, int, int);
+	void filterWorker(SequenceDB*, int, int, string, vector<int>*);
 	#ifdef USE_MPI
 	int driverMPIRun(int, int, MPI_File&, MPI_File&, vector<unsigned long long>&);
 	int MPICreateFilter(int, int, Filters&, MPI_File&, vector<unsigned long long>&);	
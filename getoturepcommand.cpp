@@ -607,11 +607,11 @@ int GetOTURepCommand::readDist() {
 			// all distances of a certain sequence. Vector and maps are accessed
 			// via the index of a sequence in the distance matrix
 			seqVec = vector<SeqMap>(list->size()); 
-            for (int i = 0; i < matrix->seqVec.size(); i++) {
-                for (int j = 0; j < matrix->seqVec[i].size(); j++) {
+            for (int i = 0; i < matrix->getNumRows(); i++) {
+                for (int j = 0; j < matrix->getNumCells(i); j++) {
                     if (m->control_pressed) { delete readMatrix; return 0; }
                     //already added everyone else in row
-                    if (i < matrix->seqVec[i][j].index) {  seqVec[i][matrix->seqVec[i][j].index] = matrix->seqVec[i][j].dist;  }
+                    if (i < matrix->getIndex(i, j)) {  seqVec[i][matrix->getIndex(i, j)] = matrix->getDist(i, j);  }
                 }
 			}
 			//add dummy map for unweighted calc
@@ -21,7 +21,7 @@ Kmer::Kmer(int size) : kmerSize(size) {	//	The constructor sets the size of the
 
 /**************************************************************************************************/
 
-string Kmer::getKmerString(string sequence){	//	Calculate kmer for each position in the sequence, count the freq
+string Kmer::getKmerString(const string& sequence){	//	Calculate kmer for each position in the sequence, count the freq
 	int length = sequence.length();				//	of each kmer, and convert it to an ascii character with base '!'.
 	int nKmers = length - kmerSize + 1;			//	Export the string of characters as a string
 	vector<int> counts(maxKmer, 0);
@@ -67,7 +67,7 @@ vector< map<int, int> > Kmer::getKmerCounts(string sequence){	//	Calculate kmer
 	
 /**************************************************************************************************/
 
-int Kmer::getKmerNumber(string sequence, int index){
+int Kmer::getKmerNumber(const string& sequence, int index){
 	
 //	Here we convert a kmer to a number between 0 and maxKmer.  For example, AAAA would equal 0 and TTTT would equal 255.
 //	If there's an N in the kmer, it is set to 256 (if we are looking at 4mers).  The largest we can look at are 8mers,
@@ -97,6 +97,41 @@ int Kmer::getKmerNumber(string sequence, int index){
 	return kmer;	
 }
 	
+/**************************************************************************************************/
+
+void Kmer::getKmerNumbers(const string& sequence, vector<int>& kmers){
+	
+//	Gives the same numbers as getKmerNumber, but each kmer is made from the one before it by shifting out the first base
+//	and adding the next one, instead of starting over at every position.  We remember where the last N was so any kmer
+//	that includes it is set to 4^kmerSize.
+	
+	int power4s[14] = { 1, 4, 16, 64, 256, 1024, 4096, 16384, 65536, 262144, 1048576, 4194304, 16777216, 67108864 };
+	
+	int mask = power4s[kmerSize] - 1;
+	int length = sequence.length();
+	
+	kmers.clear();
+	if (length >= kmerSize) { kmers.reserve(length - kmerSize + 1); }
+	
+	int kmer = 0;
+	int lastN = -1;
+	for(int i=0;i<length;i++){
+		char base = toupper(sequence[i]);
+		int value = 0;											//	anything that isn't ACGTUN counts as an A, like getKmerNumber
+		if(base == 'C')							{	value = 1;	}
+		else if(base == 'G')					{	value = 2;	}
+		else if((base == 'T') || (base == 'U'))	{	value = 3;	}
+		else if(base == 'N')					{	lastN = i;	}
+		
+		kmer = ((kmer << 2) | value) & mask;
+		
+		if(i >= kmerSize-1){
+			if(lastN > (i - kmerSize))	{	kmers.push_back(power4s[kmerSize]);	}
+			else						{	kmers.push_back(kmer);				}
+		}
+	}
+}
+	
 /**************************************************************************************************/
 	
 string Kmer::getKmerBases(int kmerNumber){
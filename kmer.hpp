@@ -18,8 +18,9 @@ class Kmer {
 	
 public:
 	Kmer(int);
-	string getKmerString(string);
-	int getKmerNumber(string, int);
+	string getKmerString(const string&);
+	int getKmerNumber(const string&, int);
+	void getKmerNumbers(const string&, vector<int>&);	//fills the vector with the kmer number at each position of the sequence
 	string getKmerBases(int);
 	int getReverseKmerNumber(int);
 	vector< map<int, int> > getKmerCounts(string sequence);  //for use in chimeraCheck
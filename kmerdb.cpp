@@ -14,6 +14,8 @@
  *	then will read in the database file (readKmerDB), otherwise it will generate one and store the data in memory
  *	(generateKmerDB)
  *
+ *	The database file is written in the binary format described in kmerdb.hpp.
+ *
  *	The search method used here is roughly the same as that used in the SimRank program that is found at the
  *	greengenes website.  The default kmer size is 7.  The speed complexity is between O(L) and O(LN).  When I use 7mers
  *	on average a kmer is found in ~100 other sequences with a database of ~5000 sequences.  If this is the case then the
@@ -27,6 +29,28 @@
 #include "database.hpp"
 #include "kmerdb.hpp"
 
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+	#include <sys/mman.h>
+	#include <fcntl.h>
+#endif
+
+static const char kmerDBMagic[8] = { 'M', 'T', 'H', 'R', 'K', 'M', 'E', 'R' };
+static const unsigned int kmerDBVersion = 1;
+
+/**************************************************************************************************/
+//7 bits per byte, low bits first, the high bit is set if more bytes follow
+static void writeVarint(vector<unsigned char>& data, unsigned int value) {
+	while (value >= 128) { data.push_back((value & 127) | 128); value >>= 7; }
+	data.push_back(value);
+}
+/**************************************************************************************************/
+static inline unsigned int readVarint(const unsigned char*& p) {
+	unsigned int value = 0;
+	int shift = 0;
+	while (*p & 128) { value |= (unsigned int)(*p & 127) << shift; shift += 7; p++; }
+	value |= (unsigned int)(*p) << shift; p++;
+	return value;
+}
 /**************************************************************************************************/
 
 KmerDB::KmerDB(string fastaFileName, int kSize) : Database(), kmerSize(kSize) {
@@ -37,6 +61,9 @@ KmerDB::KmerDB(string fastaFileName, int kSize) : Database(), kmerSize(kSize) {
 		int power4s[14] = { 1, 4, 16, 64, 256, 1024, 4096, 16384, 65536, 262144, 1048576, 4194304, 16777216, 67108864 };
 		count = 0;
 		
+		mappedData = NULL; mappedSize = 0;
+		kmerOffsets = NULL; kmerData = NULL;
+		
 		maxKmer = power4s[kmerSize];
 		kmerLocations.resize(maxKmer+1);
 		
@@ -48,10 +75,14 @@ KmerDB::KmerDB(string fastaFileName, int kSize) : Database(), kmerSize(kSize) {
 
 }
 /**************************************************************************************************/
-KmerDB::KmerDB() : Database() {}
+KmerDB::KmerDB() : Database() { mappedData = NULL; mappedSize = 0; kmerOffsets = NULL; kmerData = NULL; }
 /**************************************************************************************************/
 
-KmerDB::~KmerDB(){}
+KmerDB::~KmerDB(){
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+	if (mappedData != NULL) { munmap(mappedData, mappedSize); }
+#endif
+}
 
 /**************************************************************************************************/
 
@@ -60,86 +91,289 @@ vector<int> KmerDB::findClosestSequences(Sequence* candidateSeq, int num){
 		if (num > numSeqs) { m->mothurOut("[WARNING]: you requested " + toString(num) + " closest sequences, but the template only contains " + toString(numSeqs) + ", adjusting."); m->mothurOutEndLine(); num = numSeqs; }
 		
 		vector<int> topMatches;
-		Kmer kmer(kmerSize);
 		searchScore = 0;
 		Scores.clear();
 		
-		vector<int> matches(numSeqs, 0);						//	a record of the sequences with shared kmers
-		vector<int> timesKmerFound(kmerLocations.size()+1, 0);	//	a record of the kmers that we have already found
-		
 		int numKmers = candidateSeq->getNumBases() - kmerSize + 1;	
-	
-		for(int i=0;i<numKmers;i++){
-			int kmerNumber = kmer.getKmerNumber(candidateSeq->getUnaligned(), i);		//	go through the query sequence and get a kmer number
-			if(timesKmerFound[kmerNumber] == 0){				//	if we haven't seen it before...
-				for(int j=0;j<kmerLocations[kmerNumber].size();j++){//increase the count for each sequence that also has
-					matches[kmerLocations[kmerNumber][j]]++;	//	that kmer
-				}
+		
+		findQueryKmers(candidateSeq->getUnaligned(), numKmers);
+		
+		vector<seqMatch> seqMatches;
+		if (queryKmers.size() <= 65535) {	scoreSequences(matchCounts, num, seqMatches);		}
+		else							{	scoreSequences(wideMatchCounts, num, seqMatches);	}
+		
+		if (seqMatches.size() == 0) { return topMatches; }
+		
+		searchScore = seqMatches[0].match;
+		searchScore = 100 * searchScore / (float) numKmers;		//	return the Sequence object corresponding to the db
+		
+		//save top matches
+		for (int i = 0; i < seqMatches.size(); i++) {
+			topMatches.push_back(seqMatches[i].seq);
+			float thisScore = 100 * seqMatches[i].match / (float) numKmers;
+			Scores.push_back(thisScore);
+		}
+		
+		return topMatches;		
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "findClosestSequences");
+		exit(1);
+	}	
+}
+/**************************************************************************************************/
+//finds the closest sequences to the query and to its reverse complement at the same time and returns the better set,
+//so the orientation of a read is known before it is aligned
+vector<int> KmerDB::findClosestBothStrands(Sequence* candidateSeq, int num, bool& reversed){
+	try {
+		if (num > numSeqs) { m->mothurOut("[WARNING]: you requested " + toString(num) + " closest sequences, but the template only contains " + toString(numSeqs) + ", adjusting."); m->mothurOutEndLine(); num = numSeqs; }
+		
+		vector<int> topMatches;
+		searchScore = 0;
+		Scores.clear();
+		reversed = false;
+		
+		int numKmers = candidateSeq->getNumBases() - kmerSize + 1;
+		
+		findQueryKmers(candidateSeq->getUnaligned(), numKmers);
+		forwardKmers.swap(queryKmers);
+		
+		Sequence copy(candidateSeq->getName(), candidateSeq->getUnaligned());
+		copy.reverseComplement();
+		findQueryKmers(copy.getUnaligned(), numKmers);
+		
+		if (kmerSeen.size() == 0) { kmerSeen.resize(maxKmer/64 + 1, 0); }
+		
+		//the kmers of both strands, each listed once with the strands that have it
+		strandKmers.clear(); strandMasks.clear();
+		for(int i=0;i<queryKmers.size();i++){ kmerSeen[queryKmers[i] >> 6] |= 1ULL << (queryKmers[i] & 63); }
+		for(int i=0;i<forwardKmers.size();i++){
+			bool inReverse = ((kmerSeen[forwardKmers[i] >> 6] & (1ULL << (forwardKmers[i] & 63))) != 0);
+			strandKmers.push_back(forwardKmers[i]); strandMasks.push_back(inReverse ? 3 : 1);
+		}
+		for(int i=0;i<queryKmers.size();i++){ kmerSeen[queryKmers[i] >> 6] = 0; }
+		
+		for(int i=0;i<forwardKmers.size();i++){ kmerSeen[forwardKmers[i] >> 6] |= 1ULL << (forwardKmers[i] & 63); }
+		for(int i=0;i<queryKmers.size();i++){
+			bool inForward = ((kmerSeen[queryKmers[i] >> 6] & (1ULL << (queryKmers[i] & 63))) != 0);
+			if (!inForward) { strandKmers.push_back(queryKmers[i]); strandMasks.push_back(2); }
+		}
+		for(int i=0;i<forwardKmers.size();i++){ kmerSeen[forwardKmers[i] >> 6] = 0; }
+		
+		vector<seqMatch> forwardMatches, reverseMatches;
+		if (max(forwardKmers.size(), queryKmers.size()) <= 65535) {	scoreBothStrands(matchCounts, reverseCounts, num, forwardMatches, reverseMatches);			}
+		else														{	scoreBothStrands(wideMatchCounts, wideReverseCounts, num, forwardMatches, reverseMatches);	}
+		
+		//ties go to the forward strand
+		if ((reverseMatches.size() != 0) && ((forwardMatches.size() == 0) || (reverseMatches[0].match > forwardMatches[0].match))) {
+			reversed = true;
+			forwardMatches.swap(reverseMatches);
+		}
+		
+		if (forwardMatches.size() == 0) { return topMatches; }
+		
+		searchScore = forwardMatches[0].match;
+		searchScore = 100 * searchScore / (float) numKmers;
+		
+		for (int i = 0; i < forwardMatches.size(); i++) {
+			topMatches.push_back(forwardMatches[i].seq);
+			float thisScore = 100 * forwardMatches[i].match / (float) numKmers;
+			Scores.push_back(thisScore);
+		}
+		
+		return topMatches;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "findClosestBothStrands");
+		exit(1);
+	}	
+}
+/**************************************************************************************************/
+//fills queryKmers with the different kmers in the first numKmers positions of the query
+void KmerDB::findQueryKmers(const string& unaligned, int numKmers){
+	try {
+		Kmer kmer(kmerSize);
+		kmer.getKmerNumbers(unaligned, positionKmers);
+		
+		if (kmerSeen.size() == 0) { kmerSeen.resize(maxKmer/64 + 1, 0); }
+		
+		queryKmers.clear();
+		for(int i=0;(i<numKmers) && (i<positionKmers.size());i++){
+			int kmerNumber = positionKmers[i];
+			unsigned long long bit = 1ULL << (kmerNumber & 63);
+			if ((kmerSeen[kmerNumber >> 6] & bit) == 0) {		//	if we haven't seen it before...
+				kmerSeen[kmerNumber >> 6] |= bit;
+				queryKmers.push_back(kmerNumber);
 			}
-			timesKmerFound[kmerNumber] = 1;						//	ok, we've seen the kmer now
 		}
 		
-		if (num != 1) {
-			vector<seqMatch> seqMatches; seqMatches.resize(numSeqs);
-			for(int i=0;i<numSeqs;i++){		
-				seqMatches[i].seq = i;
-				seqMatches[i].match = matches[i];
+		//only the bits we set need to be cleared for the next query
+		for(int i=0;i<queryKmers.size();i++){ kmerSeen[queryKmers[i] >> 6] = 0; }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "findQueryKmers");
+		exit(1);
+	}	
+}
+/**************************************************************************************************/
+//counts the kmers each template shares with the query and returns the num best, most matches first and then the lowest index.
+template<class T> 
+void KmerDB::scoreSequences(vector<T>& counts, int num, vector<seqMatch>& seqMatches){
+	try {
+		if (counts.size() != numSeqs) { counts.assign(numSeqs, 0); }
+		
+		for(int i=0;i<queryKmers.size();i++){
+			int kmerNumber = queryKmers[i];
+			if (kmerData != NULL) {
+				const unsigned char* p = kmerData + kmerOffsets[kmerNumber];
+				unsigned int numValues = readVarint(p);
+				int seqNumber = 0;
+				for(int j=0;j<numValues;j++){					//	decode the sequence indices as we go
+					seqNumber += readVarint(p);
+					counts[seqNumber]++;
+				}
+			}else {
+				const int* seqNumbers = kmerLocations[kmerNumber].data();
+				int numValues = kmerLocations[kmerNumber].size();
+				for(int j=0;j<numValues;j++){					//increase the count for each sequence that also has
+					counts[seqNumbers[j]]++;					//	that kmer
+				}
 			}
+		}
+		
+		findTopMatches(counts, num, queryKmers.size(), seqMatches);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "scoreSequences");
+		exit(1);
+	}	
+}
+/**************************************************************************************************/
+//scores the query and its reverse complement with one pass over the sequence list of each kmer either of them has
+template<class T> 
+void KmerDB::scoreBothStrands(vector<T>& forward, vector<T>& reverse, int num, vector<seqMatch>& forwardMatches, vector<seqMatch>& reverseMatches){
+	try {
+		if (forward.size() != numSeqs) { forward.assign(numSeqs, 0); }
+		if (reverse.size() != numSeqs) { reverse.assign(numSeqs, 0); }
+		
+		int numForward = 0; int numReverse = 0;
+		for(int i=0;i<strandKmers.size();i++){
+			int kmerNumber = strandKmers[i];
+			bool inForward = ((strandMasks[i] & 1) != 0);
+			bool inReverse = ((strandMasks[i] & 2) != 0);
+			if (inForward) { numForward++; }
+			if (inReverse) { numReverse++; }
 			
-			//sorts putting largest matches first
-			sort(seqMatches.begin(), seqMatches.end(), compareSeqMatches);
-			
-			searchScore = seqMatches[0].match;
-			searchScore = 100 * searchScore / (float) numKmers;		//	return the Sequence object corresponding to the db
-		
-			//save top matches
-			for (int i = 0; i < num; i++) {
-				topMatches.push_back(seqMatches[i].seq);
-				float thisScore = 100 * seqMatches[i].match / (float) numKmers;
-				Scores.push_back(thisScore);
+			if (kmerData != NULL) {
+				const unsigned char* p = kmerData + kmerOffsets[kmerNumber];
+				unsigned int numValues = readVarint(p);
+				int seqNumber = 0;
+				for(int j=0;j<numValues;j++){
+					seqNumber += readVarint(p);
+					if (inForward) { forward[seqNumber]++; }
+					if (inReverse) { reverse[seqNumber]++; }
+				}
+			}else {
+				const int* seqNumbers = kmerLocations[kmerNumber].data();
+				int numValues = kmerLocations[kmerNumber].size();
+				for(int j=0;j<numValues;j++){
+					if (inForward) { forward[seqNumbers[j]]++; }
+					if (inReverse) { reverse[seqNumbers[j]]++; }
+				}
 			}
-		}else{
+		}
+		
+		findTopMatches(forward, num, numForward, forwardMatches);
+		findTopMatches(reverse, num, numReverse, reverseMatches);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "scoreBothStrands");
+		exit(1);
+	}	
+}
+/**************************************************************************************************/
+//returns the num best counts, most matches first and then the lowest index, and zeros the counts for the next query.
+//the best are picked from a histogram of the counts instead of sorting every template
+template<class T> 
+void KmerDB::findTopMatches(vector<T>& counts, int num, int maxCount, vector<seqMatch>& seqMatches){
+	try {
+		seqMatches.clear();
+		if (num == 1) {
 			int bestIndex = 0;
-			int bestMatch = -1;
+			T bestMatch = 0;
 			for(int i=0;i<numSeqs;i++){	
-				
-				if (matches[i] > bestMatch) {
-					bestIndex = i;
-					bestMatch = matches[i];
-				}
+				if (counts[i] > bestMatch) { bestIndex = i; bestMatch = counts[i]; }
+			}
+			seqMatches.push_back(seqMatch(bestIndex, bestMatch));
+		}else if (num > 0) {
+			//no count can be bigger than the number of different kmers in the query
+			vector<int> numWithCount(maxCount+1, 0);
+			for(int i=0;i<numSeqs;i++){ numWithCount[counts[i]]++; }
+			
+			//find the smallest count that makes the top num
+			int threshold = maxCount;
+			int numAbove = 0;
+			while ((threshold > 0) && ((numAbove + numWithCount[threshold]) < num)) { numAbove += numWithCount[threshold]; threshold--; }
+			
+			//everyone above the threshold, then the lowest indexes at it
+			int numAtThreshold = num - numAbove;
+			for(int i=0;i<numSeqs;i++){
+				if (counts[i] > threshold) { seqMatches.push_back(seqMatch(i, counts[i])); }
+				else if ((counts[i] == threshold) && (numAtThreshold > 0)) { seqMatches.push_back(seqMatch(i, counts[i])); numAtThreshold--; }
 			}
 			
-			searchScore = bestMatch;
-			searchScore = 100 * searchScore / (float) numKmers;		//	return the Sequence object corresponding to the db
-			topMatches.push_back(bestIndex);
-			Scores.push_back(searchScore);
+			sort(seqMatches.begin(), seqMatches.end(), compareSeqMatchRank);
 		}
-		return topMatches;		
+		
+		fill(counts.begin(), counts.end(), 0);
 	}
 	catch(exception& e) {
-		m->errorOut(e, "KmerDB", "findClosestSequences");
+		m->errorOut(e, "KmerDB", "findTopMatches");
 		exit(1);
 	}	
 }
-
 /**************************************************************************************************/
 
 void KmerDB::generateDB(){
 	try {
 		
+		//code the sequence indices for each kmer, they are added in order so the differences are never negative
+		vector<unsigned long long> offsets(maxKmer+1, 0);
+		vector<unsigned char> data;
+		for(int i=0;i<maxKmer;i++){								//	step through all of the possible kmer numbers
+			offsets[i] = data.size();
+			writeVarint(data, kmerLocations[i].size());			//	the number of sequences with that kmer
+			int last = 0;
+			for(int j=0;j<kmerLocations[i].size();j++){			//	then the indices of the sequences with that kmer
+				writeVarint(data, kmerLocations[i][j] - last);
+				last = kmerLocations[i][j];
+			}
+		}
+		offsets[maxKmer] = data.size();						//	kmers with an N were never saved, so that kmer is empty
+		writeVarint(data, 0);
+		
 		ofstream kmerFile;										//	once we have the kmerLocations folder print it out
-		m->openOutputFile(kmerDBName, kmerFile);					//	to a file
+		m->openOutputFileBinary(kmerDBName, kmerFile);			//	to a file
 		
 		//output version
 		kmerFile << "#" << m->getVersion() << endl;
 		
-		for(int i=0;i<maxKmer;i++){								//	step through all of the possible kmer numbers
-			kmerFile << i << ' ' << kmerLocations[i].size();	//	print the kmer number and the number of sequences with
-			for(int j=0;j<kmerLocations[i].size();j++){			//	that kmer.  then print out the indices of the sequences
-				kmerFile << ' ' << kmerLocations[i][j];			//	with that kmer.
-			}
-			kmerFile << endl;
-		}
+		unsigned long long headerOffset = kmerFile.tellp();
+		while ((headerOffset % 8) != 0) { kmerFile.put(0); headerOffset++; }
+		
+		kmerDBHeader header;
+		memcpy(header.magic, kmerDBMagic, 8);
+		header.version = kmerDBVersion;
+		header.kmerSize = kmerSize;
+		header.maxKmer = maxKmer;
+		header.numSeqs = count;
+		header.offsetsOffset = headerOffset + sizeof(kmerDBHeader);
+		header.dataOffset = header.offsetsOffset + offsets.size() * sizeof(unsigned long long);
+		header.dataSize = data.size();
+		
+		kmerFile.write((char*)&header, sizeof(kmerDBHeader));
+		kmerFile.write((char*)&offsets[0], offsets.size() * sizeof(unsigned long long));
+		if (data.size() != 0) { kmerFile.write((char*)&data[0], data.size()); }
 		kmerFile.close();
 		
 	}
@@ -150,21 +384,15 @@ void KmerDB::generateDB(){
 	
 }
 /**************************************************************************************************/
-void KmerDB::addSequence(Sequence seq) {
+void KmerDB::addSequence(const Sequence& seq) {
 	try {
-		Kmer kmer(kmerSize);
-		
-		string unaligned = seq.getUnaligned();	//	...take the unaligned sequence...
+		const string& unaligned = seq.getUnaligned();	//	...take the unaligned sequence...
 		int numKmers = unaligned.length() - kmerSize + 1;
-			
-		vector<int> seenBefore(maxKmer+1,0);
-		for(int j=0;j<numKmers;j++){						//	...step though the sequence and get each kmer...
-			int kmerNumber = kmer.getKmerNumber(unaligned, j);
-			if(seenBefore[kmerNumber] == 0){
-				kmerLocations[kmerNumber].push_back(count);		//	...insert the sequence index into kmerLocations for
-			}												//	the appropriate kmer number
-			seenBefore[kmerNumber] = 1;
-		}													
+		
+		findQueryKmers(unaligned, numKmers);				//	...step though the sequence and get each kmer...
+		for(int j=0;j<queryKmers.size();j++){
+			kmerLocations[queryKmers[j]].push_back(count);	//	...insert the sequence index into kmerLocations for
+		}													//	the appropriate kmer number
 	
 		count++;
 	}
@@ -177,7 +405,11 @@ void KmerDB::addSequence(Sequence seq) {
 
 void KmerDB::readKmerDB(ifstream& kmerDBFile){
 	try {
-					
+		
+		if (readBinaryKmerDB()) { kmerDBFile.close(); return; }
+		
+		//text file from an older version
+		kmerDBFile.clear();
 		kmerDBFile.seekg(0);									//	start at the beginning of the file
 		
 		//read version
@@ -204,12 +436,74 @@ void KmerDB::readKmerDB(ifstream& kmerDBFile){
 	}	
 }
 
+/**************************************************************************************************/
+//returns false if the file is not a binary kmer database for this kmer size
+bool KmerDB::readBinaryKmerDB(){
+	try {
+		
+		ifstream in;
+		m->openInputFileBinary(kmerDBName, in);
+		string line = m->getline(in); 
+		
+		unsigned long long headerOffset = line.length() + 1;
+		while ((headerOffset % 8) != 0) { headerOffset++; }
+		
+		kmerDBHeader header;
+		in.seekg(headerOffset);
+		in.read((char*)&header, sizeof(kmerDBHeader));
+		bool good = (in.gcount() == sizeof(kmerDBHeader));
+		in.close();
+		
+		if (!good) { return false; }
+		if (memcmp(header.magic, kmerDBMagic, 8) != 0) { return false; }
+		if ((header.version != kmerDBVersion) || (header.kmerSize != kmerSize) || (header.maxKmer != maxKmer)) { return false; }
+		
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+		int fd = open(kmerDBName.c_str(), O_RDONLY);
+		if (fd == -1) { return false; }
+		struct stat info;
+		if (fstat(fd, &info) == -1) { ::close(fd); return false; }
+		mappedSize = info.st_size;
+		if (mappedSize < (header.dataOffset + header.dataSize)) { ::close(fd); return false; }
+		void* mapped = mmap(NULL, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (mapped == MAP_FAILED) { mappedSize = 0; return false; }
+		mappedData = (char*)mapped;
+#else
+		m->openInputFileBinary(kmerDBName, in);
+		in.seekg(0, ios::end);
+		mappedSize = in.tellg();
+		in.seekg(0, ios::beg);
+		if (mappedSize < (header.dataOffset + header.dataSize)) { in.close(); return false; }
+		buffer.resize(mappedSize);
+		in.read(&buffer[0], mappedSize);
+		in.close();
+		mappedData = &buffer[0];
+#endif
+		
+		kmerOffsets = (const unsigned long long*)(mappedData + header.offsetsOffset);
+		kmerData = (const unsigned char*)(mappedData + header.dataOffset);
+		count = header.numSeqs;
+		
+		//the table is read from the file from now on
+		vector<vector<int> >().swap(kmerLocations);
+		
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "readBinaryKmerDB");
+		exit(1);
+	}	
+}
 /**************************************************************************************************/
 int KmerDB::getCount(int kmer) {
 	try {
 		if (kmer < 0) { return 0; }  //if user gives negative number
 		else if (kmer > maxKmer) {	return 0;	}  //or a kmer that is bigger than maxkmer
-		else {	return kmerLocations[kmer].size();	}  // kmer is in vector range
+		else if (kmerData != NULL) {	
+			const unsigned char* p = kmerData + kmerOffsets[kmer];
+			return readVarint(p);
+		}else {	return kmerLocations[kmer].size();	}  // kmer is in vector range
 	}
 	catch(exception& e) {
 		m->errorOut(e, "KmerDB", "getCount");
@@ -238,7 +532,12 @@ vector<int> KmerDB::getSequencesWithKmer(int kmer) {
 	
 		if (kmer < 0) { }  //if user gives negative number
 		else if (kmer > maxKmer) {	}  //or a kmer that is bigger than maxkmer
-		else {	seqs = kmerLocations[kmer];	}
+		else if (kmerData != NULL) {	
+			const unsigned char* p = kmerData + kmerOffsets[kmer];
+			unsigned int numValues = readVarint(p);
+			int seqNumber = 0;
+			for(int j=0;j<numValues;j++){ seqNumber += readVarint(p); seqs.push_back(seqNumber); }
+		}else {	seqs = kmerLocations[kmer];	}
 		
 		return seqs;
 	}
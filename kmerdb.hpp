@@ -16,12 +16,39 @@
  *	Construction of an object of this type will first look for an appropriately named database file and if it is found
  *	then will read in the database file (readKmerDB), otherwise it will generate one and store the data in memory
  *	(generateKmerDB)
+ *
+ *	The database file starts with the mothur version line, which the callers check, followed by a binary kmer table that is memory
+ *	mapped instead of parsed, so concurrent processes using the same template share one copy in the page cache:
+ *
+ *		kmerDBHeader	- padded to 8 bytes from the start of the file
+ *		offsets			- maxKmer+1 unsigned 64 bit byte offsets into data, one for each kmer number.  kmer number maxKmer is
+ *						  used for kmers with an N and its list is always empty
+ *		data			- for each kmer the number of sequences with that kmer followed by the sequence indices, each index
+ *						  stored as the difference from the one before it.  all values are varints, 7 bits per byte with the
+ *						  high bit set on every byte but the last.
+ *
+ *	Text files written by older versions are still read into kmerLocations.
 
  */
 
 #include "mothur.h"
 #include "database.hpp"
 
+/**************************************************************************************************/
+
+struct kmerDBHeader {
+	char magic[8];
+	unsigned int version;
+	unsigned int kmerSize;
+	unsigned long long maxKmer;
+	unsigned long long numSeqs;
+	unsigned long long offsetsOffset;
+	unsigned long long dataOffset;
+	unsigned long long dataSize;
+};
+
+/**************************************************************************************************/
+
 class KmerDB : public Database {
 	
 public:
@@ -30,8 +57,9 @@ public:
 	~KmerDB();
 	
 	void generateDB();
-	void addSequence(Sequence);
+	void addSequence(const Sequence&);
 	vector<int> findClosestSequences(Sequence*, int);
+	vector<int> findClosestBothStrands(Sequence*, int, bool&);
 	void readKmerDB(ifstream&);
 	int getCount(int);  //returns number of sequences with that kmer number
 	vector<int> getSequencesWithKmer(int);  //returns vector of sequences that contain kmer passed in
@@ -44,6 +72,30 @@ private:
 	int maxKmer, count;
 	string kmerDBName;
 	vector<vector<int> > kmerLocations;
+	
+	char* mappedData;                           //the mapped database file
+	unsigned long long mappedSize;
+	vector<char> buffer;                        //holds the file on systems without mmap
+	const unsigned long long* kmerOffsets;
+	const unsigned char* kmerData;              //NULL unless the database was read from a binary file
+	
+	bool readBinaryKmerDB();
+	
+	//reused by each search so nothing is allocated per query.  this makes the searches non-reentrant, so a KmerDB must only
+	//be searched by one thread at a time, as every Database already is because the search score is kept in searchScore
+	vector<unsigned short> matchCounts;			//kmers each template shares with the query
+	vector<int> wideMatchCounts;				//used instead for queries with more than 65535 different kmers
+	vector<unsigned long long> kmerSeen;		//bitset of the kmers already found in the query
+	vector<int> positionKmers, queryKmers;
+	vector<unsigned short> reverseCounts;		//used by findClosestBothStrands for the reverse complement
+	vector<int> wideReverseCounts;
+	vector<int> forwardKmers, strandKmers;
+	vector<unsigned char> strandMasks;			//1 if the forward query has the kmer, 2 if the reverse complement does, 3 for both
+	
+	void findQueryKmers(const string&, int);
+	template<class T> void scoreSequences(vector<T>&, int, vector<seqMatch>&);
+	template<class T> void scoreBothStrands(vector<T>&, vector<T>&, int, vector<seqMatch>&, vector<seqMatch>&);
+	template<class T> void findTopMatches(vector<T>&, int, int, vector<seqMatch>&);
 };
 
 #endif
@@ -0,0 +1,225 @@
+//
+//  minimizerdb.cpp
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+#include "sequence.hpp"
+#include "database.hpp"
+#include "minimizerdb.hpp"
+
+const int MinimizerDB::WINDOW;
+const unsigned long long MinimizerDB::EMPTY_SLOT;
+
+/**************************************************************************************************/
+
+MinimizerDB::MinimizerDB(int kSize) : Database() {
+	try {
+		kmerSize = kSize;
+		if (kmerSize > 31) { kmerSize = 31; }		//the seed is packed in 64 bits and must never equal EMPTY_SLOT
+		if (kmerSize < 1) { kmerSize = 1; }
+		count = 0;
+		slotMask = 0;
+
+		//spaced seed 11011011..., ending with a care position
+		int position = 0;
+		while (seedPositions.size() < kmerSize) {
+			if ((position % 3) != 2) { seedPositions.push_back(position); }
+			position++;
+		}
+		seedSpan = seedPositions.back() + 1;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "MinimizerDB", "MinimizerDB");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//mixes the bits of the seed so the minimizers are spread over the seeds instead of favoring runs of A's
+unsigned long long MinimizerDB::hashSeed(unsigned long long seed) {
+	seed ^= seed >> 33;
+	seed *= 0xff51afd7ed558ccdULL;
+	seed ^= seed >> 33;
+	seed *= 0xc4ceb9fe1a85ec53ULL;
+	seed ^= seed >> 33;
+	return seed;
+}
+/**************************************************************************************************/
+//fills minimizers with the different minimizers of the sequence, sorted
+void MinimizerDB::getMinimizers(const string& sequence, vector<unsigned long long>& minimizers) {
+	try {
+		minimizers.clear();
+
+		int numSeeds = (int)sequence.length() - seedSpan + 1;
+		if (numSeeds <= 0) { return; }
+
+		seeds.resize(numSeeds);
+		seedHashes.resize(numSeeds);
+		for (int i = 0; i < numSeeds; i++) {
+			unsigned long long seed = 0;
+			bool valid = true;
+			for (int j = 0; j < seedPositions.size(); j++) {
+				int code;
+				switch (sequence[i + seedPositions[j]]) {
+					case 'A': case 'a': code = 0; break;
+					case 'C': case 'c': code = 1; break;
+					case 'G': case 'g': code = 2; break;
+					case 'T': case 't': code = 3; break;
+					default: code = -1; break;
+				}
+				if (code == -1) { valid = false; break; }
+				seed = (seed << 2) | code;
+			}
+			seeds[i] = seed;
+			seedHashes[i] = EMPTY_SLOT;		//seeds with an ambiguous base are never picked
+			if (valid) { seedHashes[i] = hashSeed(seed); }
+		}
+
+		//the smallest hash in each window, the leftmost if there is a tie
+		int numWindows = max(1, numSeeds - WINDOW + 1);
+		int windowSize = min(WINDOW, numSeeds);
+		int last = -1;
+		for (int i = 0; i < numWindows; i++) {
+			int best = i;
+			for (int j = i + 1; j < i + windowSize; j++) { if (seedHashes[j] < seedHashes[best]) { best = j; } }
+			if ((best != last) && (seedHashes[best] != EMPTY_SLOT)) { minimizers.push_back(seeds[best]); }
+			last = best;
+		}
+
+		sort(minimizers.begin(), minimizers.end());
+		minimizers.erase(unique(minimizers.begin(), minimizers.end()), minimizers.end());
+	}
+	catch(exception& e) {
+		m->errorOut(e, "MinimizerDB", "getMinimizers");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void MinimizerDB::addSequence(const Sequence& seq) {
+	try {
+		getMinimizers(seq.getUnaligned(), queryMinimizers);
+		for (int i = 0; i < queryMinimizers.size(); i++) { seedSeqs.push_back(make_pair(queryMinimizers[i], count)); }
+		count++;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "MinimizerDB", "addSequence");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//builds the hash table from the minimizers of the sequences added
+void MinimizerDB::generateDB() {
+	try {
+		sort(seedSeqs.begin(), seedSeqs.end());
+
+		vector<unsigned long long> distinctSeeds;
+		postingStarts.clear();
+		postings.clear();
+		for (int i = 0; i < seedSeqs.size(); i++) {
+			if ((i == 0) || (seedSeqs[i].first != seedSeqs[i-1].first)) {
+				distinctSeeds.push_back(seedSeqs[i].first);
+				postingStarts.push_back(postings.size());
+			}
+			postings.push_back(seedSeqs[i].second);
+		}
+		postingStarts.push_back(postings.size());
+		vector< pair<unsigned long long, int> >().swap(seedSeqs);
+
+		//at most half full so the probes stay short
+		unsigned long long numSlots = 16;
+		while (numSlots < (2 * distinctSeeds.size())) { numSlots *= 2; }
+		slotMask = numSlots - 1;
+		slotSeeds.assign(numSlots, EMPTY_SLOT);
+		slotSeedNumbers.assign(numSlots, -1);
+
+		for (int i = 0; i < distinctSeeds.size(); i++) {
+			unsigned long long slot = hashSeed(distinctSeeds[i]) & slotMask;
+			while (slotSeeds[slot] != EMPTY_SLOT) { slot = (slot + 1) & slotMask; }
+			slotSeeds[slot] = distinctSeeds[i];
+			slotSeedNumbers[slot] = i;
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "MinimizerDB", "generateDB");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//returns the number of the seed, or -1 if no template has it
+int MinimizerDB::findSlot(unsigned long long seed) {
+	try {
+		if (slotSeeds.size() == 0) { return -1; }
+
+		unsigned long long slot = hashSeed(seed) & slotMask;
+		while (slotSeeds[slot] != EMPTY_SLOT) {
+			if (slotSeeds[slot] == seed) { return slotSeedNumbers[slot]; }
+			slot = (slot + 1) & slotMask;
+		}
+		return -1;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "MinimizerDB", "findSlot");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//returns the num templates sharing the most minimizers with the query, ties go to the lower index
+vector<int> MinimizerDB::findClosestSequences(Sequence* candidateSeq, int num) {
+	try {
+		if (num > count) { m->mothurOut("[WARNING]: you requested " + toString(num) + " closest sequences, but the template only contains " + toString(count) + ", adjusting."); m->mothurOutEndLine(); num = count; }
+
+		vector<int> topMatches;
+		searchScore = 0;
+		Scores.clear();
+
+		if (num <= 0) { return topMatches; }
+
+		getMinimizers(candidateSeq->getUnaligned(), queryMinimizers);
+
+		if (matchCounts.size() != count) { matchCounts.assign(count, 0); }
+
+		matchedSeqs.clear();
+		for (int i = 0; i < queryMinimizers.size(); i++) {
+			int seedNumber = findSlot(queryMinimizers[i]);
+			if (seedNumber == -1) { continue; }
+
+			for (int j = postingStarts[seedNumber]; j < postingStarts[seedNumber+1]; j++) {
+				int seqNumber = postings[j];
+				if (matchCounts[seqNumber] == 0) { matchedSeqs.push_back(seqNumber); }
+				matchCounts[seqNumber]++;
+			}
+		}
+
+		vector<seqMatch> seqMatches;
+		for (int i = 0; i < matchedSeqs.size(); i++) { seqMatches.push_back(seqMatch(matchedSeqs[i], matchCounts[matchedSeqs[i]])); matchCounts[matchedSeqs[i]] = 0; }
+
+		if (seqMatches.size() > num) {
+			partial_sort(seqMatches.begin(), seqMatches.begin() + num, seqMatches.end(), compareSeqMatchRank);
+			seqMatches.resize(num);
+		}else {
+			sort(seqMatches.begin(), seqMatches.end(), compareSeqMatchRank);
+
+			//not enough templates share a minimizer, so fill in with the lowest indexes like the kmer search
+			sort(matchedSeqs.begin(), matchedSeqs.end());
+			for (int i = 0; (i < count) && (seqMatches.size() < num); i++) {
+				if (!binary_search(matchedSeqs.begin(), matchedSeqs.end(), i)) { seqMatches.push_back(seqMatch(i, 0)); }
+			}
+		}
+
+		int numMinimizers = max(1, (int)queryMinimizers.size());
+		searchScore = 100 * seqMatches[0].match / (float) numMinimizers;
+
+		for (int i = 0; i < seqMatches.size(); i++) {
+			topMatches.push_back(seqMatches[i].seq);
+			Scores.push_back(100 * seqMatches[i].match / (float) numMinimizers);
+		}
+
+		return topMatches;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "MinimizerDB", "findClosestSequences");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
@@ -0,0 +1,63 @@
+#ifndef MINIMIZERDB_HPP
+#define MINIMIZERDB_HPP
+
+//
+//  minimizerdb.hpp
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+//	This is a child class of the Database class that indexes the template sequences by their minimizers instead of
+//	every kmer.  Each position of a sequence is read through a spaced seed with kmerSize care positions, 11011011011
+//	for the default of 8, so a sequencing error only changes the seeds where it lands on a care position.  Of every
+//	WINDOW consecutive seeds only the one with the smallest hash, the minimizer, is kept.  Two sequences that share a
+//	stretch of WINDOW seeds share its minimizer, so similar sequences still share most of their minimizers while only
+//	about a third of the seeds are indexed.
+//
+//	The minimizers are kept in an open addressing hash table.  Each slot holds a seed and its number, which gives the
+//	seed's list of sequences in postings, so the whole index is four flat arrays.
+//
+
+#include "mothur.h"
+#include "database.hpp"
+
+/**************************************************************************************************/
+
+class MinimizerDB : public Database {
+
+public:
+	MinimizerDB(int);
+	~MinimizerDB() {}
+
+	void generateDB();
+	void addSequence(const Sequence&);
+	vector<int> findClosestSequences(Sequence*, int);
+
+	static const int WINDOW = 5;
+
+private:
+	int kmerSize, seedSpan, count;
+	vector<int> seedPositions;				//the care positions of the spaced seed
+
+	vector< pair<unsigned long long, int> > seedSeqs;	//the minimizers of each sequence added, until generateDB indexes them
+
+	vector<unsigned long long> slotSeeds;	//the hash table, empty slots hold EMPTY_SLOT
+	vector<int> slotSeedNumbers;			//the number of the seed in each slot
+	vector<int> postingStarts;				//the sequences with seed number i are postings[postingStarts[i]] to postings[postingStarts[i+1]-1]
+	vector<int> postings;
+	unsigned long long slotMask;
+
+	vector<int> matchCounts;				//reused by each search
+	vector<int> matchedSeqs;
+	vector<unsigned long long> queryMinimizers, seeds, seedHashes;
+
+	static const unsigned long long EMPTY_SLOT = ~0ULL;
+
+	void getMinimizers(const string&, vector<unsigned long long>&);
+	unsigned long long hashSeed(unsigned long long);
+	int findSlot(unsigned long long);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -11,6 +11,7 @@
 #include "engine.hpp"
 #include "mothurout.h"
 #include "referencedb.h"
+#include "compressedfile.h"
 
 /**************************************************************************************************/
 
@@ -239,6 +240,13 @@ int main(int argc, char *argv[]){
 				
 		if (mothur != NULL) { delete mothur; }
 		
+		#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+		#ifdef USE_COMPRESSION
+			//finish writing any compressed outputs
+			CompressedFile::finish();
+		#endif
+		#endif
+		
 		#ifdef USE_MPI
 			MPI_Finalize();
 		#endif
@@ -8,6 +8,7 @@
  */
 
 #include "mothurout.h"
+#include "compressedfile.h"
 
 
 /******************************************************/
@@ -700,10 +701,9 @@ string MothurOut::getRootName(string longName){
 
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
 #ifdef USE_COMPRESSION
-    if (endsWith(rootName, ".gz") || endsWith(rootName, ".bz2")) {
+    if (endsWith(rootName, ".gz") || endsWith(rootName, ".bz2") || endsWith(rootName, ".zst")) {
       int pos = rootName.find_last_of('.');
       rootName = rootName.substr(0, pos);
-      cerr << "shortening " << longName << " to " << rootName << "\n";
     }
 #endif
 #endif
@@ -1055,26 +1055,9 @@ int MothurOut::openInputFile(string fileName, ifstream& fileHandle, string m){
 			string completeFileName = getFullPathName(fileName);
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
 #ifdef USE_COMPRESSION
-      // check for gzipped or bzipped file
-      if (endsWith(completeFileName, ".gz") || endsWith(completeFileName, ".bz2")) {
-        string tempName = string(tmpnam(0));
-        mkfifo(tempName.c_str(), 0666);
-        int fork_result = fork();
-        if (fork_result < 0) {
-          cerr << "Error forking.\n";
-          exit(1);
-        } else if (fork_result == 0) {
-          string command = (endsWith(completeFileName, ".gz") ? "zcat " : "bzcat ") + completeFileName + string(" > ") + tempName;
-          cerr << "Decompressing " << completeFileName << " via temporary named pipe " << tempName << "\n";
-          system(command.c_str());
-          cerr << "Done decompressing " << completeFileName << "\n";
-          mothurRemove(tempName);
-          exit(EXIT_SUCCESS);
-        } else {
-          cerr << "waiting on child process " << fork_result << "\n";
-          completeFileName = tempName;
-        }
-      }
+      //a compressed file is read through a pipe that a thread decompresses it into
+      CompressedFile::waitFor(completeFileName);
+      if (CompressedFile::getFormat(completeFileName) != "") { completeFileName = CompressedFile::startReading(completeFileName); }
 #endif
 #endif
 			fileHandle.open(completeFileName.c_str());
@@ -1101,26 +1084,9 @@ int MothurOut::openInputFile(string fileName, ifstream& fileHandle){
 		string completeFileName = getFullPathName(fileName);
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
 #ifdef USE_COMPRESSION
-  // check for gzipped or bzipped file
-  if (endsWith(completeFileName, ".gz") || endsWith(completeFileName, ".bz2")) {
-    string tempName = string(tmpnam(0));
-    mkfifo(tempName.c_str(), 0666);
-    int fork_result = fork();
-    if (fork_result < 0) {
-      cerr << "Error forking.\n";
-      exit(1);
-    } else if (fork_result == 0) {
-      string command = (endsWith(completeFileName, ".gz") ? "zcat " : "bzcat ") + completeFileName + string(" > ") + tempName;
-      cerr << "Decompressing " << completeFileName << " via temporary named pipe " << tempName << "\n";
-      system(command.c_str());
-      cerr << "Done decompressing " << completeFileName << "\n";
-      mothurRemove(tempName);
-      exit(EXIT_SUCCESS);
-    } else {
-      cerr << "waiting on child process " << fork_result << "\n";
-      completeFileName = tempName;
-    }
-  }
+  //a compressed file is read through a pipe that a thread decompresses it into
+  CompressedFile::waitFor(completeFileName);
+  if (CompressedFile::getFormat(completeFileName) != "") { completeFileName = CompressedFile::startReading(completeFileName); }
 #endif
 #endif
 
@@ -1150,26 +1116,9 @@ int MothurOut::openInputFileBinary(string fileName, ifstream& fileHandle){
 		string completeFileName = getFullPathName(fileName);
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
 #ifdef USE_COMPRESSION
-        // check for gzipped or bzipped file
-        if (endsWith(completeFileName, ".gz") || endsWith(completeFileName, ".bz2")) {
-            string tempName = string(tmpnam(0));
-            mkfifo(tempName.c_str(), 0666);
-            int fork_result = fork();
-            if (fork_result < 0) {
-                cerr << "Error forking.\n";
-                exit(1);
-            } else if (fork_result == 0) {
-                string command = (endsWith(completeFileName, ".gz") ? "zcat " : "bzcat ") + completeFileName + string(" > ") + tempName;
-                cerr << "Decompressing " << completeFileName << " via temporary named pipe " << tempName << "\n";
-                system(command.c_str());
-                cerr << "Done decompressing " << completeFileName << "\n";
-                mothurRemove(tempName);
-                exit(EXIT_SUCCESS);
-            } else {
-                cerr << "waiting on child process " << fork_result << "\n";
-                completeFileName = tempName;
-            }
-        }
+        //a compressed file is read through a pipe that a thread decompresses it into
+        CompressedFile::waitFor(completeFileName);
+        if (CompressedFile::getFormat(completeFileName) != "") { completeFileName = CompressedFile::startReading(completeFileName); }
 #endif
 #endif
         
@@ -1199,26 +1148,9 @@ int MothurOut::openInputFileBinary(string fileName, ifstream& fileHandle, string
 		string completeFileName = getFullPathName(fileName);
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
 #ifdef USE_COMPRESSION
-        // check for gzipped or bzipped file
-        if (endsWith(completeFileName, ".gz") || endsWith(completeFileName, ".bz2")) {
-            string tempName = string(tmpnam(0));
-            mkfifo(tempName.c_str(), 0666);
-            int fork_result = fork();
-            if (fork_result < 0) {
-                cerr << "Error forking.\n";
-                exit(1);
-            } else if (fork_result == 0) {
-                string command = (endsWith(completeFileName, ".gz") ? "zcat " : "bzcat ") + completeFileName + string(" > ") + tempName;
-                cerr << "Decompressing " << completeFileName << " via temporary named pipe " << tempName << "\n";
-                system(command.c_str());
-                cerr << "Done decompressing " << completeFileName << "\n";
-                mothurRemove(tempName);
-                exit(EXIT_SUCCESS);
-            } else {
-                cerr << "waiting on child process " << fork_result << "\n";
-                completeFileName = tempName;
-            }
-        }
+        //a compressed file is read through a pipe that a thread decompresses it into
+        CompressedFile::waitFor(completeFileName);
+        if (CompressedFile::getFormat(completeFileName) != "") { completeFileName = CompressedFile::startReading(completeFileName); }
 #endif
 #endif
         
@@ -1281,23 +1213,8 @@ int MothurOut::openOutputFile(string fileName, ofstream& fileHandle){
 		string completeFileName = getFullPathName(fileName);
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
 #ifdef USE_COMPRESSION
-    // check for gzipped file
-    if (endsWith(completeFileName, ".gz") || endsWith(completeFileName, ".bz2")) {
-      string tempName = string(tmpnam(0));
-      mkfifo(tempName.c_str(), 0666);
-      cerr << "Compressing " << completeFileName << " via temporary named pipe " << tempName << "\n";
-      int fork_result = fork();
-      if (fork_result < 0) {
-        cerr << "Error forking.\n";
-        exit(1);
-      } else if (fork_result == 0) {
-        string command = string(endsWith(completeFileName, ".gz") ?  "gzip" : "bzip2") + " -v > " + completeFileName + string(" < ") + tempName;
-        system(command.c_str());
-        exit(0);
-      } else {
-        completeFileName = tempName;
-      }
-    }
+    //a .gz, .zst or .bz2 file is written through a pipe that a thread compresses into the file
+    if (CompressedFile::getOutputFormat(completeFileName) != "") { completeFileName = CompressedFile::startWriting(completeFileName); }
 #endif
 #endif
 		fileHandle.open(completeFileName.c_str(), ios::trunc);
@@ -1323,23 +1240,8 @@ int MothurOut::openOutputFileBinary(string fileName, ofstream& fileHandle){
 		string completeFileName = getFullPathName(fileName);
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
 #ifdef USE_COMPRESSION
-        // check for gzipped file
-        if (endsWith(completeFileName, ".gz") || endsWith(completeFileName, ".bz2")) {
-            string tempName = string(tmpnam(0));
-            mkfifo(tempName.c_str(), 0666);
-            cerr << "Compressing " << completeFileName << " via temporary named pipe " << tempName << "\n";
-            int fork_result = fork();
-            if (fork_result < 0) {
-                cerr << "Error forking.\n";
-                exit(1);
-            } else if (fork_result == 0) {
-                string command = string(endsWith(completeFileName, ".gz") ?  "gzip" : "bzip2") + " -v > " + completeFileName + string(" < ") + tempName;
-                system(command.c_str());
-                exit(0);
-            } else {
-                completeFileName = tempName;
-            }
-        }
+        //a .gz, .zst or .bz2 file is written through a pipe that a thread compresses into the file
+        if (CompressedFile::getOutputFormat(completeFileName) != "") { completeFileName = CompressedFile::startWriting(completeFileName); }
 #endif
 #endif
 		fileHandle.open(completeFileName.c_str(), ios::trunc | ios::binary);
@@ -1712,6 +1614,13 @@ vector<unsigned long long> MothurOut::divideFile(string filename, int& proc) {
 		unsigned long long size;
 		
 		filename = getFullPathName(filename);
+		
+	#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+	#ifdef USE_COMPRESSION
+		//a compressed file can only be read from its start, so one process reads all of it
+		if (CompressedFile::getFormat(filename) != "") { proc = 1; filePos.push_back(numeric_limits<unsigned long long>::max()); return filePos; }
+	#endif
+	#endif
 	
 		//get num bytes in file
 		pFile = fopen (filename.c_str(),"rb");
@@ -1780,6 +1689,34 @@ vector<unsigned long long> MothurOut::divideFile(string filename, int& proc) {
 	}
 }
 /**************************************************************************************************/
+//a compressed file is read from a pipe, which has no position, so divideFile gives it one part that ends with the stream
+bool MothurOut::endOfPart(ifstream& in, unsigned long long end) {
+	try {
+		unsigned long long pos = in.tellg();
+		if (pos == -1) { return !in.good(); }
+		return (pos >= end);
+	}
+	catch(exception& e) {
+		errorOut(e, "MothurOut", "endOfPart");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+bool MothurOut::isCompressed(string fileName) {
+	try {
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+#ifdef USE_COMPRESSION
+		return (CompressedFile::getFormat(fileName) != "");
+#endif
+#endif
+		return false;
+	}
+	catch(exception& e) {
+		errorOut(e, "MothurOut", "isCompressed");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
 
 vector<unsigned long long> MothurOut::divideFilePerLine(string filename, int& proc) {
 	try{
@@ -76,6 +76,8 @@ class MothurOut {
 		//file operations
         bool dirCheck(string&); //completes path, appends appropriate / or \, makes sure dir is writable.
 		vector<unsigned long long> divideFile(string, int&); //divides splitting unevenness by sequence
+		bool endOfPart(ifstream&, unsigned long long); //true once a process has read its part of a file divided by divideFile
+		bool isCompressed(string); //true for a file that is read through a pipe, from its start and in one part
         vector<unsigned long long> divideFilePerLine(string, int&); //divides splitting unevenness at line breaks
 		int divideFile(string, int&, vector<string>&);
 		vector<unsigned long long> setFilePosEachLine(string, int&);
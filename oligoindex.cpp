@@ -0,0 +1,115 @@
+//
+//  oligoindex.cpp
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+#include "oligoindex.h"
+
+/**************************************************************************************************/
+OligoIndex::OligoIndex() {
+	try {
+		m = MothurOut::getInstance();
+		diffs = 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "OligoIndex", "OligoIndex");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+OligoIndex::OligoIndex(vector<string> o, int d) {
+	try {
+		m = MothurOut::getInstance();
+		oligos = o;
+		diffs = d;
+
+		for (int i = 0; i < oligos.size(); i++) {
+			string oligo = oligos[i];
+			int length = oligo.length();
+
+			bool found = false;
+			for (int j = 0; j < firstOfLength.size(); j++) { if (firstOfLength[j].first == length) { found = true; break; } }
+			if (!found) { firstOfLength.push_back(make_pair(length, i)); }
+
+			//an ambiguous base is not compared exactly, so the pieces can't be looked up
+			bool ambiguous = false;
+			for (int j = 0; j < length; j++) {
+				if ((oligo[j] != 'A') && (oligo[j] != 'T') && (oligo[j] != 'G') && (oligo[j] != 'C')) { ambiguous = true; break; }
+			}
+
+			if (ambiguous || (length < (diffs + 1))) { unsplit.push_back(i); continue; }
+
+			//diffs+1 pieces as close to the same length as they can be
+			for (int k = 0; k <= diffs; k++) {
+				int start = (length * k) / (diffs + 1);
+				int end = (length * (k + 1)) / (diffs + 1);
+
+				int p = 0;
+				while ((p < pieces.size()) && ((pieces[p].start != start) || (pieces[p].length != (end - start)))) { p++; }
+				if (p == pieces.size()) { pieces.push_back(oligoPiece(start, end - start)); }
+
+				pieces[p].keys.push_back(make_pair(hashPiece(oligo.c_str() + start, end - start), i));
+			}
+		}
+
+		for (int p = 0; p < pieces.size(); p++) { sort(pieces[p].keys.begin(), pieces[p].keys.end()); }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "OligoIndex", "OligoIndex");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+unsigned long long OligoIndex::hashPiece(const char* piece, int length) {
+	unsigned long long key = 14695981039346656037ULL;
+	for (int i = 0; i < length; i++) {
+		key ^= (unsigned char)piece[i];
+		key *= 1099511628211ULL;
+	}
+	return key;
+}
+/**************************************************************************************************/
+void OligoIndex::getCandidates(const string& seq, vector<int>& candidates) {
+	try {
+		candidates = unsplit;
+
+		int seqLength = seq.length();
+		for (int p = 0; p < pieces.size(); p++) {
+			oligoPiece& piece = pieces[p];
+
+			//the gaps before the piece can move it diffs bases either way
+			for (int shift = -diffs; shift <= diffs; shift++) {
+				int start = piece.start + shift;
+				if ((start < 0) || ((start + piece.length) > seqLength)) { continue; }
+
+				unsigned long long key = hashPiece(seq.c_str() + start, piece.length);
+				vector< pair<unsigned long long, int> >::iterator it = lower_bound(piece.keys.begin(), piece.keys.end(), make_pair(key, 0));
+				for (; (it != piece.keys.end()) && (it->first == key); it++) { candidates.push_back(it->second); }
+			}
+		}
+
+		sort(candidates.begin(), candidates.end());
+		candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+	}
+	catch(exception& e) {
+		m->errorOut(e, "OligoIndex", "getCandidates");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+int OligoIndex::getFirstLonger(int length) {
+	try {
+		int first = oligos.size();
+		for (int i = 0; i < firstOfLength.size(); i++) {
+			if ((firstOfLength[i].first > length) && (firstOfLength[i].second < first)) { first = firstOfLength[i].second; }
+		}
+		return first;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "OligoIndex", "getFirstLonger");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
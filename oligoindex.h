@@ -0,0 +1,56 @@
+#ifndef Mothur_oligoindex_h
+#define Mothur_oligoindex_h
+
+//
+//  oligoindex.h
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+/* OligoIndex finds the barcodes or primers that could be within diffs of the start of a sequence, so TrimOligos only
+ compares and aligns those instead of every oligo.  Each oligo is split into diffs+1 pieces.  An oligo within diffs of
+ the sequence has at most diffs differences, so one of its pieces is in the sequence unchanged, moved at most diffs
+ bases by the gaps before it.  The pieces are kept as hash keys, so a sequence is looked up with (diffs+1)*(2*diffs+1)
+ searches for each oligo length, however many oligos there are.
+
+ A hash collision only adds a candidate, which the caller still checks.  Oligos with ambiguous bases can match
+ sequences with different bases, and oligos shorter than diffs+1 can't be split, so they are candidates for every
+ sequence. */
+
+#include "mothur.h"
+#include "mothurout.h"
+
+/**************************************************************************************************/
+
+class OligoIndex {
+
+public:
+	OligoIndex();
+	OligoIndex(vector<string>, int);			//oligos in the order they are searched, diffs
+	~OligoIndex() {}
+
+	void getCandidates(const string&, vector<int>&);	//the oligos that could be within diffs of the start of the sequence, in order
+	int getFirstLonger(int);					//the first oligo longer than the length, the number of oligos if there isn't one
+	string getOligo(int i)	{ return oligos[i]; }
+
+private:
+	MothurOut* m;
+	int diffs;
+	vector<string> oligos;
+	vector<int> unsplit;						//compared to every sequence
+	vector< pair<int, int> > firstOfLength;	//each oligo length and the first oligo that long
+
+	struct oligoPiece {
+		int start, length;
+		vector< pair<unsigned long long, int> > keys;	//the hash of the piece in each oligo split this way and the oligo, sorted
+		oligoPiece(int s, int l) : start(s), length(l) {}
+	};
+	vector<oligoPiece> pieces;					//the distinct places the oligos are split at
+
+	unsigned long long hashPiece(const char*, int);
+};
+
+/**************************************************************************************************/
+
+#endif
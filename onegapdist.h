@@ -20,7 +20,9 @@ public:
 	
 	oneGapDist() {}
 	
-	void calcDist(Sequence A, Sequence B){
+	using Dist::calcDist;
+	
+	void calcDist(const char* seqA, const char* seqB, int alignLength){
 		
 		int difference = 0;
 		int minLength = 0;
@@ -28,10 +30,6 @@ public:
 		int openGapB = 0;
 		int start = 0;
 		
-		string seqA = A.getAligned();
-		string seqB = B.getAligned();
-		int alignLength = seqA.length();
-		
 		for(int i=0;i<alignLength;i++){
 			if((seqA[i] != '.' || seqB[i] != '.')){
 				start = i;
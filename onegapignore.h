@@ -20,7 +20,9 @@ public:
 	
 	oneGapIgnoreTermGapDist() {}
 	
-	void calcDist(Sequence A, Sequence B){
+	using Dist::calcDist;
+	
+	void calcDist(const char* seqA, const char* seqB, int alignLength){
 		
 		int difference = 0;
 		int openGapA = 0;
@@ -30,10 +32,6 @@ public:
 		int end = 0;
 		bool overlap = false;
 		
-		string seqA = A.getAligned();
-		string seqB = B.getAligned();
-		int alignLength = seqA.length();
-
 		// this assumes that sequences start and end with '.'s instead of'-'s.
 		for(int i=0;i<alignLength;i++){
 			if(seqA[i] != '.' && seqB[i] != '.' && seqA[i] != '-' && seqB[i] != '-' ){
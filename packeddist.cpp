@@ -0,0 +1,394 @@
+//
+//  packeddist.cpp
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+//  If mothur is compiled with AVX2 enabled (-mavx2 or -march=native) the columns between the first and last
+//  word of the region being compared are counted 256 bits at a time, otherwise one 64 bit word at a time.
+//
+
+#ifdef __AVX2__
+	#include <immintrin.h>
+#endif
+
+#include "packeddist.h"
+
+/**************************************************************************************************/
+
+static inline int popCount(unsigned long long x) {
+#if defined (__GNUC__)
+	return __builtin_popcountll(x);
+#else
+	x = x - ((x >> 1) & 0x5555555555555555ULL);
+	x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+	x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+/**************************************************************************************************/
+//position of the lowest set bit, x can not be 0
+static inline int lowBit(unsigned long long x) {
+#if defined (__GNUC__)
+	return __builtin_ctzll(x);
+#else
+	int pos = 0;
+	while ((x & 1ULL) == 0) { x >>= 1; pos++; }
+	return pos;
+#endif
+}
+/**************************************************************************************************/
+//position of the highest set bit, x can not be 0
+static inline int highBit(unsigned long long x) {
+#if defined (__GNUC__)
+	return 63 - __builtin_clzll(x);
+#else
+	int pos = 63;
+	while ((x & 0x8000000000000000ULL) == 0) { x <<= 1; pos--; }
+	return pos;
+#endif
+}
+/**************************************************************************************************/
+//mask of the columns in word w that fall in [start, stop)
+static inline unsigned long long rangeMask(int w, int start, int stop) {
+	unsigned long long mask = ~0ULL;
+	if (w == (start / 64))		{ mask &= (~0ULL) << (start % 64);	}
+	if (w == ((stop-1) / 64))	{ int keep = stop - (w * 64); if (keep < 64) { mask &= ~((~0ULL) << keep); } }
+	return mask;
+}
+/**************************************************************************************************/
+//columns where the sequence has a base (BASE = true) or anything but a '-' (BASE = false)
+template <bool BASE>
+static inline unsigned long long hasChar(const unsigned long long* s, int w, int numWords) {
+	if (BASE) { return ~(s[w] | s[numWords + w]); }
+	return ~s[numWords + w];
+}
+/**************************************************************************************************/
+//columns where the two sequences have different characters
+static inline unsigned long long differ(const unsigned long long* a, const unsigned long long* b, int w, int numWords, int numPlanes) {
+	unsigned long long d = 0;
+	for (int p = 0; p < numPlanes; p++) { d |= a[p*numWords + w] ^ b[p*numWords + w]; }
+	return d;
+}
+/**************************************************************************************************/
+#ifdef __AVX2__
+static inline __m256i popCount256(__m256i v) {
+	const __m256i lookup = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4, 0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+	const __m256i low = _mm256_set1_epi8(0x0f);
+	__m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low));
+	__m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+	return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+/**************************************************************************************************/
+static inline unsigned long long sum256(__m256i v) {
+	return (unsigned long long)_mm256_extract_epi64(v, 0) + (unsigned long long)_mm256_extract_epi64(v, 1)
+		 + (unsigned long long)_mm256_extract_epi64(v, 2) + (unsigned long long)_mm256_extract_epi64(v, 3);
+}
+#endif
+/**************************************************************************************************/
+//counts the columns in [start, stop) where both (BOTH = true) or either (BOTH = false) sequence has a char and how many of those differ
+template <bool BASE, bool BOTH>
+static void countColumns(const unsigned long long* a, const unsigned long long* b, int numWords, int numPlanes, int start, int stop, int& length, int& diffs) {
+	int firstW = start / 64;
+	int lastW = (stop - 1) / 64;
+	int w = firstW;
+
+#ifdef __AVX2__
+	//edge words are done below, whole words in between 4 at a time
+	if (lastW - firstW > 4) {
+		w = firstW + 1;
+		__m256i lenSum = _mm256_setzero_si256();
+		__m256i diffSum = _mm256_setzero_si256();
+		const __m256i ones = _mm256_set1_epi64x(-1);
+		for (; w + 4 <= lastW; w += 4) {
+			__m256i dotA = _mm256_loadu_si256((const __m256i*)(a + w));
+			__m256i dotB = _mm256_loadu_si256((const __m256i*)(b + w));
+			__m256i gapA = _mm256_loadu_si256((const __m256i*)(a + numWords + w));
+			__m256i gapB = _mm256_loadu_si256((const __m256i*)(b + numWords + w));
+
+			__m256i xa = BASE ? _mm256_xor_si256(_mm256_or_si256(dotA, gapA), ones) : _mm256_xor_si256(gapA, ones);
+			__m256i xb = BASE ? _mm256_xor_si256(_mm256_or_si256(dotB, gapB), ones) : _mm256_xor_si256(gapB, ones);
+			__m256i counted = BOTH ? _mm256_and_si256(xa, xb) : _mm256_or_si256(xa, xb);
+
+			__m256i d = _mm256_or_si256(_mm256_xor_si256(dotA, dotB), _mm256_xor_si256(gapA, gapB));
+			for (int p = 2; p < numPlanes; p++) {
+				d = _mm256_or_si256(d, _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + p*numWords + w)), _mm256_loadu_si256((const __m256i*)(b + p*numWords + w))));
+			}
+
+			lenSum = _mm256_add_epi64(lenSum, popCount256(counted));
+			diffSum = _mm256_add_epi64(diffSum, popCount256(_mm256_and_si256(counted, d)));
+		}
+		length += (int)sum256(lenSum);
+		diffs += (int)sum256(diffSum);
+
+		//first word
+		unsigned long long mask = rangeMask(firstW, start, stop);
+		unsigned long long xa = hasChar<BASE>(a, firstW, numWords), xb = hasChar<BASE>(b, firstW, numWords);
+		unsigned long long counted = (BOTH ? (xa & xb) : (xa | xb)) & mask;
+		length += popCount(counted);
+		diffs += popCount(counted & differ(a, b, firstW, numWords, numPlanes));
+
+		//leftover words and last word are finished by the scalar loop
+		for (; w <= lastW; w++) {
+			mask = rangeMask(w, start, stop);
+			xa = hasChar<BASE>(a, w, numWords); xb = hasChar<BASE>(b, w, numWords);
+			counted = (BOTH ? (xa & xb) : (xa | xb)) & mask;
+			length += popCount(counted);
+			diffs += popCount(counted & differ(a, b, w, numWords, numPlanes));
+		}
+		return;
+	}
+#endif
+
+	for (; w <= lastW; w++) {
+		unsigned long long mask = rangeMask(w, start, stop);
+		unsigned long long xa = hasChar<BASE>(a, w, numWords), xb = hasChar<BASE>(b, w, numWords);
+		unsigned long long counted = (BOTH ? (xa & xb) : (xa | xb)) & mask;
+		length += popCount(counted);
+		diffs += popCount(counted & differ(a, b, w, numWords, numPlanes));
+	}
+}
+/**************************************************************************************************/
+PackedDist::PackedDist(SequenceDB& db, string c, bool countends) {
+	try {
+		m = MothurOut::getInstance();
+
+		if (countends) {
+			if (c == "nogaps")			{	calc = NOGAPS;		}
+			else if (c == "eachgap")	{	calc = EACHGAP;		}
+			else						{	calc = ONEGAP;		}
+		}else {
+			if (c == "nogaps")			{	calc = NOGAPS;			}
+			else if (c == "eachgap")	{	calc = EACHGAPIGNORE;	}
+			else						{	calc = ONEGAPIGNORE;	}
+		}
+
+		numSeqs = 0; alignLength = 0; numWords = 0; numPlanes = 0; stride = 0;
+		packed = encode(db);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PackedDist", "PackedDist");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+bool PackedDist::encode(SequenceDB& db) {
+	try {
+		numSeqs = db.getNumSeqs();
+		if (numSeqs == 0) { return false; }
+		if (!db.sameLength()) { return false; }
+
+		//give each character other than '.' and '-' a code, the '.' and '-' planes keep them apart from the rest
+		int code[256];
+		for (int i = 0; i < 256; i++) { code[i] = -1; }
+		int numSymbols = 0;
+
+		alignLength = db.getAlignedLength(0);
+		for (int i = 0; i < numSeqs; i++) {
+			if (m->control_pressed) { return false; }
+
+			const char* aligned = db.getAligned(i);
+			if (db.getAlignedLength(i) != alignLength) { return false; }
+
+			for (int j = 0; j < alignLength; j++) {
+				unsigned char ch = aligned[j];
+				if ((ch == '.') || (ch == '-') || (code[ch] != -1)) { continue; }
+				if (numSymbols == 16) { return false; }
+				code[ch] = numSymbols++;
+			}
+		}
+
+		int numCodePlanes = 0;
+		while ((1 << numCodePlanes) < numSymbols) { numCodePlanes++; }
+
+		numPlanes = 2 + numCodePlanes;
+		numWords = (alignLength + 63) / 64;
+		stride = numPlanes * numWords;
+		planes.assign((size_t)numSeqs * stride, 0);
+		firstWord.assign(numSeqs, numWords);
+		lastWord.assign(numSeqs, -1);
+
+		for (int i = 0; i < numSeqs; i++) {
+			if (m->control_pressed) { return false; }
+
+			const char* aligned = db.getAligned(i);
+			unsigned long long* s = &planes[(size_t)i * stride];
+
+			for (int j = 0; j < alignLength; j++) {
+				int w = j / 64;
+				unsigned long long bit = 1ULL << (j % 64);
+				unsigned char ch = aligned[j];
+
+				if (ch == '.')		{ s[w] |= bit; continue; }
+				if (w < firstWord[i]) { firstWord[i] = w; }
+				lastWord[i] = w;
+
+				if (ch == '-')		{ s[numWords + w] |= bit; continue; }
+				for (int p = 0; p < numCodePlanes; p++) {
+					if (code[ch] & (1 << p)) { s[(2+p)*numWords + w] |= bit; }
+				}
+			}
+
+			//pad the last word with '.' so the padding never looks like a column with a base
+			for (int j = alignLength; j < numWords * 64; j++) { s[j / 64] |= 1ULL << (j % 64); }
+		}
+
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PackedDist", "encode");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//first column that starts the comparison, -1 if there is none
+int PackedDist::findStart(const unsigned long long* a, const unsigned long long* b, int wBegin, int wEnd) {
+	try {
+		for (int w = wBegin; w < wEnd; w++) {
+			unsigned long long mask;
+			if ((calc == EACHGAP) || (calc == ONEGAP))	{ mask = ~(a[w] & b[w]);	}  //not both '.'
+			else if (calc == NOGAPS)					{ mask = ~(a[w] | b[w]);	}  //neither '.'
+			else										{ mask = hasChar<true>(a, w, numWords) & hasChar<true>(b, w, numWords); }  //both bases
+
+			if (mask != 0) { return (w * 64) + lowBit(mask); }
+		}
+		return -1;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PackedDist", "findStart");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//last column where both sequences have a base
+int PackedDist::findEnd(const unsigned long long* a, const unsigned long long* b, int wBegin, int wEnd) {
+	try {
+		for (int w = wEnd-1; w >= wBegin; w--) {
+			unsigned long long mask = hasChar<true>(a, w, numWords) & hasChar<true>(b, w, numWords);
+			if (mask != 0) { return (w * 64) + highBit(mask); }
+		}
+		return -1;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PackedDist", "findEnd");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//first column at or after start where both (bothDots = true) or either sequence has a '.'
+int PackedDist::findBreak(const unsigned long long* a, const unsigned long long* b, int start, int wEnd, bool bothDots) {
+	try {
+		for (int w = start / 64; w < wEnd; w++) {
+			unsigned long long mask = bothDots ? (a[w] & b[w]) : (a[w] | b[w]);
+			if (w == (start / 64)) { mask &= (~0ULL) << (start % 64); }
+			if (mask != 0) { return min(alignLength, (w * 64) + lowBit(mask)); }
+		}
+		//every column past wEnd is '.' in both sequences
+		return min(alignLength, wEnd * 64);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PackedDist", "findBreak");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//a run of gaps in one sequence counts once, columns where neither sequence has a char do not end the run
+void PackedDist::countGapOpens(const unsigned long long* a, const unsigned long long* b, int start, int stop, bool useBase, int& opens) {
+	try {
+		int state = 0; //0 - last column had chars in both, 1 - gap in A, 2 - gap in B
+
+		for (int w = start / 64; w <= (stop - 1) / 64; w++) {
+			unsigned long long mask = rangeMask(w, start, stop);
+			unsigned long long xa = useBase ? hasChar<true>(a, w, numWords) : hasChar<false>(a, w, numWords);
+			unsigned long long xb = useBase ? hasChar<true>(b, w, numWords) : hasChar<false>(b, w, numWords);
+
+			unsigned long long relevant = (xa | xb) & mask;
+			unsigned long long gapA = ~xa & xb & mask;
+			unsigned long long gapB = xa & ~xb & mask;
+			unsigned long long gaps = gapA | gapB;
+
+			if (gaps == 0) { if (relevant != 0) { state = 0; } continue; }
+
+			while (gaps != 0) {
+				unsigned long long bit = 1ULL << lowBit(gaps);
+				unsigned long long below = relevant & (bit - 1);
+
+				int prev = state;
+				if (below != 0) {
+					unsigned long long prevBit = 1ULL << highBit(below);
+					prev = (gapA & prevBit) ? 1 : ((gapB & prevBit) ? 2 : 0);
+				}
+
+				if ((gapA & bit) && (prev != 1))		{ opens++; }
+				else if ((gapB & bit) && (prev != 2))	{ opens++; }
+
+				gaps &= gaps - 1;
+			}
+
+			unsigned long long lastBit = 1ULL << highBit(relevant);
+			state = (gapA & lastBit) ? 1 : ((gapB & lastBit) ? 2 : 0);
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PackedDist", "countGapOpens");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+double PackedDist::calcDist(int i, int j) {
+	try {
+		const unsigned long long* a = &planes[(size_t)i * stride];
+		const unsigned long long* b = &planes[(size_t)j * stride];
+
+		//only words where at least one of the sequences has something other than '.' can be counted
+		int wBegin = min(firstWord[i], firstWord[j]);
+		int wEnd = max(lastWord[i], lastWord[j]) + 1;
+
+		int length = 0;
+		int diffs = 0;
+
+		int start = -1;
+		if (wBegin < wEnd) { start = findStart(a, b, wBegin, wEnd); }
+
+		if (start != -1) {
+			int stop, end, opens;
+
+			switch (calc) {
+				case NOGAPS:
+					stop = findBreak(a, b, start, wEnd, false);
+					countColumns<true, true>(a, b, numWords, numPlanes, start, stop, length, diffs);
+					break;
+				case EACHGAP:
+					stop = findBreak(a, b, start, wEnd, true);
+					countColumns<true, false>(a, b, numWords, numPlanes, start, stop, length, diffs);
+					break;
+				case ONEGAP:
+					stop = findBreak(a, b, start, wEnd, true);
+					countColumns<true, true>(a, b, numWords, numPlanes, start, stop, length, diffs);
+					opens = 0; countGapOpens(a, b, start, stop, true, opens);
+					length += opens; diffs += opens;
+					break;
+				case EACHGAPIGNORE:
+					end = findEnd(a, b, wBegin, wEnd);
+					stop = min(end + 1, findBreak(a, b, start, wEnd, false));
+					countColumns<false, false>(a, b, numWords, numPlanes, start, stop, length, diffs);
+					break;
+				case ONEGAPIGNORE:
+					end = findEnd(a, b, wBegin, wEnd);
+					stop = end + 1;
+					countColumns<false, true>(a, b, numWords, numPlanes, start, stop, length, diffs);
+					opens = 0; countGapOpens(a, b, start, stop, false, opens);
+					length += opens; diffs += opens;
+					break;
+			}
+		}
+
+		if (length == 0)	{	return 1.0000;								}
+		else				{	return ((double)diffs / (double)length);	}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PackedDist", "calcDist");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
@@ -0,0 +1,55 @@
+#ifndef Mothur_packeddist_h
+#define Mothur_packeddist_h
+
+//
+//  packeddist.h
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+/* PackedDist encodes every aligned sequence in a SequenceDB once into 64 column bit planes:
+ a terminal '.' mask, a '-' gap mask and up to 4 planes holding a code for each remaining character.
+ The distance between two sequences is then found with word wide and / or / xor and popcounts instead
+ of walking both strings one char at a time.  The results are identical to the ignoreGaps, eachGapDist,
+ oneGapDist, eachGapIgnoreTermGapDist and oneGapIgnoreTermGapDist calculators.
+
+ If the alignment can not be encoded (sequences of different lengths or more than 16 distinct characters)
+ isPacked() returns false and the caller should use the Dist calculators instead. */
+
+#include "mothur.h"
+#include "mothurout.h"
+#include "sequencedb.h"
+
+/**************************************************************************************************/
+
+class PackedDist {
+
+public:
+	PackedDist(SequenceDB&, string, bool);   //sequences, calc (nogaps, eachgap or onegap), countends
+	~PackedDist() {}
+
+	bool isPacked() { return packed; }
+	int getBytesPerSeq() { return stride * sizeof(unsigned long long); }
+	double calcDist(int, int);              //indexes of the sequences in the SequenceDB
+
+private:
+	enum calcType { NOGAPS, EACHGAP, ONEGAP, EACHGAPIGNORE, ONEGAPIGNORE };
+
+	MothurOut* m;
+	calcType calc;
+	bool packed;
+	int numSeqs, alignLength, numWords, numPlanes, stride;
+	vector<unsigned long long> planes;      //for each sequence numPlanes blocks of numWords words - dot, gap, code bits
+	vector<int> firstWord, lastWord;         //first and last word of each sequence containing a character that is not a '.'
+
+	bool encode(SequenceDB&);
+	int findStart(const unsigned long long*, const unsigned long long*, int, int);
+	int findEnd(const unsigned long long*, const unsigned long long*, int, int);
+	int findBreak(const unsigned long long*, const unsigned long long*, int, int, bool);
+	void countGapOpens(const unsigned long long*, const unsigned long long*, int, int, bool, int&);
+};
+
+/**************************************************************************************************/
+
+#endif
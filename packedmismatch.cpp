@@ -0,0 +1,214 @@
+//
+//  packedmismatch.cpp
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+#include "packedmismatch.h"
+
+/**************************************************************************************************/
+
+static inline int popCount(unsigned long long x) {
+#if defined (__GNUC__)
+	return __builtin_popcountll(x);
+#else
+	x = x - ((x >> 1) & 0x5555555555555555ULL);
+	x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+	x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+/**************************************************************************************************/
+PackedMisMatch::PackedMisMatch(int length, int d) {
+	try {
+		m = MothurOut::getInstance();
+		alignLength = length;
+		diffs = d;
+		numSeqs = 0;
+		numWords = (alignLength + 63) / 64;
+		numPlanes = 1;
+		stride = numWords;
+		indexed = false;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PackedMisMatch", "PackedMisMatch");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void PackedMisMatch::addSeq(const string& aligned) {
+	try {
+		unpacked.push_back(&aligned);
+		numSeqs++;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PackedMisMatch", "addSeq");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//mixes the bits of the key so the keys of similar columns are spread over the buckets
+unsigned long long PackedMisMatch::hashKey(unsigned long long key) {
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	key *= 0xc4ceb9fe1a85ec53ULL;
+	key ^= key >> 33;
+	return key;
+}
+/**************************************************************************************************/
+void PackedMisMatch::buildIndex() {
+	try {
+		if (numSeqs == 0) { return; }
+
+		//every character gets a code, so two columns match exactly when all their code bits do
+		int code[256];
+		for (int i = 0; i < 256; i++) { code[i] = -1; }
+		int numSymbols = 0;
+
+		for (int i = 0; i < numSeqs; i++) {
+			if (m->control_pressed) { return; }
+			for (int j = 0; j < alignLength; j++) {
+				unsigned char ch = (*unpacked[i])[j];
+				if (code[ch] == -1) { code[ch] = numSymbols++; }
+			}
+		}
+
+		numPlanes = 1;
+		while ((1 << numPlanes) < numSymbols) { numPlanes++; }
+		stride = numWords * numPlanes;
+		planes.assign((size_t)numSeqs * stride, 0);
+
+		for (int i = 0; i < numSeqs; i++) {
+			if (m->control_pressed) { return; }
+
+			unsigned long long* s = &planes[(size_t)i * stride];
+			for (int j = 0; j < alignLength; j++) {
+				int c = code[(unsigned char)(*unpacked[i])[j]];
+				unsigned long long bit = 1ULL << (j % 64);
+				for (int p = 0; p < numPlanes; p++) {
+					if (c & (1 << p)) { s[(j / 64) * numPlanes + p] |= bit; }
+				}
+			}
+		}
+		vector<const string*>().swap(unpacked);
+
+		//only the columns where the sequences differ can hold a mismatch
+		vector<unsigned long long> variable(numWords, 0);
+		const unsigned long long* first = &planes[0];
+		for (int i = 1; i < numSeqs; i++) {
+			if (m->control_pressed) { return; }
+
+			const unsigned long long* s = &planes[(size_t)i * stride];
+			for (int w = 0; w < numWords; w++) {
+				for (int p = 0; p < numPlanes; p++) { variable[w] |= s[w * numPlanes + p] ^ first[w * numPlanes + p]; }
+			}
+		}
+
+		int numVariable = 0;
+		for (int w = 0; w < numWords; w++) { numVariable += popCount(variable[w]); }
+
+		//with fewer variable columns than groups, every pair shares an empty group and nothing can be skipped
+		int numGroups = diffs + 1;
+		indexed = (numSeqs > 1) && (numVariable >= numGroups);
+		if (!indexed) { return; }
+
+		//split the variable columns into groups with the same number of them in each
+		vector< vector<unsigned long long> > groupMasks(numGroups, vector<unsigned long long>(numWords, 0));
+		int count = 0;
+		for (int w = 0; w < numWords; w++) {
+			for (int b = 0; b < 64; b++) {
+				if (variable[w] & (1ULL << b)) {
+					int g = (int)(((long long)count * numGroups) / numVariable);
+					groupMasks[g][w] |= 1ULL << b;
+					count++;
+				}
+			}
+		}
+
+		groupKeys.assign(numGroups, vector< pair<unsigned long long, int> >());
+		seqBuckets.assign(numGroups, vector<int>(numSeqs, 0));
+		for (int g = 0; g < numGroups; g++) {
+			if (m->control_pressed) { return; }
+
+			int wBegin = 0; while ((wBegin < numWords) && (groupMasks[g][wBegin] == 0)) { wBegin++; }
+			int wEnd = numWords; while ((wEnd > wBegin) && (groupMasks[g][wEnd-1] == 0)) { wEnd--; }
+
+			groupKeys[g].resize(numSeqs);
+			for (int i = 0; i < numSeqs; i++) {
+				const unsigned long long* s = &planes[(size_t)i * stride];
+				unsigned long long key = 0;
+				for (int w = wBegin; w < wEnd; w++) {
+					for (int p = 0; p < numPlanes; p++) { key = hashKey(key ^ (s[w * numPlanes + p] & groupMasks[g][w])); }
+				}
+				groupKeys[g][i] = make_pair(key, i);
+			}
+
+			//a bucket is the run of sequences with the same key, in the order they were added
+			sort(groupKeys[g].begin(), groupKeys[g].end());
+			int bucketStart = 0;
+			for (int k = 0; k < numSeqs; k++) {
+				if (groupKeys[g][k].first != groupKeys[g][bucketStart].first) { bucketStart = k; }
+				seqBuckets[g][groupKeys[g][k].second] = bucketStart;
+			}
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PackedMisMatch", "buildIndex");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+int PackedMisMatch::calcMisMatches(int i, int j) {
+	try {
+		const unsigned long long* a = &planes[(size_t)i * stride];
+		const unsigned long long* b = &planes[(size_t)j * stride];
+
+		int numBad = 0;
+		for (int w = 0; w < numWords; w++) {
+			unsigned long long different = 0;
+			for (int p = 0; p < numPlanes; p++) { different |= a[p] ^ b[p]; }
+			a += numPlanes; b += numPlanes;
+
+			numBad += popCount(different);
+			if (numBad > diffs) { return alignLength; } //to far to cluster
+		}
+
+		return numBad;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PackedMisMatch", "calcMisMatches");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void PackedMisMatch::getCandidates(int i, vector<int>& candidates) {
+	try {
+		candidates.clear();
+
+		if (!indexed) {
+			for (int j = i+1; j < numSeqs; j++) { candidates.push_back(j); }
+			return;
+		}
+
+		for (int g = 0; g < groupKeys.size(); g++) {
+			vector< pair<unsigned long long, int> >& keys = groupKeys[g];
+			int start = seqBuckets[g][i];
+			unsigned long long key = keys[start].first;
+
+			//the bucket is sorted, so the sequences after i start right after it
+			int k = lower_bound(keys.begin() + start, keys.end(), make_pair(key, i+1)) - keys.begin();
+			for (; (k < numSeqs) && (keys[k].first == key); k++) { candidates.push_back(keys[k].second); }
+		}
+
+		//a sequence sharing more than one group with i is found once for each
+		sort(candidates.begin(), candidates.end());
+		candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PackedMisMatch", "getCandidates");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
@@ -0,0 +1,52 @@
+#ifndef Mothur_packedmismatch_h
+#define Mothur_packedmismatch_h
+
+//
+//  packedmismatch.h
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+/* PackedMisMatch counts the columns where two aligned sequences have different characters, like
+ PreClusterCommand::calcMisMatches, for all the sequences of a pre.cluster group.  Each character is given a code
+ and each sequence is stored as bit planes of 64 columns, so the columns that differ are found with an xor and or
+ of the planes and counted with a popcount, stopping as soon as there are more than diffs.
+
+ It also keeps a pigeonhole index.  The columns where the sequences are not all the same are split into diffs+1
+ groups, so two sequences within diffs of each other must be identical over at least one group.  getCandidates
+ only returns the sequences sharing a group with the query, which skips the pairs that can not be within diffs.
+ Once buildIndex is done, calcMisMatches and getCandidates can be called from more than one thread. */
+
+#include "mothur.h"
+#include "mothurout.h"
+
+/**************************************************************************************************/
+
+class PackedMisMatch {
+
+public:
+	PackedMisMatch(int, int);				//alignment length, diffs
+	~PackedMisMatch() {}
+
+	void addSeq(const string&);				//kept until buildIndex, the sequences must all be alignment length
+	void buildIndex();						//after the sequences are added
+	int calcMisMatches(int, int);			//indexes of the sequences in the order added, alignment length if more than diffs
+	void getCandidates(int, vector<int>&);	//the sequences after this one that could be within diffs of it, in order
+
+private:
+	MothurOut* m;
+	int alignLength, diffs, numSeqs, numWords, numPlanes, stride;
+	bool indexed;							//false if the groups can't tell any sequences apart
+
+	vector<const string*> unpacked;			//the sequences until buildIndex packs them
+	vector<unsigned long long> planes;		//for each sequence numWords blocks of numPlanes words
+	vector< vector< pair<unsigned long long, int> > > groupKeys;	//for each group the key of each sequence, sorted
+	vector< vector<int> > seqBuckets;		//for each group where each sequence's bucket starts in groupKeys
+
+	unsigned long long hashKey(unsigned long long);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -8,21 +8,23 @@
  */
 
 #include "pairwiseseqscommand.h"
+#include "binarydist.h"
 
 //**********************************************************************************************************************
 vector<string> PairwiseSeqsCommand::setParameters(){	
 	try {
-		CommandParameter pfasta("fasta", "InputTypes", "", "", "none", "none", "none","phylip-column",false,true,true); parameters.push_back(pfasta);
-		CommandParameter palign("align", "Multiple", "needleman-gotoh-blast-noalign", "needleman", "", "", "","",false,false); parameters.push_back(palign);
+		CommandParameter pfasta("fasta", "InputTypes", "", "", "none", "none", "none","phylip-column-binary",false,true,true); parameters.push_back(pfasta);
+		CommandParameter palign("align", "Multiple", "needleman-gotoh-fastneedleman-fastgotoh-blast-noalign", "needleman", "", "", "","",false,false); parameters.push_back(palign);
 		CommandParameter pmatch("match", "Number", "", "1.0", "", "", "","",false,false); parameters.push_back(pmatch);
 		CommandParameter pmismatch("mismatch", "Number", "", "-1.0", "", "", "","",false,false); parameters.push_back(pmismatch);
 		CommandParameter pgapopen("gapopen", "Number", "", "-2.0", "", "", "","",false,false); parameters.push_back(pgapopen);
 		CommandParameter pgapextend("gapextend", "Number", "", "-1.0", "", "", "","",false,false); parameters.push_back(pgapextend);
 		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
-		CommandParameter poutput("output", "Multiple", "column-lt-square-phylip", "column", "", "", "","phylip-column",false,false,true); parameters.push_back(poutput);
+		CommandParameter poutput("output", "Multiple", "column-lt-square-phylip-binary", "column", "", "", "","phylip-column-binary",false,false,true); parameters.push_back(poutput);
 		CommandParameter pcalc("calc", "Multiple", "nogaps-eachgap-onegap", "onegap", "", "", "","",false,false); parameters.push_back(pcalc);
 		CommandParameter pcountends("countends", "Boolean", "", "T", "", "", "","",false,false); parameters.push_back(pcountends);
 		CommandParameter pcompress("compress", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pcompress);
+		CommandParameter phalfprecision("halfprecision", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(phalfprecision);
 		CommandParameter pcutoff("cutoff", "Number", "", "1.0", "", "", "","",false,false,true); parameters.push_back(pcutoff);
 		CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -41,9 +43,9 @@ string PairwiseSeqsCommand::getHelpString(){
 	try {
 		string helpString = "";
 		helpString += "The pairwise.seqs command reads a fasta file and creates distance matrix.\n";
-		helpString += "The pairwise.seqs command parameters are fasta, align, match, mismatch, gapopen, gapextend, calc, output, cutoff and processors.\n";
+		helpString += "The pairwise.seqs command parameters are fasta, align, match, mismatch, gapopen, gapextend, calc, output, halfprecision, cutoff and processors.\n";
 		helpString += "The fasta parameter is required. You may enter multiple fasta files by separating their names with dashes. ie. fasta=abrecovery.fasta-amzon.fasta \n";
-		helpString += "The align parameter allows you to specify the alignment method to use.  Your options are: gotoh, needleman, blast and noalign. The default is needleman.\n";
+		helpString += "The align parameter allows you to specify the alignment method to use.  Your options are: gotoh, needleman, fastgotoh, fastneedleman, blast and noalign. The default is needleman. The fastgotoh and fastneedleman methods give the same alignments as gotoh and needleman using integer scores, and are used automatically for sequences longer than 2000 bases.\n";
 		helpString += "The match parameter allows you to specify the bonus for having the same base. The default is 1.0.\n";
 		helpString += "The mistmatch parameter allows you to specify the penalty for having different bases.  The default is -1.0.\n";
 		helpString += "The gapopen parameter allows you to specify the penalty for opening a gap in an alignment. The default is -2.0.\n";
@@ -51,7 +53,8 @@ string PairwiseSeqsCommand::getHelpString(){
 		helpString += "The calc parameter allows you to specify the method of calculating the distances.  Your options are: nogaps, onegap or eachgap. The default is onegap.\n";
 		helpString += "The countends parameter allows you to specify whether to include terminal gaps in distance.  Your options are: T or F. The default is T.\n";
 		helpString += "The cutoff parameter allows you to specify maximum distance to keep. The default is 1.0.\n";
-		helpString += "The output parameter allows you to specify format of your distance matrix. Options are column, lt, and square. The default is column.\n";
+		helpString += "The output parameter allows you to specify format of your distance matrix. Options are column, lt, square and binary. The default is column.\n";
+		helpString += "The halfprecision parameter allows you to store the binary distances as 16 bit floats.  The default is false.\n";
 		helpString += "The compress parameter allows you to indicate that you want the resulting distance file compressed.  The default is false.\n";
 		helpString += "The pairwise.seqs command should be in the following format: \n";
 		helpString += "pairwise.seqs(fasta=yourfastaFile, align=yourAlignmentMethod) \n";
@@ -71,6 +74,7 @@ string PairwiseSeqsCommand::getOutputPattern(string type) {
         
         if (type == "phylip") {  pattern = "[filename],[outputtag],dist"; } 
         else if (type == "column") { pattern = "[filename],dist"; }
+        else if (type == "binary") { pattern = "[filename],dist,bin"; }
         else { m->mothurOut("[ERROR]: No definition for type " + type + " output pattern.\n"); m->control_pressed = true;  }
         
         return pattern;
@@ -88,6 +92,7 @@ PairwiseSeqsCommand::PairwiseSeqsCommand(){
 		vector<string> tempOutNames;
 		outputTypes["phylip"] = tempOutNames;
 		outputTypes["column"] = tempOutNames;
+		outputTypes["binary"] = tempOutNames;
 	}
 	catch(exception& e) {
 		m->errorOut(e, "PairwiseSeqsCommand", "PairwiseSeqsCommand");
@@ -121,6 +126,7 @@ PairwiseSeqsCommand::PairwiseSeqsCommand(string option)  {
 			vector<string> tempOutNames;
 			outputTypes["phylip"] = tempOutNames;
 			outputTypes["column"] = tempOutNames;
+			outputTypes["binary"] = tempOutNames;
 			
 			//if the user changes the output directory command factory will send this info to us in the output parameter 
 			outputDir = validParameter.validFile(parameters, "outputdir", false);		if (outputDir == "not found"){	outputDir = "";		}
@@ -241,11 +247,26 @@ PairwiseSeqsCommand::PairwiseSeqsCommand(string option)  {
 			temp = validParameter.validFile(parameters, "compress", false);		if(temp == "not found"){  temp = "F"; }
 			compress = m->isTrue(temp); 
 			
+			temp = validParameter.validFile(parameters, "halfprecision", false);		if(temp == "not found"){  temp = "F"; }
+			halfPrecision = m->isTrue(temp); 
+			
 			align = validParameter.validFile(parameters, "align", false);		if (align == "not found"){	align = "needleman";	}
 			
+			//the fast aligners score with integers
+			if ((align == "fastneedleman") || (align == "fastgotoh")) {
+				if (!FastAlignment::isWholeNumber(match) || !FastAlignment::isWholeNumber(misMatch) || !FastAlignment::isWholeNumber(gapOpen) || !FastAlignment::isWholeNumber(gapExtend)) {
+					m->mothurOut("[WARNING]: The " + align + " method requires whole number scores, using " + align.substr(4) + " instead."); m->mothurOutEndLine();
+					align = align.substr(4);
+				}
+			}
+			
 			output = validParameter.validFile(parameters, "output", false);		if(output == "not found"){	output = "column"; }
             if (output=="phylip") { output = "lt"; }
-			if ((output != "column") && (output != "lt") && (output != "square")) { m->mothurOut(output + " is not a valid output form. Options are column, lt and square. I will use column."); m->mothurOutEndLine(); output = "column"; }
+			if ((output != "column") && (output != "lt") && (output != "square") && (output != "binary")) { m->mothurOut(output + " is not a valid output form. Options are column, lt, square and binary. I will use column."); m->mothurOutEndLine(); output = "column"; }
+			
+			#ifdef USE_MPI
+			if (output == "binary") { m->mothurOut("The binary output is not available with MPI. I will use column."); m->mothurOutEndLine(); output = "column"; }
+			#endif
 			
 			calc = validParameter.validFile(parameters, "calc", false);			
 			if (calc == "not found") { calc = "onegap";  }
@@ -284,6 +305,13 @@ int PairwiseSeqsCommand::execute(){
 			inFASTA.close();
 			
 			int numSeqs = alignDB.getNumSeqs();
+			
+			//size the aligners for the longest sequence up front, so long reads can be given to the fast aligners
+			for (int i = 0; i < numSeqs; i++) {
+				int numBases = alignDB.getNumBases(i);
+				if (numBases >= longestBase) { longestBase = numBases + 1; }
+			}
+			
 			int startTime = time(NULL);
 			string outputFile = "";
 			
@@ -297,6 +325,10 @@ int PairwiseSeqsCommand::execute(){
 				outputFile = getOutputFileName("column", variables);
 				outputTypes["column"].push_back(outputFile);
 				m->mothurRemove(outputFile);
+			}else if (output == "binary") { //user wants the column distances in a .dist.bin file
+				outputFile = getOutputFileName("binary", variables);
+				outputTypes["binary"].push_back(outputFile);
+				m->mothurRemove(outputFile);
 			}else { //assume square
                 variables["[outputtag]"] = "square";
                 outputFile = getOutputFileName("phylip", variables);
@@ -427,9 +459,13 @@ int PairwiseSeqsCommand::execute(){
 					
 		//#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
 			//if you don't need to fork anything
+			//the drivers save binary distances to a part file that is added to the .dist.bin file once they are all done
+			string distFile = outputFile;
+			if (output == "binary") { distFile = outputFile + ".part.temp"; }
+			
 			if(processors == 1){
-				if (output != "square") {  driver(0, numSeqs, outputFile, cutoff); }
-				else { driver(0, numSeqs, outputFile, "square");  }
+				if (output != "square") {  driver(0, numSeqs, distFile, cutoff); }
+				else { driver(0, numSeqs, distFile, "square");  }
 			}else{ //you have multiple processors
 				
 				for (int i = 0; i < processors; i++) {
@@ -444,7 +480,17 @@ int PairwiseSeqsCommand::execute(){
 					}
 				}
 				
-				createProcesses(outputFile); 
+				createProcesses(distFile); 
+			}
+			
+			if (output == "binary") {
+				vector<string> names;
+				for (int i = 0; i < numSeqs; i++) { names.push_back(alignDB.getName(i)); }
+				
+				BinaryDistWriter binaryFile(outputFile, names, cutoff, halfPrecision);
+				binaryFile.addPart(distFile);
+				binaryFile.close();
+				m->mothurRemove(distFile);
 			}
 		//#else
 			//ifstream inFASTA;
@@ -611,10 +657,13 @@ int PairwiseSeqsCommand::driver(int startLine, int endLine, string dFileName, fl
 		int startTime = time(NULL);
         
         Alignment* alignment;
-        if(align == "gotoh")			{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);			}
-		else if(align == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);				}
-		else if(align == "blast")		{	alignment = new BlastAlignment(gapOpen, gapExtend, match, misMatch);		}
-		else if(align == "noalign")		{	alignment = new NoAlign();													}
+        string method = FastAlignment::getMethod(align, longestBase, match, misMatch, gapOpen, gapExtend);
+		if(method == "gotoh")			{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);			}
+		else if(method == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);				}
+		else if(method == "fastgotoh")		{	alignment = new FastGotoh(gapOpen, gapExtend, match, misMatch, longestBase, 0);			}
+		else if(method == "fastneedleman")	{	alignment = new FastNeedleman(gapOpen, match, misMatch, longestBase, 0);				}
+		else if(method == "blast")		{	alignment = new BlastAlignment(gapOpen, gapExtend, match, misMatch);		}
+		else if(method == "noalign")		{	alignment = new NoAlign();													}
 		else {
 			m->mothurOut(align + " is not a valid alignment option. I will run the command using needleman.");
 			m->mothurOutEndLine();
@@ -638,7 +687,9 @@ int PairwiseSeqsCommand::driver(int startLine, int endLine, string dFileName, fl
         }
 		
 		//column file
-		ofstream outFile(dFileName.c_str(), ios::trunc);
+		ios::openmode mode = ios::trunc;
+		if (output == "binary") { mode |= ios::binary; }
+		ofstream outFile(dFileName.c_str(), mode);
 		outFile.setf(ios::fixed, ios::showpoint);
 		outFile << setprecision(4);
 		
@@ -646,7 +697,7 @@ int PairwiseSeqsCommand::driver(int startLine, int endLine, string dFileName, fl
 		
 		for(int i=startLine;i<endLine;i++){
 			if(output == "lt")	{	
-				string name = alignDB.get(i).getName();
+				string name = alignDB.getName(i);
 				if (name.length() < 10) { //pad with spaces to make compatible
 					while (name.length() < 10) {  name += " ";  }
 				}
@@ -657,16 +708,16 @@ int PairwiseSeqsCommand::driver(int startLine, int endLine, string dFileName, fl
 				
 				if (m->control_pressed) { outFile.close(); delete alignment; delete distCalculator; return 0;  }
 				
-				if (alignDB.get(i).getUnaligned().length() > alignment->getnRows()) {
-					alignment->resize(alignDB.get(i).getUnaligned().length()+1);
+				if (alignDB.getNumBases(i) > alignment->getnRows()) {
+					alignment->resize(alignDB.getNumBases(i)+1);
 				}
 				
-				if (alignDB.get(j).getUnaligned().length() > alignment->getnRows()) {
-					alignment->resize(alignDB.get(j).getUnaligned().length()+1);
+				if (alignDB.getNumBases(j) > alignment->getnRows()) {
+					alignment->resize(alignDB.getNumBases(j)+1);
 				}
 				
-				Sequence seqI(alignDB.get(i).getName(), alignDB.get(i).getAligned());
-				Sequence seqJ(alignDB.get(j).getName(), alignDB.get(j).getAligned());
+				Sequence seqI = alignDB.get(i);
+				Sequence seqJ = alignDB.get(j);
 				
 				alignment->align(seqI.getUnaligned(), seqJ.getUnaligned());
 				seqI.setAligned(alignment->getSeqAAln());
@@ -678,7 +729,8 @@ int PairwiseSeqsCommand::driver(int startLine, int endLine, string dFileName, fl
                 if (m->debug) { m->mothurOut("[DEBUG]: " + seqI.getName() + '\t' +  alignment->getSeqAAln() + '\n' + seqJ.getName() + alignment->getSeqBAln() + '\n' + "distance = " + toString(dist) + "\n"); }
 				                
 				if(dist <= cutoff){
-					if (output == "column") { outFile << alignDB.get(i).getName() << ' ' << alignDB.get(j).getName() << ' ' << dist << endl; }
+					if (output == "column") { outFile << alignDB.getName(i) << ' ' << alignDB.getName(j) << ' ' << dist << endl; }
+					else if (output == "binary") { BinaryDistWriter::writePart(outFile, i, j, dist); }
 				}
 				if (output == "lt") {  outFile << dist << '\t'; }
 			}
@@ -711,10 +763,13 @@ int PairwiseSeqsCommand::driver(int startLine, int endLine, string dFileName, st
 		int startTime = time(NULL);
         
         Alignment* alignment;
-        if(align == "gotoh")			{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);			}
-		else if(align == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);				}
-		else if(align == "blast")		{	alignment = new BlastAlignment(gapOpen, gapExtend, match, misMatch);		}
-		else if(align == "noalign")		{	alignment = new NoAlign();													}
+        string method = FastAlignment::getMethod(align, longestBase, match, misMatch, gapOpen, gapExtend);
+		if(method == "gotoh")			{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);			}
+		else if(method == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);				}
+		else if(method == "fastgotoh")		{	alignment = new FastGotoh(gapOpen, gapExtend, match, misMatch, longestBase, 0);			}
+		else if(method == "fastneedleman")	{	alignment = new FastNeedleman(gapOpen, match, misMatch, longestBase, 0);				}
+		else if(method == "blast")		{	alignment = new BlastAlignment(gapOpen, gapExtend, match, misMatch);		}
+		else if(method == "noalign")		{	alignment = new NoAlign();													}
 		else {
 			m->mothurOut(align + " is not a valid alignment option. I will run the command using needleman.");
 			m->mothurOutEndLine();
@@ -746,7 +801,7 @@ int PairwiseSeqsCommand::driver(int startLine, int endLine, string dFileName, st
 		
 		for(int i=startLine;i<endLine;i++){
 				
-			string name = alignDB.get(i).getName();
+			string name = alignDB.getName(i);
 			//pad with spaces to make compatible
 			if (name.length() < 10) { while (name.length() < 10) {  name += " ";  } }
 				
@@ -756,16 +811,16 @@ int PairwiseSeqsCommand::driver(int startLine, int endLine, string dFileName, st
 				
 				if (m->control_pressed) { outFile.close(); delete alignment; delete distCalculator; return 0;  }
 				
-				if (alignDB.get(i).getUnaligned().length() > alignment->getnRows()) {
-					alignment->resize(alignDB.get(i).getUnaligned().length()+1);
+				if (alignDB.getNumBases(i) > alignment->getnRows()) {
+					alignment->resize(alignDB.getNumBases(i)+1);
 				}
 				
-				if (alignDB.get(j).getUnaligned().length() > alignment->getnRows()) {
-					alignment->resize(alignDB.get(j).getUnaligned().length()+1);
+				if (alignDB.getNumBases(j) > alignment->getnRows()) {
+					alignment->resize(alignDB.getNumBases(j)+1);
 				}
 				
-				Sequence seqI(alignDB.get(i).getName(), alignDB.get(i).getAligned());
-				Sequence seqJ(alignDB.get(j).getName(), alignDB.get(j).getAligned());
+				Sequence seqI = alignDB.get(i);
+				Sequence seqJ = alignDB.get(j);
 				
 				alignment->align(seqI.getUnaligned(), seqJ.getUnaligned());
 				seqI.setAligned(alignment->getSeqAAln());
@@ -808,10 +863,13 @@ int PairwiseSeqsCommand::driverMPI(int startLine, int endLine, MPI_File& outMPI,
 		int startTime = time(NULL);
         
         Alignment* alignment;
-        if(align == "gotoh")			{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);			}
-		else if(align == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);				}
-		else if(align == "blast")		{	alignment = new BlastAlignment(gapOpen, gapExtend, match, misMatch);		}
-		else if(align == "noalign")		{	alignment = new NoAlign();													}
+        string method = FastAlignment::getMethod(align, longestBase, match, misMatch, gapOpen, gapExtend);
+		if(method == "gotoh")			{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);			}
+		else if(method == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);				}
+		else if(method == "fastgotoh")		{	alignment = new FastGotoh(gapOpen, gapExtend, match, misMatch, longestBase, 0);			}
+		else if(method == "fastneedleman")	{	alignment = new FastNeedleman(gapOpen, match, misMatch, longestBase, 0);				}
+		else if(method == "blast")		{	alignment = new BlastAlignment(gapOpen, gapExtend, match, misMatch);		}
+		else if(method == "noalign")		{	alignment = new NoAlign();													}
 		else {
 			m->mothurOut(align + " is not a valid alignment option. I will run the command using needleman.");
 			m->mothurOutEndLine();
@@ -842,16 +900,16 @@ int PairwiseSeqsCommand::driverMPI(int startLine, int endLine, MPI_File& outMPI,
 				
 				if (m->control_pressed) { delete alignment; delete distCalculator; return 0;  }
 				
-				if (alignDB.get(i).getUnaligned().length() > alignment->getnRows()) {
-					alignment->resize(alignDB.get(i).getUnaligned().length()+1);
+				if (alignDB.getNumBases(i) > alignment->getnRows()) {
+					alignment->resize(alignDB.getNumBases(i)+1);
 				}
 				
-				if (alignDB.get(j).getUnaligned().length() > alignment->getnRows()) {
-					alignment->resize(alignDB.get(j).getUnaligned().length()+1);
+				if (alignDB.getNumBases(j) > alignment->getnRows()) {
+					alignment->resize(alignDB.getNumBases(j)+1);
 				}
 				
-				Sequence seqI(alignDB.get(i).getName(), alignDB.get(i).getAligned());
-				Sequence seqJ(alignDB.get(j).getName(), alignDB.get(j).getAligned());
+				Sequence seqI = alignDB.get(i);
+				Sequence seqJ = alignDB.get(j);
 				
 				alignment->align(seqI.getUnaligned(), seqJ.getUnaligned());
 				seqI.setAligned(alignment->getSeqAAln());
@@ -863,7 +921,7 @@ int PairwiseSeqsCommand::driverMPI(int startLine, int endLine, MPI_File& outMPI,
                 if (m->debug) { cout << ("[DEBUG]: " + seqI.getName() + '\t' +  alignment->getSeqAAln() + '\n' + seqJ.getName() + alignment->getSeqBAln() + '\n' + "distance = " + toString(dist) + "\n"); }
 				
 				if(dist <= cutoff){
-					 outputString += (alignDB.get(i).getName() + ' ' + alignDB.get(j).getName() + ' ' + toString(dist) + '\n'); 
+					 outputString += (alignDB.getName(i) + ' ' + alignDB.getName(j) + ' ' + toString(dist) + '\n'); 
 				}
 			}
 			
@@ -908,10 +966,13 @@ int PairwiseSeqsCommand::driverMPI(int startLine, int endLine, string file, unsi
 		MPI_File_open(MPI_COMM_SELF, filename, amode, MPI_INFO_NULL, &outMPI);
 
 		Alignment* alignment;
-        if(align == "gotoh")			{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);			}
-		else if(align == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);				}
-		else if(align == "blast")		{	alignment = new BlastAlignment(gapOpen, gapExtend, match, misMatch);		}
-		else if(align == "noalign")		{	alignment = new NoAlign();													}
+        string method = FastAlignment::getMethod(align, longestBase, match, misMatch, gapOpen, gapExtend);
+		if(method == "gotoh")			{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);			}
+		else if(method == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);				}
+		else if(method == "fastgotoh")		{	alignment = new FastGotoh(gapOpen, gapExtend, match, misMatch, longestBase, 0);			}
+		else if(method == "fastneedleman")	{	alignment = new FastNeedleman(gapOpen, match, misMatch, longestBase, 0);				}
+		else if(method == "blast")		{	alignment = new BlastAlignment(gapOpen, gapExtend, match, misMatch);		}
+		else if(method == "noalign")		{	alignment = new NoAlign();													}
 		else {
 			m->mothurOut(align + " is not a valid alignment option. I will run the command using needleman.");
 			m->mothurOutEndLine();
@@ -942,7 +1003,7 @@ int PairwiseSeqsCommand::driverMPI(int startLine, int endLine, string file, unsi
 		
 		for(int i=startLine;i<endLine;i++){
 				
-			string name = alignDB.get(i).getName();
+			string name = alignDB.getName(i);
 			if (name.length() < 10) { //pad with spaces to make compatible
 				while (name.length() < 10) {  name += " ";  }
 			}
@@ -952,16 +1013,16 @@ int PairwiseSeqsCommand::driverMPI(int startLine, int endLine, string file, unsi
 				
 				if (m->control_pressed) { delete alignment; delete distCalculator; return 0;  }
 				
-				if (alignDB.get(i).getUnaligned().length() > alignment->getnRows()) {
-					alignment->resize(alignDB.get(i).getUnaligned().length()+1);
+				if (alignDB.getNumBases(i) > alignment->getnRows()) {
+					alignment->resize(alignDB.getNumBases(i)+1);
 				}
 				
-				if (alignDB.get(j).getUnaligned().length() > alignment->getnRows()) {
-					alignment->resize(alignDB.get(j).getUnaligned().length()+1);
+				if (alignDB.getNumBases(j) > alignment->getnRows()) {
+					alignment->resize(alignDB.getNumBases(j)+1);
 				}
 				
-				Sequence seqI(alignDB.get(i).getName(), alignDB.get(i).getAligned());
-				Sequence seqJ(alignDB.get(j).getName(), alignDB.get(j).getAligned());
+				Sequence seqI = alignDB.get(i);
+				Sequence seqJ = alignDB.get(j);
 				
 				alignment->align(seqI.getUnaligned(), seqJ.getUnaligned());
 				seqI.setAligned(alignment->getSeqAAln());
@@ -1014,10 +1075,13 @@ int PairwiseSeqsCommand::driverMPI(int startLine, int endLine, string file, unsi
 		MPI_File_open(MPI_COMM_SELF, filename, amode, MPI_INFO_NULL, &outMPI);
 		
 		Alignment* alignment;
-        if(align == "gotoh")			{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);			}
-		else if(align == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);				}
-		else if(align == "blast")		{	alignment = new BlastAlignment(gapOpen, gapExtend, match, misMatch);		}
-		else if(align == "noalign")		{	alignment = new NoAlign();													}
+        string method = FastAlignment::getMethod(align, longestBase, match, misMatch, gapOpen, gapExtend);
+		if(method == "gotoh")			{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);			}
+		else if(method == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);				}
+		else if(method == "fastgotoh")		{	alignment = new FastGotoh(gapOpen, gapExtend, match, misMatch, longestBase, 0);			}
+		else if(method == "fastneedleman")	{	alignment = new FastNeedleman(gapOpen, match, misMatch, longestBase, 0);				}
+		else if(method == "blast")		{	alignment = new BlastAlignment(gapOpen, gapExtend, match, misMatch);		}
+		else if(method == "noalign")		{	alignment = new NoAlign();													}
 		else {
 			m->mothurOut(align + " is not a valid alignment option. I will run the command using needleman.");
 			m->mothurOutEndLine();
@@ -1047,7 +1111,7 @@ int PairwiseSeqsCommand::driverMPI(int startLine, int endLine, string file, unsi
 		
 		for(int i=startLine;i<endLine;i++){
 				
-			string name = alignDB.get(i).getName();
+			string name = alignDB.getName(i);
 			if (name.length() < 10) { //pad with spaces to make compatible
 				while (name.length() < 10) {  name += " ";  }
 			}
@@ -1057,16 +1121,16 @@ int PairwiseSeqsCommand::driverMPI(int startLine, int endLine, string file, unsi
 				
 				if (m->control_pressed) {  delete alignment; return 0;  }
 				
-				if (alignDB.get(i).getUnaligned().length() > alignment->getnRows()) {
-					alignment->resize(alignDB.get(i).getUnaligned().length()+1);
+				if (alignDB.getNumBases(i) > alignment->getnRows()) {
+					alignment->resize(alignDB.getNumBases(i)+1);
 				}
 				
-				if (alignDB.get(j).getUnaligned().length() > alignment->getnRows()) {
-					alignment->resize(alignDB.get(j).getUnaligned().length()+1);
+				if (alignDB.getNumBases(j) > alignment->getnRows()) {
+					alignment->resize(alignDB.getNumBases(j)+1);
 				}
 				
-				Sequence seqI(alignDB.get(i).getName(), alignDB.get(i).getAligned());
-				Sequence seqJ(alignDB.get(j).getName(), alignDB.get(j).getAligned());
+				Sequence seqI = alignDB.get(i);
+				Sequence seqJ = alignDB.get(j);
 				
 				alignment->align(seqI.getUnaligned(), seqJ.getUnaligned());
 				seqI.setAligned(alignment->getSeqAAln());
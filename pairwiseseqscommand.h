@@ -21,6 +21,8 @@
 
 #include "gotohoverlap.hpp"
 #include "needlemanoverlap.hpp"
+#include "fastgotoh.hpp"
+#include "fastneedleman.hpp"
 #include "blastalign.hpp"
 #include "noalign.hpp"
 
@@ -28,6 +30,7 @@
 #include "eachgapdist.h"
 #include "eachgapignore.h"
 #include "onegapdist.h"
+#include "binarydist.h"
 #include "onegapignore.h"
 
 class PairwiseSeqsCommand : public Command {
@@ -76,7 +79,7 @@ private:
 	vector<string> fastaFileNames, Estimators;
 	vector<string> outputNames;
 	
-	bool abort, countends, compress;
+	bool abort, countends, compress, halfPrecision;
 };
 
 /**************************************************************************************************/
@@ -134,10 +137,13 @@ static DWORD WINAPI MyPairwiseSquareThreadFunction(LPVOID lpParam){
         int startTime = time(NULL);
         
         Alignment* alignment;
-        if(pDataArray->align == "gotoh")			{	alignment = new GotohOverlap(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch, pDataArray->longestBase);			}
-		else if(pDataArray->align == "needleman")	{	alignment = new NeedlemanOverlap(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, pDataArray->longestBase);				}
-		else if(pDataArray->align == "blast")		{	alignment = new BlastAlignment(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch);		}
-		else if(pDataArray->align == "noalign")		{	alignment = new NoAlign();													}
+        string method = FastAlignment::getMethod(pDataArray->align, pDataArray->longestBase, pDataArray->match, pDataArray->misMatch, pDataArray->gapOpen, pDataArray->gapExtend);
+		if(method == "gotoh")			{	alignment = new GotohOverlap(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch, pDataArray->longestBase);			}
+		else if(method == "needleman")	{	alignment = new NeedlemanOverlap(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, pDataArray->longestBase);				}
+		else if(method == "fastgotoh")		{	alignment = new FastGotoh(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch, pDataArray->longestBase, 0);			}
+		else if(method == "fastneedleman")	{	alignment = new FastNeedleman(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, pDataArray->longestBase, 0);				}
+		else if(method == "blast")		{	alignment = new BlastAlignment(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch);		}
+		else if(method == "noalign")		{	alignment = new NoAlign();													}
 		else {
 			pDataArray->m->mothurOut(pDataArray->align + " is not a valid alignment option. I will run the command using needleman.");
 			pDataArray->m->mothurOutEndLine();
@@ -165,7 +171,7 @@ static DWORD WINAPI MyPairwiseSquareThreadFunction(LPVOID lpParam){
 		for(int i=pDataArray->start;i<pDataArray->end;i++){
             pDataArray->count++;
             
-			string name = pDataArray->alignDB.get(i).getName();
+			string name = pDataArray->alignDB.getName(i);
 			//pad with spaces to make compatible
 			if (name.length() < 10) { while (name.length() < 10) {  name += " ";  } }
             
@@ -175,16 +181,16 @@ static DWORD WINAPI MyPairwiseSquareThreadFunction(LPVOID lpParam){
 				
 				if (pDataArray->m->control_pressed) { outFile.close(); delete alignment; delete distCalculator; return 0;  }
 				
-				if (pDataArray->alignDB.get(i).getUnaligned().length() > alignment->getnRows()) {
-					alignment->resize(pDataArray->alignDB.get(i).getUnaligned().length()+1);
+				if (pDataArray->alignDB.getNumBases(i) > alignment->getnRows()) {
+					alignment->resize(pDataArray->alignDB.getNumBases(i)+1);
 				}
 				
-				if (pDataArray->alignDB.get(j).getUnaligned().length() > alignment->getnRows()) {
-					alignment->resize(pDataArray->alignDB.get(j).getUnaligned().length()+1);
+				if (pDataArray->alignDB.getNumBases(j) > alignment->getnRows()) {
+					alignment->resize(pDataArray->alignDB.getNumBases(j)+1);
 				}
 				
-				Sequence seqI(pDataArray->alignDB.get(i).getName(), pDataArray->alignDB.get(i).getAligned());
-				Sequence seqJ(pDataArray->alignDB.get(j).getName(), pDataArray->alignDB.get(j).getAligned());
+				Sequence seqI = pDataArray->alignDB.get(i);
+				Sequence seqJ = pDataArray->alignDB.get(j);
 				
 				alignment->align(seqI.getUnaligned(), seqJ.getUnaligned());
 				seqI.setAligned(alignment->getSeqAAln());
@@ -225,17 +231,22 @@ static DWORD WINAPI MyPairwiseThreadFunction(LPVOID lpParam){
 	pDataArray = (pairwiseData*)lpParam;
 	
 	try {
-		ofstream outFile((pDataArray->outputFileName).c_str(), ios::trunc);
+		ios::openmode mode = ios::trunc;
+		if (pDataArray->output == "binary") { mode |= ios::binary; }
+		ofstream outFile((pDataArray->outputFileName).c_str(), mode);
 		outFile.setf(ios::fixed, ios::showpoint);
 		outFile << setprecision(4);
         
         int startTime = time(NULL);
         
         Alignment* alignment;
-        if(pDataArray->align == "gotoh")			{	alignment = new GotohOverlap(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch, pDataArray->longestBase);			}
-		else if(pDataArray->align == "needleman")	{	alignment = new NeedlemanOverlap(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, pDataArray->longestBase);				}
-		else if(pDataArray->align == "blast")		{	alignment = new BlastAlignment(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch);		}
-		else if(pDataArray->align == "noalign")		{	alignment = new NoAlign();													}
+        string method = FastAlignment::getMethod(pDataArray->align, pDataArray->longestBase, pDataArray->match, pDataArray->misMatch, pDataArray->gapOpen, pDataArray->gapExtend);
+		if(method == "gotoh")			{	alignment = new GotohOverlap(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch, pDataArray->longestBase);			}
+		else if(method == "needleman")	{	alignment = new NeedlemanOverlap(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, pDataArray->longestBase);				}
+		else if(method == "fastgotoh")		{	alignment = new FastGotoh(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch, pDataArray->longestBase, 0);			}
+		else if(method == "fastneedleman")	{	alignment = new FastNeedleman(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, pDataArray->longestBase, 0);				}
+		else if(method == "blast")		{	alignment = new BlastAlignment(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch);		}
+		else if(method == "noalign")		{	alignment = new NoAlign();													}
 		else {
 			pDataArray->m->mothurOut(pDataArray->align + " is not a valid alignment option. I will run the command using needleman.");
 			pDataArray->m->mothurOutEndLine();
@@ -265,7 +276,7 @@ static DWORD WINAPI MyPairwiseThreadFunction(LPVOID lpParam){
             pDataArray->count++;
             
 			if(pDataArray->output == "lt")	{	
-				string name = pDataArray->alignDB.get(i).getName();
+				string name = pDataArray->alignDB.getName(i);
 				if (name.length() < 10) { //pad with spaces to make compatible
 					while (name.length() < 10) {  name += " ";  }
 				}
@@ -277,16 +288,16 @@ static DWORD WINAPI MyPairwiseThreadFunction(LPVOID lpParam){
 				
 				if (pDataArray->m->control_pressed) { outFile.close(); delete alignment; delete distCalculator; return 0;  }
 				
-				if (pDataArray->alignDB.get(i).getUnaligned().length() > alignment->getnRows()) {
-					alignment->resize(pDataArray->alignDB.get(i).getUnaligned().length()+1);
+				if (pDataArray->alignDB.getNumBases(i) > alignment->getnRows()) {
+					alignment->resize(pDataArray->alignDB.getNumBases(i)+1);
 				}
 				
-				if (pDataArray->alignDB.get(j).getUnaligned().length() > alignment->getnRows()) {
-					alignment->resize(pDataArray->alignDB.get(j).getUnaligned().length()+1);
+				if (pDataArray->alignDB.getNumBases(j) > alignment->getnRows()) {
+					alignment->resize(pDataArray->alignDB.getNumBases(j)+1);
 				}
 				
-				Sequence seqI(pDataArray->alignDB.get(i).getName(), pDataArray->alignDB.get(i).getAligned());
-				Sequence seqJ(pDataArray->alignDB.get(j).getName(), pDataArray->alignDB.get(j).getAligned());
+				Sequence seqI = pDataArray->alignDB.get(i);
+				Sequence seqJ = pDataArray->alignDB.get(j);
 				
 				alignment->align(seqI.getUnaligned(), seqJ.getUnaligned());
 				seqI.setAligned(alignment->getSeqAAln());
@@ -298,7 +309,8 @@ static DWORD WINAPI MyPairwiseThreadFunction(LPVOID lpParam){
                 if (pDataArray->m->debug) { pDataArray->m->mothurOut("[DEBUG]: " + seqI.getName() + '\t' +  alignment->getSeqAAln() + '\n' + seqJ.getName() + alignment->getSeqBAln() + '\n' + "distance = " + toString(dist) + "\n"); }
                 
 				if(dist <= pDataArray->cutoff){
-					if (pDataArray->output == "column") { outFile << pDataArray->alignDB.get(i).getName() << ' ' << pDataArray->alignDB.get(j).getName() << ' ' << dist << endl; }
+					if (pDataArray->output == "column") { outFile << pDataArray->alignDB.getName(i) << ' ' << pDataArray->alignDB.getName(j) << ' ' << dist << endl; }
+					else if (pDataArray->output == "binary") { BinaryDistWriter::writePart(outFile, i, j, dist); }
 				}
 				if (pDataArray->output == "lt") {  outFile << dist << '\t'; }
 			}
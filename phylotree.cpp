@@ -207,6 +207,25 @@ PhyloTree::PhyloTree(string tfile){
 	}
 }
 
+/**************************************************************************************************/
+//same tree as PhyloTree(ifstream&, string) makes from a train.tree file
+PhyloTree::PhyloTree(vector<TaxNode>& nodes, vector<int>& genusNodes, vector<int>& genusTotals){
+	try {
+		m = MothurOut::getInstance();
+		calcTotals = false;
+		numSeqs = 0;
+		
+		tree = nodes;
+		numNodes = tree.size();
+		
+		for (int i = 0; i < genusNodes.size(); i++) { uniqueTaxonomies.insert(genusNodes[i]); }
+		totals = genusTotals;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PhyloTree", "PhyloTree");
+		exit(1);
+	}
+}
 /**************************************************************************************************/
 
 string PhyloTree::getNextTaxon(string& heirarchy, string seqname){
@@ -618,6 +637,21 @@ void PhyloTree::printTreeNodes(string treefilename) {
 	}
 }
 /**************************************************************************************************/
+void PhyloTree::getTreeNodes(vector<TaxNode>& nodes) {
+	try {
+		nodes.resize(tree.size());
+		for (int i = 0; i < tree.size(); i++) {
+			nodes[i].name = tree[i].name;
+			nodes[i].level = tree[i].level;
+			nodes[i].parent = tree[i].parent;
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PhyloTree", "getTreeNodes");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
 TaxNode PhyloTree::get(int i ){
 	try {
 		if (i < tree.size()) {  return tree[i];	 }
@@ -33,10 +33,12 @@ public:
 	PhyloTree();
 	PhyloTree(string);  //pass it a taxonomy file and it makes the tree
 	PhyloTree(ifstream&, string);  //pass it a taxonomy file and it makes the train.tree
+	PhyloTree(vector<TaxNode>&, vector<int>&, vector<int>&);  //pass it the nodes, genus nodes and genus totals and it makes the train.tree
 	~PhyloTree() {};
 	int addSeqToTree(string, string);
 	void assignHeirarchyIDs(int);
 	void printTreeNodes(string); //used by bayesian to save time
+	void getTreeNodes(vector<TaxNode>&); //fills with each node's name, level and parent, used by bayesian to save time
 	vector<int> getGenusNodes();
 	vector<int> getGenusTotals();	
 	void setUp(string);  //used to create file needed for summary file if you use () constructor and add seqs manually instead of passing taxonomyfile
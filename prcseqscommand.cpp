@@ -634,7 +634,7 @@ int PcrSeqsCommand::driverPcr(string filename, string goodFasta, string badFasta
 		ifstream inFASTA;
 		m->openInputFile(filename, inFASTA);
         
-		inFASTA.seekg(filePos.start);
+		if (filePos.start != 0) { inFASTA.seekg(filePos.start); }
         
 		bool done = false;
 		int count = 0;
@@ -812,8 +812,7 @@ int PcrSeqsCommand::driverPcr(string filename, string goodFasta, string badFasta
 			}
 			
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-            unsigned long long pos = inFASTA.tellg();
-            if ((pos == -1) || (pos >= filePos.end)) { break; }
+            if (m->endOfPart(inFASTA, filePos.end)) { break; }
 #else
             if (inFASTA.eof()) { break; }
 #endif
@@ -43,6 +43,7 @@ string PreClusterCommand::getHelpString(){
 		helpString += "The name parameter allows you to give a list of seqs that are identical. This file is 2 columns, first column is name or representative sequence, second column is a list of its identical sequences separated by commas.\n";
 		helpString += "The group parameter allows you to provide a group file so you can cluster by group. \n";
         helpString += "The count parameter allows you to provide a count file so you can cluster by group. \n";
+		helpString += "The processors parameter allows you to specify the number of threads to use. The groups are clustered at the same time, largest first, and a group or fasta file too large to share out has its comparisons split between the threads.\n";
 		helpString += "The diffs parameter allows you to specify maximum number of mismatched bases allowed between sequences in a grouping. The default is 1.\n";
         helpString += "The topdown parameter allows you to specify whether to cluster from largest abundance to smallest or smallest to largest.  Default=T, meaning largest to smallest.\n";
 		helpString += "The pre.cluster command should be in the following format: \n";
@@ -252,9 +253,6 @@ int PreClusterCommand::execute(){
 		else { outputNames.push_back(newCountFile); outputTypes["count"].push_back(newCountFile); }
 		
 		if (bygroup) {
-			//clear out old files
-			ofstream outFasta; m->openOutputFile(newFastaFile, outFasta); outFasta.close();
-			ofstream outNames; m->openOutputFile(newNamesFile, outNames);  outNames.close();
 			newMapFile = fileroot + "precluster.";
 			
 			//parse fasta and name file by group
@@ -268,8 +266,7 @@ int PreClusterCommand::execute(){
                 groups = parser->getNamesOfGroups();
 			}
             
-			if(processors == 1)	{	driverGroups(newFastaFile, newNamesFile, newMapFile, 0, groups.size(), groups);	}
-			else				{	createProcessesGroups(newFastaFile, newNamesFile, newMapFile, groups);			}
+			createThreadsGroups(newFastaFile, newNamesFile, newMapFile, groups);
 			
 			if (countfile != "") { 
                 mergeGroupCounts(newCountFile, newNamesFile, newFastaFile);
@@ -300,26 +297,34 @@ int PreClusterCommand::execute(){
 			m->mothurOut("It took " + toString(time(NULL) - start) + " secs to run pre.cluster."); m->mothurOutEndLine(); 
 				
 		}else {
-            if (processors != 1) { m->mothurOut("When using running without group information mothur can only use 1 processor, continuing."); m->mothurOutEndLine(); processors = 1; }
 			if (namefile != "") { readNameFile(); }
 		
 			//reads fasta file and return number of seqs
-			int numSeqs = readFASTA(); //fills alignSeqs and makes all seqs active
+			preClusterGroup group;
+			int numSeqs = readFASTA(group); //fills the group's seqs and makes all seqs active
 		
 			if (m->control_pressed) { for (int i = 0; i < outputNames.size(); i++) {	m->mothurRemove(outputNames[i]); 	} return 0; }
 	
 			if (numSeqs == 0) { m->mothurOut("Error reading fasta file...please correct."); m->mothurOutEndLine(); return 0;  }
-			if (diffs > length) { m->mothurOut("Error: diffs is greater than your sequence length."); m->mothurOutEndLine(); return 0;  }
+			if (diffs > group.length) { m->mothurOut("Error: diffs is greater than your sequence length."); m->mothurOutEndLine(); return 0;  }
 			
-			int count = process(newMapFile);
+			//without groups the processors split the comparisons
+			int count = process(group, newMapFile, processors, true);
+			m->mothurOut(group.messages);
 			outputNames.push_back(newMapFile); outputTypes["map"].push_back(newMapFile);
 			
 			if (m->control_pressed) { for (int i = 0; i < outputNames.size(); i++) {	m->mothurRemove(outputNames[i]); 	} return 0; }	
 			
-			m->mothurOut("Total number of sequences before precluster was " + toString(alignSeqs.size()) + "."); m->mothurOutEndLine();
+			m->mothurOut("Total number of sequences before precluster was " + toString(group.numSeqs) + "."); m->mothurOutEndLine();
 			m->mothurOut("pre.cluster removed " + toString(count) + " sequences."); m->mothurOutEndLine(); m->mothurOutEndLine(); 
 			if (countfile != "") { newNamesFile = newCountFile; }
-            printData(newFastaFile, newNamesFile, "");
+			
+			ofstream outFasta, outNames;
+			m->openOutputFile(newFastaFile, outFasta);
+			m->openOutputFile(newNamesFile, outNames);
+            printData(group, outFasta, outNames, "");
+			outFasta.close();
+			outNames.close();
             			
 			m->mothurOut("It took " + toString(time(NULL) - start) + " secs to cluster " + toString(numSeqs) + " sequences."); m->mothurOutEndLine(); 
 		}
@@ -357,346 +362,289 @@ int PreClusterCommand::execute(){
 	}
 }
 /**************************************************************************************************/
-int PreClusterCommand::createProcessesGroups(string newFName, string newNName, string newMFile, vector<string> groups) {
+//this thread loads the groups largest first and writes them to the merged outputs in group order, the workers cluster them
+int PreClusterCommand::createThreadsGroups(string newFName, string newNName, string newMFile, vector<string> groups) {
 	try {
-		
-		vector<int> processIDS;
-		int process = 1;
-		int num = 0;
-		bool recalc = false;
-        
-		//sanity check
-		if (groups.size() < processors) { processors = groups.size(); }
-		
-		//divide the groups between the processors
-		vector<linePair> lines;
-		int remainingPairs = groups.size();
-        int startIndex = 0;
-        for (int remainingProcessors = processors; remainingProcessors > 0; remainingProcessors--) {
-            int numPairs = remainingPairs; //case for last processor
-            if (remainingProcessors != 1) { numPairs = ceil(remainingPairs / remainingProcessors); }
-            lines.push_back(linePair(startIndex, (startIndex+numPairs))); //startIndex, endIndex
-            startIndex = startIndex + numPairs;
-            remainingPairs = remainingPairs - numPairs;
-        }
-		
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)		
-		
-		//loop through and create all the processes you want
-		while (process != processors) {
-			pid_t pid = fork();
-			
-			if (pid > 0) {
-				processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-				process++;
-			}else if (pid == 0){
-                outputNames.clear();
-				num = driverGroups(newFName + m->mothurGetpid(process) + ".temp", newNName + m->mothurGetpid(process) + ".temp", newMFile, lines[process].start, lines[process].end, groups);
-                
-                string tempFile = m->mothurGetpid(process) + ".outputNames.temp";
-                ofstream outTemp;
-                m->openOutputFile(tempFile, outTemp);
-                
-                outTemp << outputNames.size();
-                for (int i = 0; i < outputNames.size(); i++) { outTemp << outputNames[i] << endl; }
-                outTemp.close();
-                
-				exit(0);
-			}else {
-                m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(process) + "\n"); processors = process;
-                for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                recalc = true;
-				break;
-			}
-		}
-        
-        if (recalc) {
-            lines.clear();
-            num = 0;
-            processIDS.resize(0);
-            process = 1;
-            
-            int remainingPairs = groups.size();
-            int startIndex = 0;
-            for (int remainingProcessors = processors; remainingProcessors > 0; remainingProcessors--) {
-                int numPairs = remainingPairs; //case for last processor
-                if (remainingProcessors != 1) { numPairs = ceil(remainingPairs / remainingProcessors); }
-                lines.push_back(linePair(startIndex, (startIndex+numPairs))); //startIndex, endIndex
-                startIndex = startIndex + numPairs;
-                remainingPairs = remainingPairs - numPairs;
-            }
-            
-            while (process != processors) {
-                pid_t pid = fork();
-                
-                if (pid > 0) {
-                    processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-                    process++;
-                }else if (pid == 0){
-                    outputNames.clear();
-                    num = driverGroups(newFName + m->mothurGetpid(process) + ".temp", newNName + m->mothurGetpid(process) + ".temp", newMFile, lines[process].start, lines[process].end, groups);
-                    
-                    string tempFile = m->mothurGetpid(process) + ".outputNames.temp";
-                    ofstream outTemp;
-                    m->openOutputFile(tempFile, outTemp);
-                    
-                    outTemp << outputNames.size();
-                    for (int i = 0; i < outputNames.size(); i++) { outTemp << outputNames[i] << endl; }
-                    outTemp.close();
-                    
-                    exit(0);
-                }else {
-                    m->mothurOut("[ERROR]: unable to spawn the necessary processes."); m->mothurOutEndLine();
-                    for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                    exit(0);
-                }
-            }
-        }
+		//the groups are appended to the outputs as they are written
+		ofstream outFasta;
+		m->openOutputFile(newFName, outFasta);
+		outFasta.close();
 
-		
-		//do my part
-		num = driverGroups(newFName, newNName, newMFile, lines[0].start, lines[0].end, groups);
-		
-		//force parent to wait until all the processes are done
-		for (int i=0;i<processIDS.size();i++) { 
-			int temp = processIDS[i];
-			wait(&temp);
+		ofstream outNames;
+		m->openOutputFile(newNName, outNames);
+		outNames.close();
+
+		int numGroups = groups.size();
+
+		//the comparisons grow with the square of a group's size, so the largest groups are started first and the last to finish are small
+		vector< pair<int, int> > order;
+		double totalPairs = 0;
+		for (int i = 0; i < numGroups; i++) {
+			int numSeqs = 0;
+			if (countfile != "") { numSeqs = cparser->getNumSeqs(groups[i]); }
+			else { numSeqs = parser->getNumSeqs(groups[i]); }
+			order.push_back(make_pair(-numSeqs, i));
+			totalPairs += numSeqs * (double)numSeqs;
 		}
-        
-        for (int i = 0; i < processIDS.size(); i++) {
-            string tempFile = toString(processIDS[i]) +  ".outputNames.temp";
-            ifstream intemp;
-            m->openInputFile(tempFile, intemp);
-            
-            int num;
-            intemp >> num;
-            for (int k = 0; k < num; k++) {
-                string name = "";
-                intemp >> name; m->gobble(intemp);
-                
-                outputNames.push_back(name); outputTypes["map"].push_back(name);
-            }
-            intemp.close();
-            m->mothurRemove(tempFile);
-        }
-#else
-		
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		//Windows version shared memory, so be careful when passing variables through the preClusterData struct. 
-		//Above fork() will clone, so memory is separate, but that's not the case with windows, 
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		
-		vector<preClusterData*> pDataArray; 
-		DWORD   dwThreadIdArray[processors-1];
-		HANDLE  hThreadArray[processors-1]; 
-		
-		//Create processor worker threads.
-		for( int i=1; i<processors; i++ ){
-			// Allocate memory for thread data.
-			string extension = toString(i) + ".temp";
-			
-			preClusterData* tempPreCluster = new preClusterData(fastafile, namefile, groupfile, countfile, (newFName+extension), (newNName+extension), newMFile, groups, m, lines[i].start, lines[i].end, diffs, topdown, i);
-			pDataArray.push_back(tempPreCluster);
-			processIDS.push_back(i);
-			
-			//MySeqSumThreadFunction is in header. It must be global or static to work with the threads.
-			//default security attributes, thread function name, argument to thread function, use default creation flags, returns the thread identifier
-			hThreadArray[i-1] = CreateThread(NULL, 0, MyPreclusterThreadFunction, pDataArray[i-1], 0, &dwThreadIdArray[i-1]);   
+		sort(order.begin(), order.end());
+
+		clusteredGroups.clear();
+		clusteredGroups.resize(numGroups);
+
+		//a group with more than one thread's share of the comparisons is clustered on its own, with its rows split between all the threads
+		int next = 0;
+		while ((processors > 1) && (next < numGroups) && (order[next].first * (double)order[next].first > (totalPairs / processors))) {
+			if (m->control_pressed) { break; }
+
+			preClusterGroup& group = clusteredGroups[order[next].second];
+			loadGroup(groups[order[next].second], group);
+			if (!m->control_pressed) { clusterGroup(groups[order[next].second], newMFile, processors, group); }
+			group.clustered = true;
+			next++;
 		}
-		
-				
-		//using the main process as a worker saves time and memory
-		num = driverGroups(newFName, newNName, newMFile, lines[0].start, lines[0].end, groups);
-		
-		//Wait until all threads have terminated.
-		WaitForMultipleObjects(processors-1, hThreadArray, TRUE, INFINITE);
-		
-		//Close all thread handles and free memory allocations.
-		for(int i=0; i < pDataArray.size(); i++){
-            if (pDataArray[i]->count != (pDataArray[i]->end-pDataArray[i]->start)) {
-                m->mothurOut("[ERROR]: process " + toString(i) + " only processed " + toString(pDataArray[i]->count) + " of " + toString(pDataArray[i]->end-pDataArray[i]->start) + " groups assigned to it, quitting. \n"); m->control_pressed = true; 
-            }
-			for (int j = 0; j < pDataArray[i]->mapFileNames.size(); j++) {
-				outputNames.push_back(pDataArray[i]->mapFileNames[j]); outputTypes["map"].push_back(pDataArray[i]->mapFileNames[j]); 
+
+		WorkQueue queue(processors);
+		numInFlight = 0;
+
+		vector<thread*> workers;
+		for (int i = 0; i < processors; i++) { workers.push_back(new thread(&PreClusterCommand::clusterWorker, this, i, &queue, newMFile, ref(groups))); }
+
+		//only a few groups are loaded ahead of the workers, so the sequences of every group are not copied at once
+		int window = 2 * processors;
+		int numWritten = 0;
+
+		while (numWritten < numGroups) {
+			bool load = false;
+			{
+				unique_lock<mutex> guard(groupLock);
+				while (true) {
+					if ((next < numGroups) && (numInFlight < window)) { load = true; numInFlight++; break; }
+					if (clusteredGroups[numWritten].clustered) { break; }
+					groupDone.wait(guard);
+				}
 			}
-			CloseHandle(hThreadArray[i]);
-			delete pDataArray[i];
+
+			if (load) {
+				//once cancelled the workers mark the rest of the groups done without clustering them
+				if (!m->control_pressed) { loadGroup(groups[order[next].second], clusteredGroups[order[next].second]); }
+				queue.push(next % processors, order[next].second);
+				next++;
+				continue;
+			}
+
+			//write the next group once it is clustered
+			preClusterGroup& group = clusteredGroups[numWritten];
+			string mapFile = newMFile + groups[numWritten] + ".map";
+			string fastaTemp = newMFile + groups[numWritten] + ".fasta.temp";
+			string namesTemp = newMFile + groups[numWritten] + ".names.temp";
+			numWritten++;
+
+			if (group.messages != "") { m->mothurOutEndLine(); m->mothurOut("Processing group " + groups[numWritten-1] + ":"); m->mothurOutEndLine(); m->mothurOut(group.messages); }
+			string().swap(group.messages);
+
+			if (m->control_pressed) { continue; }
+
+			m->appendFiles(fastaTemp, newFName); m->mothurRemove(fastaTemp);
+			m->appendFiles(namesTemp, newNName); m->mothurRemove(namesTemp);
+			outputNames.push_back(mapFile); outputTypes["map"].push_back(mapFile);
 		}
-		
-#endif		
-		
-		//append output files
-		for(int i=0;i<processIDS.size();i++){
-			//newFName = m->getFullPathName(".\\" + newFName);
-			//newNName = m->getFullPathName(".\\" + newNName);
-			
-			m->appendFiles((newFName + toString(processIDS[i]) + ".temp"), newFName);
-			m->mothurRemove((newFName + toString(processIDS[i]) + ".temp"));
-			
-			m->appendFiles((newNName + toString(processIDS[i]) + ".temp"), newNName);
-			m->mothurRemove((newNName + toString(processIDS[i]) + ".temp"));
+
+		queue.close();
+		for (int i = 0; i < workers.size(); i++) { workers[i]->join(); delete workers[i]; }
+		clusteredGroups.clear();
+
+		if (m->control_pressed) { 
+			for (int i = 0; i < numGroups; i++) { m->mothurRemove(newMFile + groups[i] + ".fasta.temp"); m->mothurRemove(newMFile + groups[i] + ".names.temp"); }
 		}
-		
-		return num;	
-		
+
+		return 0;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "PreClusterCommand", "createProcessesGroups");
+		m->errorOut(e, "PreClusterCommand", "createThreadsGroups");
 		exit(1);
 	}
 }
 /**************************************************************************************************/
-int PreClusterCommand::driverGroups(string newFFile, string newNFile, string newMFile, int start, int end, vector<string> groups){
+void PreClusterCommand::clusterWorker(int worker, WorkQueue* queue, string newMFile, vector<string>& groups) {
 	try {
-		
-		int numSeqs = 0;
-		
-		//precluster each group
-		for (int i = start; i < end; i++) {
-			
-			start = time(NULL);
-			
-			if (m->control_pressed) {  return 0; }
-			
-			m->mothurOutEndLine(); m->mothurOut("Processing group " + groups[i] + ":"); m->mothurOutEndLine();
-			
-			map<string, string> thisNameMap;
-            vector<Sequence> thisSeqs;
-			if (groupfile != "") { 
-                thisSeqs = parser->getSeqs(groups[i]);
-            }else if (countfile != "") {
-                thisSeqs = cparser->getSeqs(groups[i]);
-            }
-			if (namefile != "") {  thisNameMap = parser->getNameMap(groups[i]); }
-            
-			//fill alignSeqs with this groups info.
-			numSeqs = loadSeqs(thisNameMap, thisSeqs, groups[i]);
-			
-			if (m->control_pressed) {   return 0; }
-			
-			if (diffs > length) { m->mothurOut("Error: diffs is greater than your sequence length."); m->mothurOutEndLine(); m->control_pressed = true; return 0;  }
-			
-			int count= process(newMFile+groups[i]+".map");
-			outputNames.push_back(newMFile+groups[i]+".map"); outputTypes["map"].push_back(newMFile+groups[i]+".map");
-			
-			if (m->control_pressed) {  return 0; }
-			
-			m->mothurOut("Total number of sequences before pre.cluster was " + toString(alignSeqs.size()) + "."); m->mothurOutEndLine();
-			m->mothurOut("pre.cluster removed " + toString(count) + " sequences."); m->mothurOutEndLine(); m->mothurOutEndLine(); 
-			printData(newFFile, newNFile, groups[i]);
-			
-			m->mothurOut("It took " + toString(time(NULL) - start) + " secs to cluster " + toString(numSeqs) + " sequences."); m->mothurOutEndLine(); 
-			
+		long long task;
+		while (queue->pop(worker, task)) {
+			preClusterGroup& group = clusteredGroups[task];
+
+			if (!m->control_pressed) { clusterGroup(groups[task], newMFile, 1, group); }
+
+			lock_guard<mutex> guard(groupLock);
+			group.clustered = true;
+			numInFlight--;
+			groupDone.notify_all();
 		}
-		
-		return numSeqs;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "PreClusterCommand", "driverGroups");
+		m->errorOut(e, "PreClusterCommand", "clusterWorker");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//runs on the thread writing the outputs, the parsers are not shared with the workers
+void PreClusterCommand::loadGroup(string groupName, preClusterGroup& group) {
+	try {
+		map<string, string> thisNameMap;
+		vector<Sequence> thisSeqs;
+		if (groupfile != "") {
+			thisSeqs = parser->getSeqs(groupName);
+		}else if (countfile != "") {
+			thisSeqs = cparser->getSeqs(groupName);
+		}
+		if (namefile != "") {  thisNameMap = parser->getNameMap(groupName); }
+
+		//fill the group's seqs with this groups info.
+		loadSeqs(thisNameMap, thisSeqs, groupName, group);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PreClusterCommand", "loadGroup");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//the group's fasta and names are written to temp files, the messages are kept with the group and written to the log in group order
+void PreClusterCommand::clusterGroup(string groupName, string newMFile, int numThreads, preClusterGroup& group) {
+	try {
+		int start = time(NULL);
+
+		if (diffs > group.length) { group.messages += "Error: diffs is greater than your sequence length.\n"; m->control_pressed = true; return;  }
+
+		group.count = process(group, newMFile+groupName+".map", numThreads, false);
+
+		if (m->control_pressed) {  return; }
+
+		group.messages += "Total number of sequences before pre.cluster was " + toString(group.numSeqs) + ".\n";
+		group.messages += "pre.cluster removed " + toString(group.count) + " sequences.\n\n";
+
+		ofstream outFasta, outNames;
+		m->openOutputFile(newMFile + groupName + ".fasta.temp", outFasta);
+		m->openOutputFile(newMFile + groupName + ".names.temp", outNames);
+		printData(group, outFasta, outNames, groupName);
+		outFasta.close(); outNames.close();
+		vector<seqPNode>().swap(group.seqs);
+
+		group.messages += "It took " + toString(time(NULL) - start) + " secs to cluster " + toString(group.numSeqs) + " sequences.\n";
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PreClusterCommand", "clusterGroup");
 		exit(1);
 	}
 }
 /**************************************************************************************************/
-int PreClusterCommand::process(string newMapFile){
+int PreClusterCommand::process(preClusterGroup& group, string newMapFile, int numThreads, bool report){
 	try {
 		ofstream out;
 		m->openOutputFile(newMapFile, out);
-		
+
+		vector<seqPNode>& alignSeqs = group.seqs;
+
 		//sort seqs by number of identical seqs
         if (topdown) { sort(alignSeqs.begin(), alignSeqs.end(), comparePriorityTopDown);  }
         else {  sort(alignSeqs.begin(), alignSeqs.end(), comparePriorityDownTop);  }
-		
+
 		int count = 0;
 		int numSeqs = alignSeqs.size();
-		
-        if (topdown) {
-            //think about running through twice...
-            for (int i = 0; i < numSeqs; i++) {
-                
-                if (alignSeqs[i].active) {  //this sequence has not been merged yet
-                    
-                    string chunk = alignSeqs[i].seq.getName() + "\t" + toString(alignSeqs[i].numIdentical) + "\t" + toString(0) + "\t" + alignSeqs[i].seq.getAligned() + "\n";
-                    
-                    //try to merge it with all smaller seqs
-                    for (int j = i+1; j < numSeqs; j++) {
-                        
-                        if (m->control_pressed) { out.close(); return 0; }
-                        
-                        if (alignSeqs[j].active) {  //this sequence has not been merged yet
-                            //are you within "diff" bases
-                            int mismatch = calcMisMatches(alignSeqs[i].seq.getAligned(), alignSeqs[j].seq.getAligned());
-                            
-                            if (mismatch <= diffs) {
-                                //merge
-                                alignSeqs[i].names += ',' + alignSeqs[j].names;
-                                alignSeqs[i].numIdentical += alignSeqs[j].numIdentical;
-                                
-                                chunk += alignSeqs[j].seq.getName() + "\t" + toString(alignSeqs[j].numIdentical) + "\t" + toString(mismatch) + "\t" + alignSeqs[j].seq.getAligned() + "\n";
-                                
-                                alignSeqs[j].active = 0;
-                                alignSeqs[j].numIdentical = 0;
-                                count++;
-                            }
-                        }//end if j active
-                    }//end for loop j
-                    
-                    //remove from active list 
-                    alignSeqs[i].active = 0;
-                    
-                    out << "ideal_seq_" << (i+1) << '\t' << alignSeqs[i].numIdentical << endl << chunk << endl;;
-                    
-                }//end if active i
-                if(i % 100 == 0)	{ m->mothurOutJustToScreen(toString(i) + "\t" + toString(numSeqs - count) + "\t" + toString(count)+"\n"); 	}
-            }
-        }else {
-            map<int, string> mapFile;
-            map<int, int> originalCount;
-            map<int, int>::iterator itCount;
-            for (int i = 0; i < numSeqs; i++) { mapFile[i] = ""; originalCount[i] = alignSeqs[i].numIdentical; }
-            
-            //think about running through twice...
-            for (int i = 0; i < numSeqs; i++) {
-                
-                //try to merge it into larger seqs
-                for (int j = i+1; j < numSeqs; j++) {
-                    
-                    if (m->control_pressed) { out.close(); return 0; }
-                    
-                    if (originalCount[j] > originalCount[i]) {  //this sequence is more abundant than I am
-                        //are you within "diff" bases
-                        int mismatch = calcMisMatches(alignSeqs[i].seq.getAligned(), alignSeqs[j].seq.getAligned());
-                        
-                        if (mismatch <= diffs) {
-                            //merge
-                            alignSeqs[j].names += ',' + alignSeqs[i].names;
-                            alignSeqs[j].numIdentical += alignSeqs[i].numIdentical;
-                            
-                            mapFile[j] = alignSeqs[i].seq.getName() + "\t" + toString(alignSeqs[i].numIdentical) + "\t" + toString(mismatch) + "\t" + alignSeqs[i].seq.getAligned() + "\n" + mapFile[i];
-                            alignSeqs[i].numIdentical = 0;
-                            originalCount.erase(i);
-                            mapFile[i] = "";
-                            count++;
-                            j+=numSeqs; //exit search, we merged this one in.
-                        }
-                    }//end abundance check
-                }//end for loop j
-                
-                if(i % 100 == 0)	{ m->mothurOutJustToScreen(toString(i) + "\t" + toString(numSeqs - count) + "\t" + toString(count)+"\n"); 	}
-            }
-            
+
+		//pack the sequences and index them, so only the pairs that could be within diffs are compared
+		PackedMisMatch packed(group.length, diffs);
+		for (int i = 0; i < numSeqs; i++) { packed.addSeq(alignSeqs[i].seq.getAligned()); }
+		packed.buildIndex();
+
+		//a sequence is only merged into one that was more abundant before any merging
+		vector<int> originalCount(numSeqs, 0);
+		for (int i = 0; i < numSeqs; i++) { originalCount[i] = alignSeqs[i].numIdentical; }
+
+		//with one thread each row is compared just before it is merged, otherwise the threads compare a block of rows and the merges are made in row order
+		int blockSize = 1;
+		if (numThreads > 1) { blockSize = PRECLUSTER_BLOCK * 4 * numThreads; }
+		vector< vector< pair<int, int> > > merges(blockSize); //for each row of the block, the seqs it merges with and their mismatches
+
+		map<int, string> mapFile;
+		if (!topdown) { for (int i = 0; i < numSeqs; i++) { mapFile[i] = ""; } }
+
+		for (int blockStart = 0; blockStart < numSeqs; blockStart += blockSize) {
+			int blockEnd = min(numSeqs, blockStart + blockSize);
+			int numChunks = (blockEnd - blockStart + PRECLUSTER_BLOCK - 1) / PRECLUSTER_BLOCK;
+			int numWorkers = min(numThreads, numChunks);
+
+			WorkQueue queue(numWorkers);
+			for (int k = 0; k < numChunks; k++) { queue.push(k % numWorkers, k); }
+			queue.close();
+
+			vector<thread*> workers;
+			for (int i = 1; i < numWorkers; i++) { workers.push_back(new thread(&PreClusterCommand::findMerges, this, i, &queue, &packed, ref(alignSeqs), ref(originalCount), blockStart, blockEnd, ref(merges))); }
+			findMerges(0, &queue, &packed, alignSeqs, originalCount, blockStart, blockEnd, merges);
+			for (int i = 0; i < workers.size(); i++) { workers[i]->join(); delete workers[i]; }
+
+			if (m->control_pressed) { out.close(); return 0; }
+
+			for (int i = blockStart; i < blockEnd; i++) {
+				vector< pair<int, int> >& rowMerges = merges[i - blockStart];
+
+				if (topdown) {
+					if (alignSeqs[i].active) {  //this sequence has not been merged yet
+
+						string chunk = alignSeqs[i].seq.getName() + "\t" + toString(alignSeqs[i].numIdentical) + "\t" + toString(0) + "\t" + alignSeqs[i].seq.getAligned() + "\n";
+
+						//merge it with the smaller seqs within "diff" bases
+						for (int k = 0; k < rowMerges.size(); k++) {
+							int j = rowMerges[k].first;
+							int mismatch = rowMerges[k].second;
+
+							if (alignSeqs[j].active) {  //this sequence has not been merged yet
+								//merge
+								alignSeqs[i].names += ',' + alignSeqs[j].names;
+								alignSeqs[i].numIdentical += alignSeqs[j].numIdentical;
+
+								chunk += alignSeqs[j].seq.getName() + "\t" + toString(alignSeqs[j].numIdentical) + "\t" + toString(mismatch) + "\t" + alignSeqs[j].seq.getAligned() + "\n";
+
+								alignSeqs[j].active = 0;
+								alignSeqs[j].numIdentical = 0;
+								count++;
+							}//end if j active
+						}//end for loop merges
+
+						//remove from active list
+						alignSeqs[i].active = 0;
+
+						out << "ideal_seq_" << (i+1) << '\t' << alignSeqs[i].numIdentical << endl << chunk << endl;;
+
+					}//end if active i
+				}else if (rowMerges.size() != 0) {
+					//merge it into the first larger seq within "diff" bases
+					int j = rowMerges[0].first;
+					int mismatch = rowMerges[0].second;
+
+					alignSeqs[j].names += ',' + alignSeqs[i].names;
+					alignSeqs[j].numIdentical += alignSeqs[i].numIdentical;
+
+					mapFile[j] = alignSeqs[i].seq.getName() + "\t" + toString(alignSeqs[i].numIdentical) + "\t" + toString(mismatch) + "\t" + alignSeqs[i].seq.getAligned() + "\n" + mapFile[i];
+					alignSeqs[i].numIdentical = 0;
+					mapFile[i] = "";
+					count++;
+				}
+
+				if(report && (i % 100 == 0))	{ m->mothurOutJustToScreen(toString(i) + "\t" + toString(numSeqs - count) + "\t" + toString(count)+"\n"); 	}
+			}
+		}
+
+		if (!topdown) {
             for (int i = 0; i < numSeqs; i++) {
                 if (alignSeqs[i].numIdentical != 0) {
                     out << "ideal_seq_" << (i+1) << '\t' << alignSeqs[i].numIdentical << endl  << alignSeqs[i].seq.getName() + "\t" + toString(alignSeqs[i].numIdentical) + "\t" + toString(0) + "\t" + alignSeqs[i].seq.getAligned() + "\n" << mapFile[i] << endl;
                 }
             }
-            
         }
 		out.close();
-		
-		if(numSeqs % 100 != 0)	{ m->mothurOut(toString(numSeqs) + "\t" + toString(numSeqs - count) + "\t" + toString(count)); m->mothurOutEndLine();	}	
-		
+
+		if(numSeqs % 100 != 0)	{ group.messages += toString(numSeqs) + "\t" + toString(numSeqs - count) + "\t" + toString(count) + "\n";	}
+
 		return count;
-		
+
 	}
 	catch(exception& e) {
 		m->errorOut(e, "PreClusterCommand", "process");
@@ -704,7 +652,49 @@ int PreClusterCommand::process(string newMapFile){
 	}
 }
 /**************************************************************************************************/
-int PreClusterCommand::readFASTA(){
+//finds the seqs the rows of the block merge with, each task is PRECLUSTER_BLOCK rows.  Only process changes the seqs, after the threads are done,
+//so a row skips the seqs merged in earlier blocks and process skips the ones merged earlier in this block.
+void PreClusterCommand::findMerges(int worker, WorkQueue* queue, PackedMisMatch* packed, vector<seqPNode>& alignSeqs, vector<int>& originalCount, int blockStart, int blockEnd, vector< vector< pair<int, int> > >& merges){
+	try {
+		vector<int> candidates;
+		long long task;
+
+		while (queue->pop(worker, task)) {
+			int rowStart = blockStart + task * PRECLUSTER_BLOCK;
+			int rowEnd = min(blockEnd, rowStart + PRECLUSTER_BLOCK);
+
+			for (int i = rowStart; i < rowEnd; i++) {
+				vector< pair<int, int> >& rowMerges = merges[i - blockStart];
+				rowMerges.clear();
+
+				if (m->control_pressed) { break; }
+				if (topdown && !alignSeqs[i].active) { continue; }
+
+				packed->getCandidates(i, candidates);
+				for (int k = 0; k < candidates.size(); k++) {
+					int j = candidates[k];
+
+					if (topdown) { if (!alignSeqs[j].active) { continue; } }
+					else if (originalCount[j] <= originalCount[i]) { continue; }  //a merge needs a sequence more abundant than I am
+
+					//are you within "diff" bases
+					int mismatch = packed->calcMisMatches(i, j);
+
+					if (mismatch <= diffs) {
+						rowMerges.push_back(make_pair(j, mismatch));
+						if (!topdown) { break; } //exit search, it merges into the first one
+					}
+				}
+			}
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PreClusterCommand", "findMerges");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+int PreClusterCommand::readFASTA(preClusterGroup& group){
 	try {
 		//ifstream inNames;
 		ifstream inFasta;
@@ -725,14 +715,14 @@ int PreClusterCommand::readFASTA(){
 					if (itSize == sizes.end()) { m->mothurOut(seq.getName() + " is not in your names file, please correct."); m->mothurOutEndLine(); exit(1); }
 					else{
 						seqPNode tempNode(itSize->second, seq, names[seq.getName()]);
-						alignSeqs.push_back(tempNode);
+						group.seqs.push_back(tempNode);
 						lengths.insert(seq.getAligned().length());
 					}	
 				}else { //no names file, you are identical to yourself 
                     int numRep = 1;
                     if (countfile != "") { numRep = ct.getNumSeqs(seq.getName()); }
 					seqPNode tempNode(numRep, seq, seq.getName());
-					alignSeqs.push_back(tempNode);
+					group.seqs.push_back(tempNode);
 					lengths.insert(seq.getAligned().length());
 				}
 			}
@@ -740,9 +730,10 @@ int PreClusterCommand::readFASTA(){
 		inFasta.close();
         
         if (lengths.size() > 1) { m->control_pressed = true; m->mothurOut("[ERROR]: your sequences are not all the same length. pre.cluster requires sequences to be aligned."); m->mothurOutEndLine(); }
-        else if (lengths.size() == 1) { length = *(lengths.begin()); }
+        else if (lengths.size() == 1) { group.length = *(lengths.begin()); }
         
-		return alignSeqs.size();
+		group.numSeqs = group.seqs.size();
+		return group.numSeqs;
 	}
 	
 	catch(exception& e) {
@@ -751,14 +742,14 @@ int PreClusterCommand::readFASTA(){
 	}
 }
 /**************************************************************************************************/
-int PreClusterCommand::loadSeqs(map<string, string>& thisName, vector<Sequence>& thisSeqs, string group){
+int PreClusterCommand::loadSeqs(map<string, string>& thisName, vector<Sequence>& thisSeqs, string groupName, preClusterGroup& group){
 	try {
 		set<int> lengths;
-		alignSeqs.clear();
+		group.seqs.clear();
 		map<string, string>::iterator it;
 		bool error = false;
         map<string, int> thisCount;
-        if (countfile != "") { thisCount = cparser->getCountTable(group);  }
+        if (countfile != "") { thisCount = cparser->getCountTable(groupName);  }
         	
 		for (int i = 0; i < thisSeqs.size(); i++) {
 			
@@ -777,7 +768,7 @@ int PreClusterCommand::loadSeqs(map<string, string>& thisName, vector<Sequence>&
 					}
 					
 					seqPNode tempNode(numReps, thisSeqs[i], it->second);
-					alignSeqs.push_back(tempNode);
+					group.seqs.push_back(tempNode);
                     lengths.insert(thisSeqs[i].getAligned().length());
 				}	
 			}else { //no names file, you are identical to yourself 
@@ -790,20 +781,21 @@ int PreClusterCommand::loadSeqs(map<string, string>& thisName, vector<Sequence>&
                     else { numRep = it2->second;  }
                 }
 				seqPNode tempNode(numRep, thisSeqs[i], thisSeqs[i].getName());
-				alignSeqs.push_back(tempNode);
+				group.seqs.push_back(tempNode);
 				lengths.insert(thisSeqs[i].getAligned().length());
 			}
 		}
     
         if (lengths.size() > 1) { error = true; m->mothurOut("[ERROR]: your sequences are not all the same length. pre.cluster requires sequences to be aligned."); m->mothurOutEndLine(); }
-        else if (lengths.size() == 1) { length = *(lengths.begin()); }
+        else if (lengths.size() == 1) { group.length = *(lengths.begin()); }
         
 		//sanity check
 		if (error) { m->control_pressed = true; }
 		
 		thisSeqs.clear();
 		
-		return alignSeqs.size();
+		group.numSeqs = group.seqs.size();
+		return group.numSeqs;
 	}
 	
 	catch(exception& e) {
@@ -814,25 +806,6 @@ int PreClusterCommand::loadSeqs(map<string, string>& thisName, vector<Sequence>&
 				
 /**************************************************************************************************/
 
-int PreClusterCommand::calcMisMatches(string seq1, string seq2){
-	try {
-		int numBad = 0;
-		
-		for (int i = 0; i < seq1.length(); i++) {
-			//do they match
-			if (seq1[i] != seq2[i]) { numBad++; }
-			if (numBad > diffs) { return length;  } //to far to cluster
-		}
-		
-		return numBad;
-	}
-	catch(exception& e) {
-		m->errorOut(e, "PreClusterCommand", "calcMisMatches");
-		exit(1);
-	}
-}
-/**************************************************************************************************/
-
 int PreClusterCommand::mergeGroupCounts(string newcount, string newname, string newfasta){
 	try {
 		ifstream inNames;
@@ -908,33 +881,20 @@ int PreClusterCommand::mergeGroupCounts(string newcount, string newname, string
 
 /**************************************************************************************************/
 
-void PreClusterCommand::printData(string newfasta, string newname, string group){
+void PreClusterCommand::printData(preClusterGroup& group, ostream& outFasta, ostream& outNames, string groupName){
 	try {
-		ofstream outFasta;
-		ofstream outNames;
+		vector<seqPNode>& alignSeqs = group.seqs;
 		
-		if (bygroup) {
-			m->openOutputFileAppend(newfasta, outFasta);
-			m->openOutputFileAppend(newname, outNames);
-		}else {
-			m->openOutputFile(newfasta, outFasta);
-			m->openOutputFile(newname, outNames);
-		}
-		
-        if ((countfile != "") && (group == ""))  { outNames << "Representative_Sequence\ttotal\n";  }
+        if ((countfile != "") && (groupName == ""))  { outNames << "Representative_Sequence\ttotal\n";  }
 		for (int i = 0; i < alignSeqs.size(); i++) {
 			if (alignSeqs[i].numIdentical != 0) {
 				alignSeqs[i].seq.printSequence(outFasta); 
 				if (countfile != "") {  
-                    if (group != "") {  outNames << group << '\t' << alignSeqs[i].seq.getName() << '\t' << alignSeqs[i].names << endl; }
+                    if (groupName != "") {  outNames << groupName << '\t' << alignSeqs[i].seq.getName() << '\t' << alignSeqs[i].names << endl; }
                     else {  outNames << alignSeqs[i].seq.getName() << '\t' << alignSeqs[i].numIdentical << endl;  }
                 }else {  outNames << alignSeqs[i].seq.getName() << '\t' << alignSeqs[i].names << endl;  }
 			}
 		}
-		
-		outFasta.close();
-		outNames.close();
-		
 	}
 	catch(exception& e) {
 		m->errorOut(e, "PreClusterCommand", "printData");
@@ -729,7 +729,7 @@ vector< vector< vector<unsigned int> > > PrimerDesignCommand::driverGetCounts(ma
         ifstream in;
 		m->openInputFile(fastafile, in);
         
-		in.seekg(start);
+		if (start != 0) { in.seekg(start); }
         
 		bool done = false;
 		fastaCount = 0;
@@ -785,8 +785,7 @@ vector< vector< vector<unsigned int> > > PrimerDesignCommand::driverGetCounts(ma
             }
 
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-            unsigned long long pos = in.tellg();
-            if ((pos == -1) || (pos >= end)) { break; }
+            if (m->endOfPart(in, end)) { break; }
 #else
             if (in.eof()) { break; }
 #endif
@@ -9,6 +9,7 @@
 
 #include "readcolumn.h"
 #include "progress.hpp"
+#include "binarydist.h"
 
 /***********************************************************************/
 
@@ -36,6 +37,21 @@ int ReadColumnMatrix::read(NameAssignment* nameMap){
 		int nseqs = nameMap->size();
         DMatrix->resize(nseqs);
 		list = new ListVector(nameMap->getListVector());
+        
+        if (BinaryDistReader::isBinary(distFile)) {
+            BinaryDistReader reader(distFile);
+            if (!reader.good()) { m->control_pressed = true; fileHandle.close(); return 0; }
+            
+            vector<string> names = reader.getNames();
+            vector<int> indexes(names.size());
+            for (int i = 0; i < names.size(); i++) {
+                map<string,int>::iterator it = nameMap->find(names[i]);
+                if(it == nameMap->end()){  m->mothurOut("AAError: Sequence '" + names[i] + "' was not found in the names file, please correct\n"); exit(1);  }
+                indexes[i] = it->second;
+            }
+            
+            return readBinary(reader, indexes);
+        }
 	
 		Progress* reading = new Progress("Reading matrix:     ", nseqs * nseqs);
 
@@ -162,6 +178,20 @@ int ReadColumnMatrix::read(CountTable* countTable){
         DMatrix->resize(nseqs);
 		list = new ListVector(countTable->getListVector());
         
+        if (BinaryDistReader::isBinary(distFile)) {
+            BinaryDistReader reader(distFile);
+            if (!reader.good()) { m->control_pressed = true; fileHandle.close(); return 0; }
+            
+            vector<string> names = reader.getNames();
+            vector<int> indexes(names.size());
+            for (int i = 0; i < names.size(); i++) {
+                indexes[i] = countTable->get(names[i]);
+                if (m->control_pressed) { exit(1); }
+            }
+            
+            return readBinary(reader, indexes);
+        }
+        
 		Progress* reading = new Progress("Reading matrix:     ", nseqs * nseqs);
         
 		int lt = 1;
@@ -273,6 +303,25 @@ int ReadColumnMatrix::read(CountTable* countTable){
 	}
 }
 
+/***********************************************************************/
+//.dist.bin files from dist.seqs output=binary, indexes gives the matrix index of each sequence in the file
+int ReadColumnMatrix::readBinary(BinaryDistReader& reader, vector<int>& indexes){
+	try {
+        m->mothurOut("Reading binary matrix with " + toString(reader.getNumDists()) + " distances."); m->mothurOutEndLine();
+        
+        fileHandle.close();
+        
+        if (!reader.fillMatrix(DMatrix, indexes, cutoff, sim)) { return 0; }
+        
+        list->setLabel("0");
+        
+		return 1;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ReadColumnMatrix", "readBinary");
+		exit(1);
+	}
+}
 /***********************************************************************/
 ReadColumnMatrix::~ReadColumnMatrix(){}
 /***********************************************************************/
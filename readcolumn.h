@@ -11,6 +11,8 @@
 
 #include "readmatrix.hpp"
 
+class BinaryDistReader;
+
 /******************************************************/
 
 class ReadColumnMatrix : public ReadMatrix {
@@ -25,6 +27,7 @@ private:
 	ifstream fileHandle;
 	string distFile;
 	
+	int readBinary(BinaryDistReader&, vector<int>&);
 };
 
 /******************************************************/
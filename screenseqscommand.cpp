@@ -1367,7 +1367,7 @@ int ScreenSeqsCommand::driverContigsSummary(vector<int>& oLength, vector<int>& o
   		ifstream in;
 		m->openInputFile(contigsreport, in);
         
-		in.seekg(filePos.start);
+		if (filePos.start != 0) { in.seekg(filePos.start); }
         if (filePos.start == 0) { //read headers
             m->getline(in); m->gobble(in);
         }
@@ -1404,8 +1404,7 @@ int ScreenSeqsCommand::driverContigsSummary(vector<int>& oLength, vector<int>& o
 			
 			//if((count) % 100 == 0){	m->mothurOut("Optimizing sequence: " + toString(count)); m->mothurOutEndLine();		}
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-            unsigned long long pos = in.tellg();
-            if ((pos == -1) || (pos >= filePos.end)) { break; }
+            if (m->endOfPart(in, filePos.end)) { break; }
 #else
             if (in.eof()) { break; }
 #endif
@@ -1640,7 +1639,7 @@ int ScreenSeqsCommand::driverAlignSummary(vector<float>& sims, vector<float>& sc
   		ifstream in;
 		m->openInputFile(alignreport, in);
         
-		in.seekg(filePos.start);
+		if (filePos.start != 0) { in.seekg(filePos.start); }
         if (filePos.start == 0) { //read headers
             m->getline(in); m->gobble(in);
         }
@@ -1674,8 +1673,7 @@ int ScreenSeqsCommand::driverAlignSummary(vector<float>& sims, vector<float>& sc
 			
 			//if((count) % 100 == 0){	m->mothurOut("Optimizing sequence: " + toString(count)); m->mothurOutEndLine();		}
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-            unsigned long long pos = in.tellg();
-            if ((pos == -1) || (pos >= filePos.end)) { break; }
+            if (m->endOfPart(in, filePos.end)) { break; }
 #else
             if (in.eof()) { break; }
 #endif
@@ -1921,7 +1919,7 @@ int ScreenSeqsCommand::driverCreateSummary(vector<int>& startPosition, vector<in
 		ifstream in;
 		m->openInputFile(filename, in);
 				
-		in.seekg(filePos.start);
+		if (filePos.start != 0) { in.seekg(filePos.start); }
 
 		bool done = false;
 		int count = 0;
@@ -1957,8 +1955,7 @@ int ScreenSeqsCommand::driverCreateSummary(vector<int>& startPosition, vector<in
 			}
 			//if((count) % 100 == 0){	m->mothurOut("Optimizing sequence: " + toString(count)); m->mothurOutEndLine();		}
 			#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				unsigned long long pos = in.tellg();
-				if ((pos == -1) || (pos >= filePos.end)) { break; }
+				if (m->endOfPart(in, filePos.end)) { break; }
 			#else
 				if (in.eof()) { break; }
 			#endif
@@ -2360,7 +2357,7 @@ int ScreenSeqsCommand::driver(linePair filePos, string goodFName, string badAccn
 		ifstream inFASTA;
 		m->openInputFile(filename, inFASTA);
 
-		inFASTA.seekg(filePos.start);
+		if (filePos.start != 0) { inFASTA.seekg(filePos.start); }
 
 		bool done = false;
 		int count = 0;
@@ -2400,8 +2397,7 @@ int ScreenSeqsCommand::driver(linePair filePos, string goodFName, string badAccn
 			}
 			
 			#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				unsigned long long pos = inFASTA.tellg();
-				if ((pos == -1) || (pos >= filePos.end)) { break; }
+				if (m->endOfPart(inFASTA, filePos.end)) { break; }
 			#else
 				if (inFASTA.eof()) { break; }
 			#endif
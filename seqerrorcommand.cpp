@@ -717,13 +717,13 @@ int SeqErrorCommand::driver(string filename, string qFileName, string rFileName,
 		ifstream queryFile;
 		m->openInputFile(filename, queryFile);
         
-		queryFile.seekg(line.start);
+		if (line.start != 0) { queryFile.seekg(line.start); }
 		
 		ifstream reportFile;
 		ifstream qualFile;
 		if((qFileName != "" && rFileName != "" && aligned)){
 			m->openInputFile(qFileName, qualFile);
-			qualFile.seekg(qline.start);  
+			if (qline.start != 0) { qualFile.seekg(qline.start); }
 			
 			//gobble headers
 			if (rline.start == 0) {  report = ReportFile(reportFile, rFileName); } 
@@ -742,7 +742,7 @@ int SeqErrorCommand::driver(string filename, string qFileName, string rFileName,
 		else if(qFileName != "" && !aligned){
 
             m->openInputFile(qFileName, qualFile);
-			qualFile.seekg(qline.start);  
+			if (qline.start != 0) { qualFile.seekg(qline.start); }
 			
 			qualForwardMap.resize(maxLength);
 			qualReverseMap.resize(maxLength);
@@ -868,8 +868,7 @@ int SeqErrorCommand::driver(string filename, string qFileName, string rFileName,
 			index++;
 			
 			#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				unsigned long long pos = queryFile.tellg();
-				if ((pos == -1) || (pos >= line.end)) { break; }
+				if (m->endOfPart(queryFile, line.end)) { break; }
 			#else
 				if (queryFile.eof()) { break; }
 			#endif
@@ -1369,6 +1368,9 @@ void SeqErrorCommand::printQualityFR(vector<vector<int> > qualForwardMap, vector
 int SeqErrorCommand::setLines(string filename, string qfilename, string rfilename, vector<unsigned long long>& fastaFilePos, vector<unsigned long long>& qfileFilePos, vector<unsigned long long>& rfileFilePos) {
 	try {
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+		//a compressed quality or report file can't be divided, so neither is the fasta file and they are read from their start
+		if (((qfilename != "") && m->isCompressed(qfilename)) || ((rfilename != "") && m->isCompressed(rfilename))) { processors = 1; }
+		
 		//set file positions for fasta file
 		fastaFilePos = m->divideFile(filename, processors);
 		
@@ -1379,7 +1381,7 @@ int SeqErrorCommand::setLines(string filename, string qfilename, string rfilenam
 		for (int i = 0; i < (fastaFilePos.size()-1); i++) {
 			ifstream in;
 			m->openInputFile(filename, in);
-			in.seekg(fastaFilePos[i]);
+			if (fastaFilePos[i] != 0) { in.seekg(fastaFilePos[i]); }
 			
 			Sequence temp(in); 
 			firstSeqNames[temp.getName()] = i;
@@ -1411,7 +1413,8 @@ int SeqErrorCommand::setLines(string filename, string qfilename, string rfilenam
 					
 					if(it != firstSeqNames.end()) { //this is the start of a new chunk
 						unsigned long long pos = inQual.tellg(); 
-						qfileFilePos.push_back(pos - input.length() - 1);	
+						if (pos == -1)	{ qfileFilePos.push_back(0);							}
+						else			{ qfileFilePos.push_back(pos - input.length() - 1);	}
 						firstSeqNames.erase(it);
 					}
 				}
@@ -1472,7 +1475,8 @@ int SeqErrorCommand::setLines(string filename, string qfilename, string rfilenam
                 
                     if(it != firstSeqNamesReport.end()) { //this is the start of a new chunk
                         unsigned long long pos = inR.tellg(); 
-                        rfileFilePos.push_back(pos - input.length() - 1);	
+                        if (pos == -1)	{ rfileFilePos.push_back(0);							}
+                        else			{ rfileFilePos.push_back(pos - input.length() - 1);	}
                         firstSeqNamesReport.erase(it);
                     }
                 }
@@ -275,9 +275,9 @@ int seqNoise::getListData(string listFileName, double cutOff, vector<int>& otuDa
 }
 
 /**************************************************************************************************/
-int seqNoise::updateOTUCountData(vector<int> otuFreq,
-								 vector<vector<int> > otuBySeqLookUp,
-								 vector<vector<int> > aanI,
+int seqNoise::updateOTUCountData(vector<int>& otuFreq,
+								 vector<vector<int> >& otuBySeqLookUp,
+								 vector<vector<int> >& aanI,
 								 vector<int>& anP,
 								 vector<int>& anI,
 								 vector<int>& cumCount
@@ -310,12 +310,12 @@ int seqNoise::updateOTUCountData(vector<int> otuFreq,
 /**************************************************************************************************/
 double seqNoise::calcNewWeights(
 					  vector<double>& weights,	//
-					  vector<int> seqFreq,		//
-					  vector<int> anI,			//
-					  vector<int> cumCount,		//
-					  vector<int> anP,			//
-					  vector<int> otuFreq,		//
-					  vector<double> tau		//
+					  vector<int>& seqFreq,		//
+					  vector<int>& anI,			//
+					  vector<int>& cumCount,		//
+					  vector<int>& anP,			//
+					  vector<int>& otuFreq,		//
+					  vector<double>& tau		//
 					  ){
 	try {
 		
@@ -359,15 +359,15 @@ double seqNoise::calcNewWeights(
 /**************************************************************************************************/
 
 int seqNoise::calcCentroids(
-				   vector<int> anI,
-				   vector<int> anP,
+				   vector<int>& anI,
+				   vector<int>& anP,
 				   vector<int>& change, 
 				   vector<int>& centroids, 
-				   vector<int> cumCount,
-				   vector<double> distances,///
-				   vector<int> seqFreq, 
-				   vector<int> otuFreq, 
-				   vector<double> tau 
+				   vector<int>& cumCount,
+				   vector<double>& distances,///
+				   vector<int>& seqFreq, 
+				   vector<int>& otuFreq, 
+				   vector<double>& tau 
 				   ){
 	try {
 		int numOTUs = change.size();
@@ -439,7 +439,7 @@ int seqNoise::calcCentroids(
 
 /**************************************************************************************************/
 
-int seqNoise::checkCentroids(vector<double>& weights, vector<int> centroids){
+int seqNoise::checkCentroids(vector<double>& weights, vector<int>& centroids){
 	try {
 		int numOTUs = centroids.size();
 		vector<int> unique(numOTUs, 1);
@@ -473,6 +473,114 @@ int seqNoise::checkCentroids(vector<double>& weights, vector<int> centroids){
 	}
 }
 
+/**************************************************************************************************/
+//finds the taus of the sequences for the otus with a weight above MIN_WEIGHT, and returns the number of sequence otu pairs
+//updated.  With sparse each sequence only looks at the otus it was close to last time and the otus whose centroids moved,
+//unless it is a full pass.
+long long seqNoise::calcNewTaus(double sigma, vector<double>& weights, vector<int>& change, vector<int>& centroids, vector<double>& distances,
+								vector<double>& tau, vector<vector<int> >& otuBySeqLookUp, vector<vector<int> >& aanI, vector<int>& otuFreq,
+								vector<int>& anP, vector<int>& anI, vector<vector<int> >& seqOTUs, bool sparse, bool fullPass){
+	try {
+		int numOTUs = weights.size();
+		int numSeqs = seqOTUs.size();
+		
+		vector<int> activeOTUs;
+		vector<int> changedOTUs;
+		for(int j=0;j<numOTUs;j++){
+			if(weights[j] > MIN_WEIGHT){
+				activeOTUs.push_back(j);
+				if(change[j] == 1){	changedOTUs.push_back(j);	}
+			}
+		}
+		
+		otuFreq.assign(numOTUs, 0);
+		
+		int total = 0;
+		long long numPairs = 0;
+		vector<double> currentTau(numOTUs);
+		vector<int> closeOTUs;
+		
+		for(int i=0;i<numSeqs;i++){
+			if (m->control_pressed) { return 0; }
+			
+			vector<int>* otus = &activeOTUs;
+			if (sparse && !fullPass) {
+				if (getCloseOTUs(seqOTUs[i], weights, changedOTUs, closeOTUs) != 0) { otus = &closeOTUs; }
+			}
+			int numLooked = otus->size();
+			numPairs += numLooked;
+			
+			double offset = 1e6;
+			double norm = 0.0000;
+			
+			for(int k=0;k<numLooked;k++){
+				int j = (*otus)[k];
+				if(distances[i * numSeqs+centroids[j]] < offset){
+					offset = distances[i * numSeqs+centroids[j]];
+				}
+			}
+			
+			for(int k=0;k<numLooked;k++){
+				int j = (*otus)[k];
+				currentTau[j] = exp(sigma * (-distances[(i * numSeqs + centroids[j])] + offset)) * weights[j];
+				norm += currentTau[j];
+			}
+			
+			for(int k=0;k<numLooked;k++){
+				currentTau[(*otus)[k]] /= norm;
+			}
+			
+			if (sparse) { seqOTUs[i].clear(); }
+			for(int k=0;k<numLooked;k++){
+				int j = (*otus)[k];
+				
+				if(currentTau[j] > MIN_TAU){
+					int oldTotal = total;
+					total++;
+					
+					tau.resize(oldTotal+1);
+					tau[oldTotal] = currentTau[j];
+					otuBySeqLookUp[j][otuFreq[j]] = oldTotal;
+					aanI[j][otuFreq[j]] = i;
+					otuFreq[j]++;
+				}
+				if(sparse && (currentTau[j] > SPARSE_TAU)){	seqOTUs[i].push_back(j);	}
+			}
+			
+			anP.resize(total);
+			anI.resize(total);
+		}
+		
+		return numPairs;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "seqNoise", "calcNewTaus");
+		exit(1);
+	}
+}
+
+/**************************************************************************************************/
+//with sparse, the otus a sequence is updated against: the still active otus it was close to and the changed ones, kept
+//in order so the taus are summed in the same order as a full pass.  If there are none every active otu is used.
+int seqNoise::getCloseOTUs(vector<int>& seqOTUs, vector<double>& weights, vector<int>& changedOTUs, vector<int>& closeOTUs){
+	try {
+		closeOTUs.clear();
+		for(int k=0;k<seqOTUs.size();k++){
+			if(weights[seqOTUs[k]] > MIN_WEIGHT){	closeOTUs.push_back(seqOTUs[k]);	}
+		}
+		int numClose = closeOTUs.size();
+		closeOTUs.insert(closeOTUs.end(), changedOTUs.begin(), changedOTUs.end());
+		inplace_merge(closeOTUs.begin(), closeOTUs.begin() + numClose, closeOTUs.end());
+		closeOTUs.erase(unique(closeOTUs.begin(), closeOTUs.end()), closeOTUs.end());
+		
+		return closeOTUs.size();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "seqNoise", "getCloseOTUs");
+		exit(1);
+	}
+}
+
 /**************************************************************************************************/
 
 int seqNoise::setUpOTUData(vector<int>& otuData, vector<double>& percentage, vector<int> cumCount, vector<double> tau, vector<int> otuFreq, vector<int> anP, vector<int> anI){
@@ -20,6 +20,9 @@
 
 
 #include "mothurout.h"
+
+#define SPARSE_TAU 1e-10		//with sparse, a sequence keeps the otus whose tau is above this
+#define SPARSE_REFRESH 10		//with sparse, every otu is updated for every sequence this often
 /**************************************************************************************************/
 
 struct freqData {
@@ -47,10 +50,12 @@ public:
 	int addRedundantName(string, string, vector<string>&, vector<string>&, vector<int>&);
     int getDistanceData(string, vector<double>&);
 	int getListData(string, double, vector<int>&, vector<int>&, vector<vector<int> >&);
-	int updateOTUCountData(vector<int>, vector<vector<int> >, vector<vector<int> >, vector<int>&, vector<int>&, vector<int>&);
-	double calcNewWeights(vector<double>&,vector<int>,vector<int>,vector<int>,vector<int>,vector<int>,vector<double>);
-	int calcCentroids(vector<int>,vector<int>,vector<int>&,vector<int>&,vector<int>,vector<double>,vector<int>,vector<int>,vector<double>);
-	int checkCentroids(vector<double>&, vector<int>);
+	int updateOTUCountData(vector<int>&, vector<vector<int> >&, vector<vector<int> >&, vector<int>&, vector<int>&, vector<int>&);
+	double calcNewWeights(vector<double>&,vector<int>&,vector<int>&,vector<int>&,vector<int>&,vector<int>&,vector<double>&);
+	int calcCentroids(vector<int>&,vector<int>&,vector<int>&,vector<int>&,vector<int>&,vector<double>&,vector<int>&,vector<int>&,vector<double>&);
+	int checkCentroids(vector<double>&, vector<int>&);
+	long long calcNewTaus(double, vector<double>&, vector<int>&, vector<int>&, vector<double>&, vector<double>&, vector<vector<int> >&, vector<vector<int> >&, vector<int>&, vector<int>&, vector<int>&, vector<vector<int> >&, bool, bool);
+	int getCloseOTUs(vector<int>&, vector<double>&, vector<int>&, vector<int>&);
 	int setUpOTUData(vector<int>&, vector<double>&, vector<int>, vector<double>, vector<int>, vector<int>, vector<int>);
 	int finishOTUData(vector<int>, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<vector<int> >&, vector<vector<int> >&, vector<double>&);
 	int writeOutput(string, string, string, vector<int>, vector<int>, vector<int>, vector<string>, vector<string>, vector<string>, vector<int>, vector<double>&);
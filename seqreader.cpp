@@ -0,0 +1,332 @@
+//
+//  seqreader.cpp
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+#include "seqreader.h"
+
+const int SeqReader::BATCH_SIZE;
+const int SeqReader::MAX_BATCHES;
+const unsigned long long SeqReader::BLOCK_SIZE;
+
+/**************************************************************************************************/
+SeqReader::SeqReader(string f, string form) {
+	try {
+		m = MothurOut::getInstance();
+		filename = f; format = form;
+		start = 0; end = numeric_limits<unsigned long long>::max();
+		startReading();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SeqReader", "SeqReader");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+SeqReader::SeqReader(string f, string form, unsigned long long st, unsigned long long en) {
+	try {
+		m = MothurOut::getInstance();
+		filename = f; format = form;
+		start = st; end = en;
+		startReading();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SeqReader", "SeqReader");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+SeqReader::~SeqReader() {
+	try {
+		{
+			lock_guard<mutex> guard(queueLock);
+			stopped = true;
+		}
+		notFull.notify_all();
+		producer->join(); delete producer;
+
+		for (int i = 0; i < batches.size(); i++) { delete batches[i]; }
+		if (current != NULL) { delete current; }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SeqReader", "~SeqReader");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void SeqReader::startReading() {
+	try {
+		finished = false; stopped = false;
+		current = NULL; currentIndex = 0;
+		producer = new thread(&SeqReader::readFile, this);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SeqReader", "startReading");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+bool SeqReader::getBatch(vector<seqRecord>& records) {
+	try {
+		vector<seqRecord>* batch = NULL;
+		{
+			unique_lock<mutex> guard(queueLock);
+			while (batches.empty() && !finished) { notEmpty.wait(guard); }
+			if (batches.empty()) { records.clear(); return false; }
+			batch = batches.front(); batches.pop_front();
+		}
+		notFull.notify_one();
+
+		records.swap(*batch);
+		delete batch;
+
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SeqReader", "getBatch");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+bool SeqReader::getNext(seqRecord& record) {
+	try {
+		if (current == NULL) { current = new vector<seqRecord>; }
+
+		while (currentIndex >= current->size()) {
+			if (!getBatch(*current)) { return false; }
+			currentIndex = 0;
+		}
+
+		record = (*current)[currentIndex];
+		currentIndex++;
+
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SeqReader", "getNext");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//runs on the producer thread, reads the file a block at a time and queues the records in batches
+void SeqReader::readFile() {
+	try {
+		ifstream in;
+		m->openInputFileBinary(filename, in);
+
+		//a compressed file is read through a pipe, which can't seek, but is only ever read from the start
+		unsigned long long bufferStart = start;		//the file position of buffer[0]
+		if (start != 0) { in.seekg(start); }
+		else {
+			long long position = in.tellg();		//openInputFileBinary skipped the blank lines at the start
+			if (position != -1) { bufferStart = position; }
+		}
+
+		string buffer;
+		unsigned long long parsed = 0;				//the records before this position in buffer are done
+		bool endOfFile = false;
+
+		vector<seqRecord>* batch = new vector<seqRecord>;
+		batch->reserve(BATCH_SIZE);
+
+		while (!m->control_pressed) {
+			unsigned long long recordStart, recordEnd;
+			if (!findRecord(buffer, parsed, endOfFile, recordStart, recordEnd)) {
+				if (endOfFile) { break; }
+
+				//keep the partial record and read the next block after it
+				buffer.erase(0, parsed); bufferStart += parsed; parsed = 0;
+				unsigned long long size = buffer.size();
+				buffer.resize(size + BLOCK_SIZE);
+				in.read(&buffer[size], BLOCK_SIZE);
+				unsigned long long numRead = in.gcount();
+				buffer.resize(size + numRead);
+				if (numRead < BLOCK_SIZE) { endOfFile = true; }
+				continue;
+			}
+
+			if ((bufferStart + recordStart) >= end) { break; }
+
+			batch->push_back(seqRecord());
+			parseRecord(buffer.data() + recordStart, recordEnd - recordStart, batch->back());
+			parsed = recordEnd;
+
+			if (batch->size() == BATCH_SIZE) {
+				if (!addBatch(batch)) { batch = NULL; break; }
+				batch = new vector<seqRecord>;
+				batch->reserve(BATCH_SIZE);
+			}
+		}
+		in.close();
+
+		if (batch != NULL) {
+			if (batch->size() != 0) { addBatch(batch); }
+			else { delete batch; }
+		}
+
+		{
+			lock_guard<mutex> guard(queueLock);
+			finished = true;
+		}
+		notEmpty.notify_all();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SeqReader", "readFile");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//waits for room in the queue, false if the reader is being destroyed
+bool SeqReader::addBatch(vector<seqRecord>* batch) {
+	try {
+		{
+			unique_lock<mutex> guard(queueLock);
+			while ((batches.size() >= MAX_BATCHES) && !stopped) { notFull.wait(guard); }
+			if (stopped) { delete batch; return false; }
+			batches.push_back(batch);
+		}
+		notEmpty.notify_one();
+
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SeqReader", "addBatch");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//finds the next record in buffer after position from, false if more of the file is needed to find its end
+bool SeqReader::findRecord(const string& buffer, unsigned long long from, bool endOfFile, unsigned long long& recordStart, unsigned long long& recordEnd) {
+	try {
+		unsigned long long size = buffer.size();
+		unsigned long long pos = from;
+		while ((pos < size) && isspace(buffer[pos])) { pos++; }
+		if (pos == size) { return false; }
+		recordStart = pos;
+
+		if (format == "fastq") {
+			//four lines, blank lines between them are skipped like gobble does
+			for (int line = 0; line < 4; line++) {
+				while ((pos < size) && isspace(buffer[pos])) { pos++; }
+				pos = buffer.find_first_of("\r\n", pos);
+				if (pos == string::npos) {
+					if (!endOfFile) { return false; }
+					pos = size; break;
+				}
+			}
+			recordEnd = pos;
+		}else {
+			//the name line can contain '>', the record ends at the next '>' after it
+			pos = buffer.find_first_of("\r\n", pos);
+			if (pos != string::npos) { pos = buffer.find('>', pos); }
+			if (pos == string::npos) {
+				if (!endOfFile) { return false; }
+				pos = size;
+			}
+			recordEnd = pos;
+		}
+
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SeqReader", "findRecord");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void SeqReader::parseRecord(const char* record, int length, seqRecord& parsed) {
+	try {
+		if (format == "fastq")		{	parseFastq(record, length, parsed);				}
+		else if (format == "qual")	{	parseQual(record, length, parsed);				}
+		else						{	parsed.seq = Sequence(record, length);		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SeqReader", "parseRecord");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//checks the record like ParseFastaQCommand::readFastq, a read with problems gets a blank name
+void SeqReader::parseFastq(const char* record, int length, seqRecord& parsed) {
+	try {
+		vector<string> lines;
+		int pos = 0;
+		while ((pos < length) && (lines.size() < 4)) {
+			while ((pos < length) && isspace(record[pos])) { pos++; }
+			int lineStart = pos;
+			while ((pos < length) && (record[pos] != '\r') && (record[pos] != '\n')) { pos++; }
+			lines.push_back(string(record + lineStart, pos - lineStart));
+		}
+		lines.resize(4, "");
+
+		bool ignore = false;
+		vector<string> pieces = m->splitWhiteSpace(lines[0]);
+		string name = "";  if (pieces.size() != 0) { name = pieces[0]; }
+		if (name == "") {  m->mothurOut("[WARNING]: Blank fasta name, ignoring read."); m->mothurOutEndLine(); ignore=true;  }
+		else if (name[0] != '@') { m->mothurOut("[WARNING]: reading " + name + " expected a name with @ as a leading character, ignoring read."); m->mothurOutEndLine(); ignore=true; }
+		else { name = name.substr(1); }
+
+		if (lines[1] == "") {  m->mothurOut("[WARNING]: missing sequence for " + name + ", ignoring."); ignore=true; }
+
+		pieces = m->splitWhiteSpace(lines[2]);
+		string name2 = "";  if (pieces.size() != 0) { name2 = pieces[0]; }
+		if (name2 == "") {  m->mothurOut("[WARNING]: expected a name with + as a leading character, ignoring."); ignore=true; }
+		else if (name2[0] != '+') { m->mothurOut("[WARNING]: reading " + name2 + " expected a name with + as a leading character, ignoring."); ignore=true; }
+		else { name2 = name2.substr(1); if (name2 == "") { name2 = name; } }
+
+		if (lines[3] == "") {  m->mothurOut("[WARNING]: missing quality for " + name2 + ", ignoring."); ignore=true; }
+
+		if (name2 != "") { if (name != name2) { m->mothurOut("[WARNING]: names do not match. read " + name + " for fasta and " + name2 + " for quality, ignoring."); ignore=true; } }
+		if (lines[3].length() != lines[1].length()) { m->mothurOut("[WARNING]: Lengths do not match for sequence " + name + ". Read " + toString(lines[1].length()) + " characters for fasta and " + toString(lines[3].length()) + " characters for quality scores, ignoring read."); ignore=true; }
+
+		if (ignore) { return; }
+
+		m->checkName(name);
+		parsed.seq = Sequence(name, lines[1]);
+		parsed.quality = lines[3];
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SeqReader", "parseFastq");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//reads the record like QualityScores(ifstream&), the rest of the name line is skipped
+void SeqReader::parseQual(const char* record, int length, seqRecord& parsed) {
+	try {
+		int pos = 0;
+		while ((pos < length) && isspace(record[pos])) { pos++; }
+		int nameStart = pos;
+		while ((pos < length) && !isspace(record[pos])) { pos++; }
+
+		if (pos == nameStart) { m->mothurOut("Error in reading your qfile, blank name."); m->mothurOutEndLine(); m->control_pressed = true; return; }
+
+		string name(record + nameStart + 1, pos - nameStart - 1);
+		m->checkName(name);
+
+		while ((pos < length) && (record[pos] != '\r') && (record[pos] != '\n')) { pos++; }
+
+		vector<int> scores;
+		while (pos < length) {
+			while ((pos < length) && isspace(record[pos])) { pos++; }
+			if (pos == length) { break; }
+			int scoreStart = pos;
+			while ((pos < length) && !isspace(record[pos])) { pos++; }
+
+			string temp(record + scoreStart, pos - scoreStart);
+			if (!m->isContainingOnlyDigits(temp)) { m->mothurOut("[ERROR]: In sequence " + name + "'s quality scores, expected a number and got " + temp + ", setting score to 0."); m->mothurOutEndLine(); temp = "0"; }
+			int score;
+			convert(temp, score);
+			scores.push_back(score);
+		}
+
+		parsed.scores = QualityScores(name, scores);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SeqReader", "parseQual");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
@@ -0,0 +1,78 @@
+#ifndef Mothur_seqreader_h
+#define Mothur_seqreader_h
+
+//
+//  seqreader.h
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+/* SeqReader reads a fasta, fastq or qual file in large blocks on its own thread.  The thread finds where each record
+ starts and ends in the block, parses the records and hands them to the command in batches through a queue that holds
+ at most a few batches, so the next batch is read while the command works on the last one without the whole file ever
+ being in memory.  A reader can cover the part of a file from one of the positions made by MothurOut::divideFile to
+ the next, which reads the same records as seeking an ifstream to the start and reading until tellg passes the end.
+
+ A fasta record is everything from its '>' to the next '>' that is not on the header line, a qual record is the same,
+ and a fastq record is four lines.  Records whose name starts with '#' are commented out and come back with a blank
+ name, like Sequence(ifstream&) makes for them. */
+
+#include "mothur.h"
+#include "sequence.hpp"
+#include "qualityscores.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+/**************************************************************************************************/
+
+struct seqRecord {
+	Sequence seq;				//fasta and fastq records
+	string quality;				//the quality line of a fastq record
+	QualityScores scores;		//qual records
+};
+
+/**************************************************************************************************/
+
+class SeqReader {
+
+public:
+	SeqReader(string, string);								//filename, format - "fasta", "fastq" or "qual"
+	SeqReader(string, string, unsigned long long, unsigned long long);	//filename, format, start and end positions
+	~SeqReader();
+
+	bool getBatch(vector<seqRecord>&);		//false once every record has been returned
+	bool getNext(seqRecord&);				//one record at a time from the batches
+
+	static const int BATCH_SIZE = 1000;					//records in a batch
+	static const int MAX_BATCHES = 4;					//batches read ahead of the command
+	static const unsigned long long BLOCK_SIZE = 4194304;	//bytes read at a time
+
+private:
+	MothurOut* m;
+	string filename, format;
+	unsigned long long start, end;
+
+	thread* producer;
+	mutex queueLock;
+	condition_variable notEmpty, notFull;
+	deque< vector<seqRecord>* > batches;
+	bool finished, stopped;
+
+	vector<seqRecord>* current;				//the batch getNext is returning records from
+	int currentIndex;
+
+	void startReading();
+	void readFile();
+	bool findRecord(const string&, unsigned long long, bool, unsigned long long&, unsigned long long&);
+	void parseRecord(const char*, int, seqRecord&);
+	void parseFastq(const char*, int, seqRecord&);
+	void parseQual(const char*, int, seqRecord&);
+	bool addBatch(vector<seqRecord>*);
+};
+
+/**************************************************************************************************/
+
+#endif
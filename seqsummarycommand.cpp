@@ -442,22 +442,22 @@ int SeqSummaryCommand::driverCreateSummary(vector<int>& startPosition, vector<in
 			outSummary << "seqname\tstart\tend\tnbases\tambigs\tpolymer\tnumSeqs" << endl;	
 		}
 				
-		ifstream in;
-		m->openInputFile(filename, in);
-				
-		in.seekg(filePos->start);
-
-		bool done = false;
+		//the sequences are read and parsed on another thread while this one summarizes them
+		#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+			SeqReader reader(filename, "fasta", filePos->start, filePos->end);
+		#else
+			SeqReader reader(filename, "fasta", filePos->start, numeric_limits<unsigned long long>::max());
+		#endif
+		seqRecord record;
 		int count = 0;
         
-        
-		while (!done) {
+		while (reader.getNext(record)) {
 				
-			if (m->control_pressed) { in.close(); outSummary.close(); return 1; }
+			if (m->control_pressed) { outSummary.close(); return 1; }
             
             if (m->debug) { m->mothurOut("[DEBUG]: count = " + toString(count) + "\n");  }
             
-			Sequence current(in); m->gobble(in);
+			Sequence& current = record.seq;
            
 			if (current.getName() != "") {
 				
@@ -488,16 +488,7 @@ int SeqSummaryCommand::driverCreateSummary(vector<int>& startPosition, vector<in
                 
                 if (m->debug) { m->mothurOut("[DEBUG]: " + current.getName() + '\t' + toString(current.getNumBases()) + "\n");  }
 			}
-			
-			#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				unsigned long long pos = in.tellg();
-				if ((pos == -1) || (pos >= filePos->end)) { break; }
-			#else
-				if (in.eof()) { break; }
-			#endif
 		}
-				
-		in.close();
 		
 		return count;
 	}
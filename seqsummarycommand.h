@@ -13,6 +13,7 @@
 #include "mothur.h"
 #include "command.hpp"
 #include "sequence.hpp"
+#include "seqreader.h"
 
 /**************************************************************************************************/
 
@@ -23,8 +23,7 @@ Sequence::Sequence(string newName, string sequence) {
         
         m->checkName(name);
 		
-		//setUnaligned removes any gap characters for us
-		setUnaligned(sequence);
+		//setAligned also sets the unaligned sequence, removing any gap characters
 		setAligned(sequence);
 	}
 	catch(exception& e) {
@@ -82,9 +81,8 @@ Sequence::Sequence(istringstream& fastaString){
 			int numAmbig = 0;
 			sequence = getSequenceString(fastaString, numAmbig);
 			
+			//setAligned also sets the unaligned sequence
 			setAligned(sequence);	
-			//setUnaligned removes any gap characters for us						
-			setUnaligned(sequence);	
 			
 			if ((numAmbig / (float) numBases) > 0.25) { m->mothurOut("[WARNING]: We found more than 25% of the bases in sequence " + name + " to be ambiguous. Mothur is not setup to process protein sequences."); m->mothurOutEndLine(); }
 		}
@@ -142,6 +140,56 @@ Sequence::Sequence(istringstream& fastaString, string JustUnaligned){
 }
 
 
+//********************************************************************************************************************
+//reads the record like Sequence(ifstream&) reads it from a file, a commented out sequence makes a blank seq
+Sequence::Sequence(const char* record, int length){
+	try {
+		m = MothurOut::getInstance();
+		initialize();
+		
+		int i = 0;
+		while ((i < length) && isspace(record[i])) { i++; }
+		int nameStart = i;
+		while ((i < length) && !isspace(record[i])) { i++; }
+		
+		if (i == nameStart) { m->mothurOut("Error in reading your fastafile, blank name."); m->mothurOutEndLine(); m->control_pressed = true; return; }
+		
+		name = string(record + nameStart + 1, i - nameStart - 1);
+		if ((name.length() != 0) && (name[0] == '#')) { name = ""; return; }
+		m->checkName(name);
+		
+		int commentStart = i;
+		while ((i < length) && (record[i] != '\r') && (record[i] != '\n')) { i++; }
+		comment = string(record + commentStart, i - commentStart);
+		
+		int numAmbig = 0;
+		string sequence;
+		sequence.reserve(length - i);
+		for (; i < length; i++) {
+			char letter = record[i];
+			if (letter == '>') { break; }
+			else if (letter == ' ') {;}
+			else if (isprint(letter)) {
+				letter = toupper(letter);
+				if(letter == 'U'){letter = 'T';}
+				if(letter != '.' && letter != '-' && letter != 'A' && letter != 'T' && letter != 'G'  && letter != 'C' && letter != 'N'){
+					letter = 'N';
+					numAmbig++;
+				}
+				sequence += letter;
+			}
+		}
+		
+		//setAligned also sets the unaligned sequence
+		setAligned(sequence);
+		
+		if ((numAmbig / (float) numBases) > 0.25) { m->mothurOut("[WARNING]: We found more than 25% of the bases in sequence " + name + " to be ambiguous. Mothur is not setup to process protein sequences."); m->mothurOutEndLine(); }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Sequence", "Sequence");
+		exit(1);
+	}
+}
 //********************************************************************************************************************
 //this function will jump over commented out sequences, but if the last sequence in a file is commented out it makes a blank seq
 Sequence::Sequence(ifstream& fastaFile){
@@ -174,9 +222,8 @@ Sequence::Sequence(ifstream& fastaFile){
 			int numAmbig = 0;
 			sequence = getSequenceString(fastaFile, numAmbig);
 			
+			//setAligned also sets the unaligned sequence
 			setAligned(sequence);	
-			//setUnaligned removes any gap characters for us						
-			setUnaligned(sequence);	
 			
 			if ((numAmbig / (float) numBases) > 0.25) { m->mothurOut("[WARNING]: We found more than 25% of the bases in sequence " + name + " to be ambiguous. Mothur is not setup to process protein sequences."); m->mothurOutEndLine(); }
 			
@@ -227,9 +274,8 @@ Sequence::Sequence(ifstream& fastaFile, string& extraInfo, bool getInfo){
 			int numAmbig = 0;
 			sequence = getSequenceString(fastaFile, numAmbig);
 			
+			//setAligned also sets the unaligned sequence
 			setAligned(sequence);	
-			//setUnaligned removes any gap characters for us						
-			setUnaligned(sequence);	
 			
 			if ((numAmbig / (float) numBases) > 0.25) { m->mothurOut("[WARNING]: We found more than 25% of the bases in sequence " + name + " to be ambiguous. Mothur is not setup to process protein sequences."); m->mothurOutEndLine(); }
 		}
@@ -471,27 +517,41 @@ void Sequence::setName(string seqName) {
 void Sequence::setUnaligned(string sequence){
 	
 	if(sequence.find_first_of('.') != string::npos || sequence.find_first_of('-') != string::npos) {
-		string temp = "";
-		for(int j=0;j<sequence.length();j++) {
-			if(isalpha(sequence[j]))	{	temp += sequence[j];	}
-		}
-		unaligned = temp;
+		removeGaps(sequence);
 	}
 	else {
-		unaligned = sequence;
+		unaligned.swap(sequence);
 	}
 	numBases = unaligned.length();
 	
 }
 
+//********************************************************************************************************************
+//copies the bases of sequence into unaligned, reusing unaligned's buffer
+void Sequence::removeGaps(const string& sequence){
+	
+	unaligned.clear();
+	unaligned.reserve(sequence.length());
+	for(int j=0;j<sequence.length();j++) {
+		if(isalpha(sequence[j]))	{	unaligned += sequence[j];	}
+	}
+	
+}
+
 //********************************************************************************************************************
 
 void Sequence::setAligned(string sequence){
 	
 	//if the alignment starts or ends with a gap, replace it with a period to indicate missing data
-	aligned = sequence;
+	aligned.swap(sequence);
 	alignmentLength = aligned.length();
-	setUnaligned(sequence);	
+	if(aligned.find_first_of('.') != string::npos || aligned.find_first_of('-') != string::npos) {
+		removeGaps(aligned);
+	}
+	else {
+		unaligned = aligned;
+	}
+	numBases = unaligned.length();
 
 	if(aligned[0] == '-'){
 		for(int i=0;i<alignmentLength;i++){
@@ -517,12 +577,12 @@ void Sequence::setAligned(string sequence){
 //********************************************************************************************************************
 
 void Sequence::setPairwise(string sequence){
-	pairwise = sequence;
+	pairwise.swap(sequence);
 }
 
 //********************************************************************************************************************
 
-string Sequence::convert2ints() {
+string Sequence::convert2ints() const {
 	
 	if(unaligned == "")	{	/* need to throw an error */	}
 	
@@ -541,13 +601,13 @@ string Sequence::convert2ints() {
 
 //********************************************************************************************************************
 
-string Sequence::getName(){
+const string& Sequence::getName() const {
 	return name;
 }
 
 //********************************************************************************************************************
 
-string Sequence::getAligned(){
+const string& Sequence::getAligned() const {
 	if(isAligned == 0)	{ return unaligned; }
 	else				{  return aligned;  }
 }
@@ -561,13 +621,13 @@ string Sequence::getInlineSeq(){
 
 //********************************************************************************************************************
 
-string Sequence::getPairwise(){
+const string& Sequence::getPairwise() const {
 	return pairwise;
 }
 
 //********************************************************************************************************************
 
-string Sequence::getUnaligned(){
+const string& Sequence::getUnaligned() const {
 	return unaligned;
 }
 
@@ -33,6 +33,7 @@ public:
 	Sequence(string, string, string);  
 	Sequence(ifstream&, string);
 	Sequence(istringstream&, string);
+	Sequence(const char*, int);		//parses one fasta record from memory, ">name comment" followed by the bases
 	
 	void setName(string);
 	void setUnaligned(string);
@@ -42,11 +43,12 @@ public:
 	void reverseComplement();
 	void trim(int);
 	
-	string convert2ints();
-	string getName();
-	string getAligned();
-	string getPairwise();
-	string getUnaligned();
+	string convert2ints() const;
+	//these return references to the sequence's own strings, so copy them if you need them after changing the sequence
+	const string& getName() const;
+	const string& getAligned() const;
+	const string& getPairwise() const;
+	const string& getUnaligned() const;
 	string getInlineSeq();
     int getNumNs();
 	int getNumBases();
@@ -66,6 +68,7 @@ public:
 private:
 	MothurOut* m;
 	void initialize();
+	void removeGaps(const string&);
 	string getSequenceString(ifstream&, int&);
 	string getCommentString(ifstream&);
 	string getSequenceString(istringstream&, int&);
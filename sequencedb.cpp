@@ -15,160 +15,100 @@
 
 /***********************************************************************/
 
-SequenceDB::SequenceDB() {  m = MothurOut::getInstance();  length = 0; samelength = true; }
-/***********************************************************************/
-//the clear function free's the memory
-SequenceDB::~SequenceDB() { clear(); }
-
-/***********************************************************************/
-
-SequenceDB::SequenceDB(int newSize) {
-	data.resize(newSize, Sequence());
-	length = 0; samelength = true;
+SequenceDB::SequenceDB() {  
+	m = MothurOut::getInstance();  length = 0; samelength = true; 
+	nameStarts.push_back(0); seqStarts.push_back(0);
 }
 
 /***********************************************************************/
 
 SequenceDB::SequenceDB(ifstream& filehandle) {
 	try{
+		m = MothurOut::getInstance();
 		length = 0; samelength = true;
+		nameStarts.push_back(0); seqStarts.push_back(0);
+		
+		//the bases take up most of the file, so this saves growing the arena while reading.
+		//A compressed file is read through a pipe, which can't seek, so it isn't reserved.
+		streamoff start = filehandle.tellg();
+		if (start != -1) {
+			filehandle.seekg(0, ios::end);
+			streamoff end = filehandle.tellg();
+			filehandle.clear();
+			filehandle.seekg(start, ios::beg);
+			if (end > start) { seqData.reserve(end - start); }
+		}
+		filehandle.clear();
 				
 		//read through file
-		while (!filehandle.eof()) {
+		while (filehandle.good()) {
 			//input sequence info into sequencedb
 			Sequence newSequence(filehandle);
 			
-			if (newSequence.getName() != "") {   
-				if (length == 0) { length = newSequence.getAligned().length(); }
-				if (length != newSequence.getAligned().length()) { samelength = false; }
-				data.push_back(newSequence);  
-			}
+			if (newSequence.getName() != "") {   push_back(newSequence);  }
 			
 			//takes care of white space
 			m->gobble(filehandle);
 		}
 
 		filehandle.close();
-		
 	}
 	catch(exception& e) {
 		m->errorOut(e, "SequenceDB", "SequenceDB");
 		exit(1);
 	}
 }
-/*******************************************************************************/
-string SequenceDB::readName(ifstream& in) {
-	try{
-		string name = "";
-		int c;
-		string temp;
-		
-		while ((c = in.get()) != EOF) {
-			//if c is not a line return
-			if (c != 10) {
-				name += c;
-			}else { break;  }
-		}
-			
-		return name;
-	}
-	catch(exception& e) {
-		m->errorOut(e, "SequenceDB", "readName");
-		exit(1);
-	}
-}
-
-/*******************************************************************************/
-string SequenceDB::readSequence(ifstream& in) {
-	try{
-		string sequence = "";
-		string line;
-		int pos, c;
-		
-		while (!in.eof()) {
-			//save position in file in case next line is a new name.
-			pos = in.tellg();
-			line = "";
-			in >> line;			
-			//if you are at a new name
-			if (line[0] == '>') {
-				//put file pointer back since you are now at a new name
-				in.seekg(pos, ios::beg);
-				c = in.get();  //because you put it back to a newline char
-				break;
-			}else {  sequence += line;	}
-		}
-		
-		if (length == 0) { length = sequence.length(); }
-		if (length != sequence.length()) { samelength = false; }
-		
-		return sequence;
-	}
-	catch(exception& e) {
-		m->errorOut(e, "SequenceDB", "readSequence");
-		exit(1);
-	}
-}
-	
 /***********************************************************************/
 
 int SequenceDB::getNumSeqs() {
-	return data.size();
+	return numBases.size();
 }
 
 /***********************************************************************/
 
-void SequenceDB::set(int index, string newUnaligned) {
+Sequence SequenceDB::get(int index) {
 	try {
-		if (length == 0) { length = newUnaligned.length(); }
-		if (length != newUnaligned.length()) { samelength = false; }
-		
-		data[index] = Sequence(data[index].getName(), newUnaligned);
+		return Sequence(getName(index), string(getAligned(index), getAlignedLength(index)));
 	}
 	catch(exception& e) {
-		m->errorOut(e, "SequenceDB", "set");
+		m->errorOut(e, "SequenceDB", "get");
 		exit(1);
 	}
 }
 
 /***********************************************************************/
 
-void SequenceDB::set(int index, Sequence newSeq) {
-	try {
-		if (length == 0) { length = newSeq.getAligned().length(); }
-		if (length != newSeq.getAligned().length()) { samelength = false; }
+string SequenceDB::getName(int index) {
+	return string(&nameData[nameStarts[index]], nameStarts[index+1] - nameStarts[index] - 1);
+}
 
-		data[index] = newSeq;
-	}
-	catch(exception& e) {
-		m->errorOut(e, "SequenceDB", "set");
-		exit(1);
-	}
+/***********************************************************************/
+
+const char* SequenceDB::getAligned(int index) {
+	return &seqData[seqStarts[index]];
 }
 
 /***********************************************************************/
 
-Sequence SequenceDB::get(int index) {
-	return data[index];
+int SequenceDB::getAlignedLength(int index) {
+	return seqStarts[index+1] - seqStarts[index] - 1;
 }
 
 /***********************************************************************/
 
-void SequenceDB::resize(int newSize) {
-	try {
-		data.resize(newSize);
-	}
-	catch(exception& e) {
-		m->errorOut(e, "SequenceDB", "resize");
-		exit(1);
-	}
+int SequenceDB::getNumBases(int index) {
+	return numBases[index];
 }
 
 /***********************************************************************/
 
 void SequenceDB::clear() {
 	try {
-		data.clear();
+		vector<char>().swap(nameData);
+		vector<char>().swap(seqData);
+		nameStarts.assign(1, 0);
+		seqStarts.assign(1, 0);
+		vector<int>().swap(numBases);
 	}
 	catch(exception& e) {
 		m->errorOut(e, "SequenceDB", "clear");
@@ -179,15 +119,15 @@ void SequenceDB::clear() {
 /***********************************************************************/
 
 int SequenceDB::size() {
-	return data.size();
+	return numBases.size();
 }
 
 /***********************************************************************/
 
 void SequenceDB::print(ostream& out) {
 	try {
-		for(int i = 0; i < data.size(); i++) {
-			data[i].printSequence(out);
+		for(int i = 0; i < numBases.size(); i++) {
+			out << ">" << getName(i) << endl << getAligned(i) << endl;
 		}
 	}
 	catch(exception& e) {
@@ -198,12 +138,23 @@ void SequenceDB::print(ostream& out) {
 	
 /***********************************************************************/
 
-void SequenceDB::push_back(Sequence newSequence) {
+void SequenceDB::push_back(Sequence& newSequence) {
 	try {
-		if (length == 0) { length = newSequence.getAligned().length(); }
-		if (length != newSequence.getAligned().length()) { samelength = false; }
+		const string& name = newSequence.getName();
+		const string& aligned = newSequence.getAligned();
+		
+		if (length == 0) { length = aligned.length(); }
+		if (length != aligned.length()) { samelength = false; }
 
-		data.push_back(newSequence);
+		nameData.insert(nameData.end(), name.begin(), name.end());
+		nameData.push_back('\0');
+		nameStarts.push_back(nameData.size());
+		
+		seqData.insert(seqData.end(), aligned.begin(), aligned.end());
+		seqData.push_back('\0');
+		seqStarts.push_back(seqData.size());
+		
+		numBases.push_back(newSequence.getNumBases());
 	}
 	catch(exception& e) {
 		m->errorOut(e, "SequenceDB", "push_back");
@@ -212,4 +163,3 @@ void SequenceDB::push_back(Sequence newSequence) {
 }
 
 /***********************************************************************/
-
@@ -11,7 +11,9 @@
  */
 
 
-/* This class is a container to store the sequences. */
+/* This class is a read only container to store the sequences.  Instead of a Sequence for each read, the names and the
+ aligned bases are appended to two arenas and found through offset tables, so a large aligned fasta file takes about its
+ own size in memory.  getName and getAligned read the arenas in place, get makes a Sequence when one is needed. */
 
 
 #include "sequence.hpp"
@@ -22,27 +24,27 @@ class SequenceDB {
 	
 public:
 	SequenceDB();
-	SequenceDB(int);           //makes data that size
-	SequenceDB(ifstream&);	   //reads file to fill data
-	SequenceDB(const SequenceDB& sdb) : data(sdb.data) {};
-	~SequenceDB();             //loops through data and delete each sequence
+	SequenceDB(ifstream&);	   //reads file to fill data, no destructor so "db = SequenceDB(file)" moves the arenas instead of copying them
 
 	int getNumSeqs();
 	
-	void set(int, string);     //unaligned - should also set length
-	void set(int, Sequence);   //unaligned - should also set length
-	Sequence get(int);         //returns sequence name at that location
-	void push_back(Sequence);        //adds unaligned sequence
-	void resize(int);      //resizes data
-	void clear();              //clears data - remeber to loop through and delete the sequences inside or you will have a memory leak
-	int size();                //returns datas size
-	void print(ostream&);      //loops through data using sequence class print
+	Sequence get(int);         //makes a copy of the sequence at that location
+	string getName(int);
+	const char* getAligned(int);	//the aligned bases of the sequence at that location, followed by a '\0'
+	int getAlignedLength(int);
+	int getNumBases(int);
+	void push_back(Sequence&);        //adds sequence
+	void clear();
+	int size();                //returns number of sequences
+	void print(ostream&);      //prints the sequences in fasta format
 	bool sameLength() { return samelength; }
 		
 private:
-	vector<Sequence> data;
-	string readName(ifstream&);
-	string readSequence(ifstream&);
+	vector<char> nameData;		//the names, each followed by a '\0'
+	vector<char> seqData;		//the aligned bases, each followed by a '\0'
+	vector<unsigned long long> nameStarts;	//sequence i's name starts at nameData[nameStarts[i]], the last entry is the end of the data
+	vector<unsigned long long> seqStarts;
+	vector<int> numBases;
 	MothurOut* m;
 	bool samelength;
 	int length;
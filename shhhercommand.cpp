@@ -21,6 +21,7 @@ vector<string> ShhherCommand::setParameters(){
         CommandParameter plarge("large", "Number", "", "-1", "", "", "","",false,false); parameters.push_back(plarge);
 		CommandParameter psigma("sigma", "Number", "", "60", "", "", "","",false,false); parameters.push_back(psigma);
 		CommandParameter pmindelta("mindelta", "Number", "", "0.000001", "", "", "","",false,false); parameters.push_back(pmindelta);
+		CommandParameter psparse("sparse", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(psparse);
         CommandParameter porder("order", "Multiple", "A-B-I", "A", "", "", "","",false,false, true); parameters.push_back(porder);		CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
 		
@@ -38,10 +39,12 @@ string ShhherCommand::getHelpString(){
 	try {
 		string helpString = "";
 		helpString += "The shhh.flows command reads a file containing flowgrams and creates a file of corrected sequences.\n";
-        helpString += "The shhh.flows command parameters are flow, file, lookup, cutoff, processors, large, maxiter, sigma, mindelta and order.\n";
+        helpString += "The shhh.flows command parameters are flow, file, lookup, cutoff, processors, large, maxiter, sigma, mindelta, sparse and order.\n";
         helpString += "The flow parameter is used to input your flow file.\n";
         helpString += "The file parameter is used to input the *flow.files file created by trim.flows.\n";
         helpString += "The lookup parameter is used specify the lookup file you would like to use. http://www.mothur.org/wiki/Lookup_files.\n";
+        helpString += "The sparse parameter allows you to only update the otus each sequence is close to during denoising, and all of them every " + toString(SPARSE_REFRESH) + " iterations. This is much faster for large flow files, but the results can differ slightly. Default=F.\n";
+        helpString += "The processors parameter allows you to specify the number of threads used to find the distances between the flowgrams and to denoise each flow file.\n";
         helpString += "The order parameter options are A, B or I.  Default=A. A = TACG and B = TACGTACGTACGATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATAGATCGCATGACGATCGCATATCGTCAGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATAGATCGCATGACGATCGCATATCGTCAGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATAGATCGCATGACGATCGCATATCGTCAGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGATCTCAGTCAGCAGC and I = TACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGC.\n";
 		return helpString;
 	}
@@ -356,6 +359,9 @@ ShhherCommand::ShhherCommand(string option) {
 
 			temp = validParameter.validFile(parameters, "maxiter", false);	if (temp == "not found"){	temp = "1000";		}
 			m->mothurConvert(temp, maxIters); 
+			
+			temp = validParameter.validFile(parameters, "sparse", false);	if (temp == "not found"){	temp = "F";		}
+			sparse = m->isTrue(temp);
             
             temp = validParameter.validFile(parameters, "large", false);	if (temp == "not found"){	temp = "0";		}
 			m->mothurConvert(temp, largeSize); 
@@ -1958,16 +1964,8 @@ int ShhherCommand::execute(){
 		getSingleLookUp();	if (m->control_pressed) { return 0; }
 		getJointLookUp();	if (m->control_pressed) { return 0; }
 		
-        int numFiles = flowFileVector.size();
-		
-        if (numFiles < processors) { processors = numFiles; }
-        
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-        if (processors == 1) { driver(flowFileVector, compositeFASTAFileName, compositeNamesFileName); }
-        else { createProcesses(flowFileVector); } //each processor processes one file
-#else
+        //the files are denoised one at a time, the processors share the distances and the steps of each one
         driver(flowFileVector, compositeFASTAFileName, compositeNamesFileName);
-#endif
         
 		if(compositeFASTAFileName != ""){
 			outputNames.push_back(compositeFASTAFileName); outputTypes["fasta"].push_back(compositeFASTAFileName);
@@ -1988,194 +1986,6 @@ int ShhherCommand::execute(){
 }
 #endif
 //********************************************************************************************************************
-//sorts biggest to smallest
-inline bool compareFileSizes(string left, string right){
-    
-    FILE * pFile;
-    long leftsize = 0;
-    
-    //get num bytes in file
-    string filename = left;
-    pFile = fopen (filename.c_str(),"rb");
-    string error = "Error opening " + filename;
-    if (pFile==NULL) perror (error.c_str());
-    else{
-        fseek (pFile, 0, SEEK_END);
-        leftsize=ftell (pFile);
-        fclose (pFile);
-    }
-    
-    FILE * pFile2;
-    long rightsize = 0;
-    
-    //get num bytes in file
-    filename = right;
-    pFile2 = fopen (filename.c_str(),"rb");
-    error = "Error opening " + filename;
-    if (pFile2==NULL) perror (error.c_str());
-    else{
-        fseek (pFile2, 0, SEEK_END);
-        rightsize=ftell (pFile2);
-        fclose (pFile2);
-    }
-    
-    return (leftsize > rightsize);	
-} 
-/**************************************************************************************************/
-
-int ShhherCommand::createProcesses(vector<string> filenames){
-    try {
-        vector<int> processIDS;
-		int process = 1;
-		int num = 0;
-		
-		//sanity check
-		if (filenames.size() < processors) { processors = filenames.size(); }
-        
-        //sort file names by size to divide load better
-        sort(filenames.begin(), filenames.end(), compareFileSizes);
-        
-        vector < vector <string> > dividedFiles; //dividedFiles[1] = vector of filenames for process 1...
-        dividedFiles.resize(processors);
-        
-        //for each file, figure out which process will complete it
-        //want to divide the load intelligently so the big files are spread between processes
-        for (int i = 0; i < filenames.size(); i++) { 
-            int processToAssign = (i+1) % processors; 
-            if (processToAssign == 0) { processToAssign = processors; }
-            
-            dividedFiles[(processToAssign-1)].push_back(filenames[i]);
-        }
-        
-        //now lets reverse the order of ever other process, so we balance big files running with little ones
-        for (int i = 0; i < processors; i++) {
-            int remainder = ((i+1) % processors);
-            if (remainder) {  reverse(dividedFiles[i].begin(), dividedFiles[i].end());  }
-        }
-        
-          		
-		//divide the groups between the processors
-		/*vector<linePair> lines;
-        vector<int> numFilesToComplete;
-		int numFilesPerProcessor = filenames.size() / processors;
-		for (int i = 0; i < processors; i++) {
-			int startIndex =  i * numFilesPerProcessor;
-			int endIndex = (i+1) * numFilesPerProcessor;
-			if(i == (processors - 1)){	endIndex = filenames.size(); 	}
-			lines.push_back(linePair(startIndex, endIndex));
-            numFilesToComplete.push_back((endIndex-startIndex));
-		}*/
-		
-        #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)		
-		
-		//loop through and create all the processes you want
-		while (process != processors) {
-			pid_t pid = fork();
-			
-			if (pid > 0) {
-				processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-				process++;
-			}else if (pid == 0){
-				num = driver(dividedFiles[process], compositeFASTAFileName + m->mothurGetpid(process) + ".temp", compositeNamesFileName  + m->mothurGetpid(process) + ".temp");
-                
-                //pass numSeqs to parent
-				ofstream out;
-				string tempFile = compositeFASTAFileName + m->mothurGetpid(process) + ".num.temp";
-				m->openOutputFile(tempFile, out);
-				out << num << endl;
-				out.close();
-                
-				exit(0);
-			}else { 
-				m->mothurOut("[ERROR]: unable to spawn the necessary processes."); m->mothurOutEndLine(); 
-				for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-				exit(0);
-			}
-		}
-		
-		//do my part
-		driver(dividedFiles[0], compositeFASTAFileName, compositeNamesFileName);
-		
-		//force parent to wait until all the processes are done
-		for (int i=0;i<processIDS.size();i++) { 
-			int temp = processIDS[i];
-			wait(&temp);
-		}
-        
-        #else
-        
-        //////////////////////////////////////////////////////////////////////////////////////////////////////
-        
-        /////////////////////// NOT WORKING, ACCESS VIOLATION ON READ OF FLOWGRAMS IN THREAD /////////////////
-        
-        //////////////////////////////////////////////////////////////////////////////////////////////////////
-		//Windows version shared memory, so be careful when passing variables through the shhhFlowsData struct. 
-		//Above fork() will clone, so memory is separate, but that's not the case with windows, 
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		/*
-		vector<shhhFlowsData*> pDataArray; 
-		DWORD   dwThreadIdArray[processors-1];
-		HANDLE  hThreadArray[processors-1]; 
-		
-		//Create processor worker threads.
-		for( int i=0; i<processors-1; i++ ){
-			// Allocate memory for thread data.
-			string extension = "";
-			if (i != 0) { extension = toString(i) + ".temp"; }
-			
-            shhhFlowsData* tempFlow = new shhhFlowsData(filenames, (compositeFASTAFileName + extension), (compositeNamesFileName + extension), outputDir, flowOrder, jointLookUp, singleLookUp, m, lines[i].start, lines[i].end, cutoff, sigma, minDelta, maxIters, i);
-			pDataArray.push_back(tempFlow);
-			processIDS.push_back(i);
-            
-			hThreadArray[i] = CreateThread(NULL, 0, ShhhFlowsThreadFunction, pDataArray[i], 0, &dwThreadIdArray[i]);   
-		}
-		
-		//using the main process as a worker saves time and memory
-		//do my part
-		driver(filenames, compositeFASTAFileName, compositeNamesFileName, lines[processors-1].start, lines[processors-1].end);
-		
-		//Wait until all threads have terminated.
-		WaitForMultipleObjects(processors-1, hThreadArray, TRUE, INFINITE);
-		
-		//Close all thread handles and free memory allocations.
-		for(int i=0; i < pDataArray.size(); i++){
-			for(int j=0; j < pDataArray[i]->outputNames.size(); j++){ outputNames.push_back(pDataArray[i]->outputNames[j]); }
-			CloseHandle(hThreadArray[i]);
-			delete pDataArray[i];
-		}
-		*/
-        #endif
-        
-        for (int i=0;i<processIDS.size();i++) { 
-            ifstream in;
-			string tempFile =  compositeFASTAFileName + toString(processIDS[i]) + ".num.temp";
-			m->openInputFile(tempFile, in);
-			if (!in.eof()) { 
-                int tempNum = 0; 
-                in >> tempNum; 
-                if (tempNum != dividedFiles[i+1].size()) {
-                    m->mothurOut("[ERROR]: main process expected " + toString(processIDS[i]) + " to complete " + toString(dividedFiles[i+1].size()) + " files, and it only reported completing " + toString(tempNum) + ". This will cause file mismatches.  The flow files may be too large to process with multiple processors. \n");
-                }
-            }
-			in.close(); m->mothurRemove(tempFile);
-            
-            if (compositeFASTAFileName != "") {
-                m->appendFiles((compositeFASTAFileName + toString(processIDS[i]) + ".temp"), compositeFASTAFileName);
-                m->appendFiles((compositeNamesFileName + toString(processIDS[i]) + ".temp"), compositeNamesFileName);
-                m->mothurRemove((compositeFASTAFileName + toString(processIDS[i]) + ".temp"));
-                m->mothurRemove((compositeNamesFileName + toString(processIDS[i]) + ".temp"));
-            }
-        }
-        
-        return 0;
-        
-    }
-	catch(exception& e) {
-		m->errorOut(e, "ShhherCommand", "createProcesses");
-		exit(1);
-	}
-}
-/**************************************************************************************************/
 
 vector<string> ShhherCommand::parseFlowFiles(string filename){
     try {
@@ -2343,8 +2153,11 @@ int ShhherCommand::driver(vector<string> filenames, string thisCompositeFASTAFil
                 begClock = clock();
                 begTime = time(NULL);
                 
+                vector<vector<int> > seqOTUs;	//with sparse, the otus each sequence is close to
+                if (sparse) { seqOTUs.resize(numSeqs); }
+                
                 m->mothurOut("\nDenoising flowgrams...\n");
-                m->mothurOut("iter\tmaxDelta\tnLL\t\tcycletime\n");
+                m->mothurOut("iter\tmaxDelta\tnLL\t\tcycletime\t\tactive\tchanged\tupdated\n");
                 
                 while((maxIters == 0 && maxDelta > minDelta) || iter < MIN_ITER || (maxDelta > minDelta && iter < maxIters)){
                     
@@ -2372,13 +2185,20 @@ int ShhherCommand::driver(vector<string> filenames, string thisCompositeFASTAFil
                     
                     if (m->control_pressed) { break; }
                     
-                    calcNewDistances(numSeqs, numOTUs, nSeqsPerOTU,  dist, weight, change, centroids, aaP, singleTau, aaI, seqNumber, seqIndex, uniqueFlowgrams, flowDataIntI, numFlowCells, lengths);
+                    //the otus still in the model and the ones whose centroids moved, to see how close the iterations are to converging
+                    int numActive = 0; int numChanged = 0;
+                    for(int j=0;j<numOTUs;j++){
+                        if(weight[j] > MIN_WEIGHT){ numActive++; if(change[j] == 1){ numChanged++; } }
+                    }
+                    
+                    bool fullPass = (!sparse) || ((iter % SPARSE_REFRESH) == 0);
+                    long long numUpdated = calcNewDistances(numSeqs, numOTUs, nSeqsPerOTU,  dist, weight, change, centroids, aaP, singleTau, aaI, seqNumber, seqIndex, uniqueFlowgrams, flowDataIntI, numFlowCells, lengths, seqOTUs, fullPass);
                     
                     if (m->control_pressed) { break; }
                     
                     iter++;
                     
-                    m->mothurOut(toString(iter) + '\t' + toString(maxDelta) + '\t' + toString(nLL) + '\t' + toString(time(NULL) - cycTime) + '\t' + toString((clock() - cycClock)/(double)CLOCKS_PER_SEC) + '\n');
+                    m->mothurOut(toString(iter) + '\t' + toString(maxDelta) + '\t' + toString(nLL) + '\t' + toString(time(NULL) - cycTime) + '\t' + toString((clock() - cycClock)/(double)CLOCKS_PER_SEC) + '\t' + toString(numActive) + '\t' + toString(numChanged) + '\t' + toString(numUpdated) + '\n');
                     
                 }	
                 
@@ -2532,43 +2352,59 @@ int ShhherCommand::getFlowData(string filename, vector<string>& thisSeqNameVecto
 int ShhherCommand::flowDistParentFork(int numFlowCells, string distFileName, int stopSeq, vector<int>& mapUniqueToSeq, vector<int>& mapSeqToUnique, vector<int>& lengths, vector<double>& flowDataPrI, vector<short>& flowDataIntI){
 	try{		
         
-		ostringstream outStream;
-		outStream.setf(ios::fixed, ios::floatfield);
-		outStream.setf(ios::dec, ios::basefield);
-		outStream.setf(ios::showpoint);
-		outStream.precision(6);
-		
-		int begTime = time(NULL);
-		double begClock = clock();
-        
-		for(int i=0;i<stopSeq;i++){
-			
-			if (m->control_pressed) { break; }
-			
-			for(int j=0;j<i;j++){
-				float flowDistance = calcPairwiseDist(numFlowCells, mapUniqueToSeq[i], mapUniqueToSeq[j], mapSeqToUnique, lengths, flowDataPrI, flowDataIntI);
-                
-				if(flowDistance < 1e-6){
-					outStream << mapUniqueToSeq[i] << '\t' << mapUniqueToSeq[j] << '\t' << 0.000000 << endl;
-				}
-				else if(flowDistance <= cutoff){
-					outStream << mapUniqueToSeq[i] << '\t' << mapUniqueToSeq[j] << '\t' << flowDistance << endl;
-				}
-			}
-			if(i % 100 == 0){
-				m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(NULL) - begTime));
-				m->mothurOutJustToScreen("\t" + toString((clock()-begClock)/CLOCKS_PER_SEC)+"\n");
+		//interleave the flowgrams of the full blocks, the rows compare themselves to the uniques before them a block at a time
+		flowDistData data;
+		data.numFlowCells = numFlowCells;
+		int numBlocks = stopSeq / FLOW_BLOCK;
+		data.blockIntI.resize(numBlocks * numFlowCells * FLOW_BLOCK);
+		data.blockPrI.resize(numBlocks * numFlowCells * FLOW_BLOCK);
+		data.blockSeqs.resize(numBlocks * FLOW_BLOCK);
+		for(int u=0;u<numBlocks*FLOW_BLOCK;u++){
+			int seqOffset = mapUniqueToSeq[u] * numFlowCells;
+			int blockOffset = (u / FLOW_BLOCK) * numFlowCells * FLOW_BLOCK + (u % FLOW_BLOCK);
+			for(int c=0;c<numFlowCells;c++){
+				data.blockIntI[blockOffset + c * FLOW_BLOCK] = flowDataIntI[seqOffset + c];
+				data.blockPrI[blockOffset + c * FLOW_BLOCK] = flowDataPrI[seqOffset + c];
 			}
+			data.blockSeqs[u] = mapUniqueToSeq[u];
+		}
+		
+		//row i has i distances, so the chunks get about the same number of distances each
+		int numThreads = processors;
+		if (numThreads < 1) { numThreads = 1; }
+		int numChunks = min(stopSeq, 16 * numThreads);
+		if (numChunks < 1) { numChunks = 1; }
+		data.chunkStarts.assign(numChunks+1, 0);
+		for(int k=1;k<numChunks;k++){
+			data.chunkStarts[k] = max(data.chunkStarts[k-1], (int)(stopSeq * sqrt(k / (double)numChunks)));
+		}
+		data.chunkStarts[numChunks] = stopSeq;
+		data.chunkDists.resize(numChunks);
+		
+		data.begTime = time(NULL);
+		data.begClock = clock();
+		
+		WorkQueue queue(numThreads);
+		for(int k=0;k<numChunks;k++){ queue.push(k % numThreads, k); }
+		queue.close();
+		
+		vector<thread*> workers;
+		for(int i=0;i<numThreads;i++){
+			workers.push_back(new thread(&ShhherCommand::flowDistWorker, this, i, &queue, &data, ref(mapUniqueToSeq), ref(mapSeqToUnique), ref(lengths), ref(flowDataPrI), ref(flowDataIntI)));
+		}
+		for(int i=0;i<workers.size();i++){
+			workers[i]->join();
+			delete workers[i];
 		}
 		
 		ofstream distFile(distFileName.c_str());
-		distFile << outStream.str();		
+		for(int k=0;k<numChunks;k++){ distFile << data.chunkDists[k]; }
 		distFile.close();
 		
 		if (m->control_pressed) {}
 		else {
-			m->mothurOutJustToScreen(toString(stopSeq-1) + "\t" + toString(time(NULL) - begTime));
-			m->mothurOutJustToScreen("\t" + toString((clock()-begClock)/CLOCKS_PER_SEC)+"\n");
+			m->mothurOutJustToScreen(toString(stopSeq-1) + "\t" + toString(time(NULL) - data.begTime));
+			m->mothurOutJustToScreen("\t" + toString((clock()-data.begClock)/CLOCKS_PER_SEC)+"\n");
 		}
         
         return 0;
@@ -2580,6 +2416,56 @@ int ShhherCommand::flowDistParentFork(int numFlowCells, string distFileName, int
 }
 /**************************************************************************************************/
 
+void ShhherCommand::flowDistWorker(int worker, WorkQueue* queue, flowDistData* data, vector<int>& mapUniqueToSeq, vector<int>& mapSeqToUnique, vector<int>& lengths, vector<double>& flowDataPrI, vector<short>& flowDataIntI){
+	try{
+		long long task;
+		float blockDists[FLOW_BLOCK];
+		
+		while (queue->pop(worker, task)) {
+			
+			ostringstream outStream;
+			outStream.setf(ios::fixed, ios::floatfield);
+			outStream.setf(ios::dec, ios::basefield);
+			outStream.setf(ios::showpoint);
+			outStream.precision(6);
+			
+			for(int i=data->chunkStarts[task];i<data->chunkStarts[task+1];i++){
+				
+				if (m->control_pressed) { break; }
+				
+				int numFullBlocks = i / FLOW_BLOCK;
+				
+				for(int j=0;j<i;j++){
+					float flowDistance;
+					if (j < numFullBlocks * FLOW_BLOCK) {
+						if ((j % FLOW_BLOCK) == 0) { calcPairwiseDistBlock(data, mapUniqueToSeq[i], j / FLOW_BLOCK, mapSeqToUnique, lengths, flowDataPrI, flowDataIntI, blockDists); }
+						flowDistance = blockDists[j % FLOW_BLOCK];
+					}
+					else { flowDistance = calcPairwiseDist(data->numFlowCells, mapUniqueToSeq[i], mapUniqueToSeq[j], mapSeqToUnique, lengths, flowDataPrI, flowDataIntI); }
+	                
+					if(flowDistance < 1e-6){
+						outStream << mapUniqueToSeq[i] << '\t' << mapUniqueToSeq[j] << '\t' << 0.000000 << endl;
+					}
+					else if(flowDistance <= cutoff){
+						outStream << mapUniqueToSeq[i] << '\t' << mapUniqueToSeq[j] << '\t' << flowDistance << endl;
+					}
+				}
+				if((worker == 0) && (i % 100 == 0)){
+					m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(NULL) - data->begTime));
+					m->mothurOutJustToScreen("\t" + toString((clock()-data->begClock)/CLOCKS_PER_SEC)+"\n");
+				}
+			}
+			
+			data->chunkDists[task] = outStream.str();
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ShhherCommand", "flowDistWorker");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
 float ShhherCommand::calcPairwiseDist(int numFlowCells, int seqA, int seqB, vector<int>& mapSeqToUnique, vector<int>& lengths, vector<double>& flowDataPrI, vector<short>& flowDataIntI){
 	try{
 		int minLength = lengths[mapSeqToUnique[seqA]];
@@ -2610,6 +2496,50 @@ float ShhherCommand::calcPairwiseDist(int numFlowCells, int seqA, int seqB, vect
 		exit(1);
 	}
 }
+/**************************************************************************************************/
+//the distances from seqA to the FLOW_BLOCK uniques of the block, each one summed in the same order as calcPairwiseDist
+void ShhherCommand::calcPairwiseDistBlock(flowDistData* data, int seqA, int block, vector<int>& mapSeqToUnique, vector<int>& lengths, vector<double>& flowDataPrI, vector<short>& flowDataIntI, float* blockDists){
+	try{
+		int numFlowCells = data->numFlowCells;
+		
+		int minLengths[FLOW_BLOCK];
+		int maxLength = 0;
+		for(int k=0;k<FLOW_BLOCK;k++){
+			int seqB = data->blockSeqs[block * FLOW_BLOCK + k];
+			minLengths[k] = lengths[mapSeqToUnique[seqA]];
+			if(lengths[seqB] < minLengths[k]){	minLengths[k] = lengths[mapSeqToUnique[seqB]];	}
+			if(minLengths[k] > maxLength){	maxLength = minLengths[k];	}
+		}
+		
+		const short* flowAIntI = &flowDataIntI[seqA * numFlowCells];
+		const double* flowAPrI = &flowDataPrI[seqA * numFlowCells];
+		const short* flowBIntI = &data->blockIntI[block * numFlowCells * FLOW_BLOCK];
+		const float* flowBPrI = &data->blockPrI[block * numFlowCells * FLOW_BLOCK];
+		const double* joint = &jointLookUp[0];
+		
+		float dist[FLOW_BLOCK];
+		for(int k=0;k<FLOW_BLOCK;k++){ dist[k] = 0; }
+		
+		for(int i=0;i<maxLength;i++){
+			const double* jointRow = joint + flowAIntI[i] * NUMBINS;
+			float prA = flowAPrI[i];
+			
+			//no branches in the lanes so the compiler can vectorize them, the flowgrams past their length are masked out
+			for(int k=0;k<FLOW_BLOCK;k++){
+				float summed = dist[k] + (jointRow[flowBIntI[k]] - prA - flowBPrI[k]);
+				dist[k] = (i < minLengths[k]) ? summed : dist[k];
+			}
+			flowBIntI += FLOW_BLOCK;
+			flowBPrI += FLOW_BLOCK;
+		}
+		
+		for(int k=0;k<FLOW_BLOCK;k++){ blockDists[k] = dist[k] / (float) minLengths[k]; }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ShhherCommand", "calcPairwiseDistBlock");
+		exit(1);
+	}
+}
 
 /**************************************************************************************************/
 
@@ -2888,7 +2818,50 @@ int ShhherCommand::calcCentroidsDriver(int numOTUs,
 	
 	try{
 		
-		for(int i=0;i<numOTUs;i++){
+		//the otus are independent, each thread finds the centroids of the otus it takes from the queue
+		int numThreads = processors;
+		if (numThreads < 1) { numThreads = 1; }
+		
+		WorkQueue queue(numThreads);
+		for(int i=0;i<numOTUs;i++){ queue.push(i % numThreads, i); }
+		queue.close();
+		
+		vector<thread*> workers;
+		for(int i=0;i<numThreads;i++){
+			workers.push_back(new thread(&ShhherCommand::calcCentroidsWorker, this, i, &queue, ref(cumNumSeqs), ref(nSeqsPerOTU), ref(seqIndex), ref(change), ref(centroids), ref(singleTau), ref(mapSeqToUnique), ref(uniqueFlowgrams), ref(flowDataIntI), ref(lengths), numFlowCells, ref(seqNumber)));
+		}
+		for(int i=0;i<workers.size();i++){
+			workers[i]->join();
+			delete workers[i];
+		}
+        
+        return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ShhherCommand", "calcCentroidsDriver");
+		exit(1);	
+	}		
+}
+/**************************************************************************************************/
+
+void ShhherCommand::calcCentroidsWorker(int worker, WorkQueue* queue,
+                                          vector<int>& cumNumSeqs,
+                                          vector<int>& nSeqsPerOTU,
+                                          vector<int>& seqIndex,
+                                          vector<short>& change,
+                                          vector<int>& centroids,
+                                          vector<double>& singleTau,
+                                          vector<int>& mapSeqToUnique,
+                                          vector<short>& uniqueFlowgrams,
+                                          vector<short>& flowDataIntI,
+                                          vector<int>& lengths,
+                                          int numFlowCells,
+                                          vector<int>& seqNumber){
+	try{
+		
+		long long task;
+		while (queue->pop(worker, task)) {
+			int i = task;
 			
 			if (m->control_pressed) { break; }
 			
@@ -2953,11 +2926,9 @@ int ShhherCommand::calcCentroidsDriver(int numOTUs,
 				centroids[i] = -1;			
 			}
 		}
-        
-        return 0;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ShhherCommand", "calcCentroidsDriver");
+		m->errorOut(e, "ShhherCommand", "calcCentroidsWorker");
 		exit(1);	
 	}		
 }
@@ -3102,77 +3073,155 @@ int ShhherCommand::checkCentroids(int numOTUs, vector<int>& centroids, vector<do
 }
 /**************************************************************************************************/
 
-void ShhherCommand::calcNewDistances(int numSeqs, int numOTUs, vector<int>& nSeqsPerOTU, vector<double>& dist, 
+long long ShhherCommand::calcNewDistances(int numSeqs, int numOTUs, vector<int>& nSeqsPerOTU, vector<double>& dist, 
                                      vector<double>& weight, vector<short>& change, vector<int>& centroids,
                                      vector<vector<int> >& aaP,	vector<double>& singleTau, vector<vector<int> >& aaI,	
                                      vector<int>& seqNumber, vector<int>& seqIndex,
                                      vector<short>& uniqueFlowgrams,
-                                     vector<short>& flowDataIntI, int numFlowCells, vector<int>& lengths){
+                                     vector<short>& flowDataIntI, int numFlowCells, vector<int>& lengths,
+                                     vector<vector<int> >& seqOTUs, bool fullPass){
 	
 	try{
 		
+		//an otu at or below MIN_WEIGHT gets no tau, so only the active ones are looked at
+		vector<int> activeOTUs;
+		vector<int> changedOTUs;
+		for(int j=0;j<numOTUs;j++){
+			if(weight[j] > MIN_WEIGHT){
+				activeOTUs.push_back(j);
+				if(change[j] == 1){	changedOTUs.push_back(j);	}
+			}
+		}
+		
+		//the threads find the taus of ranges of sequences, then they are added to the otus in sequence order
+		int numThreads = processors;
+		if (numThreads < 1) { numThreads = 1; }
+		int numChunks = min(numSeqs, 8 * numThreads);
+		if (numChunks < 1) { numChunks = 1; }
+		
+		vector<int> chunkStarts(numChunks+1, 0);
+		for(int k=1;k<=numChunks;k++){ chunkStarts[k] = (int)((long long)numSeqs * k / numChunks); }
+		vector< vector<seqTau> > chunkTaus(numChunks);
+		vector<long long> chunkPairs(numChunks, 0);
+		
+		WorkQueue queue(numThreads);
+		for(int k=0;k<numChunks;k++){ queue.push(k % numThreads, k); }
+		queue.close();
+		
+		vector<thread*> workers;
+		for(int i=0;i<numThreads;i++){
+			workers.push_back(new thread(&ShhherCommand::calcNewDistancesWorker, this, i, &queue, ref(chunkStarts), ref(chunkTaus), ref(chunkPairs), ref(activeOTUs), ref(changedOTUs), ref(seqOTUs), fullPass, numOTUs, ref(dist), ref(weight), ref(change), ref(centroids), ref(uniqueFlowgrams), ref(flowDataIntI), numFlowCells, ref(lengths)));
+		}
+		for(int i=0;i<workers.size();i++){
+			workers[i]->join();
+			delete workers[i];
+		}
+		
 		int total = 0;
-		vector<double> newTau(numOTUs,0);
-		vector<double> norms(numSeqs, 0);
+		long long numPairs = 0;
 		nSeqsPerOTU.assign(numOTUs, 0);
         
-		for(int i=0;i<numSeqs;i++){
+		for(int k=0;k<numChunks;k++){
 			
 			if (m->control_pressed) { break; }
 			
-			int indexOffset = i * numOTUs;
-            
-			double offset = 1e8;
+			numPairs += chunkPairs[k];
 			
-			for(int j=0;j<numOTUs;j++){
-                
-				if(weight[j] > MIN_WEIGHT && change[j] == 1){
-					dist[indexOffset + j] = getDistToCentroid(centroids[j], i, lengths[i], uniqueFlowgrams, flowDataIntI, numFlowCells);
+			for(int t=0;t<chunkTaus[k].size();t++){
+				int j = chunkTaus[k][t].otu;
+				
+				int oldTotal = total;
+				
+				total++;
+				
+				singleTau.resize(total, 0);
+				seqNumber.resize(total, 0);
+				seqIndex.resize(total, 0);
+				
+				singleTau[oldTotal] = chunkTaus[k][t].tau;
+				
+				aaP[j][nSeqsPerOTU[j]] = oldTotal;
+				aaI[j][nSeqsPerOTU[j]] = chunkTaus[k][t].seq;
+				nSeqsPerOTU[j]++;
+			}
+		}
+        
+		return numPairs;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ShhherCommand", "calcNewDistances");
+		exit(1);	
+	}		
+}
+/**************************************************************************************************/
+//with sparse each sequence only looks at the otus it was close to last time and the otus whose centroids moved,
+//otherwise or on a full pass it looks at every active otu
+void ShhherCommand::calcNewDistancesWorker(int worker, WorkQueue* queue, vector<int>& chunkStarts, vector< vector<seqTau> >& chunkTaus, vector<long long>& chunkPairs,
+                                           vector<int>& activeOTUs, vector<int>& changedOTUs, vector<vector<int> >& seqOTUs, bool fullPass,
+                                           int numOTUs, vector<double>& dist, vector<double>& weight, vector<short>& change, vector<int>& centroids,
+                                           vector<short>& uniqueFlowgrams, vector<short>& flowDataIntI, int numFlowCells, vector<int>& lengths){
+	
+	try{
+		
+		vector<double> newTau(numOTUs,0);
+		vector<int> closeOTUs;
+		seqNoise noise;
+		long long task;
+		
+		while (queue->pop(worker, task)) {
+			
+			for(int i=chunkStarts[task];i<chunkStarts[task+1];i++){
+				
+				if (m->control_pressed) { break; }
+				
+				vector<int>* otus = &activeOTUs;
+				if (sparse && !fullPass) {
+					if (noise.getCloseOTUs(seqOTUs[i], weight, changedOTUs, closeOTUs) != 0) { otus = &closeOTUs; }
 				}
-                
-				if(weight[j] > MIN_WEIGHT && dist[indexOffset + j] < offset){
-					offset = dist[indexOffset + j];
+				int numLooked = otus->size();
+				chunkPairs[task] += numLooked;
+				
+				int indexOffset = i * numOTUs;
+	            
+				double offset = 1e8;
+				double norm = 0;
+				
+				for(int k=0;k<numLooked;k++){
+					int j = (*otus)[k];
+	                
+					if(change[j] == 1){
+						dist[indexOffset + j] = getDistToCentroid(centroids[j], i, lengths[i], uniqueFlowgrams, flowDataIntI, numFlowCells);
+					}
+	                
+					if(dist[indexOffset + j] < offset){
+						offset = dist[indexOffset + j];
+					}
 				}
-			}
-            
-			for(int j=0;j<numOTUs;j++){
-				if(weight[j] > MIN_WEIGHT){
+	            
+				for(int k=0;k<numLooked;k++){
+					int j = (*otus)[k];
 					newTau[j] = exp(sigma * (-dist[indexOffset + j] + offset)) * weight[j];
-					norms[i] += newTau[j];
+					norm += newTau[j];
 				}
-				else{
-					newTau[j] = 0.0;
+	            
+				for(int k=0;k<numLooked;k++){
+					newTau[(*otus)[k]] /= norm;
 				}
-			}
-            
-			for(int j=0;j<numOTUs;j++){
-				newTau[j] /= norms[i];
-			}
-            
-			for(int j=0;j<numOTUs;j++){
-				if(newTau[j] > MIN_TAU){
-					
-					int oldTotal = total;
-					
-					total++;
-					
-					singleTau.resize(total, 0);
-					seqNumber.resize(total, 0);
-					seqIndex.resize(total, 0);
-					
-					singleTau[oldTotal] = newTau[j];
-					
-					aaP[j][nSeqsPerOTU[j]] = oldTotal;
-					aaI[j][nSeqsPerOTU[j]] = i;
-					nSeqsPerOTU[j]++;
+	            
+				if (sparse) { seqOTUs[i].clear(); }
+				for(int k=0;k<numLooked;k++){
+					int j = (*otus)[k];
+					if(newTau[j] > MIN_TAU){
+						chunkTaus[task].push_back(seqTau(i, j, newTau[j]));
+					}
+					if(sparse && (newTau[j] > SPARSE_TAU)){	seqOTUs[i].push_back(j);	}
 				}
 			}
-            
 		}
         
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ShhherCommand", "calcNewDistances");
+		m->errorOut(e, "ShhherCommand", "calcNewDistancesWorker");
 		exit(1);	
 	}		
 }
@@ -18,6 +18,8 @@
 #include "sabundvector.hpp"
 #include "listvector.hpp"
 #include "cluster.hpp"
+#include "workqueue.h"
+#include "seqnoise.h"
 #include <cfloat>
 
 //**********************************************************************************************************************
@@ -28,8 +30,31 @@
 #define MIN_WEIGHT 0.1
 #define MIN_TAU 0.0001
 #define MIN_ITER 10
+#define FLOW_BLOCK 8
 //**********************************************************************************************************************
 
+//the flowgrams of the uniques interleaved FLOW_BLOCK at a time, so one flowgram is compared to a block of them at once.
+//flow cell c of unique u is at ((u / FLOW_BLOCK) * numFlowCells + c) * FLOW_BLOCK + u % FLOW_BLOCK
+struct flowDistData {
+	int numFlowCells;
+	vector<short> blockIntI;
+	vector<float> blockPrI;
+	vector<int> blockSeqs;			//the seq each unique in the blocks comes from
+	vector<int> chunkStarts;		//the threads take the rows chunkStarts[k] to chunkStarts[k+1]-1 as task k
+	vector<string> chunkDists;		//the distances found by task k
+	int begTime;
+	double begClock;
+};
+
+//a tau above MIN_TAU found by calcNewDistancesWorker, added to the otus in sequence order afterwards
+struct seqTau {
+	int seq;
+	int otu;
+	double tau;
+	seqTau(int s, int o, double t) : seq(s), otu(o), tau(t) {}
+};
+
+
 class ShhherCommand : public Command {
 	
 public:
@@ -57,7 +82,7 @@ private:
 		linePair(int i, int j) : start(i), end(j) {}
 	};
     
-	bool abort, large;
+	bool abort, large, sparse;
 	string outputDir, flowFileName, flowFilesFileName, lookupFileName, compositeFASTAFileName, compositeNamesFileName;
 
 	int processors, maxIters, largeSize;
@@ -71,21 +96,24 @@ private:
 	
     vector<string> parseFlowFiles(string);
     int driver(vector<string>, string, string);
-    int createProcesses(vector<string>);
     int getFlowData(string, vector<string>&, vector<int>&, vector<short>&, map<string, int>&, int&);
     int getUniques(int, int, vector<short>&, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<double>&, vector<short>&);
     int flowDistParentFork(int, string, int, vector<int>&, vector<int>&, vector<int>&, vector<double>&, vector<short>&);
     float calcPairwiseDist(int, int, int, vector<int>&, vector<int>&, vector<double>&, vector<short>&);
+    void calcPairwiseDistBlock(flowDistData*, int, int, vector<int>&, vector<int>&, vector<double>&, vector<short>&, float*);
+    void flowDistWorker(int, WorkQueue*, flowDistData*, vector<int>&, vector<int>&, vector<int>&, vector<double>&, vector<short>&);
     int createNamesFile(int, int, string, vector<string>&, vector<int>&, vector<int>&);
     int cluster(string, string, string);
     int getOTUData(int numSeqs, string,  vector<int>&, vector<int>&, vector<int>&, vector<vector<int> >&, vector<vector<int> >&, vector<int>&, vector<int>&,map<string, int>&);
     int calcCentroidsDriver(int numOTUs, vector<int>&, vector<int>&, vector<int>&, vector<short>&, vector<int>&, vector<double>&, vector<int>&, vector<short>&, vector<short>&, vector<int>&, int, vector<int>&);
+    void calcCentroidsWorker(int, WorkQueue*, vector<int>&, vector<int>&, vector<int>&, vector<short>&, vector<int>&, vector<double>&, vector<int>&, vector<short>&, vector<short>&, vector<int>&, int, vector<int>&);
     double getDistToCentroid(int, int, int, vector<short>&, vector<short>&, int);
     double getNewWeights(int, vector<int>&, vector<int>&, vector<double>&, vector<int>&, vector<double>&);
     
     double getLikelihood(int, int, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<double>&, vector<double>&);
     int checkCentroids(int, vector<int>&, vector<double>&);
-    void calcNewDistances(int, int, vector<int>& , vector<double>&,vector<double>& , vector<short>& change, vector<int>&,vector<vector<int> >&,	vector<double>&, vector<vector<int> >&, vector<int>&, vector<int>&, vector<short>&, vector<short>&, int, vector<int>&);
+    long long calcNewDistances(int, int, vector<int>& , vector<double>&,vector<double>& , vector<short>& change, vector<int>&,vector<vector<int> >&,	vector<double>&, vector<vector<int> >&, vector<int>&, vector<int>&, vector<short>&, vector<short>&, int, vector<int>&, vector<vector<int> >&, bool);
+    void calcNewDistancesWorker(int, WorkQueue*, vector<int>&, vector< vector<seqTau> >&, vector<long long>&, vector<int>&, vector<int>&, vector<vector<int> >&, bool, int, vector<double>&, vector<double>&, vector<short>&, vector<int>&, vector<short>&, vector<short>&, int, vector<int>&);
     int fill(int, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<vector<int> >&, vector<vector<int> >&);
     void setOTUs(int, int, vector<int>&, vector<int>&, vector<int>&, vector<int>&,
                  vector<int>&, vector<double>&, vector<double>&, vector<vector<int> >&, vector<vector<int> >&);
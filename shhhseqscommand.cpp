@@ -21,6 +21,7 @@ vector<string> ShhhSeqsCommand::setParameters(){
 		CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
 		CommandParameter psigma("sigma", "Number", "", "0.01", "", "", "","",false,false); parameters.push_back(psigma);
+		CommandParameter psparse("sparse", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(psparse);
 		
 		vector<string> myArray;
 		for (int i = 0; i < parameters.size(); i++) {	myArray.push_back(parameters[i].name);		}
@@ -36,12 +37,13 @@ string ShhhSeqsCommand::getHelpString(){
 	try {
 		string helpString = "";
 		helpString += "The shhh.seqs command reads a fasta and name file and ....\n";
-		helpString += "The shhh.seqs command parameters are fasta, name, group, sigma and processors.\n";
+		helpString += "The shhh.seqs command parameters are fasta, name, group, sigma, sparse and processors.\n";
 		helpString += "The fasta parameter allows you to enter the fasta file containing your sequences, and is required, unless you have a valid current fasta file. \n";
 		helpString += "The name parameter allows you to provide a name file associated with your fasta file. It is required. \n";
 		helpString += "The group parameter allows you to provide a group file.  When checking sequences, only sequences from the same group as the query sequence will be used as the reference. \n";
 		helpString += "The processors parameter allows you to specify how many processors you would like to use.  The default is 1. \n";
 		helpString += "The sigma parameter ....  The default is 0.01. \n";
+		helpString += "The sparse parameter allows you to only update the otus each sequence is close to while denoising, and all of them every " + toString(SPARSE_REFRESH) + " iterations. It is faster, but the results can differ slightly.  The default is F. \n";
 		helpString += "The shhh.seqs command should be in the following format: \n";
 		helpString += "shhh.seqs(fasta=yourFastaFile, name=yourNameFile) \n";
 		helpString += "Example: shhh.seqs(fasta=AD.align, name=AD.names) \n";
@@ -180,6 +182,9 @@ ShhhSeqsCommand::ShhhSeqsCommand(string option) {
 			string temp	= validParameter.validFile(parameters, "sigma", false);		if(temp == "not found"){	temp = "0.01"; }
 			m->mothurConvert(temp, sigma); 
 			sigma = 1/sigma;
+			
+			temp = validParameter.validFile(parameters, "sparse", false);		if(temp == "not found"){	temp = "F"; }
+			sparse = m->isTrue(temp);
             
 			temp = validParameter.validFile(parameters, "processors", false);	if (temp == "not found"){	temp = m->getProcessors();	}
 			m->setProcessors(temp);
@@ -619,6 +624,7 @@ int ShhhSeqsCommand::driver(seqNoise& noise,
 		vector<int> anI(numSeqs, 0);
 		vector<int> anN(numSeqs, 0);
 		vector<vector<int> > aanI = otuBySeqLookUp;
+		vector<vector<int> > seqOTUs(numSeqs);		//with sparse, the otus each sequence is close to
 		
 		while(numIters < minIter || ((maxDelta > minDelta) && (numIters < maxIter))){
 			
@@ -629,60 +635,15 @@ int ShhhSeqsCommand::driver(seqNoise& noise,
 			
 			noise.calcCentroids(anI, anP, change, centroids, cumCount, distances, seqFreq, otuFreq, tau); if (m->control_pressed) { return 0; }
 			noise.checkCentroids(weights, centroids); if (m->control_pressed) { return 0; }
-			 
-			otuFreq.assign(numOTUs, 0);
 			
-			int total = 0;
+			bool fullPass = (!sparse) || ((numIters % SPARSE_REFRESH) == 0);
+			long long numUpdated = noise.calcNewTaus(sigma, weights, change, centroids, distances, tau, otuBySeqLookUp, aanI, otuFreq, anP, anI, seqOTUs, sparse, fullPass);
+			if (m->control_pressed) { return 0; }
 			
-			for(int i=0;i<numSeqs;i++){
-				if (m->control_pressed) { return 0; }
-				
-				double offset = 1e6;
-				double norm = 0.0000;
-				double minWeight = 0.1;
-				vector<double> currentTau(numOTUs);
-				
-				for(int j=0;j<numOTUs;j++){
-					if (m->control_pressed) { return 0; }
-					if(weights[j] > minWeight && distances[i * numSeqs+centroids[j]] < offset){
-						offset = distances[i * numSeqs+centroids[j]];
-					}
-				}
-				
-				for(int j=0;j<numOTUs;j++){
-					if (m->control_pressed) { return 0; }
-					if(weights[j] > minWeight){
-						currentTau[j] = exp(sigma * (-distances[(i * numSeqs + centroids[j])] + offset)) * weights[j];
-						norm += currentTau[j];
-					}
-					else{
-						currentTau[j] = 0.0000;
-					}
-				}			
-				
-				for(int j=0;j<numOTUs;j++){
-					if (m->control_pressed) { return 0; }
-					currentTau[j] /= norm;
-				}
-				
-				for(int j=0;j<numOTUs;j++){
-					if (m->control_pressed) { return 0; }
-					
-					if(currentTau[j] > 1.0e-4){
-						int oldTotal = total;
-						total++;
-						
-						tau.resize(oldTotal+1);
-						tau[oldTotal] = currentTau[j];
-						otuBySeqLookUp[j][otuFreq[j]] = oldTotal;
-						aanI[j][otuFreq[j]] = i;
-						otuFreq[j]++;
-						
-					}
-				}
-				
-				anP.resize(total);
-				anI.resize(total);
+			if (m->debug) {
+				int numActive = 0; int numChanged = 0;
+				for(int j=0;j<numOTUs;j++){ if(weights[j] > 0.1){ numActive++; if(change[j] == 1){ numChanged++; } } }
+				m->mothurOut("[DEBUG]: iter " + toString(numIters+1) + " maxDelta = " + toString(maxDelta) + " active otus = " + toString(numActive) + " changed centroids = " + toString(numChanged) + " updated taus = " + toString(numUpdated) + "\n");
 			}
 			
 			numIters++;
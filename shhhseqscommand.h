@@ -47,7 +47,7 @@ private:
 		linePair(int i, int j) : start(i), end(j) {}
 	};
 	
-	bool abort;
+	bool abort, sparse;
 	string outputDir, fastafile, namefile, groupfile;
 	int processors;
 	double sigma;
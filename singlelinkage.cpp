@@ -21,8 +21,8 @@ string SingleLinkage::getTag() {
 void SingleLinkage::update(double& cutOFF){
 	try {
 		smallCol = dMatrix->getSmallestCell(smallRow);
-        nColCells = dMatrix->seqVec[smallCol].size();
-        nRowCells = dMatrix->seqVec[smallRow].size();	
+        nColCells = dMatrix->getNumCells(smallCol);
+        nRowCells = dMatrix->getNumCells(smallRow);	
 	
 		vector<bool> deleted(nRowCells, false);
 		int rowInd;
@@ -32,16 +32,15 @@ void SingleLinkage::update(double& cutOFF){
 		// The vector has to be traversed in reverse order to preserve the index
 		// for faster removal in removeCell()
 		for (int i=nRowCells-1;i>=0;i--) {
-                if (dMatrix->seqVec[smallRow][i].index == smallCol) {
+                if (dMatrix->getIndex(smallRow, i) == smallCol) {
                     rowInd = i;   // The index of the smallest distance cell in rowCells
                 } else {
-                    search = dMatrix->seqVec[smallRow][i].index;
+                    search = dMatrix->getIndex(smallRow, i);
                     
                     for (int j=0;j<nColCells;j++) {
-                        if (dMatrix->seqVec[smallCol][j].index != smallRow) { //if you are not the small cell
-                            if (dMatrix->seqVec[smallCol][j].index == search) {
-                                changed = updateDistance(dMatrix->seqVec[smallCol][j], dMatrix->seqVec[smallRow][i]);
-                                dMatrix->updateCellCompliment(smallCol, j);
+                        if (dMatrix->getIndex(smallCol, j) != smallRow) { //if you are not the small cell
+                            if (dMatrix->getIndex(smallCol, j) == search) {
+                                changed = updateCell(j, i);
                                 dMatrix->rmCell(smallRow, i);
                                 deleted[i] = true;
                                 break;
@@ -50,19 +49,17 @@ void SingleLinkage::update(double& cutOFF){
                     }
                     if (!deleted[i]) {
                         // Assign the cell to the new cluster 
-                        // remove the old cell from seqVec and add the cell
+                        // remove the old cell from the matrix and add the cell
                         // with the new row and column assignment again
-                        float distance =  dMatrix->seqVec[smallRow][i].dist;
+                        float distance =  dMatrix->getDist(smallRow, i);
                         dMatrix->rmCell(smallRow, i);
                         if (search < smallCol){
                             PDistCell value(smallCol, distance);
-                            dMatrix->addCell(search, value);
+                            dMatrix->addCellSorted(search, value);
                         } else {
                             PDistCell value(search, distance);
-                            dMatrix->addCell(smallCol, value);
+                            dMatrix->addCellSorted(smallCol, value);
                         }
-                        sort(dMatrix->seqVec[smallCol].begin(), dMatrix->seqVec[smallCol].end(), compareIndexes);
-                        sort(dMatrix->seqVec[search].begin(), dMatrix->seqVec[search].end(), compareIndexes); 
                     }
                 }
 		}
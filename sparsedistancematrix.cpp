@@ -11,7 +11,12 @@
 
 /***********************************************************************/
 
-SparseDistanceMatrix::SparseDistanceMatrix() : numNodes(0), smallDist(1e6){  m = MothurOut::getInstance(); sorted=false; aboveCutoff = 1e6; }
+//number of cells in each chunk, rows bigger than this get a chunk of their own
+static const ull distChunkSize = 1048576;
+
+/***********************************************************************/
+
+SparseDistanceMatrix::SparseDistanceMatrix() : numNodes(0), smallDist(1e6){  m = MothurOut::getInstance(); sorted=false; aboveCutoff = 1e6; chunkUsed = 0; deadCells = 0; liveCells = 0; }
 
 /***********************************************************************/
 
@@ -21,29 +26,171 @@ int SparseDistanceMatrix::getNNodes(){
 /***********************************************************************/
 
 void SparseDistanceMatrix::clear(){
-    for (int i = 0; i < seqVec.size(); i++) {  seqVec[i].clear();  }
-    seqVec.clear();
+    rows.clear();
+    clearChunks();
+    heap.clear();
+    sorted = false;
 }
+/***********************************************************************/
 
+void SparseDistanceMatrix::clearChunks(){
+    for (int i = 0; i < indexChunks.size(); i++) { delete[] indexChunks[i]; delete[] distChunks[i]; }
+    indexChunks.clear();
+    distChunks.clear();
+    chunkSizes.clear();
+    freeBlocks.clear();
+    chunkUsed = 0; deadCells = 0; liveCells = 0;
+}
+/***********************************************************************/
+
+void SparseDistanceMatrix::resize(ull n){
+	try {
+        //column indexes are stored as unsigned ints to save space
+        if (n > numeric_limits<unsigned int>::max()) { m->mothurOut("[ERROR]: too many sequences for a sparse distance matrix, quitting.\n"); m->control_pressed = true; return; }
+        
+        rows.resize(n);
+    }
+	catch(exception& e) {
+		m->errorOut(e, "SparseDistanceMatrix", "resize");
+		exit(1);
+	}
+}
 /***********************************************************************/
 
 float SparseDistanceMatrix::getSmallDist(){
 	return smallDist;
 }
 /***********************************************************************/
+//returns the free list for blocks of this capacity, or -1 if the capacity is not a power of two
+int SparseDistanceMatrix::freeBlockBin(ull capacity){
+	try {
+        if ((capacity == 0) || ((capacity & (capacity-1)) != 0)) { return -1; }
+        
+        int bin = 0;
+        while (capacity > 1) { capacity >>= 1; bin++; }
+        
+        if (freeBlocks.size() <= bin) { freeBlocks.resize(bin+1); }
+        
+        return bin;
+    }
+	catch(exception& e) {
+		m->errorOut(e, "SparseDistanceMatrix", "freeBlockBin");
+		exit(1);
+	}
+}
+/***********************************************************************/
+//moves the row to a block of the given size, the old block becomes a dead block
+int SparseDistanceMatrix::allocateRow(ull row, ull capacity){
+	try {
+        PDistRow& thisRow = rows[row];
+        
+        PDistRow newBlock;
+        newBlock.capacity = capacity;
+        
+        if (capacity != 0) {
+            int bin = freeBlockBin(capacity);
+            
+            if ((bin != -1) && (freeBlocks[bin].size() != 0)) { //reuse a dead block
+                newBlock = freeBlocks[bin].back();
+                freeBlocks[bin].pop_back();
+                deadCells -= capacity;
+            }else {
+                if ((indexChunks.size() == 0) || ((chunkUsed + capacity) > chunkSizes.back())) {
+                    if (indexChunks.size() != 0) { deadCells += (chunkSizes.back() - chunkUsed); } //unused end of the last chunk
+                    
+                    ull thisChunkSize = distChunkSize;
+                    if (capacity > thisChunkSize) { thisChunkSize = capacity; }
+                    
+                    indexChunks.push_back(new unsigned int[thisChunkSize]);
+                    distChunks.push_back(new float[thisChunkSize]);
+                    chunkSizes.push_back(thisChunkSize);
+                    chunkUsed = 0;
+                }
+                
+                newBlock.index = indexChunks.back() + chunkUsed;
+                newBlock.dist = distChunks.back() + chunkUsed;
+                chunkUsed += capacity;
+            }
+            
+            ull numToCopy = thisRow.size;
+            if (capacity < numToCopy) { numToCopy = capacity; }
+            for (int i = 0; i < numToCopy; i++) { newBlock.index[i] = thisRow.index[i]; newBlock.dist[i] = thisRow.dist[i]; }
+        }
+        
+        if (thisRow.capacity != 0) {
+            deadCells += thisRow.capacity;
+            int bin = freeBlockBin(thisRow.capacity);
+            if (bin != -1) { PDistRow oldBlock = thisRow; oldBlock.size = 0; freeBlocks[bin].push_back(oldBlock); }
+        }
+        liveCells -= thisRow.capacity;
+        liveCells += capacity;
+        
+        thisRow.index = newBlock.index;
+        thisRow.dist = newBlock.dist;
+        thisRow.capacity = capacity;
+        if (thisRow.size > capacity) { thisRow.size = capacity; }
+        
+        return 0;
+    }
+	catch(exception& e) {
+		m->errorOut(e, "SparseDistanceMatrix", "allocateRow");
+		exit(1);
+	}
+}
+/***********************************************************************/
+//copies the rows to new chunks without the dead blocks, the order of the cells in each row does not change
+int SparseDistanceMatrix::compact(){
+	try {
+        //keep the old chunks until all the rows are copied
+        vector<unsigned int*> oldIndexChunks; oldIndexChunks.swap(indexChunks);
+        vector<float*> oldDistChunks; oldDistChunks.swap(distChunks);
+        chunkSizes.clear();
+        freeBlocks.clear();
+        chunkUsed = 0; deadCells = 0; liveCells = 0;
+        
+        for (int i = 0; i < rows.size(); i++) {
+            rows[i].capacity = 0;
+            if (rows[i].size == 0) { rows[i] = PDistRow(); }
+            else { allocateRow(i, rows[i].size); }
+        }
+        
+        for (int i = 0; i < oldIndexChunks.size(); i++) { delete[] oldIndexChunks[i]; delete[] oldDistChunks[i]; }
+        
+        return 0;
+    }
+	catch(exception& e) {
+		m->errorOut(e, "SparseDistanceMatrix", "compact");
+		exit(1);
+	}
+}
+/***********************************************************************/
+
+void SparseDistanceMatrix::reserve(ull row, ull n){
+	try {
+        if (n > rows[row].capacity) { allocateRow(row, n); }
+    }
+	catch(exception& e) {
+		m->errorOut(e, "SparseDistanceMatrix", "reserve");
+		exit(1);
+	}
+}
+/***********************************************************************/
 
 int SparseDistanceMatrix::updateCellCompliment(ull row, ull col){
     try {
         
-        ull vrow = seqVec[row][col].index;
+        ull vrow = rows[row].index[col];
         ull vcol = 0;
         
         //find the columns entry for this cell as well
-        for (int i = 0; i < seqVec[vrow].size(); i++) {  
-            if (seqVec[vrow][i].index == row) { vcol = i;  break; }  
+        for (int i = 0; i < rows[vrow].size; i++) {  
+            if (rows[vrow].index[i] == row) { vcol = i;  break; }  
         }
        
-        seqVec[vrow][vcol].dist = seqVec[row][col].dist;
+        rows[vrow].dist[vcol] = rows[row].dist[col];
+        
+        //the old entry for this cell is left in the heap and discarded when it reaches the top
+        if (sorted) { pushHeap(row, vrow, rows[row].dist[col]); }
         
         return 0;
     }
@@ -58,14 +205,25 @@ int SparseDistanceMatrix::rmCell(ull row, ull col){
 	try {
         numNodes-=2;
  
-        ull vrow = seqVec[row][col].index;
+        ull vrow = rows[row].index[col];
         ull vcol = 0;
         
         //find the columns entry for this cell as well
-        for (int i = 0; i < seqVec[vrow].size(); i++) {  if (seqVec[vrow][i].index == row) { vcol = i;  break; }  }
+        for (int i = 0; i < rows[vrow].size; i++) {  if (rows[vrow].index[i] == row) { vcol = i;  break; }  }
         
-        seqVec[vrow].erase(seqVec[vrow].begin()+vcol);
-        seqVec[row].erase(seqVec[row].begin()+col);
+        ull rmRows[2] = { vrow, row };
+        ull rmCols[2] = { vcol, col };
+        
+        for (int k = 0; k < 2; k++) {
+            PDistRow& thisRow = rows[rmRows[k]];
+            for (int i = rmCols[k]; i < (thisRow.size-1); i++) { thisRow.index[i] = thisRow.index[i+1]; thisRow.dist[i] = thisRow.dist[i+1]; }
+            thisRow.size--;
+            
+            //merged rows are emptied, so give their space back
+            if (thisRow.size == 0) { allocateRow(rmRows[k], 0); }
+        }
+        
+        if ((deadCells > liveCells) && (deadCells > distChunkSize)) { compact(); }
  
 		return(0);
     }
@@ -80,9 +238,21 @@ void SparseDistanceMatrix::addCell(ull row, PDistCell cell){
 		numNodes+=2;
 		if(cell.dist < smallDist){ smallDist = cell.dist; }
         
-        seqVec[row].push_back(cell);
-        PDistCell temp(row, cell.dist);
-        seqVec[cell.index].push_back(temp);
+        ull addRows[2] = { row, cell.index };
+        ull addIndexes[2] = { cell.index, row };
+        
+        for (int k = 0; k < 2; k++) {
+            PDistRow& thisRow = rows[addRows[k]];
+            if (thisRow.size == thisRow.capacity) { allocateRow(addRows[k], max((ull)4, (ull)(2*thisRow.capacity))); }
+            
+            thisRow.index[thisRow.size] = addIndexes[k];
+            thisRow.dist[thisRow.size] = cell.dist;
+            thisRow.size++;
+        }
+        
+        if ((deadCells > liveCells) && (deadCells > distChunkSize)) { compact(); }
+        
+        if (sorted) { pushHeap(row, cell.index, cell.dist); }
 	}
 	catch(exception& e) {
 		m->errorOut(e, "SparseDistanceMatrix", "addCell");
@@ -95,15 +265,27 @@ int SparseDistanceMatrix::addCellSorted(ull row, PDistCell cell){
 		numNodes+=2;
 		if(cell.dist < smallDist){ smallDist = cell.dist; }
         
-        seqVec[row].push_back(cell);
-        PDistCell temp(row, cell.dist);
-        seqVec[cell.index].push_back(temp);
+        ull addRows[2] = { row, cell.index };
+        ull addIndexes[2] = { cell.index, row };
+        int location = -1; //find location of new cell when sorted
         
-        sortSeqVec(row);
-        sortSeqVec(cell.index);
+        //rows are already sorted by descending index, so insert the cell in place
+        for (int k = 0; k < 2; k++) {
+            PDistRow& thisRow = rows[addRows[k]];
+            if (thisRow.size == thisRow.capacity) { allocateRow(addRows[k], max((ull)4, (ull)(2*thisRow.capacity))); }
+            
+            int i = thisRow.size;
+            while ((i > 0) && (thisRow.index[i-1] < addIndexes[k])) { thisRow.index[i] = thisRow.index[i-1]; thisRow.dist[i] = thisRow.dist[i-1]; i--; }
+            thisRow.index[i] = addIndexes[k];
+            thisRow.dist[i] = cell.dist;
+            thisRow.size++;
+            
+            if (k == 0) { location = i; }
+        }
         
-        int location = -1; //find location of new cell when sorted
-        for (int i = 0; i < seqVec[row].size(); i++) {  if (seqVec[row][i].index == cell.index) { location = i; break; } }
+        if ((deadCells > liveCells) && (deadCells > distChunkSize)) { compact(); }
+        
+        if (sorted) { pushHeap(row, cell.index, cell.dist); }
         
         return location;
 	}
@@ -117,39 +299,26 @@ int SparseDistanceMatrix::addCellSorted(ull row, PDistCell cell){
 
 ull SparseDistanceMatrix::getSmallestCell(ull& row){
 	try {
-        if (!sorted) { sortSeqVec(); sorted = true; }
+        //the rows are done growing once clustering starts, so pack them before the heap is built
+        if (!sorted) { compact(); sortSeqVec(); buildHeap(); sorted = true; }
+        //numNodes counts each distance twice, so at least half the heap is stale entries
+        else if (heap.size() > ((ull)numNodes + 1000)) { buildHeap(); }
         
-        vector<PDistCellMin> mins;
-        smallDist = 1e6;
-       
-        for (int i = 0; i < seqVec.size(); i++) {
-            for (int j = 0; j < seqVec[i].size(); j++) {
-                
-                if (m->control_pressed) { return smallDist; }
-                
-                //already checked everyone else in row
-                if (i < seqVec[i][j].index) {  
-			    
-                    float dist = seqVec[i][j].dist;
-                  
-                    if(dist < smallDist){  //found a new smallest distance
-                        mins.clear();
-                        smallDist = dist;
-                        PDistCellMin temp(i, seqVec[i][j].index);
-                        mins.push_back(temp);  
-                    }
-                    else if(dist == smallDist){  //if a subsequent distance is the same as mins distance add the new iterator to the mins vector
-                        PDistCellMin temp(i, seqVec[i][j].index);
-                        mins.push_back(temp); 
-                    }
-                }else { j+=seqVec[i].size(); } //stop looking 
-			}
-		}
-        
-		//random_shuffle(mins.begin(), mins.end());  //randomize the order of the iterators in the mins vector
-        
-        row = mins[0].row;
-        ull col = mins[0].col;
+        //remove the entries for cells that have been removed or changed since they were added
+        while (heap.size() != 0) {
+            if (m->control_pressed) { return smallDist; }
+            
+            if (isCurrent(heap.front())) { break; }
+            
+            pop_heap(heap.begin(), heap.end(), compareHeapCells);
+            heap.pop_back();
+        }
+        
+        if (heap.size() == 0) { smallDist = 1e6; row = 0; return 0; }
+        
+        smallDist = heap.front().dist;
+        row = heap.front().row;
+        ull col = heap.front().col;
 
 		return col;
 	}
@@ -160,11 +329,72 @@ ull SparseDistanceMatrix::getSmallestCell(ull& row){
 }
 /***********************************************************************/
 
+int SparseDistanceMatrix::buildHeap(){
+	try {
+        heap.clear();
+        heap.reserve(numNodes/2);
+        
+        for (int i = 0; i < rows.size(); i++) {
+            for (int j = 0; j < rows[i].size; j++) {
+                //only add the upper half, the other half is the same cell
+                if (i < rows[i].index[j]) { heap.push_back(PDistCellMin(i, rows[i].index[j], rows[i].dist[j])); }
+            }
+        }
+        
+        make_heap(heap.begin(), heap.end(), compareHeapCells);
+        
+        return 0;
+    }
+	catch(exception& e) {
+		m->errorOut(e, "SparseDistanceMatrix", "buildHeap");
+		exit(1);
+	}
+}
+/***********************************************************************/
+
+void SparseDistanceMatrix::pushHeap(ull row, ull col, float dist){
+	try {
+        if (row < col) { heap.push_back(PDistCellMin(row, col, dist)); }
+        else { heap.push_back(PDistCellMin(col, row, dist)); }
+        
+        push_heap(heap.begin(), heap.end(), compareHeapCells);
+    }
+	catch(exception& e) {
+		m->errorOut(e, "SparseDistanceMatrix", "pushHeap");
+		exit(1);
+	}
+}
+/***********************************************************************/
+//is the cell still in the matrix with this distance
+bool SparseDistanceMatrix::isCurrent(PDistCellMin& cell){
+	try {
+        PDistRow& thisRow = rows[cell.row];
+        
+        //rows are sorted by descending index, so binary search for the column
+        int low = 0; int high = thisRow.size;
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+            if (thisRow.index[mid] > cell.col) { low = mid + 1; }
+            else { high = mid; }
+        }
+        
+        if (low == thisRow.size) { return false; }
+        if (thisRow.index[low] != cell.col) { return false; }
+        
+        return (thisRow.dist[low] == cell.dist);
+    }
+	catch(exception& e) {
+		m->errorOut(e, "SparseDistanceMatrix", "isCurrent");
+		exit(1);
+	}
+}
+/***********************************************************************/
+
 int SparseDistanceMatrix::sortSeqVec(){
 	try {
         
         //saves time in getSmallestCell, by making it so you dont search the repeats
-        for (int i = 0; i < seqVec.size(); i++) {  sort(seqVec[i].begin(), seqVec[i].end(), compareIndexes); }
+        for (int i = 0; i < rows.size(); i++) {  sortSeqVec(i); }
     
         return 0;
     }
@@ -179,7 +409,14 @@ int SparseDistanceMatrix::sortSeqVec(int index){
 	try {
         
         //saves time in getSmallestCell, by making it so you dont search the repeats
-        sort(seqVec[index].begin(), seqVec[index].end(), compareIndexes);
+        PDistRow& thisRow = rows[index];
+        
+        vector<PDistCell> cells(thisRow.size);
+        for (int i = 0; i < thisRow.size; i++) { cells[i].index = thisRow.index[i]; cells[i].dist = thisRow.dist[i]; }
+        
+        sort(cells.begin(), cells.end(), compareIndexes);
+        
+        for (int i = 0; i < thisRow.size; i++) { thisRow.index[i] = cells[i].index; thisRow.dist[i] = cells[i].dist; }
         
         return 0;
     }
@@ -18,19 +18,43 @@ class ListVector;
 
 /* For each distance in a sparse matrix we have a row, column and distance.  
  The PDistCell consists of the column and distance.
- We know the row by the distances row in the seqVec matrix.  
- SeqVec is square and each row is sorted so the column values are ascending to save time in the search for the smallest distance. */
+ We know the row by the distances row in the matrix.  
+ SeqVec is square and each row is sorted so the column values are ascending to save time in the search for the smallest distance. 
+ 
+ The rows are stored as blocks in large chunks of memory instead of a vector per row, with the column indexes and distances kept in separate
+ arrays so each distance takes 8 bytes instead of 16. A row that outgrows its block is moved to a new block twice the size and the old block
+ is left behind as a dead block, which is reused by the next row that needs a block that size. Rows that are emptied by a merge release their
+ block the same way, and the chunks are compacted once the dead blocks take up more room than the rows still in use. 
+ 
+ The smallest distance is found with a min-heap of (dist, row, col) entries where row < col. Entries are pushed by addCell, addCellSorted 
+ and updateCellCompliment and are not removed when a cell changes or is removed, instead getSmallestCell discards entries that no longer
+ match the matrix. Ties go to the lowest row and then the highest column, the first cell a search through the sorted rows would find. */
 
 /***********************************************************************/
 struct PDistCellMin{
-	ull row;
-    ull col;
+	unsigned int row;
+    unsigned int col;
+    float dist;
 	//PDistCell* cell;
-	PDistCellMin(ull r, ull c) :  col(c), row(r) {}
+	PDistCellMin(ull r, ull c) :  col(c), row(r), dist(0) {}
+    PDistCellMin(ull r, ull c, float d) :  col(c), row(r), dist(d) {}
+};
+/***********************************************************************/
+//sorts the heap so the smallest distance is on top, ties go to the lowest row and then the highest column
+inline bool compareHeapCells(const PDistCellMin& left, const PDistCellMin& right){
+    if (left.dist != right.dist) { return (left.dist > right.dist); }
+    if (left.row != right.row) { return (left.row > right.row); }
+	return (left.col < right.col);	
+} 
+/***********************************************************************/
+struct PDistRow{
+	unsigned int* index;
+    float* dist;
+    unsigned int size;
+    unsigned int capacity;
+	PDistRow() :  index(NULL), dist(NULL), size(0), capacity(0) {}
 };
 /***********************************************************************/
-
-
 
 class SparseDistanceMatrix {
 	
@@ -43,11 +67,18 @@ public:
 	
 	int rmCell(ull, ull);
     int updateCellCompliment(ull, ull);
-    void resize(ull n) { seqVec.resize(n);  }
+    void resize(ull);
     void clear();
 	void addCell(ull, PDistCell);
     int addCellSorted(ull, PDistCell);
-    vector<vector<PDistCell> > seqVec;
+    void reserve(ull, ull);                 //make room for this many cells in the row
+    
+    ull getNumRows()                    { return rows.size();               }
+    ull getNumCells(ull row)            { return rows[row].size;            }
+    ull getIndex(ull row, ull col)      { return rows[row].index[col];      }
+    float getDist(ull row, ull col)     { return rows[row].dist[col];       }
+    PDistCell getCell(ull row, ull col) { return PDistCell(rows[row].index[col], rows[row].dist[col]); }
+    void setDist(ull row, ull col, float d) { rows[row].dist[col] = d;      }
     
     
 private:
@@ -57,6 +88,22 @@ private:
     bool sorted;
     int sortSeqVec();
     int sortSeqVec(int);
+    
+    vector<PDistRow> rows;
+    vector<unsigned int*> indexChunks;
+    vector<float*> distChunks;
+    vector<ull> chunkSizes;
+    vector< vector<PDistRow> > freeBlocks;  //dead blocks that can be reused, by power of two capacity
+    ull chunkUsed, deadCells, liveCells;    //cells used in the last chunk, cells in dead blocks and cells in row blocks
+    int allocateRow(ull, ull);
+    int freeBlockBin(ull);
+    int compact();
+    void clearChunks();
+    
+    vector<PDistCellMin> heap;
+    int buildHeap();
+    void pushHeap(ull, ull, float);
+    bool isCurrent(PDistCellMin&);
 	float smallDist, aboveCutoff;
     
 	MothurOut* m;
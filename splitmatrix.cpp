@@ -11,6 +11,7 @@
 #include "phylotree.h"
 #include "distancecommand.h"
 #include "seqsummarycommand.h"
+#include "binarydist.h"
 
 /***********************************************************************/
 
@@ -188,7 +189,7 @@ int SplitMatrix::createDistanceFilesFromTax(map<string, int>& seqGroup, int numG
 			
 			string options = "";
             if (classic) { options = "fasta=" + (fastafile + "." + toString(i) + ".temp") + ", processors=" + toString(processors) + ", output=lt"; }
-            else { options = "fasta=" + (fastafile + "." + toString(i) + ".temp") + ", processors=" + toString(processors) + ", cutoff=" + toString(distCutoff); }
+            else { options = "fasta=" + (fastafile + "." + toString(i) + ".temp") + ", processors=" + toString(processors) + ", cutoff=" + toString(distCutoff) + ", output=binary"; }
 			if (outputDir != "") { options += ", outputdir=" + outputDir; }
 			
             m->mothurOut("/******************************************/"); m->mothurOutEndLine(); 
@@ -215,7 +216,7 @@ int SplitMatrix::createDistanceFilesFromTax(map<string, int>& seqGroup, int numG
             if (outputDir == "") { outputDir = m->hasPath(fastafile); }
             string tempDistFile = "";
             if (classic) { tempDistFile =  outputDir + m->getRootName(m->getSimpleName((fastafile + "." + toString(i) + ".temp"))) + "phylip.dist";}
-            else { tempDistFile = outputDir + m->getRootName(m->getSimpleName((fastafile + "." + toString(i) + ".temp"))) + "dist"; }
+            else { tempDistFile = outputDir + m->getRootName(m->getSimpleName((fastafile + "." + toString(i) + ".temp"))) + "dist.bin"; }
             tempDistFiles.push_back(tempDistFile);
         }
         
@@ -648,7 +649,9 @@ int SplitMatrix::splitNames(map<string, int>& seqGroup, int numGroups, vector<st
             fileHandle.open(tempDistFile.c_str());
             if(fileHandle) 	{	
                 m->gobble(fileHandle);
-                if (!fileHandle.eof()) {  //check
+                bool empty = fileHandle.eof();
+                if (!empty && BinaryDistReader::isBinary(tempDistFile)) { BinaryDistReader reader(tempDistFile); empty = (reader.getNumDists() == 0); }
+                if (!empty) {  //check
 				map<string, string> temp;
                 if (countfile != "") {
                     //add header
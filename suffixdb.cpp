@@ -67,7 +67,7 @@ vector<int> SuffixDB::findClosestSequences(Sequence* candidateSeq, int num){
 }
 /**************************************************************************************************/
 //adding the sequences generates the db
-void SuffixDB::addSequence(Sequence seq) {
+void SuffixDB::addSequence(const Sequence& seq) {
 	try {
 		suffixForest[count].loadSequence(seq);		
 		count++;
@@ -30,7 +30,7 @@ public:
 	~SuffixDB();
 	
 	void generateDB() {}; //adding sequences generates the db
-	void addSequence(Sequence);
+	void addSequence(const Sequence&);
 	vector<int> findClosestSequences(Sequence*, int);
 
 private:
@@ -46,7 +46,7 @@ SuffixTree::~SuffixTree(){
 
 //********************************************************************************************************************
 
-void SuffixTree::loadSequence(Sequence seq){
+void SuffixTree::loadSequence(const Sequence& seq){
 	nodeCounter = 0;							//	initially there are 0 nodes in the tree
 	activeStartPosition = 0;
 	activeEndPosition = -1;						
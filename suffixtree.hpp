@@ -37,7 +37,7 @@ public:
 	SuffixTree();
 	~SuffixTree();
 
-	void loadSequence(Sequence);
+	void loadSequence(const Sequence&);
 	string getSeqName();
 	void print();	
 	int countSuffixes(string, int&);
@@ -265,7 +265,7 @@ int SummaryQualCommand::driverCreateSummary(vector<int>& position, vector<int>&
 		ifstream in;
 		m->openInputFile(filename, in);
 		
-		in.seekg(filePos.start);
+		if (filePos.start != 0) { in.seekg(filePos.start); }
 		
 		bool done = false;
 		int count = 0;
@@ -310,8 +310,7 @@ int SummaryQualCommand::driverCreateSummary(vector<int>& position, vector<int>&
 			}
 			
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-			unsigned long long pos = in.tellg();
-			if ((pos == -1) || (pos >= filePos.end)) { break; }
+			if (m->endOfPart(in, filePos.end)) { break; }
 #else
 			if (in.eof()) { break; }
 #endif
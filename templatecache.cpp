@@ -0,0 +1,218 @@
+//
+//  templatecache.cpp
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+#include "templatecache.h"
+
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+	#include <sys/mman.h>
+	#include <fcntl.h>
+#endif
+
+static const char templateCacheMagic[8] = { 'M', 'T', 'H', 'R', 'T', 'E', 'M', 'P' };
+static const unsigned int templateCacheVersion = 1;
+
+/**************************************************************************************************/
+TemplateCache::TemplateCache(string fastaFile) {
+	try {
+		m = MothurOut::getInstance();
+		fastaFileName = fastaFile;
+		cacheFileName = fastaFileName + ".template.cache";
+		numSeqs = 0; longest = 0; alignedLength = 0;
+		mappedData = NULL; mappedSize = 0; offsets = NULL; data = NULL;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "TemplateCache", "TemplateCache");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+TemplateCache::~TemplateCache() {
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+	if (mappedData != NULL) { munmap(mappedData, mappedSize); }
+#endif
+}
+/**************************************************************************************************/
+//size and modification time of the fasta file
+bool TemplateCache::getFastaInfo(unsigned long long& size, long long& modified) {
+	try {
+		struct stat info;
+		if (stat(fastaFileName.c_str(), &info) == -1) { return false; }
+		size = info.st_size;
+		modified = info.st_mtime;
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "TemplateCache", "getFastaInfo");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+bool TemplateCache::read() {
+	try {
+		unsigned long long fastaSize; long long fastaTime;
+		if (!getFastaInfo(fastaSize, fastaTime)) { return false; }
+
+		ifstream in(cacheFileName.c_str(), ios::binary);
+		if (!in) { return false; }
+		string line = m->getline(in);
+
+		unsigned long long headerOffset = line.length() + 1;
+		while ((headerOffset % 8) != 0) { headerOffset++; }
+
+		templateCacheHeader header;
+		in.seekg(headerOffset);
+		in.read((char*)&header, sizeof(templateCacheHeader));
+		bool good = (in.gcount() == sizeof(templateCacheHeader));
+		in.close();
+
+		if (!good) { return false; }
+		if (memcmp(header.magic, templateCacheMagic, 8) != 0) { return false; }
+		if ((header.version != templateCacheVersion) || (header.fastaSize != fastaSize) || (header.fastaTime != fastaTime)) { return false; }
+
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+		int fd = open(cacheFileName.c_str(), O_RDONLY);
+		if (fd == -1) { return false; }
+		struct stat info;
+		if (fstat(fd, &info) == -1) { ::close(fd); return false; }
+		mappedSize = info.st_size;
+		if (mappedSize < (header.dataOffset + header.dataSize)) { ::close(fd); return false; }
+		void* mapped = mmap(NULL, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (mapped == MAP_FAILED) { mappedSize = 0; return false; }
+		mappedData = (char*)mapped;
+#else
+		in.clear();
+		in.open(cacheFileName.c_str(), ios::binary);
+		in.seekg(0, ios::end);
+		mappedSize = in.tellg();
+		in.seekg(0, ios::beg);
+		if (mappedSize < (header.dataOffset + header.dataSize)) { in.close(); return false; }
+		buffer.resize(mappedSize);
+		in.read(&buffer[0], mappedSize);
+		in.close();
+		mappedData = &buffer[0];
+#endif
+
+		//a damaged cache is remade from the fasta file, so every offset must point inside data before any are used
+		const unsigned long long* fileOffsets = (const unsigned long long*)(mappedData + header.offsetsOffset);
+		bool valid = (header.numSeqs < (mappedSize / 16)) && ((header.offsetsOffset + (2*header.numSeqs+1) * sizeof(unsigned long long)) <= header.dataOffset);
+		for (unsigned long long i = 0; valid && (i < (2*header.numSeqs+1)); i++) {
+			if ((fileOffsets[i] > header.dataSize) || ((i != 0) && (fileOffsets[i] < fileOffsets[i-1]))) { valid = false; }
+		}
+		if (!valid) {
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+			munmap(mappedData, mappedSize);
+#else
+			buffer.clear();
+#endif
+			mappedData = NULL; mappedSize = 0;
+			return false;
+		}
+
+		offsets = fileOffsets;
+		data = mappedData + header.dataOffset;
+		numSeqs = header.numSeqs;
+		longest = header.longestBase;
+		alignedLength = header.alignedLength;
+
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "TemplateCache", "read");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void TemplateCache::write(vector<Sequence>& templates) {
+	try {
+		unsigned long long fastaSize; long long fastaTime;
+		if (!getFastaInfo(fastaSize, fastaTime)) { return; }
+
+		vector<unsigned long long> seqOffsets;
+		unsigned long long dataSize = 0;
+		unsigned long long maxBases = 0;
+		for (int i = 0; i < templates.size(); i++) {
+			seqOffsets.push_back(dataSize);		dataSize += templates[i].getName().length();
+			seqOffsets.push_back(dataSize);		dataSize += templates[i].getAligned().length();
+			if (templates[i].getUnaligned().length() > maxBases) { maxBases = templates[i].getUnaligned().length(); }
+		}
+		seqOffsets.push_back(dataSize);
+
+		//written to a temp file and renamed, so other processes never map a partly written cache.  The cache is only
+		//a speedup, so if the reference directory is not writable the templates are read from the fasta file next time.
+		string tempFileName = m->getFullPathName(cacheFileName + m->mothurGetpid(0) + ".temp");
+		ofstream out(tempFileName.c_str(), ios::trunc | ios::binary);
+		if (!out) { 
+			if (m->debug) { m->mothurOut("[DEBUG]: could not write the template cache " + cacheFileName + "\n"); }
+			return;
+		}
+
+		//output version
+		out << "#" << m->getVersion() << endl;
+
+		unsigned long long headerOffset = out.tellp();
+		while ((headerOffset % 8) != 0) { out.put(0); headerOffset++; }
+
+		templateCacheHeader header;
+		memcpy(header.magic, templateCacheMagic, 8);
+		header.version = templateCacheVersion;
+		header.alignedLength = 0;		//left 0 if the templates are not aligned
+		if (templates.size() != 0) { header.alignedLength = templates[0].getAligned().length(); }
+		for (int i = 0; i < templates.size(); i++) {
+			if (templates[i].getAligned().length() != header.alignedLength) { header.alignedLength = 0; break; }
+		}
+		header.numSeqs = templates.size();
+		header.longestBase = maxBases;
+		header.fastaSize = fastaSize;
+		header.fastaTime = fastaTime;
+		header.offsetsOffset = headerOffset + sizeof(templateCacheHeader);
+		header.dataOffset = header.offsetsOffset + seqOffsets.size() * sizeof(unsigned long long);
+		header.dataSize = dataSize;
+
+		out.write((char*)&header, sizeof(templateCacheHeader));
+		out.write((char*)&seqOffsets[0], seqOffsets.size() * sizeof(unsigned long long));
+		for (int i = 0; i < templates.size(); i++) {
+			out << templates[i].getName() << templates[i].getAligned();
+		}
+		out.close();
+		
+		//a full disk leaves the stream failed, don't replace the cache with a partial file
+		if (out.fail()) { 
+			if (m->debug) { m->mothurOut("[DEBUG]: could not write the template cache " + cacheFileName + "\n"); }
+			m->mothurRemove(tempFileName); 
+			return;
+		}
+		
+		if (rename(tempFileName.c_str(), cacheFileName.c_str()) != 0) { m->mothurRemove(tempFileName); }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "TemplateCache", "write");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+string TemplateCache::getName(int i) {
+	try {
+		return string(data + offsets[2*i], offsets[2*i+1] - offsets[2*i]);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "TemplateCache", "getName");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+Sequence TemplateCache::getSequence(int i) {
+	try {
+		string aligned(data + offsets[2*i+1], offsets[2*i+2] - offsets[2*i+1]);
+		return Sequence(getName(i), aligned);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "TemplateCache", "getSequence");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
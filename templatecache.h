@@ -0,0 +1,75 @@
+//
+//  templatecache.h
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+#ifndef Mothur_templatecache_h
+#define Mothur_templatecache_h
+
+#include "mothur.h"
+#include "sequence.hpp"
+
+/**************************************************************************************************/
+
+/* TemplateCache saves the aligned template sequences of a reference fasta file to a binary file next to it
+ (silva.bacteria.fasta -> silva.bacteria.fasta.template.cache) so later runs can memory map the templates instead of reading
+ the fasta file.  The mapping is read only and shared, so every mothur process on a machine using the same reference
+ shares one copy in the page cache, and a short run only touches the templates it actually uses.
+
+ The file starts with the mothur version line followed by:
+
+	templateCacheHeader	- padded to 8 bytes from the start of the file.  fastaSize and fastaTime are the size and
+						  modification time of the fasta file, the cache is remade if they change
+	offsets				- 2*numSeqs+1 unsigned 64 bit offsets into data, the name and aligned sequence of template i are
+						  between offsets 2i and 2i+1 and offsets 2i+1 and 2i+2
+	data				- the names and aligned sequences */
+
+struct templateCacheHeader {
+	char magic[8];
+	unsigned int version;
+	unsigned int alignedLength;
+	unsigned long long numSeqs;
+	unsigned long long longestBase;
+	unsigned long long fastaSize;
+	long long fastaTime;
+	unsigned long long offsetsOffset;
+	unsigned long long dataOffset;
+	unsigned long long dataSize;
+};
+
+/**************************************************************************************************/
+
+class TemplateCache {
+
+public:
+	TemplateCache(string);
+	~TemplateCache();
+
+	bool read();						//maps the cache file, false if there isn't one made from the current fasta file
+	void write(vector<Sequence>&);
+
+	int getNumSeqs()			{	return numSeqs;		}
+	int getLongestBase()		{	return longest;		}	//the most bases in a template
+	int getAlignedLength()		{	return alignedLength;	}	//0 if the templates are different lengths
+	string getName(int);
+	Sequence getSequence(int);
+
+private:
+	MothurOut* m;
+	string fastaFileName, cacheFileName;
+	int numSeqs, longest, alignedLength;
+
+	char* mappedData;
+	unsigned long long mappedSize;
+	vector<char> buffer;				//holds the file on systems without mmap
+	const unsigned long long* offsets;
+	const char* data;
+
+	bool getFastaInfo(unsigned long long&, long long&);
+};
+
+/**************************************************************************************************/
+
+#endif
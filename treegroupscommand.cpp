@@ -613,13 +613,13 @@ vector< vector<double> > TreeGroupCommand::makeSimsDist(SparseDistanceMatrix* ma
 		
 		//go through sparse matrix and fill sims
 		//go through each cell in the sparsematrix
-        for (int i = 0; i < matrix->seqVec.size(); i++) {
-            for (int j = 0; j < matrix->seqVec[i].size(); j++) {
+        for (int i = 0; i < matrix->getNumRows(); i++) {
+            for (int j = 0; j < matrix->getNumCells(i); j++) {
                 
                 //already checked everyone else in row
-                if (i < matrix->seqVec[i][j].index) {   
-                    simMatrix[i][matrix->seqVec[i][j].index] = -(matrix->seqVec[i][j].dist -1.0);	
-                    simMatrix[matrix->seqVec[i][j].index][i] = -(matrix->seqVec[i][j].dist -1.0);	
+                if (i < matrix->getIndex(i, j)) {   
+                    simMatrix[i][matrix->getIndex(i, j)] = -(matrix->getDist(i, j) -1.0);	
+                    simMatrix[matrix->getIndex(i, j)][i] = -(matrix->getDist(i, j) -1.0);	
 			
                     if (m->control_pressed) { return simMatrix; }
                 }
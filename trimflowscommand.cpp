@@ -403,7 +403,7 @@ int TrimFlowsCommand::driverCreateTrim(string flowFileName, string trimFlowFileN
 		ifstream flowFile;
 		m->openInputFile(flowFileName, flowFile);
 		
-		flowFile.seekg(line->start);
+		if (line->start != 0) { flowFile.seekg(line->start); }
 		
 		if(line->start == 0){
 			flowFile >> numFlows; m->gobble(flowFile);
@@ -562,9 +562,7 @@ int TrimFlowsCommand::driverCreateTrim(string flowFileName, string trimFlowFileN
 			if((count) % 10000 == 0){	m->mothurOut(toString(count)); m->mothurOutEndLine();		}
 
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-			unsigned long long pos = flowFile.tellg();
-
-			if ((pos == -1) || (pos >= line->end)) { break; }
+			if (m->endOfPart(flowFile, line->end)) { break; }
 #else
 			if (flowFile.eof()) { break; }
 #endif
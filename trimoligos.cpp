@@ -56,6 +56,14 @@ TrimOligos::TrimOligos(int p, int b, int l, int s, map<string, int> pr, map<stri
                 maxSpacerLength = spacer[i].length();
             }
         }
+        
+        vector<string> temp;
+        for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){ temp.push_back(it->first); }
+        fBarcodeIndex = OligoIndex(temp, bdiffs);
+        
+        temp.clear();
+        for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){ temp.push_back(it->first); }
+        fPrimerIndex = OligoIndex(temp, pdiffs);
     }
     catch(exception& e) {
         m->errorOut(e, "TrimOligos", "TrimOligos");
@@ -128,6 +136,24 @@ TrimOligos::TrimOligos(int p, int b, int l, int s, map<int, oligosPair> pr, map<
         
         ipbarcodes = br;
         ipprimers = pr;
+        
+        vector<string> temp;
+        for(map<string, vector<int> >::iterator it=ifbarcodes.begin();it!=ifbarcodes.end();it++){ temp.push_back(it->first); }
+        fBarcodeIndex = OligoIndex(temp, bdiffs);
+        
+        temp.clear();
+        for(map<string, vector<int> >::iterator it=ifprimers.begin();it!=ifprimers.end();it++){ temp.push_back(it->first); }
+        fPrimerIndex = OligoIndex(temp, pdiffs);
+        
+        temp.clear();
+        for(map<string, vector<int> >::iterator it=irbarcodes.begin();it!=irbarcodes.end();it++){ rBarcodes.push_back(it->first); temp.push_back(reverseOligo(it->first)); }
+        rBarcodeIndex = OligoIndex(rBarcodes, bdiffs);
+        rcBarcodeIndex = OligoIndex(temp, bdiffs);
+        
+        temp.clear();
+        for(map<string, vector<int> >::iterator it=irprimers.begin();it!=irprimers.end();it++){ rPrimers.push_back(it->first); temp.push_back(reverseOligo(it->first)); }
+        rPrimerIndex = OligoIndex(rPrimers, pdiffs);
+        rcPrimerIndex = OligoIndex(temp, pdiffs);
     }
     catch(exception& e) {
         m->errorOut(e, "TrimOligos", "TrimOligos");
@@ -165,6 +191,14 @@ TrimOligos::TrimOligos(int p, int b, map<string, int> pr, map<string, int> br, v
             }
         }
         maxRPrimerLength = maxFPrimerLength;
+        
+        vector<string> temp;
+        for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){ temp.push_back(it->first); }
+        fBarcodeIndex = OligoIndex(temp, bdiffs);
+        
+        temp.clear();
+        for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){ temp.push_back(it->first); }
+        fPrimerIndex = OligoIndex(temp, pdiffs);
     }
     catch(exception& e) {
         m->errorOut(e, "TrimOligos", "TrimOligos");
@@ -310,13 +344,19 @@ int TrimOligos::stripBarcode(Sequence& seq, QualityScores& qual, int& group){
         string rawSequence = seq.getUnaligned();
         int success = bdiffs + 1;	//guilty until proven innocent
         
+        vector<int> candidates;
+        fBarcodeIndex.getCandidates(rawSequence, candidates);
+        
+        //the search stops at the first barcode longer than the sequence
+        int firstLonger = fBarcodeIndex.getFirstLonger(rawSequence.length());
+        if(firstLonger < barcodes.size()){	success = bdiffs + 10;	}	//if the sequence is shorter than the barcode then bail out
+        
         //can you find the barcode
-        for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){
+        for(int c = 0; c < candidates.size(); c++){
+            if(candidates[c] >= firstLonger){	break;	}
+            
+            map<string,int>::iterator it = barcodes.find(fBarcodeIndex.getOligo(candidates[c]));
             string oligo = it->first;
-            if(rawSequence.length() < oligo.length()){	//let's just assume that the barcodes are the same length
-                success = bdiffs + 10;	//if the sequence is shorter than the barcode then bail out
-                break;
-            }
             
             if(compareDNASeq(oligo, rawSequence.substr(0,oligo.length()))){
                 group = it->second;
@@ -345,7 +385,8 @@ int TrimOligos::stripBarcode(Sequence& seq, QualityScores& qual, int& group){
             int minGroup = -1;
             int minPos = 0;
             
-            for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){
+            for(int c = 0; c < candidates.size(); c++){
+                map<string,int>::iterator it = barcodes.find(fBarcodeIndex.getOligo(candidates[c]));
                 string oligo = it->first;
                 // int length = oligo.length();
                 
@@ -469,7 +510,10 @@ int TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq, int& gr
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             //cout << endl << forwardSeq.getName() << endl;
-            for(map<string, vector<int> >::iterator it=ifbarcodes.begin();it!=ifbarcodes.end();it++){
+            vector<int> fCandidates;
+            fBarcodeIndex.getCandidates(rawFSequence, fCandidates);
+            for(int c = 0; c < fCandidates.size(); c++){
+                map<string, vector<int> >::iterator it = ifbarcodes.find(fBarcodeIndex.getOligo(fCandidates[c]));
                 string oligo = it->first;
                 
                 if(rawFSequence.length() < maxFBarcodeLength){	//let's just assume that the barcodes are the same length
@@ -534,7 +578,10 @@ int TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq, int& gr
                 vector< vector<int> > minRGroup;
                 vector<int> minRPos;
                 
-                for(map<string, vector<int> >::iterator it=irbarcodes.begin();it!=irbarcodes.end();it++){
+                vector<int> rCandidates;
+                rBarcodeIndex.getCandidates(rawRSequence, rCandidates);
+                for(int c = 0; c < rCandidates.size(); c++){
+                    map<string, vector<int> >::iterator it = irbarcodes.find(rBarcodeIndex.getOligo(rCandidates[c]));
                     string oligo = it->first;
                     //cout << "before = " << oligo << '\t' << rawRSequence.substr(0,oligo.length()+bdiffs) << endl;
                     if(rawRSequence.length() < maxRBarcodeLength){	//let's just assume that the barcodes are the same length
@@ -686,7 +733,10 @@ int TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq, Quality
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             //cout << endl << forwardSeq.getName() << endl;
-            for(map<string, vector<int> >::iterator it=ifbarcodes.begin();it!=ifbarcodes.end();it++){
+            vector<int> fCandidates;
+            fBarcodeIndex.getCandidates(rawFSequence, fCandidates);
+            for(int c = 0; c < fCandidates.size(); c++){
+                map<string, vector<int> >::iterator it = ifbarcodes.find(fBarcodeIndex.getOligo(fCandidates[c]));
                 string oligo = it->first;
                 
                 if(rawFSequence.length() < maxFBarcodeLength){	//let's just assume that the barcodes are the same length
@@ -749,7 +799,10 @@ int TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq, Quality
                 vector< vector<int> > minRGroup;
                 vector<int> minRPos;
                 
-                for(map<string, vector<int> >::iterator it=irbarcodes.begin();it!=irbarcodes.end();it++){
+                vector<int> rCandidates;
+                rBarcodeIndex.getCandidates(rawRSequence, rCandidates);
+                for(int c = 0; c < rCandidates.size(); c++){
+                    map<string, vector<int> >::iterator it = irbarcodes.find(rBarcodeIndex.getOligo(rCandidates[c]));
                     string oligo = it->first;
                     //cout << "before = " << oligo << '\t' << rawRSequence.substr(0,oligo.length()+bdiffs) << endl;
                     if(rawRSequence.length() < maxRBarcodeLength){	//let's just assume that the barcodes are the same length
@@ -917,7 +970,10 @@ int TrimOligos::stripPairedBarcode(Sequence& seq, QualityScores& qual, int& grou
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             //cout << endl << forwardSeq.getName() << endl;
-            for(map<string, vector<int> >::iterator it=ifbarcodes.begin();it!=ifbarcodes.end();it++){
+            vector<int> fCandidates;
+            fBarcodeIndex.getCandidates(rawSeq, fCandidates);
+            for(int c = 0; c < fCandidates.size(); c++){
+                map<string, vector<int> >::iterator it = ifbarcodes.find(fBarcodeIndex.getOligo(fCandidates[c]));
                 string oligo = it->first;
                 
                 if(rawSeq.length() < maxFBarcodeLength){	//let's just assume that the barcodes are the same length
@@ -982,8 +1038,11 @@ int TrimOligos::stripPairedBarcode(Sequence& seq, QualityScores& qual, int& grou
                 
                 string rawRSequence = reverseOligo(seq.getUnaligned());
                 //cout << irbarcodes.size() << '\t' << maxRBarcodeLength << endl;
-                for(map<string, vector<int> >::iterator it=irbarcodes.begin();it!=irbarcodes.end();it++){
-                    string oligo = reverseOligo(it->first);
+                vector<int> rCandidates;
+                rcBarcodeIndex.getCandidates(rawRSequence, rCandidates);
+                for(int c = 0; c < rCandidates.size(); c++){
+                    map<string, vector<int> >::iterator it = irbarcodes.find(rBarcodes[rCandidates[c]]);
+                    string oligo = rcBarcodeIndex.getOligo(rCandidates[c]);
                     //cout << "r before = " << reverseOligo(oligo) << '\t' << reverseOligo(rawRSequence.substr(0,oligo.length()+bdiffs)) << endl;
                     if(rawRSequence.length() < maxRBarcodeLength){	//let's just assume that the barcodes are the same length
                         success = bdiffs + 10;
@@ -1137,7 +1196,10 @@ int TrimOligos::stripPairedBarcode(Sequence& seq, int& group){
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             //cout << endl << forwardSeq.getName() << endl;
-            for(map<string, vector<int> >::iterator it=ifbarcodes.begin();it!=ifbarcodes.end();it++){
+            vector<int> fCandidates;
+            fBarcodeIndex.getCandidates(rawSeq, fCandidates);
+            for(int c = 0; c < fCandidates.size(); c++){
+                map<string, vector<int> >::iterator it = ifbarcodes.find(fBarcodeIndex.getOligo(fCandidates[c]));
                 string oligo = it->first;
                 
                 if(rawSeq.length() < maxFBarcodeLength){	//let's just assume that the barcodes are the same length
@@ -1202,8 +1264,11 @@ int TrimOligos::stripPairedBarcode(Sequence& seq, int& group){
                 
                 string rawRSequence = reverseOligo(seq.getUnaligned());
                 //cout << irbarcodes.size() << '\t' << maxRBarcodeLength << endl;
-                for(map<string, vector<int> >::iterator it=irbarcodes.begin();it!=irbarcodes.end();it++){
-                    string oligo = reverseOligo(it->first);
+                vector<int> rCandidates;
+                rcBarcodeIndex.getCandidates(rawRSequence, rCandidates);
+                for(int c = 0; c < rCandidates.size(); c++){
+                    map<string, vector<int> >::iterator it = irbarcodes.find(rBarcodes[rCandidates[c]]);
+                    string oligo = rcBarcodeIndex.getOligo(rCandidates[c]);
                     //cout << "r before = " << reverseOligo(oligo) << '\t' << reverseOligo(rawRSequence.substr(0,oligo.length()+bdiffs)) << endl;
                     if(rawRSequence.length() < maxRBarcodeLength){	//let's just assume that the barcodes are the same length
                         success = bdiffs + 10;
@@ -1360,7 +1425,10 @@ int TrimOligos::stripPairedPrimers(Sequence& seq, QualityScores& qual, int& grou
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             //cout << endl << forwardSeq.getName() << endl;
-            for(map<string, vector<int> >::iterator it=ifprimers.begin();it!=ifprimers.end();it++){
+            vector<int> fCandidates;
+            fPrimerIndex.getCandidates(rawSeq, fCandidates);
+            for(int c = 0; c < fCandidates.size(); c++){
+                map<string, vector<int> >::iterator it = ifprimers.find(fPrimerIndex.getOligo(fCandidates[c]));
                 string oligo = it->first;
                 
                 if(rawSeq.length() < maxFPrimerLength){	//let's just assume that the barcodes are the same length
@@ -1425,8 +1493,11 @@ int TrimOligos::stripPairedPrimers(Sequence& seq, QualityScores& qual, int& grou
                 
                 string rawRSequence = reverseOligo(seq.getUnaligned());
                 
-                for(map<string, vector<int> >::iterator it=irprimers.begin();it!=irprimers.end();it++){
-                    string oligo = reverseOligo(it->first);
+                vector<int> rCandidates;
+                rcPrimerIndex.getCandidates(rawRSequence, rCandidates);
+                for(int c = 0; c < rCandidates.size(); c++){
+                    map<string, vector<int> >::iterator it = irprimers.find(rPrimers[rCandidates[c]]);
+                    string oligo = rcPrimerIndex.getOligo(rCandidates[c]);
                     //cout << "r before = " << reverseOligo(oligo) << '\t' << reverseOligo(rawRSequence.substr(0,oligo.length()+pdiffs)) << endl;
                     if(rawRSequence.length() < maxRPrimerLength){	//let's just assume that the barcodes are the same length
                         success = pdiffs + 10;
@@ -1583,7 +1654,10 @@ int TrimOligos::stripPairedPrimers(Sequence& seq, int& group){
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             //cout << endl << forwardSeq.getName() << endl;
-            for(map<string, vector<int> >::iterator it=ifprimers.begin();it!=ifprimers.end();it++){
+            vector<int> fCandidates;
+            fPrimerIndex.getCandidates(rawSeq, fCandidates);
+            for(int c = 0; c < fCandidates.size(); c++){
+                map<string, vector<int> >::iterator it = ifprimers.find(fPrimerIndex.getOligo(fCandidates[c]));
                 string oligo = it->first;
                 
                 if(rawSeq.length() < maxFPrimerLength){	//let's just assume that the barcodes are the same length
@@ -1648,8 +1722,11 @@ int TrimOligos::stripPairedPrimers(Sequence& seq, int& group){
                 
                 string rawRSequence = reverseOligo(seq.getUnaligned());
                 
-                for(map<string, vector<int> >::iterator it=irprimers.begin();it!=irprimers.end();it++){
-                    string oligo = reverseOligo(it->first);
+                vector<int> rCandidates;
+                rcPrimerIndex.getCandidates(rawRSequence, rCandidates);
+                for(int c = 0; c < rCandidates.size(); c++){
+                    map<string, vector<int> >::iterator it = irprimers.find(rPrimers[rCandidates[c]]);
+                    string oligo = rcPrimerIndex.getOligo(rCandidates[c]);
                     //cout << "r before = " << reverseOligo(oligo) << '\t' << reverseOligo(rawRSequence.substr(0,oligo.length()+pdiffs)) << endl;
                     if(rawRSequence.length() < maxRPrimerLength){	//let's just assume that the barcodes are the same length
                         success = pdiffs + 10;
@@ -1799,7 +1876,10 @@ int TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq, Quality
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             //cout << endl << forwardSeq.getName() << endl;
-            for(map<string, vector<int> >::iterator it=ifprimers.begin();it!=ifprimers.end();it++){
+            vector<int> fCandidates;
+            fPrimerIndex.getCandidates(rawFSequence, fCandidates);
+            for(int c = 0; c < fCandidates.size(); c++){
+                map<string, vector<int> >::iterator it = ifprimers.find(fPrimerIndex.getOligo(fCandidates[c]));
                 string oligo = it->first;
                 
                 if(rawFSequence.length() < maxFPrimerLength){	//let's just assume that the barcodes are the same length
@@ -1864,7 +1944,10 @@ int TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq, Quality
                 vector< vector<int> > minRGroup;
                 vector<int> minRPos;
                 
-                for(map<string, vector<int> >::iterator it=irprimers.begin();it!=irprimers.end();it++){
+                vector<int> rCandidates;
+                rPrimerIndex.getCandidates(rawRSequence, rCandidates);
+                for(int c = 0; c < rCandidates.size(); c++){
+                    map<string, vector<int> >::iterator it = irprimers.find(rPrimerIndex.getOligo(rCandidates[c]));
                     string oligo = it->first;
                     //cout << "before = " << oligo << '\t' << rawRSequence.substr(0,oligo.length()+pdiffs) << endl;
                     if(rawRSequence.length() < maxRPrimerLength){	//let's just assume that the barcodes are the same length
@@ -2015,7 +2098,10 @@ int TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq, int& gr
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             //cout << endl << forwardSeq.getName() << endl;
-            for(map<string, vector<int> >::iterator it=ifprimers.begin();it!=ifprimers.end();it++){
+            vector<int> fCandidates;
+            fPrimerIndex.getCandidates(rawFSequence, fCandidates);
+            for(int c = 0; c < fCandidates.size(); c++){
+                map<string, vector<int> >::iterator it = ifprimers.find(fPrimerIndex.getOligo(fCandidates[c]));
                 string oligo = it->first;
                 
                 if(rawFSequence.length() < maxFPrimerLength){	//let's just assume that the barcodes are the same length
@@ -2080,7 +2166,10 @@ int TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq, int& gr
                 vector< vector<int> > minRGroup;
                 vector<int> minRPos;
                 
-                for(map<string, vector<int> >::iterator it=irprimers.begin();it!=irprimers.end();it++){
+                vector<int> rCandidates;
+                rPrimerIndex.getCandidates(rawRSequence, rCandidates);
+                for(int c = 0; c < rCandidates.size(); c++){
+                    map<string, vector<int> >::iterator it = irprimers.find(rPrimerIndex.getOligo(rCandidates[c]));
                     string oligo = it->first;
                     //cout << "before = " << oligo << '\t' << rawRSequence.substr(0,oligo.length()+pdiffs) << endl;
                     if(rawRSequence.length() < maxRPrimerLength){	//let's just assume that the barcodes are the same length
@@ -2181,13 +2270,19 @@ int TrimOligos::stripBarcode(Sequence& seq, int& group){
         string rawSequence = seq.getUnaligned();
         int success = bdiffs + 1;	//guilty until proven innocent
         
+        vector<int> candidates;
+        fBarcodeIndex.getCandidates(rawSequence, candidates);
+        
+        //the search stops at the first barcode longer than the sequence
+        int firstLonger = fBarcodeIndex.getFirstLonger(rawSequence.length());
+        if(firstLonger < barcodes.size()){	success = bdiffs + 10;	}	//if the sequence is shorter than the barcode then bail out
+        
         //can you find the barcode
-        for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){
+        for(int c = 0; c < candidates.size(); c++){
+            if(candidates[c] >= firstLonger){	break;	}
+            
+            map<string,int>::iterator it = barcodes.find(fBarcodeIndex.getOligo(candidates[c]));
             string oligo = it->first;
-            if(rawSequence.length() < oligo.length()){	//let's just assume that the barcodes are the same length
-                success = bdiffs + 10;	//if the sequence is shorter than the barcode then bail out
-                break;
-            }
             
             if(compareDNASeq(oligo, rawSequence.substr(0,oligo.length()))){
                 group = it->second;
@@ -2212,7 +2307,8 @@ int TrimOligos::stripBarcode(Sequence& seq, int& group){
             int minGroup = -1;
             int minPos = 0;
             
-            for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){
+            for(int c = 0; c < candidates.size(); c++){
+                map<string,int>::iterator it = barcodes.find(fBarcodeIndex.getOligo(candidates[c]));
                 string oligo = it->first;
                 // int length = oligo.length();
                 
@@ -2286,13 +2382,19 @@ int TrimOligos::stripForward(Sequence& seq, int& group){
         string rawSequence = seq.getUnaligned();
         int success = pdiffs + 1;	//guilty until proven innocent
         
+        vector<int> candidates;
+        fPrimerIndex.getCandidates(rawSequence, candidates);
+        
+        //the search stops at the first primer longer than the sequence
+        int firstLonger = fPrimerIndex.getFirstLonger(rawSequence.length());
+        if(firstLonger < primers.size()){	success = pdiffs + 10;	}	//if the sequence is shorter than the primer then bail out
+        
         //can you find the primer
-        for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){
+        for(int c = 0; c < candidates.size(); c++){
+            if(candidates[c] >= firstLonger){	break;	}
+            
+            map<string,int>::iterator it = primers.find(fPrimerIndex.getOligo(candidates[c]));
             string oligo = it->first;
-            if(rawSequence.length() < oligo.length()){	//let's just assume that the primers are the same length
-                success = pdiffs + 10;	//if the sequence is shorter than the barcode then bail out
-                break;
-            }
             
             if(compareDNASeq(oligo, rawSequence.substr(0,oligo.length()))){
                 group = it->second;
@@ -2316,7 +2418,8 @@ int TrimOligos::stripForward(Sequence& seq, int& group){
             int minGroup = -1;
             int minPos = 0;
             
-            for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){
+            for(int c = 0; c < candidates.size(); c++){
+                map<string,int>::iterator it = primers.find(fPrimerIndex.getOligo(candidates[c]));
                 string oligo = it->first;
                 // int length = oligo.length();
                 
@@ -2386,13 +2489,19 @@ int TrimOligos::stripForward(Sequence& seq, QualityScores& qual, int& group, boo
         string rawSequence = seq.getUnaligned();
         int success = pdiffs + 1;	//guilty until proven innocent
         
+        vector<int> candidates;
+        fPrimerIndex.getCandidates(rawSequence, candidates);
+        
+        //the search stops at the first primer longer than the sequence
+        int firstLonger = fPrimerIndex.getFirstLonger(rawSequence.length());
+        if(firstLonger < primers.size()){	success = pdiffs + 10;	}	//if the sequence is shorter than the primer then bail out
+        
         //can you find the primer
-        for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){
+        for(int c = 0; c < candidates.size(); c++){
+            if(candidates[c] >= firstLonger){	break;	}
+            
+            map<string,int>::iterator it = primers.find(fPrimerIndex.getOligo(candidates[c]));
             string oligo = it->first;
-            if(rawSequence.length() < oligo.length()){	//let's just assume that the primers are the same length
-                success = pdiffs + 10;	//if the sequence is shorter than the barcode then bail out
-                break;
-            }
             
             if(compareDNASeq(oligo, rawSequence.substr(0,oligo.length()))){
                 group = it->second;
@@ -2419,7 +2528,8 @@ int TrimOligos::stripForward(Sequence& seq, QualityScores& qual, int& group, boo
             int minGroup = -1;
             int minPos = 0;
             
-            for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){
+            for(int c = 0; c < candidates.size(); c++){
+                map<string,int>::iterator it = primers.find(fPrimerIndex.getOligo(candidates[c]));
                 string oligo = it->first;
                 // int length = oligo.length();
                 
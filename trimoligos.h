@@ -14,6 +14,7 @@
 #include "mothurout.h"
 #include "sequence.hpp"
 #include "qualityscores.h"
+#include "oligoindex.h"
 
 
 class TrimOligos {
@@ -66,6 +67,12 @@ class TrimOligos {
         map<int, oligosPair> ipprimers;
     
         int maxFBarcodeLength, maxRBarcodeLength, maxFPrimerLength, maxRPrimerLength, maxLinkerLength, maxSpacerLength;
+    
+        //the strip functions only compare and align the oligos sharing a piece with the start of the sequence.  The others are
+        //more than diffs away, so they can't match exactly or change the best match and its ties, see oligoindex.h
+        OligoIndex fBarcodeIndex, rBarcodeIndex, fPrimerIndex, rPrimerIndex;
+        OligoIndex rcBarcodeIndex, rcPrimerIndex;   //reverse complements of irbarcodes and irprimers, for the reverse oligos at the end of a single read
+        vector<string> rBarcodes, rPrimers;         //the keys of irbarcodes and irprimers
 	
 		MothurOut* m;
 	
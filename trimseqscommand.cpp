@@ -666,12 +666,12 @@ int TrimSeqsCommand::driverCreateTrim(string filename, string qFileName, string
 		
 		ifstream inFASTA;
 		m->openInputFile(filename, inFASTA);
-		inFASTA.seekg(line.start);
+		if (line.start != 0) { inFASTA.seekg(line.start); }
 		
 		ifstream qFile;
 		if(qFileName != "")	{
 			m->openInputFile(qFileName, qFile);
-			qFile.seekg(qline.start);  
+			if (qline.start != 0) { qFile.seekg(qline.start); }
 		}
 		
 		int count = 0;
@@ -943,8 +943,7 @@ int TrimSeqsCommand::driverCreateTrim(string filename, string qFileName, string
 			}
 			
 			#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				unsigned long long pos = inFASTA.tellg();
-				if ((pos == -1) || (pos >= line.end)) { break; }
+				if (m->endOfPart(inFASTA, line.end)) { break; }
 			
 			#else
 				if (inFASTA.eof()) { break; }
@@ -1333,6 +1332,9 @@ int TrimSeqsCommand::setLines(string filename, string qfilename) {
 		vector<unsigned long long> qfileFilePos;
 		
 		#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+		//a compressed quality file can't be divided, so neither is the fasta file and the quality file is read from its start
+		if ((qfilename != "") && m->isCompressed(qfilename)) { processors = 1; }
+		
 		//set file positions for fasta file
 		fastaFilePos = m->divideFile(filename, processors);
 		
@@ -1341,7 +1343,7 @@ int TrimSeqsCommand::setLines(string filename, string qfilename) {
 		for (int i = 0; i < (fastaFilePos.size()-1); i++) {
 			ifstream in;
 			m->openInputFile(filename, in);
-			in.seekg(fastaFilePos[i]);
+			if (fastaFilePos[i] != 0) { in.seekg(fastaFilePos[i]); }
 		
 			Sequence temp(in); 
 			firstSeqNames[temp.getName()] = i;
@@ -1371,7 +1373,8 @@ int TrimSeqsCommand::setLines(string filename, string qfilename) {
                         
                         if(it != firstSeqNames.end()) { //this is the start of a new chunk
                             unsigned long long pos = inQual.tellg(); 
-                            qfileFilePos.push_back(pos - input.length() - 1);	
+                            if (pos == -1)	{ qfileFilePos.push_back(0);							}
+                            else			{ qfileFilePos.push_back(pos - input.length() - 1);	}
                             firstSeqNames.erase(it);
                         }
                     }
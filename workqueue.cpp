@@ -0,0 +1,53 @@
+//
+//  workqueue.cpp
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+#include "workqueue.h"
+
+/**************************************************************************************************/
+WorkQueue::WorkQueue(int n) : numWorkers(max(n, 1)), tasks(max(n, 1)), locks(max(n, 1)), numAvailable(0), closed(false) {}
+/**************************************************************************************************/
+void WorkQueue::push(int worker, long long task) {
+	{
+		lock_guard<mutex> guard(locks[worker % numWorkers]);
+		tasks[worker % numWorkers].push_back(task);
+	}
+
+	lock_guard<mutex> guard(countLock);
+	numAvailable++;
+	available.notify_one();
+}
+/**************************************************************************************************/
+bool WorkQueue::pop(int worker, long long& task) {
+	{
+		//claim a task first, so the search below is guaranteed to find one
+		unique_lock<mutex> guard(countLock);
+		while ((numAvailable == 0) && !closed) { available.wait(guard); }
+		if (numAvailable == 0) { return false; }
+		numAvailable--;
+	}
+
+	int me = worker % numWorkers;
+	while (true) {
+		{
+			lock_guard<mutex> guard(locks[me]);
+			if (!tasks[me].empty()) { task = tasks[me].front(); tasks[me].pop_front(); return true; }
+		}
+
+		for (int i = 1; i < numWorkers; i++) {
+			int victim = (me + i) % numWorkers;
+			lock_guard<mutex> guard(locks[victim]);
+			if (!tasks[victim].empty()) { task = tasks[victim].back(); tasks[victim].pop_back(); return true; }
+		}
+	}
+}
+/**************************************************************************************************/
+void WorkQueue::close() {
+	lock_guard<mutex> guard(countLock);
+	closed = true;
+	available.notify_all();
+}
+/**************************************************************************************************/
@@ -0,0 +1,49 @@
+#ifndef Mothur_workqueue_h
+#define Mothur_workqueue_h
+
+//
+//  workqueue.h
+//  Mothur
+//
+//  Copyright (c) 2014 Schloss Lab. All rights reserved.
+//
+
+/* WorkQueue hands out task ids to a fixed number of worker threads.  Each worker owns a deque and
+ works through it in the order the tasks were pushed.  When it runs dry it steals the newest task from
+ another workers deque, so uneven tasks are balanced.  Each deque has its own lock, but push, pop and
+ close also take countLock to count the tasks not yet claimed, so every call briefly shares that one lock.
+ pop blocks until a task is available and returns false once close() has been called and every deque is empty. */
+
+#include "mothur.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+/**************************************************************************************************/
+
+class WorkQueue {
+
+public:
+	WorkQueue(int);                     //number of workers
+	~WorkQueue() {}
+
+	void push(int, long long);          //worker whose deque gets the task, task id
+	bool pop(int, long long&);          //worker asking, task id returned
+	void close();                       //no more tasks will be pushed
+	int getNumWorkers() { return numWorkers; }
+
+private:
+	int numWorkers;
+	vector< deque<long long> > tasks;
+	vector<mutex> locks;                //one per deque
+
+	mutex countLock;
+	condition_variable available;
+	long long numAvailable;             //tasks pushed and not yet claimed by a pop
+	bool closed;
+};
+
+/**************************************************************************************************/
+
+#endif